@@ -660,6 +660,7 @@ public: // IUnknown
                 }
 
                 m_FormatReceived = pFData->Format;
+                ++m_FormatInfoCalls;
 
                 // If the format is not supported, an E_INVALIDARG will be returned
                 if (!m_DXGIFormatSupported)
@@ -1121,6 +1122,7 @@ public: // For simplicity, allow tests to set the internal state values for this
     // 5: Format Info
     bool m_DXGIFormatSupported = true;
     UINT m_PlaneCount = 0;
+    UINT m_FormatInfoCalls = 0;
 
     // 6: GPU Virtual Address Support
     bool m_GPUVASupportAvailable = true;
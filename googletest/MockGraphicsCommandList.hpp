@@ -0,0 +1,456 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#ifndef DIRECTX_HEADERS_MOCK_GRAPHICS_COMMAND_LIST_HPP
+#define DIRECTX_HEADERS_MOCK_GRAPHICS_COMMAND_LIST_HPP
+#include <vector>
+
+#ifndef __RPC_FAR
+#define __RPC_FAR
+#endif
+
+#include <directx/d3d12.h>
+#include "dxguids/dxguids.h"
+
+// Records the copies of the helpers under test; every other command is ignored
+class MockGraphicsCommandList : public ID3D12GraphicsCommandList
+{
+public: // Recorded copies
+    struct BufferCopy
+    {
+        ID3D12Resource* pDstBuffer;
+        UINT64 DstOffset;
+        ID3D12Resource* pSrcBuffer;
+        UINT64 SrcOffset;
+        UINT64 NumBytes;
+    };
+
+    struct TextureCopy
+    {
+        D3D12_TEXTURE_COPY_LOCATION Dst;
+        D3D12_TEXTURE_COPY_LOCATION Src;
+    };
+
+    std::vector<BufferCopy> m_BufferCopies;
+    std::vector<TextureCopy> m_TextureCopies;
+
+public: // ID3D12GraphicsCommandList
+    virtual HRESULT STDMETHODCALLTYPE Close() override
+    {
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE Reset(
+        _In_  ID3D12CommandAllocator *pAllocator,
+        _In_opt_  ID3D12PipelineState *pInitialState) override
+    {
+        return S_OK;
+    }
+
+    virtual void STDMETHODCALLTYPE ClearState(
+        _In_opt_  ID3D12PipelineState *pPipelineState) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE DrawInstanced(
+        _In_  UINT VertexCountPerInstance,
+        _In_  UINT InstanceCount,
+        _In_  UINT StartVertexLocation,
+        _In_  UINT StartInstanceLocation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE DrawIndexedInstanced(
+        _In_  UINT IndexCountPerInstance,
+        _In_  UINT InstanceCount,
+        _In_  UINT StartIndexLocation,
+        _In_  INT BaseVertexLocation,
+        _In_  UINT StartInstanceLocation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE Dispatch(
+        _In_  UINT ThreadGroupCountX,
+        _In_  UINT ThreadGroupCountY,
+        _In_  UINT ThreadGroupCountZ) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE CopyBufferRegion(
+        _In_  ID3D12Resource *pDstBuffer,
+        UINT64 DstOffset,
+        _In_  ID3D12Resource *pSrcBuffer,
+        UINT64 SrcOffset,
+        UINT64 NumBytes) override
+    {
+        m_BufferCopies.push_back({ pDstBuffer, DstOffset, pSrcBuffer, SrcOffset, NumBytes });
+    }
+
+    virtual void STDMETHODCALLTYPE CopyTextureRegion(
+        _In_  const D3D12_TEXTURE_COPY_LOCATION *pDst,
+        UINT DstX,
+        UINT DstY,
+        UINT DstZ,
+        _In_  const D3D12_TEXTURE_COPY_LOCATION *pSrc,
+        _In_opt_  const D3D12_BOX *pSrcBox) override
+    {
+        m_TextureCopies.push_back({ *pDst, *pSrc });
+    }
+
+    virtual void STDMETHODCALLTYPE CopyResource(
+        _In_  ID3D12Resource *pDstResource,
+        _In_  ID3D12Resource *pSrcResource) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE CopyTiles(
+        _In_  ID3D12Resource *pTiledResource,
+        _In_  const D3D12_TILED_RESOURCE_COORDINATE *pTileRegionStartCoordinate,
+        _In_  const D3D12_TILE_REGION_SIZE *pTileRegionSize,
+        _In_  ID3D12Resource *pBuffer,
+        UINT64 BufferStartOffsetInBytes,
+        D3D12_TILE_COPY_FLAGS Flags) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ResolveSubresource(
+        _In_  ID3D12Resource *pDstResource,
+        _In_  UINT DstSubresource,
+        _In_  ID3D12Resource *pSrcResource,
+        _In_  UINT SrcSubresource,
+        _In_  DXGI_FORMAT Format) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE IASetPrimitiveTopology(
+        _In_  D3D12_PRIMITIVE_TOPOLOGY PrimitiveTopology) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE RSSetViewports(
+        _In_range_(0, D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE)  UINT NumViewports,
+        _In_reads_( NumViewports)  const D3D12_VIEWPORT *pViewports) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE RSSetScissorRects(
+        _In_range_(0, D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE)  UINT NumRects,
+        _In_reads_( NumRects)  const D3D12_RECT *pRects) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE OMSetBlendFactor(
+        _In_reads_opt_(4)  const FLOAT BlendFactor[ 4 ]) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE OMSetStencilRef(
+        _In_  UINT StencilRef) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetPipelineState(
+        _In_  ID3D12PipelineState *pPipelineState) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ResourceBarrier(
+        _In_  UINT NumBarriers,
+        _In_reads_(NumBarriers)  const D3D12_RESOURCE_BARRIER *pBarriers) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ExecuteBundle(
+        _In_  ID3D12GraphicsCommandList *pCommandList) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetDescriptorHeaps(
+        _In_  UINT NumDescriptorHeaps,
+        _In_reads_(NumDescriptorHeaps)  ID3D12DescriptorHeap *const *ppDescriptorHeaps) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootSignature(
+        _In_opt_  ID3D12RootSignature *pRootSignature) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootSignature(
+        _In_opt_  ID3D12RootSignature *pRootSignature) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootDescriptorTable(
+        _In_  UINT RootParameterIndex,
+        _In_  D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootDescriptorTable(
+        _In_  UINT RootParameterIndex,
+        _In_  D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRoot32BitConstant(
+        _In_  UINT RootParameterIndex,
+        _In_  UINT SrcData,
+        _In_  UINT DestOffsetIn32BitValues) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRoot32BitConstant(
+        _In_  UINT RootParameterIndex,
+        _In_  UINT SrcData,
+        _In_  UINT DestOffsetIn32BitValues) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRoot32BitConstants(
+        _In_  UINT RootParameterIndex,
+        _In_  UINT Num32BitValuesToSet,
+        _In_reads_(Num32BitValuesToSet*sizeof(UINT))  const void *pSrcData,
+        _In_  UINT DestOffsetIn32BitValues) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRoot32BitConstants(
+        _In_  UINT RootParameterIndex,
+        _In_  UINT Num32BitValuesToSet,
+        _In_reads_(Num32BitValuesToSet*sizeof(UINT))  const void *pSrcData,
+        _In_  UINT DestOffsetIn32BitValues) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootConstantBufferView(
+        _In_  UINT RootParameterIndex,
+        _In_  D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootConstantBufferView(
+        _In_  UINT RootParameterIndex,
+        _In_  D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootShaderResourceView(
+        _In_  UINT RootParameterIndex,
+        _In_  D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootShaderResourceView(
+        _In_  UINT RootParameterIndex,
+        _In_  D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootUnorderedAccessView(
+        _In_  UINT RootParameterIndex,
+        _In_  D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootUnorderedAccessView(
+        _In_  UINT RootParameterIndex,
+        _In_  D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE IASetIndexBuffer(
+        _In_opt_  const D3D12_INDEX_BUFFER_VIEW *pView) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE IASetVertexBuffers(
+        _In_  UINT StartSlot,
+        _In_  UINT NumViews,
+        _In_reads_opt_(NumViews)  const D3D12_VERTEX_BUFFER_VIEW *pViews) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SOSetTargets(
+        _In_  UINT StartSlot,
+        _In_  UINT NumViews,
+        _In_reads_opt_(NumViews)  const D3D12_STREAM_OUTPUT_BUFFER_VIEW *pViews) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE OMSetRenderTargets(
+        _In_  UINT NumRenderTargetDescriptors,
+        _In_opt_  const D3D12_CPU_DESCRIPTOR_HANDLE *pRenderTargetDescriptors,
+        _In_  BOOL RTsSingleHandleToDescriptorRange,
+        _In_opt_  const D3D12_CPU_DESCRIPTOR_HANDLE *pDepthStencilDescriptor) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ClearDepthStencilView(
+        _In_  D3D12_CPU_DESCRIPTOR_HANDLE DepthStencilView,
+        _In_  D3D12_CLEAR_FLAGS ClearFlags,
+        _In_  FLOAT Depth,
+        _In_  UINT8 Stencil,
+        _In_  UINT NumRects,
+        _In_reads_(NumRects)  const D3D12_RECT *pRects) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ClearRenderTargetView(
+        _In_  D3D12_CPU_DESCRIPTOR_HANDLE RenderTargetView,
+        _In_  const FLOAT ColorRGBA[ 4 ],
+        _In_  UINT NumRects,
+        _In_reads_(NumRects)  const D3D12_RECT *pRects) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewUint(
+        _In_  D3D12_GPU_DESCRIPTOR_HANDLE ViewGPUHandleInCurrentHeap,
+        _In_  D3D12_CPU_DESCRIPTOR_HANDLE ViewCPUHandle,
+        _In_  ID3D12Resource *pResource,
+        _In_  const UINT Values[ 4 ],
+        _In_  UINT NumRects,
+        _In_reads_(NumRects)  const D3D12_RECT *pRects) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat(
+        _In_  D3D12_GPU_DESCRIPTOR_HANDLE ViewGPUHandleInCurrentHeap,
+        _In_  D3D12_CPU_DESCRIPTOR_HANDLE ViewCPUHandle,
+        _In_  ID3D12Resource *pResource,
+        _In_  const FLOAT Values[ 4 ],
+        _In_  UINT NumRects,
+        _In_reads_(NumRects)  const D3D12_RECT *pRects) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE DiscardResource(
+        _In_  ID3D12Resource *pResource,
+        _In_opt_  const D3D12_DISCARD_REGION *pRegion) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE BeginQuery(
+        _In_  ID3D12QueryHeap *pQueryHeap,
+        _In_  D3D12_QUERY_TYPE Type,
+        _In_  UINT Index) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE EndQuery(
+        _In_  ID3D12QueryHeap *pQueryHeap,
+        _In_  D3D12_QUERY_TYPE Type,
+        _In_  UINT Index) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ResolveQueryData(
+        _In_  ID3D12QueryHeap *pQueryHeap,
+        _In_  D3D12_QUERY_TYPE Type,
+        _In_  UINT StartIndex,
+        _In_  UINT NumQueries,
+        _In_  ID3D12Resource *pDestinationBuffer,
+        _In_  UINT64 AlignedDestinationBufferOffset) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetPredication(
+        _In_opt_  ID3D12Resource *pBuffer,
+        _In_  UINT64 AlignedBufferOffset,
+        _In_  D3D12_PREDICATION_OP Operation) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE SetMarker(
+        UINT Metadata,
+        _In_reads_bytes_opt_(Size)  const void *pData,
+        UINT Size) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE BeginEvent(
+        UINT Metadata,
+        _In_reads_bytes_opt_(Size)  const void *pData,
+        UINT Size) override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE EndEvent() override
+    {
+    }
+
+    virtual void STDMETHODCALLTYPE ExecuteIndirect(
+        _In_  ID3D12CommandSignature *pCommandSignature,
+        _In_  UINT MaxCommandCount,
+        _In_  ID3D12Resource *pArgumentBuffer,
+        _In_  UINT64 ArgumentBufferOffset,
+        _In_opt_  ID3D12Resource *pCountBuffer,
+        _In_  UINT64 CountBufferOffset) override
+    {
+    }
+
+public: // ID3D12CommandList
+    virtual D3D12_COMMAND_LIST_TYPE STDMETHODCALLTYPE GetType() override
+    {
+        return D3D12_COMMAND_LIST_TYPE_DIRECT;
+    }
+
+public: // ID3D12DeviceChild
+    virtual HRESULT STDMETHODCALLTYPE GetDevice(
+        REFIID riid,
+        _COM_Outptr_opt_  void **ppvDevice) override
+    {
+        return E_NOINTERFACE;
+    }
+
+public: // ID3D12Object
+    virtual HRESULT STDMETHODCALLTYPE GetPrivateData(
+        _In_  REFGUID guid,
+        _Inout_  UINT *pDataSize,
+        _Out_writes_bytes_opt_( *pDataSize )  void *pData) override
+    {
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE SetPrivateData(
+        _In_  REFGUID guid,
+        _In_  UINT DataSize,
+        _In_reads_bytes_opt_( DataSize )  const void *pData) override
+    {
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(
+        _In_  REFGUID guid,
+        _In_opt_  const IUnknown *pData) override
+    {
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE SetName(
+        _In_z_  LPCWSTR Name) override
+    {
+        return S_OK;
+    }
+
+public: // IUnknown
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(
+        /* [in] */ REFIID riid,
+        /* [iid_is][out] */ _COM_Outptr_ void __RPC_FAR *__RPC_FAR *ppvObject) override
+    {
+        *ppvObject = this;
+        return S_OK;
+    }
+
+    // The mock lives on the stack of the test
+    virtual ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return 1;
+    }
+
+    virtual ULONG STDMETHODCALLTYPE Release() override
+    {
+        return 1;
+    }
+};
+
+#endif
@@ -0,0 +1,304 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#ifndef DIRECTX_HEADERS_MOCK_VIDEO_DEVICE_HPP
+#define DIRECTX_HEADERS_MOCK_VIDEO_DEVICE_HPP
+#include <map>
+#include <vector>
+
+#ifndef __RPC_FAR
+#define __RPC_FAR
+#endif
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12video.h>
+#include "dxguids/dxguids.h"
+
+// Motion vector heap that only records its description and reports its lifetime to a counter
+class MockMotionVectorHeap final : public ID3D12VideoMotionVectorHeap
+{
+public:
+    MockMotionVectorHeap(const D3D12_VIDEO_MOTION_VECTOR_HEAP_DESC& Desc, UINT* pLiveCount)
+        : m_Desc(Desc), m_pLiveCount(pLiveCount)
+    {
+        ++*m_pLiveCount;
+    }
+
+public: // ID3D12VideoMotionVectorHeap
+#if defined(_MSC_VER) || !defined(_WIN32)
+    D3D12_VIDEO_MOTION_VECTOR_HEAP_DESC STDMETHODCALLTYPE GetDesc() override
+    {
+        return m_Desc;
+    }
+#else
+    D3D12_VIDEO_MOTION_VECTOR_HEAP_DESC *STDMETHODCALLTYPE GetDesc(D3D12_VIDEO_MOTION_VECTOR_HEAP_DESC* RetVal) override
+    {
+        *RetVal = m_Desc;
+        return RetVal;
+    }
+#endif
+
+    HRESULT STDMETHODCALLTYPE GetProtectedResourceSession(REFIID riid, _COM_Outptr_opt_ void **ppProtectedSession) override
+    {
+        *ppProtectedSession = nullptr;
+        return E_NOTIMPL;
+    }
+
+public: // ID3D12DeviceChild
+    HRESULT STDMETHODCALLTYPE GetDevice(REFIID riid, _COM_Outptr_opt_ void **ppvDevice) override
+    {
+        *ppvDevice = nullptr;
+        return E_NOTIMPL;
+    }
+
+public: // ID3D12Object
+    HRESULT STDMETHODCALLTYPE GetPrivateData(_In_ REFGUID guid, _Inout_ UINT *pDataSize, _Out_writes_bytes_opt_( *pDataSize ) void *pData) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateData(_In_ REFGUID guid, _In_ UINT DataSize, _In_reads_bytes_opt_( DataSize ) const void *pData) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(_In_ REFGUID guid, _In_opt_ const IUnknown *pData) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetName(_In_z_ LPCWSTR Name) override
+    {
+        return E_NOTIMPL;
+    }
+
+public: // IUnknown
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, _COM_Outptr_ void __RPC_FAR *__RPC_FAR *ppvObject) override
+    {
+        *ppvObject = this;
+        AddRef();
+        return S_OK;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return ++m_RefCount;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG RefCount = --m_RefCount;
+        if (RefCount == 0)
+        {
+            --*m_pLiveCount;
+            delete this;
+        }
+        return RefCount;
+    }
+
+private:
+    D3D12_VIDEO_MOTION_VECTOR_HEAP_DESC m_Desc;
+    UINT* m_pLiveCount;
+    ULONG m_RefCount = 1;
+};
+
+class MockVideoDevice : public ID3D12VideoDevice1
+{
+public: // ID3D12VideoDevice1
+    HRESULT STDMETHODCALLTYPE CreateVideoMotionEstimator(
+        _In_  const D3D12_VIDEO_MOTION_ESTIMATOR_DESC *pDesc,
+        _In_opt_  ID3D12ProtectedResourceSession *pProtectedResourceSession,
+        _In_  REFIID riid,
+        _COM_Outptr_  void **ppVideoMotionEstimator) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateVideoMotionVectorHeap(
+        _In_  const D3D12_VIDEO_MOTION_VECTOR_HEAP_DESC *pDesc,
+        _In_opt_  ID3D12ProtectedResourceSession *pProtectedResourceSession,
+        _In_  REFIID riid,
+        _COM_Outptr_  void **ppVideoMotionVectorHeap) override
+    {
+        ++m_CreateMotionVectorHeapCalls;
+        *ppVideoMotionVectorHeap = static_cast<ID3D12VideoMotionVectorHeap*>(new MockMotionVectorHeap(*pDesc, &m_LiveMotionVectorHeaps));
+        return S_OK;
+    }
+
+public: // ID3D12VideoDevice
+    HRESULT STDMETHODCALLTYPE CreateVideoDecoder(
+        _In_  const D3D12_VIDEO_DECODER_DESC *pDesc,
+        _In_  REFIID riid,
+        _COM_Outptr_  void **ppVideoDecoder) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateVideoDecoderHeap(
+        _In_  const D3D12_VIDEO_DECODER_HEAP_DESC *pVideoDecoderHeapDesc,
+        _In_  REFIID riid,
+        _COM_Outptr_  void **ppVideoDecoderHeap) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateVideoProcessor(
+        UINT NodeMask,
+        _In_  const D3D12_VIDEO_PROCESS_OUTPUT_STREAM_DESC *pOutputStreamDesc,
+        UINT NumInputStreamDescs,
+        _In_reads_(NumInputStreamDescs)  const D3D12_VIDEO_PROCESS_INPUT_STREAM_DESC *pInputStreamDescs,
+        _In_  REFIID riid,
+        _COM_Outptr_  void **ppVideoProcessor) override
+    {
+        return E_NOTIMPL;
+    }
+
+public: // IUnknown
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(
+        /* [in] */ REFIID riid,
+        /* [iid_is][out] */ _COM_Outptr_ void __RPC_FAR *__RPC_FAR *ppvObject) override
+    {
+        *ppvObject = this;
+        return S_OK;
+    }
+
+    virtual ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        // Casual implementation. No actual actions
+        return 0;
+    }
+
+    virtual ULONG STDMETHODCALLTYPE Release() override
+    {
+        return 0;
+    }
+
+    // Major function we need to work with
+    virtual HRESULT STDMETHODCALLTYPE CheckFeatureSupport(
+        D3D12_FEATURE_VIDEO FeatureVideo,
+        _Inout_updates_bytes_(FeatureSupportDataSize)  void *pFeatureSupportData,
+        UINT FeatureSupportDataSize
+    ) override
+    {
+        ++m_CheckFeatureSupportCalls;
+        switch (FeatureVideo)
+        {
+            case D3D12_FEATURE_VIDEO_DECODE_PROFILE_COUNT:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_DECODE_PROFILE_COUNT*>(pFeatureSupportData);
+                pData->ProfileCount = static_cast<UINT>(m_DecodeProfiles.size());
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_DECODE_PROFILES:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_DECODE_PROFILES*>(pFeatureSupportData);
+                if (pData->ProfileCount != m_DecodeProfiles.size()) return E_INVALIDARG;
+                for (UINT i = 0; i < pData->ProfileCount; ++i) pData->pProfiles[i] = m_DecodeProfiles[i].Profile;
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_DECODE_FORMAT_COUNT:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_DECODE_FORMAT_COUNT*>(pFeatureSupportData);
+                const DecodeProfile* pProfile = FindDecodeProfile(pData->Configuration.DecodeProfile);
+                if (!pProfile) return E_INVALIDARG;
+                pData->FormatCount = static_cast<UINT>(pProfile->Formats.size());
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_DECODE_FORMATS:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_DECODE_FORMATS*>(pFeatureSupportData);
+                const DecodeProfile* pProfile = FindDecodeProfile(pData->Configuration.DecodeProfile);
+                if (!pProfile || pData->FormatCount != pProfile->Formats.size()) return E_INVALIDARG;
+                for (UINT i = 0; i < pData->FormatCount; ++i) pData->pOutputFormats[i] = pProfile->Formats[i];
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_DECODE_SUPPORT:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_DECODE_SUPPORT*>(pFeatureSupportData);
+                const DecodeProfile* pProfile = FindDecodeProfile(pData->Configuration.DecodeProfile);
+                const bool bSupported = pProfile && pData->Width <= pProfile->MaxWidth && pData->Height <= pProfile->MaxHeight;
+                pData->SupportFlags = bSupported ? D3D12_VIDEO_DECODE_SUPPORT_FLAG_SUPPORTED : D3D12_VIDEO_DECODE_SUPPORT_FLAG_NONE;
+                pData->DecodeTier = bSupported ? D3D12_VIDEO_DECODE_TIER_1 : D3D12_VIDEO_DECODE_TIER_NOT_SUPPORTED;
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_ENCODER_CODEC:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_ENCODER_CODEC*>(pFeatureSupportData);
+                pData->IsSupported = m_EncodeProfiles.count(pData->Codec) != 0;
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_ENCODER_OUTPUT_RESOLUTION_RATIOS_COUNT:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_ENCODER_OUTPUT_RESOLUTION_RATIOS_COUNT*>(pFeatureSupportData);
+                pData->ResolutionRatiosCount = 1;
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_ENCODER_OUTPUT_RESOLUTION:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_ENCODER_OUTPUT_RESOLUTION*>(pFeatureSupportData);
+                if (pData->ResolutionRatiosCount != 1) return E_INVALIDARG;
+                pData->IsSupported = TRUE;
+                pData->MinResolutionSupported = { 64, 64 };
+                pData->MaxResolutionSupported = { 4096, 2304 };
+                pData->ResolutionWidthMultipleRequirement = 2;
+                pData->ResolutionHeightMultipleRequirement = 2;
+                pData->pResolutionRatios[0] = { 1, 1 };
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_ENCODER_PROFILE_LEVEL:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_ENCODER_PROFILE_LEVEL*>(pFeatureSupportData);
+                const UINT Profile = *reinterpret_cast<const UINT*>(pData->Profile.pH264Profile);
+                pData->IsSupported = m_EncodeProfiles.count(pData->Codec) && Profile < m_EncodeProfiles[pData->Codec];
+                if (pData->Codec == D3D12_VIDEO_ENCODER_CODEC_HEVC)
+                {
+                    *pData->MinSupportedLevel.pHEVCLevelSetting = { D3D12_VIDEO_ENCODER_LEVELS_HEVC_1, D3D12_VIDEO_ENCODER_TIER_HEVC_MAIN };
+                    *pData->MaxSupportedLevel.pHEVCLevelSetting = { D3D12_VIDEO_ENCODER_LEVELS_HEVC_51, D3D12_VIDEO_ENCODER_TIER_HEVC_HIGH };
+                }
+                else
+                {
+                    *pData->MinSupportedLevel.pH264LevelSetting = D3D12_VIDEO_ENCODER_LEVELS_H264_1;
+                    *pData->MaxSupportedLevel.pH264LevelSetting = D3D12_VIDEO_ENCODER_LEVELS_H264_51;
+                }
+                return S_OK;
+            }
+            case D3D12_FEATURE_VIDEO_ENCODER_INPUT_FORMAT:
+            {
+                auto pData = static_cast<D3D12_FEATURE_DATA_VIDEO_ENCODER_INPUT_FORMAT*>(pFeatureSupportData);
+                const UINT Profile = *reinterpret_cast<const UINT*>(pData->Profile.pH264Profile);
+                // 10-bit profiles take P010, everything else NV12
+                const bool bTenBit = (pData->Codec == D3D12_VIDEO_ENCODER_CODEC_H264 && Profile == D3D12_VIDEO_ENCODER_PROFILE_H264_HIGH_10)
+                    || (pData->Codec == D3D12_VIDEO_ENCODER_CODEC_HEVC && Profile == D3D12_VIDEO_ENCODER_PROFILE_HEVC_MAIN10);
+                pData->IsSupported = pData->Format == (bTenBit ? DXGI_FORMAT_P010 : DXGI_FORMAT_NV12);
+                return S_OK;
+            }
+            default:
+                return E_INVALIDARG;
+        }
+    }
+
+public: // Pretend capabilities
+    struct DecodeProfile
+    {
+        GUID Profile;
+        std::vector<DXGI_FORMAT> Formats;
+        UINT MaxWidth;
+        UINT MaxHeight;
+    };
+
+    const DecodeProfile* FindDecodeProfile(REFGUID Profile) const
+    {
+        for (const DecodeProfile& Entry : m_DecodeProfiles)
+        {
+            if (Entry.Profile == Profile) return &Entry;
+        }
+        return nullptr;
+    }
+
+    std::vector<DecodeProfile> m_DecodeProfiles;
+    std::map<D3D12_VIDEO_ENCODER_CODEC, UINT> m_EncodeProfiles; // Codec -> number of supported profiles
+    UINT m_CheckFeatureSupportCalls = 0;
+    UINT m_CreateMotionVectorHeapCalls = 0;
+    UINT m_LiveMotionVectorHeaps = 0;
+};
+
+#endif
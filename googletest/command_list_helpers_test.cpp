@@ -0,0 +1,385 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "gtest/gtest.h"
+
+#include <wsl/winadapter.h>
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12.h>
+#include "dxguids/dxguids.h"
+
+#include "MockDevice.hpp"
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Device-free tests for the command list helpers of d3dx12.h
+
+//------------------------------------------------------------------------------------------------
+// Command list pool
+
+class MockPoolAllocator final : public ID3D12CommandAllocator
+{
+public:
+    explicit MockPoolAllocator(UINT* pLiveCount) : m_pLiveCount(pLiveCount) { ++*m_pLiveCount; }
+
+public: // ID3D12CommandAllocator
+    HRESULT STDMETHODCALLTYPE Reset() override
+    {
+        EXPECT_EQ(m_NumOpenLists, 0u);
+        ++m_NumResets;
+        return S_OK;
+    }
+
+public: // ID3D12DeviceChild
+    HRESULT STDMETHODCALLTYPE GetDevice(REFIID riid, _COM_Outptr_opt_ void **ppvDevice) override
+    {
+        *ppvDevice = nullptr;
+        return E_NOTIMPL;
+    }
+
+public: // ID3D12Object
+    HRESULT STDMETHODCALLTYPE GetPrivateData(_In_ REFGUID guid, _Inout_ UINT *pDataSize, _Out_writes_bytes_opt_( *pDataSize ) void *pData) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateData(_In_ REFGUID guid, _In_ UINT DataSize, _In_reads_bytes_opt_( DataSize ) const void *pData) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(_In_ REFGUID guid, _In_opt_ const IUnknown *pData) override
+    {
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetName(_In_z_ LPCWSTR Name) override
+    {
+        return E_NOTIMPL;
+    }
+
+public: // IUnknown
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, _COM_Outptr_ void **ppvObject) override
+    {
+        *ppvObject = this;
+        AddRef();
+        return S_OK;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return ++m_RefCount;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG RefCount = --m_RefCount;
+        if (RefCount == 0)
+        {
+            --*m_pLiveCount;
+            delete this;
+        }
+        return RefCount;
+    }
+
+    UINT m_NumResets = 0;
+    UINT m_NumOpenLists = 0;  // A second open list is an error, as on a real device
+
+private:
+    UINT* m_pLiveCount;
+    ULONG m_RefCount = 1;
+};
+
+static MockPoolAllocator* GetMockAllocator(ID3D12CommandAllocator* pAllocator)
+{
+    return static_cast<MockPoolAllocator*>(pAllocator);
+}
+
+// Only the members the pool calls
+class MockPoolCommandList
+{
+public:
+    MockPoolCommandList(ID3D12CommandAllocator* pAllocator, UINT* pLiveCount)
+        : m_pAllocator(pAllocator), m_pLiveCount(pLiveCount)
+    {
+        ++GetMockAllocator(m_pAllocator)->m_NumOpenLists;
+        ++*m_pLiveCount;
+    }
+
+    HRESULT Reset(ID3D12CommandAllocator* pAllocator, ID3D12PipelineState*)
+    {
+        EXPECT_FALSE(m_bOpen);
+        if (GetMockAllocator(pAllocator)->m_NumOpenLists != 0)
+        {
+            return E_INVALIDARG;
+        }
+        m_pAllocator = pAllocator;
+        ++GetMockAllocator(m_pAllocator)->m_NumOpenLists;
+        m_bOpen = true;
+        return S_OK;
+    }
+
+    HRESULT Close()
+    {
+        EXPECT_TRUE(m_bOpen);
+        --GetMockAllocator(m_pAllocator)->m_NumOpenLists;
+        m_bOpen = false;
+        return S_OK;
+    }
+
+    ULONG Release()
+    {
+        --*m_pLiveCount;
+        delete this;
+        return 0;
+    }
+
+    ID3D12CommandAllocator* m_pAllocator;
+    bool m_bOpen = true;
+
+private:
+    UINT* m_pLiveCount;
+};
+__CRT_UUID_DECL(MockPoolCommandList, 0x2b7e1516, 0x28ae, 0xd2a6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c)
+
+class MockPoolDevice
+{
+public:
+    HRESULT CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE, REFIID riid, void** ppAllocator)
+    {
+        EXPECT_EQ(riid, IID_ID3D12CommandAllocator);
+        *ppAllocator = static_cast<ID3D12CommandAllocator*>(new MockPoolAllocator(&m_LiveAllocators));
+        return S_OK;
+    }
+
+    HRESULT CreateCommandList(UINT, D3D12_COMMAND_LIST_TYPE, ID3D12CommandAllocator* pAllocator, ID3D12PipelineState*, REFIID, void** ppList)
+    {
+        if (GetMockAllocator(pAllocator)->m_NumOpenLists != 0)
+        {
+            return E_INVALIDARG;
+        }
+        *ppList = new MockPoolCommandList(pAllocator, &m_LiveLists);
+        ++m_NumListsCreated;
+        return S_OK;
+    }
+
+    UINT m_LiveAllocators = 0;
+    UINT m_LiveLists = 0;
+    UINT m_NumListsCreated = 0;
+};
+
+class MockPoolQueue
+{
+public:
+    void ExecuteCommandLists(UINT NumCommandLists, ID3D12CommandList* const* ppCommandLists)
+    {
+        m_Submits.push_back(NumCommandLists);
+        for (UINT i = 0; i < NumCommandLists; ++i)
+        {
+            EXPECT_FALSE(reinterpret_cast<MockPoolCommandList* const*>(ppCommandLists)[i]->m_bOpen);
+        }
+    }
+
+    std::vector<UINT> m_Submits;
+};
+
+TEST(CommandListPoolTest, FenceGatedRecycling)
+{
+    MockPoolDevice device;
+    MockPoolQueue queue;
+    {
+        CD3DX12CommandListPool<MockPoolCommandList> pool;
+        pool.Init();
+        MockPoolCommandList* pList = nullptr;
+        EXPECT_EQ(pool.Acquire(&device, D3D12_COMMAND_LIST_TYPE_BUNDLE, 0, nullptr, &pList), E_INVALIDARG);
+
+        // Frame 1: three open lists, each on its own allocator, and one submit
+        MockPoolCommandList* pLists[3] = {};
+        for (MockPoolCommandList*& p : pLists)
+        {
+            ASSERT_EQ(pool.Acquire(&device, D3D12_COMMAND_LIST_TYPE_DIRECT, 0, nullptr, &p), S_OK);
+        }
+        EXPECT_NE(pLists[0]->m_pAllocator, pLists[1]->m_pAllocator);
+        EXPECT_NE(pLists[1]->m_pAllocator, pLists[2]->m_pAllocator);
+        EXPECT_NE(pLists[0]->m_pAllocator, pLists[2]->m_pAllocator);
+        ID3D12CommandAllocator* const pFirst = pLists[0]->m_pAllocator;
+        ASSERT_EQ(pool.Execute(&queue, D3D12_COMMAND_LIST_TYPE_DIRECT, 1), S_OK);
+        EXPECT_EQ(queue.m_Submits, std::vector<UINT>{ 3 });
+
+        // Frame 2 while fence 1 is pending: a fourth allocator, the lists are reused
+        ASSERT_EQ(pool.Acquire(&device, D3D12_COMMAND_LIST_TYPE_DIRECT, 0, nullptr, &pList), S_OK);
+        EXPECT_EQ(device.m_NumListsCreated, 3u);
+        EXPECT_EQ(pool.GetNumAllocators(D3D12_COMMAND_LIST_TYPE_DIRECT), 4u);
+        ASSERT_EQ(pool.Execute(&queue, D3D12_COMMAND_LIST_TYPE_DIRECT, 2), S_OK);
+
+        // Frame 3 after fence 1: the allocators of frame 1 are reset and reused in submit order
+        MockPoolCommandList* pSecond = nullptr;
+        ASSERT_EQ(pool.Acquire(&device, D3D12_COMMAND_LIST_TYPE_DIRECT, 1, nullptr, &pList), S_OK);
+        ASSERT_EQ(pool.Acquire(&device, D3D12_COMMAND_LIST_TYPE_DIRECT, 1, nullptr, &pSecond), S_OK);
+        EXPECT_EQ(pList->m_pAllocator, pFirst);
+        EXPECT_NE(pSecond->m_pAllocator, pFirst);
+        EXPECT_EQ(GetMockAllocator(pList->m_pAllocator)->m_NumResets, 1u);
+        EXPECT_EQ(pool.GetNumAllocators(D3D12_COMMAND_LIST_TYPE_DIRECT), 4u);
+
+        const D3DX12_COMMAND_ALLOCATOR_STATS& Stats = pool.GetAllocatorStats(D3D12_COMMAND_LIST_TYPE_DIRECT, 0);
+        EXPECT_EQ(Stats.NumResets, 1u);
+        EXPECT_EQ(Stats.NumLists, 2u);
+        EXPECT_EQ(Stats.FenceValue, 1u);
+
+        // Types are pooled separately
+        ASSERT_EQ(pool.Acquire(&device, D3D12_COMMAND_LIST_TYPE_COPY, 0, nullptr, &pList), S_OK);
+        EXPECT_EQ(pool.GetNumAllocators(D3D12_COMMAND_LIST_TYPE_COPY), 1u);
+        EXPECT_EQ(pool.GetNumCommandLists(D3D12_COMMAND_LIST_TYPE_COPY), 1u);
+        EXPECT_EQ(device.m_LiveAllocators, 5u);
+    }
+    EXPECT_EQ(device.m_LiveAllocators, 0u);
+    EXPECT_EQ(device.m_LiveLists, 0u);
+}
+
+//------------------------------------------------------------------------------------------------
+// Queue scheduler
+
+// Logs the queue operations in submission order, e.g. "D:E2", "C:S1", "D:W2@1" (waits on queue 2 at 1)
+class MockSchedulerQueue
+{
+public:
+    MockSchedulerQueue(char Name, std::vector<std::string>& Log) : m_Name(Name), m_Log(Log) {}
+
+    void ExecuteCommandLists(UINT NumCommandLists, ID3D12CommandList* const*)
+    {
+        m_Log.push_back(std::string(1, m_Name) + ":E" + std::to_string(NumCommandLists));
+    }
+
+    HRESULT Signal(ID3D12Fence*, UINT64 Value)
+    {
+        m_Log.push_back(std::string(1, m_Name) + ":S" + std::to_string(Value));
+        return S_OK;
+    }
+
+    HRESULT Wait(ID3D12Fence* pFence, UINT64 Value)
+    {
+        m_Log.push_back(std::string(1, m_Name) + ":W" + std::to_string(reinterpret_cast<UINT_PTR>(pFence)) + "@" + std::to_string(Value));
+        return S_OK;
+    }
+
+private:
+    char m_Name;
+    std::vector<std::string>& m_Log;
+};
+
+template <typename T>
+static T* FakePointer(UINT_PTR Id)
+{
+    return reinterpret_cast<T*>(Id);
+}
+
+TEST(QueueSchedulerTest, MinimalCrossQueueWaits)
+{
+    std::vector<std::string> log;
+    MockSchedulerQueue direct('D', log), compute('C', log), copy('X', log);
+    CD3DX12QueueScheduler<MockSchedulerQueue> scheduler;
+    scheduler.SetQueue(D3D12_COMMAND_LIST_TYPE_DIRECT, &direct, FakePointer<ID3D12Fence>(0));
+    scheduler.SetQueue(D3D12_COMMAND_LIST_TYPE_COMPUTE, &compute, FakePointer<ID3D12Fence>(1));
+    scheduler.SetQueue(D3D12_COMMAND_LIST_TYPE_COPY, &copy, FakePointer<ID3D12Fence>(2));
+
+    ID3D12CommandList* pList = FakePointer<ID3D12CommandList>(0x100);
+    ID3D12Resource* pA = FakePointer<ID3D12Resource>(0xA);
+    ID3D12Resource* pB = FakePointer<ID3D12Resource>(0xB);
+    auto Work = [&](D3D12_COMMAND_LIST_TYPE Type, std::initializer_list<ID3D12Resource*> Reads, std::initializer_list<ID3D12Resource*> Writes)
+    {
+        const D3DX12_QUEUE_WORK_DESC Desc = { Type, 1, &pList, UINT(Reads.size()), Reads.begin(), UINT(Writes.size()), Writes.begin() };
+        UINT Index = UINT_MAX;
+        EXPECT_EQ(scheduler.AddWork(Desc, &Index), S_OK);
+        return Index;
+    };
+
+    const D3DX12_QUEUE_WORK_DESC Bundle = { D3D12_COMMAND_LIST_TYPE_BUNDLE, 1, &pList, 0, nullptr, 0, nullptr };
+    EXPECT_EQ(scheduler.AddWork(Bundle), E_INVALIDARG);
+
+    Work(D3D12_COMMAND_LIST_TYPE_COPY, {}, { pA });        // Upload A
+    Work(D3D12_COMMAND_LIST_TYPE_COMPUTE, {}, { pB });     // Independent: no wait, overlaps
+    Work(D3D12_COMMAND_LIST_TYPE_DIRECT, {}, {});
+    EXPECT_TRUE(log.empty());
+
+    Work(D3D12_COMMAND_LIST_TYPE_DIRECT, { pA, pB }, {});  // Waits on copy and compute
+    Work(D3D12_COMMAND_LIST_TYPE_DIRECT, { pA }, {});      // Already ordered, batched with the previous
+    EXPECT_EQ(log, (std::vector<std::string>{ "C:E1", "C:S1", "X:E1", "X:S1", "D:E1", "D:W1@1", "D:W2@1" }));
+
+    // Copy overwrites A after the direct reads (write-after-read), then compute reads it: compute
+    // only waits on copy, which is ordered after direct
+    log.clear();
+    const UINT Overwrite = Work(D3D12_COMMAND_LIST_TYPE_COPY, {}, { pA });
+    const UINT Reader = Work(D3D12_COMMAND_LIST_TYPE_COMPUTE, { pA }, {});
+    EXPECT_EQ(log, (std::vector<std::string>{ "D:E2", "D:S1", "X:W0@1", "X:E1", "X:S2", "C:W2@2" }));
+    EXPECT_EQ(scheduler.GetFenceValue(Overwrite), 2u);
+    EXPECT_EQ(scheduler.GetFenceValue(Reader), 0u);
+
+    // Direct overwrites B: only compute's write of B conflicts, and direct already waited for it
+    log.clear();
+    Work(D3D12_COMMAND_LIST_TYPE_DIRECT, {}, { pB });
+    EXPECT_TRUE(log.empty());
+
+    ASSERT_EQ(scheduler.Flush(), S_OK);
+    EXPECT_EQ(log, (std::vector<std::string>{ "D:E1", "D:S2", "C:E1", "C:S2" }));
+    EXPECT_EQ(scheduler.GetFenceValue(Reader), 2u);
+    EXPECT_EQ(scheduler.GetLastSignaledValue(D3D12_COMMAND_LIST_TYPE_COPY), 2u);
+
+    // Ordering survives Reset: a direct write of A still waits for compute's read
+    scheduler.Reset();
+    EXPECT_LE(scheduler.GetNumWorkItems(), 3u);
+    log.clear();
+    Work(D3D12_COMMAND_LIST_TYPE_DIRECT, {}, { pA });
+    EXPECT_EQ(log, (std::vector<std::string>{ "D:W1@2" }));
+}
+
+// A resource released and recreated at the same address is not ordered after the old one's work
+TEST(QueueSchedulerTest, ForgetReusedAddress)
+{
+    std::vector<std::string> log;
+    MockSchedulerQueue direct('D', log), copy('X', log);
+    CD3DX12QueueScheduler<MockSchedulerQueue> scheduler;
+    scheduler.SetQueue(D3D12_COMMAND_LIST_TYPE_DIRECT, &direct, FakePointer<ID3D12Fence>(0));
+    scheduler.SetQueue(D3D12_COMMAND_LIST_TYPE_COPY, &copy, FakePointer<ID3D12Fence>(2));
+
+    ID3D12CommandList* pList = FakePointer<ID3D12CommandList>(0x100);
+    ID3D12Resource* pA = FakePointer<ID3D12Resource>(0xA);
+    const D3DX12_QUEUE_WORK_DESC Upload = { D3D12_COMMAND_LIST_TYPE_COPY, 1, &pList, 0, nullptr, 1, &pA };
+    const D3DX12_QUEUE_WORK_DESC Render = { D3D12_COMMAND_LIST_TYPE_DIRECT, 1, &pList, 0, nullptr, 1, &pA };
+    ASSERT_EQ(scheduler.AddWork(Upload), S_OK);
+    ASSERT_EQ(scheduler.Flush(), S_OK);
+    EXPECT_EQ(scheduler.GetNumTrackedResources(), 1u);
+
+    // Released: the record and the item it kept alive go away
+    scheduler.Forget(pA);
+    scheduler.Reset();
+    EXPECT_EQ(scheduler.GetNumTrackedResources(), 0u);
+    EXPECT_EQ(scheduler.GetNumWorkItems(), 0u);
+
+    // A new resource at the same address needs no wait on the copy queue
+    log.clear();
+    ASSERT_EQ(scheduler.AddWork(Render), S_OK);
+    ASSERT_EQ(scheduler.Flush(), S_OK);
+    EXPECT_EQ(log, (std::vector<std::string>{ "D:E1", "D:S1" }));
+
+    // Without Forget the same reuse would have waited for the old upload
+    ASSERT_EQ(scheduler.AddWork(Upload), S_OK);
+    log.clear();
+    ASSERT_EQ(scheduler.AddWork(Render), S_OK);
+    EXPECT_EQ(log, (std::vector<std::string>{ "X:E1", "X:S2", "D:W2@2" }));
+}
+
+TEST(QueueSchedulerTest, QueuePriority)
+{
+    MockDevice device(1);
+    CD3DX12FeatureSupport features;
+    ASSERT_EQ(features.Init(&device), S_OK);
+    D3D12_COMMAND_QUEUE_DESC Desc = CD3DX12QueueScheduler<>::GetQueueDesc(features, D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    EXPECT_EQ(Desc.Type, D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    EXPECT_EQ(Desc.Priority, D3D12_COMMAND_QUEUE_PRIORITY_HIGH);
+
+    device.m_CommandQueuePriorityAvailable = false;
+    Desc = CD3DX12QueueScheduler<>::GetQueueDesc(features, D3D12_COMMAND_LIST_TYPE_COPY);
+    EXPECT_EQ(Desc.Priority, D3D12_COMMAND_QUEUE_PRIORITY_NORMAL);
+}
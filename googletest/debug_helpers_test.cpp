@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "gtest/gtest.h"
+
+#include <wsl/winadapter.h>
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12debug.h>
+#include "dxguids/dxguids.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Device-free tests for the d3dx12debug.h helpers
+
+//------------------------------------------------------------------------------------------------
+// Info queue sink
+
+// The callback is driven directly, the way the debug layer would call it
+static void PostInfoQueueMessage(CD3DX12InfoQueueSink& sink, D3D12_MESSAGE_ID ID, LPCSTR pDescription,
+    D3D12_MESSAGE_SEVERITY Severity = D3D12_MESSAGE_SEVERITY_WARNING)
+{
+    CD3DX12InfoQueueSink::OnMessage(D3D12_MESSAGE_CATEGORY_STATE_CREATION, Severity, ID, pDescription, &sink);
+}
+
+// Repeats of an ID beyond the limit are counted, not queued, until the next drain
+TEST(InfoQueueSinkTest, RateLimiting)
+{
+    CD3DX12InfoQueueSink sink;
+    EXPECT_EQ(sink.Init(12), E_INVALIDARG);
+    ASSERT_EQ(sink.Init(16, 8, 2), S_OK);
+
+    for (UINT i = 0; i < 5; ++i)
+    {
+        PostInfoQueueMessage(sink, D3D12_MESSAGE_ID_CREATERESOURCE_INVALIDFORMAT, "Invalid format");
+    }
+    PostInfoQueueMessage(sink, D3D12_MESSAGE_ID_CREATERESOURCE_INVALIDDIMENSIONS, nullptr, D3D12_MESSAGE_SEVERITY_ERROR);
+
+    std::vector<D3DX12_INFO_QUEUE_MESSAGE> messages;
+    std::vector<std::string> text;
+    auto Collect = [&](const D3DX12_INFO_QUEUE_MESSAGE& Message)
+    {
+        messages.push_back(Message);
+        text.push_back(Message.pDescription);
+    };
+    EXPECT_EQ(sink.Drain(Collect), 3u);
+    EXPECT_EQ(messages[0].ID, D3D12_MESSAGE_ID_CREATERESOURCE_INVALIDFORMAT);
+    EXPECT_EQ(text[0], "Invalid");
+    EXPECT_EQ(messages[1].NumSuppressed, 0u);
+    EXPECT_EQ(messages[2].ID, D3D12_MESSAGE_ID_CREATERESOURCE_INVALIDDIMENSIONS);
+    EXPECT_EQ(messages[2].Severity, D3D12_MESSAGE_SEVERITY_ERROR);
+    EXPECT_EQ(text[2], "");
+
+    // A new window: the next message reports the three suppressed repeats
+    messages.clear();
+    text.clear();
+    PostInfoQueueMessage(sink, D3D12_MESSAGE_ID_CREATERESOURCE_INVALIDFORMAT, "Invalid format");
+    EXPECT_EQ(sink.Drain(Collect), 1u);
+    EXPECT_EQ(messages[0].NumSuppressed, 3u);
+    EXPECT_EQ(sink.Drain(Collect), 0u);
+    EXPECT_EQ(sink.GetNumDropped(), 0u);
+}
+
+// Concurrent producers never block; what does not fit is dropped and counted
+TEST(InfoQueueSinkTest, ConcurrentProducers)
+{
+    CD3DX12InfoQueueSink sink;
+    ASSERT_EQ(sink.Init(64, 32, 1000), S_OK);
+
+    const UINT NumThreads = 4;
+    const UINT NumPerThread = 100;
+    std::vector<std::thread> threads;
+    for (UINT t = 0; t < NumThreads; ++t)
+    {
+        threads.emplace_back([&sink, t]()
+        {
+            const std::string Description = "Thread " + std::to_string(t);
+            for (UINT i = 0; i < NumPerThread; ++i)
+            {
+                PostInfoQueueMessage(sink, static_cast<D3D12_MESSAGE_ID>(D3D12_MESSAGE_ID_CORRUPTED_THIS + t), Description.c_str());
+            }
+        });
+    }
+
+    UINT NumReceived = 0;
+    bool bConsistent = true;
+    auto Count = [&](const D3DX12_INFO_QUEUE_MESSAGE& Message)
+    {
+        const UINT Thread = Message.ID - D3D12_MESSAGE_ID_CORRUPTED_THIS;
+        bConsistent = bConsistent && Thread < NumThreads && std::string(Message.pDescription) == "Thread " + std::to_string(Thread);
+        ++NumReceived;
+    };
+    for (UINT i = 0; i < 100; ++i)
+    {
+        sink.Drain(Count);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    sink.Drain(Count);
+
+    EXPECT_TRUE(bConsistent);
+    EXPECT_EQ(NumReceived + sink.GetNumDropped(), NumThreads * NumPerThread);
+}
+
+//------------------------------------------------------------------------------------------------
+// DRED crash record
+
+// Two command lists, the second with a long history that is windowed around its last completed op,
+// and a page fault with one live and one freed allocation
+TEST(DREDRecordTest, CaptureAndRead)
+{
+    std::vector<D3D12_AUTO_BREADCRUMB_OP> history(200);
+    for (UINT i = 0; i < history.size(); ++i)
+    {
+        history[i] = (i % 2) ? D3D12_AUTO_BREADCRUMB_OP_DISPATCH : D3D12_AUTO_BREADCRUMB_OP_RESOURCEBARRIER;
+    }
+    const UINT LastShadows = 3;
+    const UINT LastCompute = 150;
+    D3D12_DRED_BREADCRUMB_CONTEXT contexts[] = { { 10, L"Skipped" }, { 151, L"Cull \u00e9" } };
+
+    D3D12_AUTO_BREADCRUMB_NODE1 compute = {};
+    compute.pCommandListDebugNameW = L"Compute";
+    compute.pCommandQueueDebugNameA = "AsyncCompute";
+    compute.BreadcrumbCount = static_cast<UINT>(history.size());
+    compute.pLastBreadcrumbValue = &LastCompute;
+    compute.pCommandHistory = history.data();
+    compute.BreadcrumbContextsCount = _countof(contexts);
+    compute.pBreadcrumbContexts = contexts;
+    D3D12_AUTO_BREADCRUMB_NODE1 shadows = {};
+    shadows.pCommandListDebugNameA = "Shadows";
+    shadows.BreadcrumbCount = 5;
+    shadows.pLastBreadcrumbValue = &LastShadows;
+    shadows.pCommandHistory = history.data();
+    shadows.pNext = &compute;
+
+    D3D12_DRED_ALLOCATION_NODE1 freed = { "Transient", nullptr, D3D12_DRED_ALLOCATION_TYPE_RESOURCE, nullptr, nullptr };
+    D3D12_DRED_ALLOCATION_NODE1 live = { nullptr, L"Heap", D3D12_DRED_ALLOCATION_TYPE_HEAP, nullptr, nullptr };
+    D3D12_DRED_PAGE_FAULT_OUTPUT2 pageFault = { 0x12340000, &live, &freed, D3D12_DRED_PAGE_FAULT_FLAGS_NONE };
+
+    CD3DX12DREDRecord record;
+    ASSERT_EQ(record.Init(4096, 32), S_OK);
+    ASSERT_EQ(record.Capture({ &shadows }, &pageFault, DXGI_ERROR_DEVICE_HUNG, D3D12_DRED_DEVICE_STATE_PAGEFAULT), S_OK);
+    EXPECT_EQ(record.GetSize() % 4, 0u);
+
+    // Stand-in for the file written by the crash handler
+    const std::vector<BYTE> file(static_cast<const BYTE*>(record.GetData()), static_cast<const BYTE*>(record.GetData()) + record.GetSize());
+    CD3DX12DREDRecordReader reader;
+    ASSERT_EQ(reader.Init(file.data(), file.size()), S_OK);
+    EXPECT_EQ(reader.GetDeviceRemovedReason(), DXGI_ERROR_DEVICE_HUNG);
+    EXPECT_EQ(reader.GetDeviceState(), D3D12_DRED_DEVICE_STATE_PAGEFAULT);
+    EXPECT_FALSE(reader.IsTruncated());
+
+    ASSERT_EQ(reader.GetCommandLists().size(), 2u);
+    const D3DX12_DRED_COMMAND_LIST_INFO& First = reader.GetCommandLists()[0];
+    EXPECT_EQ(First.CommandListName, "Shadows");
+    EXPECT_EQ(First.CommandQueueName, "");
+    EXPECT_EQ(First.LastCompletedOp, 3u);
+    EXPECT_EQ(First.FirstOp, 0u);
+    EXPECT_EQ(First.Ops.size(), 5u);
+
+    const D3DX12_DRED_COMMAND_LIST_INFO& Second = reader.GetCommandLists()[1];
+    EXPECT_EQ(Second.CommandListName, "Compute");
+    EXPECT_EQ(Second.CommandQueueName, "AsyncCompute");
+    EXPECT_EQ(Second.BreadcrumbCount, 200u);
+    EXPECT_EQ(Second.LastCompletedOp, 150u);
+    EXPECT_EQ(Second.FirstOp, 142u);
+    ASSERT_EQ(Second.Ops.size(), 32u);
+    EXPECT_EQ(Second.Ops[151 - 142], D3D12_AUTO_BREADCRUMB_OP_DISPATCH);
+    ASSERT_EQ(Second.Contexts.size(), 1u);
+    EXPECT_EQ(Second.Contexts[0].first, 151u);
+    EXPECT_EQ(Second.Contexts[0].second, "Cull ?");
+
+    EXPECT_TRUE(reader.HasPageFault());
+    EXPECT_EQ(reader.GetPageFaultVA(), 0x12340000u);
+    ASSERT_EQ(reader.GetAllocations().size(), 2u);
+    EXPECT_EQ(reader.GetAllocations()[0].Name, "Heap");
+    EXPECT_FALSE(reader.GetAllocations()[0].bRecentlyFreed);
+    EXPECT_EQ(reader.GetAllocations()[1].Name, "Transient");
+    EXPECT_EQ(reader.GetAllocations()[1].AllocationType, D3D12_DRED_ALLOCATION_TYPE_RESOURCE);
+    EXPECT_TRUE(reader.GetAllocations()[1].bRecentlyFreed);
+
+    // A buffer too small for everything keeps what fits and says so
+    ASSERT_EQ(record.Init(sizeof(D3DX12_DRED_RECORD_HEADER) + 64, 32), S_OK);
+    ASSERT_EQ(record.Capture({ &shadows }, nullptr, DXGI_ERROR_DEVICE_HUNG, D3D12_DRED_DEVICE_STATE_HUNG), S_OK);
+    ASSERT_EQ(reader.Init(record.GetData(), record.GetSize()), S_OK);
+    EXPECT_TRUE(reader.IsTruncated());
+    EXPECT_FALSE(reader.HasPageFault());
+    EXPECT_EQ(reader.GetCommandLists().size(), 1u);
+
+    // Corrupt records are rejected
+    std::vector<BYTE> corrupt = file;
+    EXPECT_EQ(reader.Init(corrupt.data(), corrupt.size() - 4), E_INVALIDARG);
+    reinterpret_cast<D3DX12_DRED_RECORD_HEADER*>(corrupt.data())->NumAllocations = 3;
+    EXPECT_EQ(reader.Init(corrupt.data(), corrupt.size()), E_INVALIDARG);
+
+    // A record cut inside the padding of a name is rejected even when the header agrees, and the
+    // allocation claimed to follow is never read
+    corrupt = file;
+    corrupt.resize(corrupt.size() - 3);
+    reinterpret_cast<D3DX12_DRED_RECORD_HEADER*>(corrupt.data())->Size = static_cast<UINT32>(corrupt.size());
+    reinterpret_cast<D3DX12_DRED_RECORD_HEADER*>(corrupt.data())->NumAllocations = 3;
+    EXPECT_EQ(reader.Init(corrupt.data(), corrupt.size()), E_INVALIDARG);
+
+    // Every single-byte corruption of the body either parses or fails cleanly, always within the record
+    for (SIZE_T i = sizeof(D3DX12_DRED_RECORD_HEADER); i < file.size(); ++i)
+    {
+        for (BYTE Value : { BYTE(0x01), BYTE(0x7F), BYTE(0xFF) })
+        {
+            corrupt = file;
+            corrupt[i] ^= Value;
+            const HRESULT hr = reader.Init(corrupt.data(), corrupt.size());
+            EXPECT_TRUE(hr == S_OK || hr == E_INVALIDARG);
+        }
+    }
+}
+
+// An empty page fault output, as DRED returns after a hang, is not recorded as a page fault
+TEST(DREDRecordTest, NoPageFault)
+{
+    const UINT LastOp = 1;
+    const D3D12_AUTO_BREADCRUMB_OP history[] = { D3D12_AUTO_BREADCRUMB_OP_DRAWINSTANCED, D3D12_AUTO_BREADCRUMB_OP_DISPATCH };
+    D3D12_AUTO_BREADCRUMB_NODE1 node = {};
+    node.BreadcrumbCount = _countof(history);
+    node.pLastBreadcrumbValue = &LastOp;
+    node.pCommandHistory = history;
+    const D3D12_DRED_PAGE_FAULT_OUTPUT2 pageFault = {};
+
+    CD3DX12DREDRecord record;
+    ASSERT_EQ(record.Init(4096, 32), S_OK);
+    ASSERT_EQ(record.Capture({ &node }, &pageFault, DXGI_ERROR_DEVICE_HUNG, D3D12_DRED_DEVICE_STATE_HUNG), S_OK);
+    CD3DX12DREDRecordReader reader;
+    ASSERT_EQ(reader.Init(record.GetData(), record.GetSize()), S_OK);
+    EXPECT_FALSE(reader.HasPageFault());
+    EXPECT_EQ(reader.GetPageFaultVA(), 0u);
+    EXPECT_TRUE(reader.GetAllocations().empty());
+    EXPECT_EQ(reader.GetCommandLists().size(), 1u);
+
+    // A fault with no allocation history still counts
+    const D3D12_DRED_PAGE_FAULT_OUTPUT2 addressOnly = { 0x1000, nullptr, nullptr, D3D12_DRED_PAGE_FAULT_FLAGS_NONE };
+    ASSERT_EQ(record.Capture({ &node }, &addressOnly, DXGI_ERROR_DEVICE_REMOVED, D3D12_DRED_DEVICE_STATE_PAGEFAULT), S_OK);
+    ASSERT_EQ(reader.Init(record.GetData(), record.GetSize()), S_OK);
+    EXPECT_TRUE(reader.HasPageFault());
+    EXPECT_EQ(reader.GetPageFaultVA(), 0x1000u);
+}
@@ -0,0 +1,670 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "gtest/gtest.h"
+
+#include <wsl/winadapter.h>
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12.h>
+#include "dxguids/dxguids.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Device-free tests for the d3dx12.h helpers driven by the property format table
+
+//------------------------------------------------------------------------------------------------
+// Pixel codec
+
+static std::vector<float> RoundTrip(DXGI_FORMAT Format, std::initializer_list<float> RGBA)
+{
+    CD3DX12PixelCodec codec;
+    EXPECT_EQ(codec.Init(Format), S_OK);
+    BYTE Pixel[CD3DX12PixelCodec::MaxBytesPerPixel] = {};
+    codec.EncodeRow(RGBA.begin(), 1, Pixel);
+    std::vector<float> Decoded(4);
+    codec.DecodeRow(Pixel, 1, Decoded.data());
+    return Decoded;
+}
+
+TEST(PixelCodecTest, Layouts)
+{
+    CD3DX12PixelCodec codec;
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_B8G8R8A8_UNORM), S_OK);
+    EXPECT_EQ(codec.GetBytesPerPixel(), 4u);
+    const BYTE Bgra[4] = { 0x00, 0x80, 0xFF, 0x40 };
+    float RGBA[4];
+    codec.DecodeRow(Bgra, 1, RGBA);
+    EXPECT_FLOAT_EQ(RGBA[0], 1.0f);
+    EXPECT_FLOAT_EQ(RGBA[1], 128 / 255.0f);
+    EXPECT_FLOAT_EQ(RGBA[2], 0.0f);
+    EXPECT_FLOAT_EQ(RGBA[3], 64 / 255.0f);
+
+    // 2-bit alpha in the top bits of R10G10B10A2
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_R10G10B10A2_UNORM), S_OK);
+    const float Packed[4] = { 1.0f, 0.0f, 1.0f, 1.0f / 3 };
+    UINT Bits = 0;
+    codec.EncodeRow(Packed, 1, &Bits);
+    EXPECT_EQ(Bits, 0x3FFu | (0x3FFu << 20) | (1u << 30));
+
+    // Missing channels decode as (0, 0, 0, 1)
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_A8_UNORM), S_OK);
+    const BYTE Alpha = 0xFF;
+    codec.DecodeRow(&Alpha, 1, RGBA);
+    EXPECT_EQ(RGBA[0], 0.0f);
+    EXPECT_EQ(RGBA[3], 1.0f);
+
+    EXPECT_EQ(codec.Init(DXGI_FORMAT_BC1_UNORM), E_INVALIDARG);
+    EXPECT_EQ(codec.Init(DXGI_FORMAT_NV12), E_INVALIDARG);
+    EXPECT_EQ(codec.Init(DXGI_FORMAT_R8G8B8A8_TYPELESS), E_INVALIDARG);
+    EXPECT_EQ(codec.Init(DXGI_FORMAT_R9G9B9E5_SHAREDEXP), E_INVALIDARG);
+}
+
+TEST(PixelCodecTest, Interpretations)
+{
+    EXPECT_EQ(RoundTrip(DXGI_FORMAT_R32G32B32A32_FLOAT, { 1.5f, -2.0f, 1e-20f, 3e30f }), (std::vector<float>{ 1.5f, -2.0f, 1e-20f, 3e30f }));
+    EXPECT_EQ(RoundTrip(DXGI_FORMAT_R16G16B16A16_FLOAT, { 0.5f, -65504.0f, 1e6f, 0.0f })[0], 0.5f);
+    EXPECT_EQ(RoundTrip(DXGI_FORMAT_R16G16B16A16_FLOAT, { 0.5f, -65504.0f, 1e6f, 0.0f })[1], -65504.0f);
+    EXPECT_TRUE(std::isinf(RoundTrip(DXGI_FORMAT_R16G16B16A16_FLOAT, { 0.5f, -65504.0f, 1e6f, 0.0f })[2]));
+    EXPECT_EQ(RoundTrip(DXGI_FORMAT_R16_FLOAT, { 5.96046448e-8f, 0, 0, 0 })[0], 5.96046448e-8f);
+
+    // 11/10-bit floats have no sign
+    const std::vector<float> Small = RoundTrip(DXGI_FORMAT_R11G11B10_FLOAT, { 1.0f, -1.0f, 0.25f, 0.0f });
+    EXPECT_EQ(Small, (std::vector<float>{ 1.0f, 0.0f, 0.25f, 1.0f }));
+    EXPECT_NEAR(RoundTrip(DXGI_FORMAT_R11G11B10_FLOAT, { 0.3f, 0, 0, 0 })[0], 0.3f, 0.3f / 64);
+
+    EXPECT_EQ(RoundTrip(DXGI_FORMAT_R8G8_SNORM, { -1.0f, -2.0f, 0, 0 })[1], -1.0f);
+    EXPECT_FLOAT_EQ(RoundTrip(DXGI_FORMAT_R8_SNORM, { 0.5f, 0, 0, 0 })[0], 64 / 127.0f);
+    EXPECT_EQ(RoundTrip(DXGI_FORMAT_R16G16_SINT, { -40000.0f, 123.4f, 0, 0 }), (std::vector<float>{ -32768.0f, 123.0f, 0.0f, 1.0f }));
+    EXPECT_EQ(RoundTrip(DXGI_FORMAT_R8_UINT, { 300.0f, 0, 0, 0 })[0], 255.0f);
+    EXPECT_EQ(RoundTrip(DXGI_FORMAT_D16_UNORM, { 1.0f, 7.0f, 0, 0 }), (std::vector<float>{ 1.0f, 0.0f, 0.0f, 1.0f }));
+
+    // sRGB color channels round trip through linear space; alpha stays linear
+    const std::vector<float> Srgb = RoundTrip(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, { 0.2158605f, 1.0f, 0.0f, 0.5f });
+    EXPECT_NEAR(Srgb[0], 0.2158605f, 1e-4f);
+    EXPECT_FLOAT_EQ(Srgb[3], 128 / 255.0f);
+    CD3DX12PixelCodec codec;
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB), S_OK);
+    const float Gray[4] = { 0.2158605f, 0.2158605f, 0.2158605f, 0.5f };
+    BYTE Encoded[4];
+    codec.EncodeRow(Gray, 1, Encoded);
+    EXPECT_EQ(Encoded[0], 128);
+    EXPECT_EQ(Encoded[3], 128);
+}
+
+//------------------------------------------------------------------------------------------------
+// Pixel conversion
+
+// Converts with the fast path and with the generic path and compares the bytes; NaNs only need to
+// stay NaNs, since the fast path preserves payloads
+static void ExpectMatchesGeneric(DXGI_FORMAT SrcFormat, DXGI_FORMAT DstFormat, D3DX12_PIXEL_CONVERSION_PATH Path,
+    const std::vector<BYTE>& Src)
+{
+    CD3DX12PixelConverter fast, generic;
+    ASSERT_EQ(fast.Init(SrcFormat, DstFormat), S_OK);
+    ASSERT_EQ(generic.Init(SrcFormat, DstFormat, false), S_OK);
+    EXPECT_EQ(fast.GetPath(), Path);
+    EXPECT_EQ(generic.GetPath(), D3DX12_PIXEL_CONVERSION_PATH_GENERIC);
+
+    const UINT SrcBytes = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetBitsPerUnit(SrcFormat) / 8;
+    const UINT DstBytes = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetBitsPerUnit(DstFormat) / 8;
+    const UINT NumPixels = static_cast<UINT>(Src.size() / SrcBytes);
+    std::vector<BYTE> Fast(SIZE_T(NumPixels) * DstBytes), Generic(Fast.size());
+    fast.ConvertRow(Src.data(), NumPixels, Fast.data());
+    generic.ConvertRow(Src.data(), NumPixels, Generic.data());
+
+    UINT NumMismatches = 0;
+    const bool bFloatDst = Path == D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_FLOAT;
+    for (SIZE_T i = 0; i < Fast.size(); i += bFloatDst ? 4 : 1)
+    {
+        if (bFloatDst)
+        {
+            float A, B;
+            memcpy(&A, &Fast[i], sizeof(A));
+            memcpy(&B, &Generic[i], sizeof(B));
+            NumMismatches += (std::isnan(A) && std::isnan(B)) || memcmp(&A, &B, sizeof(A)) == 0 ? 0 : 1;
+        }
+        else
+        {
+            NumMismatches += Fast[i] == Generic[i] ? 0 : 1;
+        }
+    }
+    EXPECT_EQ(NumMismatches, 0u) << SrcFormat << " -> " << DstFormat;
+}
+
+static std::vector<BYTE> RandomBytes(SIZE_T Size, UINT Seed)
+{
+    std::vector<BYTE> Bytes(Size);
+    for (BYTE& Byte : Bytes)
+    {
+        Seed = Seed * 1664525u + 1013904223u;
+        Byte = static_cast<BYTE>(Seed >> 24);
+    }
+    return Bytes;
+}
+
+// Every fast path gives the same bytes as the generic path; half inputs are covered exhaustively
+TEST(PixelConverterTest, FastPathsMatchGeneric)
+{
+    const std::vector<BYTE> Bytes = RandomBytes(4096 * 4, 7);
+    ExpectMatchesGeneric(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM, D3DX12_PIXEL_CONVERSION_PATH_COPY, Bytes);
+    ExpectMatchesGeneric(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM, D3DX12_PIXEL_CONVERSION_PATH_SWIZZLE_RB, Bytes);
+    ExpectMatchesGeneric(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, D3DX12_PIXEL_CONVERSION_PATH_SWIZZLE_RB, Bytes);
+    ExpectMatchesGeneric(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, D3DX12_PIXEL_CONVERSION_PATH_SRGB_LOOKUP, Bytes);
+    ExpectMatchesGeneric(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT_B8G8R8A8_UNORM, D3DX12_PIXEL_CONVERSION_PATH_SRGB_LOOKUP, Bytes);
+    ExpectMatchesGeneric(DXGI_FORMAT_R10G10B10A2_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT, D3DX12_PIXEL_CONVERSION_PATH_R10G10B10A2_TO_HALF, Bytes);
+
+    std::vector<BYTE> Halves(65536 * 2);
+    for (UINT i = 0; i < 65536; ++i)
+    {
+        const UINT16 Half = static_cast<UINT16>(i);
+        memcpy(&Halves[i * 2], &Half, sizeof(Half));
+    }
+    ExpectMatchesGeneric(DXGI_FORMAT_R16_FLOAT, DXGI_FORMAT_R32_FLOAT, D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_FLOAT, Halves);
+    ExpectMatchesGeneric(DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT, D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_FLOAT, Halves);
+    ExpectMatchesGeneric(DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R10G10B10A2_UNORM, D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_R10G10B10A2, Halves);
+
+    // Every half, the midpoints between neighbours (ties round to even), and random bit patterns
+    std::vector<float> Floats;
+    for (UINT i = 0; i < 0x7C00; ++i)
+    {
+        const float Value = CD3DX12PixelConverter::HalfToFloat(static_cast<UINT16>(i));
+        const float Next = CD3DX12PixelConverter::HalfToFloat(static_cast<UINT16>(i + 1));
+        for (float Sign : { 1.0f, -1.0f })
+        {
+            Floats.push_back(Sign * Value);
+            Floats.push_back(Sign * (Value + Next) / 2);
+            Floats.push_back(Sign * std::nextafter((Value + Next) / 2, 0.0f));
+        }
+    }
+    Floats.push_back(INFINITY);
+    Floats.push_back(NAN);
+    Floats.push_back(1e-40f);
+    const std::vector<BYTE> Random = RandomBytes(65536 * 4, 11);
+    std::vector<BYTE> FloatBytes(Floats.size() * 4);
+    memcpy(FloatBytes.data(), Floats.data(), FloatBytes.size());
+    FloatBytes.insert(FloatBytes.end(), Random.begin(), Random.end());
+    ExpectMatchesGeneric(DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R16_FLOAT, D3DX12_PIXEL_CONVERSION_PATH_FLOAT_TO_HALF, FloatBytes);
+    ExpectMatchesGeneric(DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R16G16_FLOAT, D3DX12_PIXEL_CONVERSION_PATH_FLOAT_TO_HALF, FloatBytes);
+}
+
+// Conversions without a fast path go through RGBA floats, in batches, honoring both pitches
+TEST(PixelConverterTest, GenericSubresource)
+{
+    CD3DX12PixelConverter converter;
+    EXPECT_EQ(converter.Init(DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM), E_INVALIDARG);
+    ASSERT_EQ(converter.Init(DXGI_FORMAT_B5G6R5_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB), S_OK);
+    EXPECT_EQ(converter.GetPath(), D3DX12_PIXEL_CONVERSION_PATH_GENERIC);
+
+    // 100 pixels spans two batches; two slices of three rows
+    const UINT Width = 100;
+    std::vector<UINT16> Src(256 * 6, 0xFFFF);
+    for (UINT Row = 0; Row < 6; ++Row)
+    {
+        for (UINT x = 0; x < Width; ++x)
+        {
+            Src[Row * 256 + x] = static_cast<UINT16>((x == 99 ? 0x1Fu : 0u) << 11 | (Row == 5 ? 0x3Fu : 0u) << 5);
+        }
+    }
+    std::vector<UINT> Dst(128 * 6, 0xCDCDCDCD);
+    const D3D12_SUBRESOURCE_DATA SrcData = { Src.data(), 512, 512 * 3 };
+    const D3D12_MEMCPY_DEST DstData = { Dst.data(), 512, 512 * 3 };
+    converter.ConvertSubresource(&DstData, &SrcData, Width, 3, 2);
+
+    EXPECT_EQ(Dst[0], 0xFF000000u);
+    EXPECT_EQ(Dst[99], 0xFF0000FFu);
+    EXPECT_EQ(Dst[100], 0xCDCDCDCDu);
+    EXPECT_EQ(Dst[5 * 128 + 99], 0xFF00FFFFu);
+    EXPECT_EQ(Dst[5 * 128 + 98], 0xFF00FF00u);
+}
+
+//------------------------------------------------------------------------------------------------
+// Mip generation
+
+// A checkerboard averages to mid gray: 0.5 linear, which is 188 in sRGB
+TEST(MipGeneratorTest, BoxFilterSRGB)
+{
+    CD3DX12MipGenerator generator;
+    ASSERT_EQ(generator.Init(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 4, 4, 1, 0)), S_OK);
+    EXPECT_EQ(generator.GetDesc().MipLevels, 3u);
+    EXPECT_EQ(generator.Init(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 4, 4, 1, 4)), E_INVALIDARG);
+    EXPECT_EQ(generator.Init(CD3DX12_RESOURCE_DESC::Tex3D(DXGI_FORMAT_R8G8B8A8_UNORM, 4, 4, 4, 1)), E_INVALIDARG);
+    ASSERT_EQ(generator.Init(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 4, 4, 1, 0)), S_OK);
+
+    UINT Texels[16];
+    for (UINT i = 0; i < 16; ++i)
+    {
+        Texels[i] = ((i ^ (i / 4)) & 1) ? 0xFFFFFFFF : 0xFF000000;
+    }
+    std::vector<BYTE> upload(static_cast<SIZE_T>(generator.GetRequiredSize()));
+    ASSERT_EQ(generator.GenerateSlice(0, { Texels, 16, 64 }, upload.data()), S_OK);
+    EXPECT_EQ(generator.GenerateSlice(1, { Texels, 16, 64 }, upload.data()), E_INVALIDARG);
+
+    const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Top = generator.GetLayout(0);
+    EXPECT_EQ(memcmp(&upload[static_cast<SIZE_T>(Top.Offset) + Top.Footprint.RowPitch * 3], &Texels[12], 16), 0);
+    for (UINT Mip = 1; Mip < 3; ++Mip)
+    {
+        const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout = generator.GetLayout(Mip);
+        EXPECT_EQ(Layout.Offset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, 0u);
+        const BYTE* pTexel = &upload[static_cast<SIZE_T>(Layout.Offset)];
+        EXPECT_EQ(pTexel[0], 188);
+        EXPECT_EQ(pTexel[2], 188);
+        EXPECT_EQ(pTexel[3], 255);
+    }
+}
+
+// The Kaiser filter preserves constant images at odd sizes; slices are generated concurrently
+TEST(MipGeneratorTest, KaiserSlices)
+{
+    CD3DX12MipGenerator generator;
+    ASSERT_EQ(generator.Init(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, 13, 7, 4, 0), D3DX12_MIP_FILTER_KAISER, 512), S_OK);
+    EXPECT_EQ(generator.GetDesc().MipLevels, 4u);
+    EXPECT_EQ(generator.GetLayout(0).Offset, 512u);
+
+    CD3DX12PixelCodec codec;
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_R16G16B16A16_FLOAT), S_OK);
+    std::vector<std::vector<UINT64>> slices(4, std::vector<UINT64>(13 * 7));
+    for (UINT Slice = 0; Slice < 4; ++Slice)
+    {
+        const float Value[4] = { 0.25f * Slice, 1.0f, -2.0f, 0.5f };
+        for (UINT64& Texel : slices[Slice])
+        {
+            codec.EncodeRow(Value, 1, &Texel);
+        }
+    }
+
+    std::vector<BYTE> upload(static_cast<SIZE_T>(512 + generator.GetRequiredSize()));
+    std::vector<std::thread> threads;
+    for (UINT Slice = 0; Slice < 4; ++Slice)
+    {
+        threads.emplace_back([&, Slice]()
+        {
+            EXPECT_EQ(generator.GenerateSlice(Slice, { slices[Slice].data(), 13 * 8, 13 * 8 * 7 }, upload.data()), S_OK);
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (UINT Slice = 0; Slice < 4; ++Slice)
+    {
+        for (UINT Mip = 1; Mip < 4; ++Mip)
+        {
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout = generator.GetLayout(D3D12CalcSubresource(Mip, Slice, 0, 4, 4));
+            const UINT Width = Layout.Footprint.Width;
+            std::vector<float> Row(Width * 4);
+            for (UINT y = 0; y < Layout.Footprint.Height; ++y)
+            {
+                codec.DecodeRow(&upload[static_cast<SIZE_T>(Layout.Offset) + Layout.Footprint.RowPitch * y], Width, Row.data());
+                for (UINT x = 0; x < Width; ++x)
+                {
+                    EXPECT_NEAR(Row[x * 4 + 0], 0.25f * Slice, 1e-3f);
+                    EXPECT_NEAR(Row[x * 4 + 2], -2.0f, 2e-3f);
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// Block compression
+
+// Packs fields into a 128-bit block from the least significant bit of the first byte
+class BlockWriter
+{
+public:
+    BlockWriter& Write(UINT Value, UINT NumBits)
+    {
+        for (UINT b = 0; b < NumBits; ++b, ++m_Position)
+        {
+            m_Block[m_Position / 8] |= static_cast<BYTE>(((Value >> b) & 1) << (m_Position % 8));
+        }
+        return *this;
+    }
+    const BYTE* Get() const { EXPECT_EQ(m_Position, 128u); return m_Block; }
+
+private:
+    BYTE m_Block[16] = {};
+    UINT m_Position = 0;
+};
+
+static float HalfBits(UINT Half)
+{
+    return CD3DX12PixelCodec::SmallFloatToFloat(Half, 5, 10, true);
+}
+
+// Hand-built blocks decode to the values of the format specifications
+TEST(BlockCodecTest, KnownBlocks)
+{
+    CD3DX12BlockCodec codec;
+    float RGBA[64];
+    EXPECT_EQ(codec.Init(DXGI_FORMAT_BC7_TYPELESS), E_INVALIDARG);
+
+    // BC1: red and blue in 4-color mode, then the same colors swapped for 3-color mode
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_BC1_UNORM), S_OK);
+    EXPECT_EQ(codec.GetBytesPerBlock(), 8u);
+    const BYTE FourColors[8] = { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0, 0, 0 };
+    codec.DecodeBlock(FourColors, RGBA);
+    EXPECT_EQ(RGBA[0], 1.0f);
+    EXPECT_EQ(RGBA[1 * 4 + 2], 1.0f);
+    EXPECT_FLOAT_EQ(RGBA[2 * 4], 2.0f / 3);
+    EXPECT_FLOAT_EQ(RGBA[3 * 4], 1.0f / 3);
+    EXPECT_EQ(RGBA[3 * 4 + 3], 1.0f);
+    const BYTE ThreeColors[8] = { 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0, 0, 0 };
+    codec.DecodeBlock(ThreeColors, RGBA);
+    EXPECT_EQ(RGBA[2 * 4], 0.5f);
+    EXPECT_EQ(RGBA[3 * 4], 0.0f);
+    EXPECT_EQ(RGBA[3 * 4 + 3], 0.0f);
+
+    // BC4 SNORM 6-value mode, with -128 read as -1
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_BC4_SNORM), S_OK);
+    const BYTE SignedBlock[8] = { 0x80, 0x7F, 0x88, 0x7C, 0, 0, 0, 0 };
+    codec.DecodeBlock(SignedBlock, RGBA);
+    EXPECT_EQ(RGBA[0], -1.0f);
+    EXPECT_FLOAT_EQ(RGBA[1 * 4], 1.0f);
+    EXPECT_FLOAT_EQ(RGBA[2 * 4], -0.6f);
+    EXPECT_EQ(RGBA[3 * 4], -1.0f);
+    EXPECT_EQ(RGBA[4 * 4], 1.0f);
+
+    // BC7 mode 6: 7-bit endpoints with a P-bit each and 4-bit indices
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_BC7_UNORM), S_OK);
+    BlockWriter Mode6;
+    Mode6.Write(1 << 6, 7).Write(127, 7).Write(0, 7).Write(64, 7).Write(64, 7).Write(0, 7).Write(127, 7).Write(127, 7).Write(127, 7);
+    Mode6.Write(1, 1).Write(0, 1).Write(0, 3).Write(15, 4).Write(8, 4);
+    for (UINT i = 3; i < 16; ++i)
+    {
+        Mode6.Write(0, 4);
+    }
+    codec.DecodeBlock(Mode6.Get(), RGBA);
+    EXPECT_EQ(RGBA[0], 1.0f);
+    EXPECT_EQ(RGBA[1], 129 / 255.0f);
+    EXPECT_EQ(RGBA[2], 1 / 255.0f);
+    EXPECT_EQ(RGBA[3], 1.0f);
+    EXPECT_EQ(RGBA[1 * 4], 0.0f);
+    EXPECT_EQ(RGBA[1 * 4 + 2], 254 / 255.0f);
+    EXPECT_EQ(RGBA[1 * 4 + 3], 254 / 255.0f);
+    EXPECT_EQ(RGBA[2 * 4], 120 / 255.0f);
+
+    // BC7 mode 1, partition 0 (columns 2 and 3 are subset 1, whose anchor is texel 15), shared P-bits
+    BlockWriter Mode1;
+    Mode1.Write(1 << 1, 2).Write(0, 6);
+    for (UINT c = 0; c < 3; ++c)
+    {
+        Mode1.Write(0, 6).Write(0, 6).Write(63, 6).Write(63, 6);
+    }
+    Mode1.Write(0, 1).Write(1, 1);
+    for (UINT i = 0; i < 16; ++i)
+    {
+        Mode1.Write(i == 2 ? 7 : 0, (i == 0 || i == 15) ? 2 : 3);
+    }
+    codec.DecodeBlock(Mode1.Get(), RGBA);
+    EXPECT_EQ(RGBA[0], 0.0f);
+    EXPECT_EQ(RGBA[2 * 4], 1.0f);
+    EXPECT_EQ(RGBA[3 * 4], 1.0f);
+    EXPECT_EQ(RGBA[3 * 4 + 3], 1.0f);
+
+    // A reserved BC7 mode is transparent black
+    const BYTE Reserved[16] = {};
+    codec.DecodeBlock(Reserved, RGBA);
+    EXPECT_EQ(RGBA[3], 0.0f);
+
+    // BC6H mode 11: one region, 10-bit endpoints, no deltas
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_BC6H_UF16), S_OK);
+    BlockWriter Mode11;
+    Mode11.Write(3, 5).Write(1023, 10).Write(1023, 10).Write(1023, 10).Write(0, 10).Write(0, 10).Write(0, 10);
+    Mode11.Write(0, 3).Write(15, 4).Write(8, 4);
+    for (UINT i = 3; i < 16; ++i)
+    {
+        Mode11.Write(0, 4);
+    }
+    codec.DecodeBlock(Mode11.Get(), RGBA);
+    EXPECT_EQ(RGBA[0], 65504.0f);
+    EXPECT_EQ(RGBA[3], 1.0f);
+    EXPECT_EQ(RGBA[1 * 4], 0.0f);
+    EXPECT_EQ(RGBA[2 * 4 + 1], HalfBits(0x3A20));
+
+    // BC6H mode 12: the second endpoint is a signed 9-bit delta from the 11-bit first endpoint
+    BlockWriter Mode12;
+    Mode12.Write(7, 5).Write(0, 10).Write(0, 10).Write(0, 10).Write(0x1FF, 9).Write(1, 1).Write(0, 9).Write(0, 1).Write(0, 9).Write(0, 1);
+    Mode12.Write(0, 3).Write(15, 4);
+    for (UINT i = 2; i < 16; ++i)
+    {
+        Mode12.Write(0, 4);
+    }
+    codec.DecodeBlock(Mode12.Get(), RGBA);
+    EXPECT_EQ(RGBA[0], HalfBits(0x3E07));
+    EXPECT_EQ(RGBA[1 * 4], HalfBits(0x3DF8));
+    EXPECT_EQ(RGBA[1 * 4 + 1], 0.0f);
+
+    // The same block signed: endpoint 1024 is now -1024 and the delta wraps to 1023
+    ASSERT_EQ(codec.Init(DXGI_FORMAT_BC6H_SF16), S_OK);
+    codec.DecodeBlock(Mode12.Get(), RGBA);
+    EXPECT_EQ(RGBA[0], -HalfBits(0x7BFF));
+    EXPECT_EQ(RGBA[1 * 4], HalfBits(0x7BFF));
+}
+
+// Encoded gradients decode back within the precision of each format, from concurrent block rows
+TEST(BlockCodecTest, EncodeRoundTrip)
+{
+    const UINT Width = 30;
+    const UINT Height = 18;
+    for (DXGI_FORMAT Format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC1_UNORM_SRGB, DXGI_FORMAT_BC4_SNORM, DXGI_FORMAT_BC5_UNORM })
+    {
+        CD3DX12BlockCodec codec;
+        ASSERT_EQ(codec.Init(Format), S_OK);
+        ASSERT_TRUE(codec.CanEncode());
+        const D3D12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Tex2D(Format, Width, Height, 1, 1);
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layout;
+        UINT64 TotalBytes;
+        ASSERT_TRUE(D3DX12GetCopyableFootprints(Desc, 0, 1, 256, &Layout, nullptr, nullptr, &TotalBytes));
+        ASSERT_EQ(CD3DX12BlockCodec::GetNumBlockRows(Layout.Footprint), 5u);
+
+        const UINT NumChannels = Format == DXGI_FORMAT_BC4_SNORM ? 1 : (Format == DXGI_FORMAT_BC5_UNORM ? 2 : 3);
+        const bool bSRGB = Format == DXGI_FORMAT_BC1_UNORM_SRGB;
+
+        // Smooth gradients along one direction, with a transparent corner for BC1
+        const D3D12_SUBRESOURCE_FOOTPRINT& Footprint = Layout.Footprint;
+        std::vector<float> Image(SIZE_T(Footprint.Width) * Footprint.Height * 4);
+        for (UINT y = 0; y < Footprint.Height; ++y)
+        {
+            for (UINT x = 0; x < Footprint.Width; ++x)
+            {
+                float* pTexel = &Image[(SIZE_T(y) * Footprint.Width + x) * 4];
+                const float Position = float(x + y) / (Footprint.Width + Footprint.Height);
+                pTexel[0] = Position;
+                pTexel[1] = NumChannels == 3 ? 1.0f - Position / 2 : float(y) / Footprint.Height;
+                pTexel[2] = 0.25f + Position / 4;
+                pTexel[3] = (x < 4 && y < 4 && (x + y) % 2) ? 0.0f : 1.0f;
+            }
+        }
+
+        std::vector<BYTE> Upload(SIZE_T(Layout.Offset + TotalBytes));
+        std::vector<float> Decoded(Image.size(), -2.0f);
+        std::thread First([&]()
+        {
+            codec.EncodeRows(Image.data(), Layout, 0, 2, Upload.data());
+            codec.DecodeRows(Upload.data(), Layout, 0, 2, Decoded.data());
+        });
+        codec.EncodeRows(Image.data(), Layout, 2, 3, Upload.data());
+        codec.DecodeRows(Upload.data(), Layout, 2, 3, Decoded.data());
+        First.join();
+
+        const float Tolerance = NumChannels == 3 ? 0.05f : 0.01f;
+        // sRGB errors are measured where the format quantizes, in sRGB space
+        auto Encoded = [&](float Value) { return bSRGB ? CD3DX12PixelCodec::LinearToSRGB(Value) : Value; };
+        float MaxError = 0.0f;
+        for (SIZE_T i = 0; i < Image.size(); i += 4)
+        {
+            const bool bTransparent = Image[i + 3] == 0.0f && NumChannels == 3;
+            EXPECT_EQ(Decoded[i + 3], bTransparent ? 0.0f : 1.0f);
+            for (UINT c = 0; c < NumChannels && !bTransparent; ++c)
+            {
+                MaxError = (std::max)(MaxError, std::fabs(Encoded(Decoded[i + c]) - Encoded(Image[i + c])));
+            }
+        }
+        EXPECT_LT(MaxError, Tolerance) << Format;
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// Format casts
+
+// The cast rule, straight from the format table
+static bool CanViewFormatReference(DXGI_FORMAT ResourceFormat, DXGI_FORMAT ViewFormat, D3D_FEATURE_LEVEL FeatureLevel)
+{
+    if (ResourceFormat == ViewFormat)
+    {
+        return true;
+    }
+    bool bInCastSet = false;
+    for (const DXGI_FORMAT* pCast = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormatCastSet(ResourceFormat); pCast && *pCast != DXGI_FORMAT_UNKNOWN; ++pCast)
+    {
+        bInCastSet = bInCastSet || *pCast == ViewFormat;
+    }
+    if (D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetTypeLevel(ResourceFormat) != D3DFTL_FULL_TYPE)
+    {
+        return bInCastSet;
+    }
+    return bInCastSet && D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::CanBeCastEvenFullyTyped(ResourceFormat, FeatureLevel)
+        && D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::CanBeCastEvenFullyTyped(ViewFormat, FeatureLevel);
+}
+
+// Every pair of formats at every feature level agrees with the table functions
+TEST(FormatCastMatrixTest, MatchesFormatTable)
+{
+    const D3D_FEATURE_LEVEL FeatureLevels[] = { D3D_FEATURE_LEVEL_1_0_CORE, D3D_FEATURE_LEVEL_9_1, D3D_FEATURE_LEVEL_9_2,
+        D3D_FEATURE_LEVEL_9_3, D3D_FEATURE_LEVEL_10_0, D3D_FEATURE_LEVEL_10_1, D3D_FEATURE_LEVEL_11_0, D3D_FEATURE_LEVEL_11_1,
+        D3D_FEATURE_LEVEL_12_0, D3D_FEATURE_LEVEL_12_1, D3D_FEATURE_LEVEL_12_2 };
+    const UINT NumFormats = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetNumFormats();
+    for (D3D_FEATURE_LEVEL FeatureLevel : FeatureLevels)
+    {
+        const CD3DX12FormatCastMatrix& matrix = CD3DX12FormatCastMatrix::Get(FeatureLevel);
+        EXPECT_EQ(matrix.GetFeatureLevel(), FeatureLevel);
+        EXPECT_EQ(&CD3DX12FormatCastMatrix::Get(FeatureLevel), &matrix);
+        UINT NumMismatches = 0;
+        for (UINT a = 0; a < NumFormats; ++a)
+        {
+            const DXGI_FORMAT FormatA = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(a);
+            for (UINT b = 0; b < NumFormats; ++b)
+            {
+                const DXGI_FORMAT FormatB = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(b);
+                NumMismatches += matrix.CanViewFormat(FormatA, FormatB) != CanViewFormatReference(FormatA, FormatB, FeatureLevel);
+                NumMismatches += matrix.ValidCastToR32UAV(FormatA, FormatB) != D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::ValidCastToR32UAV(FormatA, FormatB);
+                NumMismatches += matrix.FloatAndNotFloatFormats(FormatA, FormatB) != D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FloatAndNotFloatFormats(FormatA, FormatB);
+                NumMismatches += matrix.SNORMAndUNORMFormats(FormatA, FormatB) != D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::SNORMAndUNORMFormats(FormatA, FormatB);
+            }
+        }
+        EXPECT_EQ(NumMismatches, 0u) << FeatureLevel;
+    }
+
+    // Spot checks of the rule
+    const CD3DX12FormatCastMatrix& fl11 = CD3DX12FormatCastMatrix::Get(D3D_FEATURE_LEVEL_11_0);
+    EXPECT_TRUE(fl11.CanViewFormat(DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_R8G8B8A8_SNORM));
+    EXPECT_TRUE(fl11.CanViewFormat(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB));
+    EXPECT_FALSE(fl11.CanViewFormat(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UINT));
+    EXPECT_FALSE(fl11.CanViewFormat(DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_B8G8R8A8_UNORM));
+    EXPECT_FALSE(CD3DX12FormatCastMatrix::Get(D3D_FEATURE_LEVEL_1_0_CORE).CanViewFormat(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB));
+    EXPECT_TRUE(fl11.ValidCastToR32UAV(DXGI_FORMAT_R16G16_TYPELESS, DXGI_FORMAT_R32_UINT));
+    EXPECT_FALSE(fl11.CanViewFormat(static_cast<DXGI_FORMAT>(0x7FFF), static_cast<DXGI_FORMAT>(0x7FFF)));
+    EXPECT_EQ(CD3DX12FormatCastMatrix::Get(static_cast<D3D_FEATURE_LEVEL>(0xd000)).GetFeatureLevel(), D3D_FEATURE_LEVEL_12_2);
+}
+
+//------------------------------------------------------------------------------------------------
+// Format names
+
+// The parse a loader would write by hand, straight from the format table
+static bool ParseFormatNameReference(std::string Name, DXGI_FORMAT& Format)
+{
+    for (char& c : Name)
+    {
+        c = static_cast<char>(toupper(c));
+    }
+    if (Name.size() > 12 && Name.compare(0, 12, "DXGI_FORMAT_") == 0)
+    {
+        Name.erase(0, 12);
+    }
+    for (UINT i = 0; i < D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetNumFormats(); ++i)
+    {
+        const DXGI_FORMAT Candidate = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(i);
+        if (D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExistsInHeader(Candidate)
+            && Name == D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetName(Candidate))
+        {
+            Format = Candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every public name parses back to its format, with or without the prefix and in any case, and
+// everything else is rejected the same way a linear scan and a hash map reject it
+TEST(FormatNameParserTest, MatchesFormatTable)
+{
+    std::unordered_map<std::string, DXGI_FORMAT> map;
+    std::vector<std::string> inputs = { "", "DXGI_FORMAT_", "DXGI_FORMAT", "R8G8B8A8", "R8G8B8A8_UNORM_", "Unrecognized",
+        "dxgi_format_dxgi_format_R8_UNORM", "R8G8B8A8_UNORM\n" };
+    for (UINT i = 0; i < D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetNumFormats(); ++i)
+    {
+        const DXGI_FORMAT Format = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(i);
+        if (!D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExistsInHeader(Format))
+        {
+            continue;
+        }
+        const std::string Name = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetName(Format);
+        map[Name] = Format;
+        std::string Lower = "dxgi_format_" + Name;
+        for (char& c : Lower)
+        {
+            c = static_cast<char>(tolower(c));
+        }
+        inputs.insert(inputs.end(), { Name, "DXGI_FORMAT_" + Name, Lower, Name.substr(1), Name + "X" });
+    }
+    ASSERT_GT(map.size(), 100u);
+
+    for (const std::string& Input : inputs)
+    {
+        DXGI_FORMAT Expected = DXGI_FORMAT_UNKNOWN;
+        const bool bExpected = ParseFormatNameReference(Input, Expected);
+        if (bExpected)
+        {
+            std::string Upper = Input;
+            for (char& c : Upper)
+            {
+                c = static_cast<char>(toupper(c));
+            }
+            auto it = map.find(Upper.compare(0, 12, "DXGI_FORMAT_") == 0 ? Upper.substr(12) : Upper);
+            EXPECT_TRUE(it != map.end() && it->second == Expected) << Input;
+        }
+
+        DXGI_FORMAT Format = DXGI_FORMAT_R32_FLOAT;
+        EXPECT_EQ(CD3DX12FormatNameParser::Parse(Input.data(), Input.size(), &Format), bExpected ? S_OK : E_INVALIDARG) << Input;
+        EXPECT_EQ(Format, Expected) << Input;
+    }
+
+    DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+    EXPECT_EQ(CD3DX12FormatNameParser::Parse("Bc7_Unorm_Srgb", &Format), S_OK);
+    EXPECT_EQ(Format, DXGI_FORMAT_BC7_UNORM_SRGB);
+    EXPECT_EQ(CD3DX12FormatNameParser::Parse("DXGI_FORMAT_UNKNOWN", &Format), S_OK);
+    EXPECT_EQ(Format, DXGI_FORMAT_UNKNOWN);
+    EXPECT_EQ(CD3DX12FormatNameParser::Parse("R8G8B8A8_UNORM_SRGB", 14, &Format), S_OK);
+    EXPECT_EQ(Format, DXGI_FORMAT_R8G8B8A8_UNORM);
+}
+
+// Header formats past the end of the format table have no name there and are not recognized
+TEST(FormatNameParserTest, FormatsOutsideTable)
+{
+    for (const char* pName : { "DXGI_FORMAT_V408", "P208", "V208", "B4G4R4A4_UNORM", "A4B4G4R4_UNORM",
+        "SAMPLER_FEEDBACK_MIN_MIP_OPAQUE", "SAMPLER_FEEDBACK_MIP_REGION_USED_OPAQUE" })
+    {
+        DXGI_FORMAT Format = DXGI_FORMAT_R32_FLOAT;
+        EXPECT_EQ(CD3DX12FormatNameParser::Parse(pName, &Format), E_INVALIDARG) << pName;
+        EXPECT_EQ(Format, DXGI_FORMAT_UNKNOWN) << pName;
+    }
+}
@@ -0,0 +1,295 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "gtest/gtest.h"
+
+#include <wsl/winadapter.h>
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12.h>
+#include "dxguids/dxguids.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Device-free tests for the query helpers of d3dx12.h
+
+//------------------------------------------------------------------------------------------------
+// GPU profiler
+
+// Stands in for a command list and the GPU: EndQuery writes a synthetic timestamp into the query heap,
+// advancing a clock by a per-query step, and ResolveQueryData copies them to the "readback buffer".
+class MockTimestampCommandList
+{
+public:
+    MockTimestampCommandList(std::vector<UINT64>& Heap, std::vector<UINT64>& Readback)
+        : m_Heap(Heap), m_Readback(Readback)
+    {}
+
+    void EndQuery(ID3D12QueryHeap*, D3D12_QUERY_TYPE Type, UINT Index)
+    {
+        EXPECT_EQ(Type, D3D12_QUERY_TYPE_TIMESTAMP);
+        m_Clock += m_Step;
+        m_Heap.at(Index) = m_Clock;
+    }
+
+    void ResolveQueryData(ID3D12QueryHeap*, D3D12_QUERY_TYPE, UINT StartIndex, UINT NumQueries, ID3D12Resource*, UINT64 AlignedDestinationBufferOffset)
+    {
+        EXPECT_EQ(AlignedDestinationBufferOffset, StartIndex * sizeof(UINT64));
+        for (UINT i = 0; i < NumQueries; ++i)
+        {
+            m_Readback.at(StartIndex + i) = m_Heap.at(StartIndex + i);
+        }
+        ++m_NumResolves;
+    }
+
+    UINT64 m_Clock = 0;
+    UINT64 m_Step = 0;
+    UINT m_NumResolves = 0;
+
+private:
+    std::vector<UINT64>& m_Heap;
+    std::vector<UINT64>& m_Readback;
+};
+
+// Nested scopes over two frames in flight, with a 10 MHz clock: 1 tick = 100 ns
+TEST(GpuProfilerTest, NestedScopes)
+{
+    CD3DX12GpuProfiler profiler;
+    EXPECT_EQ(profiler.Init(0, 8, 2), E_INVALIDARG);
+    ASSERT_EQ(profiler.Init(10000000, 8, 2, 4), S_OK);
+    EXPECT_EQ(profiler.GetQueryHeapDesc().Type, D3D12_QUERY_HEAP_TYPE_TIMESTAMP);
+    EXPECT_EQ(profiler.GetQueryHeapDesc(D3D12_COMMAND_LIST_TYPE_COPY).Type, D3D12_QUERY_HEAP_TYPE_COPY_QUEUE_TIMESTAMP);
+    EXPECT_EQ(profiler.GetQueryHeapDesc().Count, 32u);
+    EXPECT_EQ(profiler.GetReadbackBufferSize(), 256u);
+
+    std::vector<UINT64> heap(32), readback(32);
+    profiler.SetResources(nullptr, nullptr, readback.data());
+    MockTimestampCommandList list(heap, readback);
+
+    // Frame = [Shadows [Cascade] [Cascade]], each timestamp Step ticks after the previous one
+    auto RecordFrame = [&](UINT64 Step, UINT64 Fence)
+    {
+        list.m_Step = Step;
+        EXPECT_TRUE(profiler.BeginFrame());
+        const UINT Frame = profiler.BeginScope(&list, "Frame");
+        const UINT Shadows = profiler.BeginScope(&list, "Shadows", Frame);
+        for (UINT i = 0; i < 2; ++i)
+        {
+            const UINT Cascade = profiler.BeginScope(&list, "Cascade", Shadows);
+            profiler.EndScope(&list, Cascade);
+        }
+        profiler.EndScope(&list, Shadows);
+        profiler.EndScope(&list, Frame);
+        profiler.ResolveFrame(&list);
+        profiler.EndFrame(Fence);
+    };
+    RecordFrame(10, 1);
+    RecordFrame(20, 2);
+    EXPECT_EQ(list.m_NumResolves, 2u);
+
+    // Both slots are in flight
+    EXPECT_FALSE(profiler.BeginFrame());
+    EXPECT_EQ(profiler.BeginScope(&list, "Dropped"), CD3DX12GpuProfiler::InvalidScope);
+    profiler.EndFrame(3);
+
+    profiler.Update(1);
+    ASSERT_EQ(profiler.GetNumScopeStats(), 3u);
+    const UINT Frame = profiler.FindScopeStats("Frame");
+    const UINT Shadows = profiler.FindScopeStats("Shadows", Frame);
+    const UINT Cascade = profiler.FindScopeStats("Cascade", Shadows);
+    ASSERT_NE(Cascade, UINT_MAX);
+    EXPECT_EQ(profiler.FindScopeStats("Cascade"), UINT_MAX);
+    EXPECT_EQ(profiler.GetScopeStats(Cascade).Depth, 2u);
+    // Frame spans 7 steps, Shadows 5, each Cascade 1 and the two are summed
+    EXPECT_EQ(profiler.GetScopeStats(Frame).LastNs, 7000u);
+    EXPECT_EQ(profiler.GetScopeStats(Shadows).LastNs, 5000u);
+    EXPECT_EQ(profiler.GetScopeStats(Cascade).LastNs, 2000u);
+
+    profiler.Update(2);
+    const D3DX12_GPU_PROFILER_SCOPE_STATS& Stats = profiler.GetScopeStats(Frame);
+    EXPECT_EQ(Stats.NumSamples, 2u);
+    EXPECT_EQ(Stats.LastNs, 14000u);
+    EXPECT_EQ(Stats.MinNs, 7000u);
+    EXPECT_EQ(Stats.MaxNs, 14000u);
+    EXPECT_EQ(Stats.AverageNs, 10500u);
+
+    // The rolling window forgets the oldest frames
+    for (UINT64 Fence = 3; Fence < 7; ++Fence)
+    {
+        RecordFrame(20, Fence);
+        profiler.Update(Fence);
+    }
+    EXPECT_EQ(profiler.GetScopeStats(Frame).MinNs, 14000u);
+    EXPECT_EQ(profiler.GetScopeStats(Frame).AverageNs, 14000u);
+}
+
+// Threads recording different command lists of a frame get distinct scopes without locking
+TEST(GpuProfilerTest, ConcurrentScopes)
+{
+    CD3DX12GpuProfiler profiler;
+    ASSERT_EQ(profiler.Init(1000000000, 64, 1), S_OK);
+    std::vector<UINT64> heap(128), readback(128);
+    profiler.SetResources(nullptr, nullptr, readback.data());
+
+    ASSERT_TRUE(profiler.BeginFrame());
+    std::vector<std::thread> threads;
+    std::vector<std::vector<UINT64>> heaps(4, std::vector<UINT64>(128));
+    for (UINT t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            MockTimestampCommandList list(heaps[t], readback);
+            list.m_Step = t + 1;
+            for (UINT i = 0; i < 20; ++i)
+            {
+                profiler.EndScope(&list, profiler.BeginScope(&list, "Draw"));
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Only the first 64 scopes are timed; merge the per-thread query writes before resolving
+    for (UINT i = 0; i < 128; ++i)
+    {
+        for (const std::vector<UINT64>& threadHeap : heaps)
+        {
+            heap[i] += threadHeap[i];
+        }
+    }
+    MockTimestampCommandList list(heap, readback);
+    profiler.ResolveFrame(&list);
+    profiler.EndFrame(1);
+    profiler.Update(1);
+    ASSERT_EQ(profiler.GetNumScopeStats(), 1u);
+    const UINT64 Total = profiler.GetScopeStats(0).LastNs;
+    EXPECT_GE(Total, 64u);
+    EXPECT_LE(Total, 64u * 4);
+}
+
+//------------------------------------------------------------------------------------------------
+// Query pool
+
+// Records Begin/EndQuery pairs and the ranges resolved. Each ended pipeline statistics query reports
+// its index as its pixel shader invocation count.
+class MockStatisticsCommandList
+{
+public:
+    explicit MockStatisticsCommandList(std::vector<D3D12_QUERY_DATA_PIPELINE_STATISTICS>& Readback)
+        : m_Readback(Readback)
+    {}
+
+    void BeginQuery(ID3D12QueryHeap*, D3D12_QUERY_TYPE Type, UINT Index)
+    {
+        EXPECT_EQ(Type, D3D12_QUERY_TYPE_PIPELINE_STATISTICS);
+        m_Open.push_back(Index);
+    }
+
+    void EndQuery(ID3D12QueryHeap*, D3D12_QUERY_TYPE Type, UINT Index)
+    {
+        EXPECT_EQ(Type, D3D12_QUERY_TYPE_PIPELINE_STATISTICS);
+        EXPECT_NE(std::find(m_Open.begin(), m_Open.end(), Index), m_Open.end());
+    }
+
+    void ResolveQueryData(ID3D12QueryHeap*, D3D12_QUERY_TYPE, UINT StartIndex, UINT NumQueries, ID3D12Resource*, UINT64 AlignedDestinationBufferOffset)
+    {
+        EXPECT_EQ(AlignedDestinationBufferOffset, StartIndex * sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS));
+        for (UINT i = 0; i < NumQueries; ++i)
+        {
+            m_Readback.at(StartIndex + i) = {};
+            m_Readback.at(StartIndex + i).PSInvocations = StartIndex + i;
+        }
+        m_Ranges.push_back({ StartIndex, NumQueries });
+    }
+
+    std::vector<UINT> m_Open;
+    std::vector<std::pair<UINT, UINT>> m_Ranges;
+
+private:
+    std::vector<D3D12_QUERY_DATA_PIPELINE_STATISTICS>& m_Readback;
+};
+
+TEST(QueryPoolTest, CoalescedResolve)
+{
+    CD3DX12QueryPool pool;
+    EXPECT_EQ(pool.Init(D3D12_QUERY_HEAP_TYPE(6), 8), E_INVALIDARG);
+    ASSERT_EQ(pool.Init(D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS, 8), S_OK);
+    EXPECT_EQ(pool.GetQueryHeapDesc().Count, 8u);
+    EXPECT_EQ(pool.GetResultSize(), sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS));
+    EXPECT_EQ(pool.GetReadbackBufferSize(), 8 * sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS));
+    EXPECT_EQ(CD3DX12QueryPool::GetResultSize(D3D12_QUERY_HEAP_TYPE_OCCLUSION), sizeof(UINT64));
+
+    std::vector<D3D12_QUERY_DATA_PIPELINE_STATISTICS> readback(8);
+    pool.SetResources(nullptr, nullptr, readback.data());
+    MockStatisticsCommandList list(readback);
+
+    // Allocate 0..5, skip 3 (freed unused): the ended queries form the runs [0,2] and [4,5]
+    UINT Indices[6];
+    for (UINT& Index : Indices)
+    {
+        Index = pool.Allocate();
+    }
+    EXPECT_EQ(Indices[0], 0u);
+    EXPECT_EQ(Indices[5], 5u);
+    pool.Free(Indices[3]);
+    for (UINT i : { 5u, 1u, 0u, 4u, 2u })
+    {
+        pool.Begin(&list, Indices[i]);
+        pool.End(&list, Indices[i]);
+    }
+    EXPECT_EQ(pool.Resolve(&list), 2u);
+    ASSERT_EQ(list.m_Ranges.size(), 2u);
+    EXPECT_EQ(list.m_Ranges[0], std::make_pair(0u, 3u));
+    EXPECT_EQ(list.m_Ranges[1], std::make_pair(4u, 2u));
+    EXPECT_EQ(pool.Resolve(&list), 0u);
+    pool.Submit(1);
+
+    std::vector<UINT> delivered;
+    auto Collect = [&](UINT Index, const void* pResult)
+    {
+        EXPECT_EQ(static_cast<const D3D12_QUERY_DATA_PIPELINE_STATISTICS*>(pResult)->PSInvocations, Index);
+        delivered.push_back(Index);
+    };
+    EXPECT_EQ(pool.Update(0, Collect), 0u);
+    EXPECT_EQ(pool.GetNumFree(), 3u);
+    EXPECT_EQ(pool.Update(1, Collect), 5u);
+    std::sort(delivered.begin(), delivered.end());
+    EXPECT_EQ(delivered, (std::vector<UINT>{ 0, 1, 2, 4, 5 }));
+    EXPECT_EQ(pool.GetNumFree(), 8u);
+}
+
+// Batches in flight complete in fence order, and the pool runs dry until they do
+TEST(QueryPoolTest, FenceGatedBatches)
+{
+    CD3DX12QueryPool pool;
+    ASSERT_EQ(pool.Init(D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS, 4), S_OK);
+    std::vector<D3D12_QUERY_DATA_PIPELINE_STATISTICS> readback(4);
+    pool.SetResources(nullptr, nullptr, readback.data());
+    MockStatisticsCommandList list(readback);
+
+    for (UINT64 Fence = 1; Fence <= 2; ++Fence)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            const UINT Index = pool.Allocate();
+            ASSERT_NE(Index, UINT_MAX);
+            pool.Begin(&list, Index);
+            pool.End(&list, Index);
+        }
+        EXPECT_EQ(pool.Resolve(&list), 1u);
+        pool.Submit(Fence);
+    }
+    EXPECT_EQ(pool.Allocate(), UINT_MAX);
+
+    UINT NumDelivered = 0;
+    auto Count = [&](UINT, const void*) { ++NumDelivered; };
+    EXPECT_EQ(pool.Update(1, Count), 2u);
+    EXPECT_EQ(pool.GetNumFree(), 2u);
+    EXPECT_EQ(pool.Update(5, Count), 2u);
+    EXPECT_EQ(NumDelivered, 4u);
+    EXPECT_EQ(pool.GetNumFree(), 4u);
+}
@@ -0,0 +1,810 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "gtest/gtest.h"
+
+#include <wsl/winadapter.h>
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12.h>
+#include "dxguids/dxguids.h"
+
+#include "MockDevice.hpp"
+#include "MockGraphicsCommandList.hpp"
+
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Device-free tests for the d3dx12.h resource helpers
+
+//------------------------------------------------------------------------------------------------
+// Transient resource aliasing
+static D3D12_RESOURCE_ALLOCATION_INFO AllocInfo(UINT64 Size, UINT64 Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+{
+    return { Size, Alignment };
+}
+
+// Resources with disjoint lifetimes share the same memory
+TEST(TransientAliasingPlannerTest, DisjointLifetimesAlias)
+{
+    CD3DX12TransientAliasingPlanner planner;
+    UINT a = planner.AddResource(AllocInfo(1 << 20), 0, 1);
+    UINT b = planner.AddResource(AllocInfo(1 << 20), 2, 3);
+    UINT c = planner.AddResource(AllocInfo(1 << 19), 4, 4);
+    EXPECT_EQ(planner.Plan(), S_OK);
+
+    EXPECT_EQ(planner.GetHeapOffset(a), 0u);
+    EXPECT_EQ(planner.GetHeapOffset(b), 0u);
+    EXPECT_EQ(planner.GetHeapOffset(c), 0u);
+    EXPECT_EQ(planner.GetHeapSize(), 1u << 20);
+    EXPECT_EQ(planner.GetUnaliasedSize(), (2u << 20) + (1u << 19));
+
+    // c only needs to wait for b, which took over all of the memory a used
+    ASSERT_EQ(planner.GetNumAliasingBarriers(), 2u);
+    const D3DX12_TRANSIENT_ALIASING_BARRIER* pBarriers = planner.GetAliasingBarriers();
+    EXPECT_EQ(pBarriers[0].Pass, 2u);
+    EXPECT_EQ(pBarriers[0].Before, a);
+    EXPECT_EQ(pBarriers[0].After, b);
+    EXPECT_EQ(pBarriers[1].Pass, 4u);
+    EXPECT_EQ(pBarriers[1].Before, b);
+    EXPECT_EQ(pBarriers[1].After, c);
+}
+
+// Resources that are alive at the same time never overlap in memory
+TEST(TransientAliasingPlannerTest, OverlappingLifetimesDoNotAlias)
+{
+    CD3DX12TransientAliasingPlanner planner;
+    const UINT64 Sizes[] = { 3 << 16, 1 << 16, 5 << 16, 2 << 16, 4 << 16, 1 << 16 };
+    const UINT Passes[][2] = { {0, 3}, {1, 2}, {2, 5}, {4, 6}, {3, 3}, {6, 7} };
+    for (UINT i = 0; i < _countof(Sizes); ++i)
+    {
+        planner.AddResource(AllocInfo(Sizes[i]), Passes[i][0], Passes[i][1]);
+    }
+    EXPECT_EQ(planner.Plan(), S_OK);
+    EXPECT_LT(planner.GetHeapSize(), planner.GetUnaliasedSize());
+
+    for (UINT i = 0; i < planner.GetNumResources(); ++i)
+    {
+        EXPECT_EQ(planner.GetHeapOffset(i) % D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT, 0u);
+        EXPECT_LE(planner.GetHeapOffset(i) + planner.GetSizeInBytes(i), planner.GetHeapSize());
+        for (UINT j = i + 1; j < planner.GetNumResources(); ++j)
+        {
+            bool bLifetimesOverlap = Passes[i][0] <= Passes[j][1] && Passes[j][0] <= Passes[i][1];
+            bool bMemoryOverlaps = planner.GetHeapOffset(i) < planner.GetHeapOffset(j) + Sizes[j]
+                && planner.GetHeapOffset(j) < planner.GetHeapOffset(i) + Sizes[i];
+            EXPECT_FALSE(bLifetimesOverlap && bMemoryOverlaps) << i << " and " << j;
+        }
+    }
+}
+
+// A resource spanning the memory of two earlier resources uses a NULL before resource
+TEST(TransientAliasingPlannerTest, MultiplePredecessors)
+{
+    CD3DX12TransientAliasingPlanner planner;
+    UINT a = planner.AddResource(AllocInfo(1 << 16), 0, 0);
+    UINT b = planner.AddResource(AllocInfo(1 << 16), 0, 0);
+    UINT c = planner.AddResource(AllocInfo(2 << 16), 1, 1);
+    EXPECT_EQ(planner.Plan(), S_OK);
+    EXPECT_NE(planner.GetHeapOffset(a), planner.GetHeapOffset(b));
+    EXPECT_EQ(planner.GetHeapSize(), 2u << 16);
+
+    ID3D12Resource* Resources[3] = {
+        reinterpret_cast<ID3D12Resource*>(0x10),
+        reinterpret_cast<ID3D12Resource*>(0x20),
+        reinterpret_cast<ID3D12Resource*>(0x30) };
+    D3D12_RESOURCE_BARRIER Barriers[2];
+    EXPECT_EQ(planner.GetAliasingBarriers(0, Resources, Barriers, _countof(Barriers)), 0u);
+    ASSERT_EQ(planner.GetAliasingBarriers(1, Resources, Barriers, _countof(Barriers)), 1u);
+    EXPECT_EQ(Barriers[0].Type, D3D12_RESOURCE_BARRIER_TYPE_ALIASING);
+    EXPECT_EQ(Barriers[0].Aliasing.pResourceBefore, nullptr);
+    EXPECT_EQ(Barriers[0].Aliasing.pResourceAfter, Resources[c]);
+}
+
+// Placement honors per-resource alignment, and invalid lifetimes are rejected
+TEST(TransientAliasingPlannerTest, AlignmentAndValidation)
+{
+    CD3DX12TransientAliasingPlanner planner;
+    planner.AddResource(AllocInfo(1 << 16), 0, 2);
+    UINT msaa = planner.AddResource(AllocInfo(1 << 22, D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT), 1, 1);
+    EXPECT_EQ(planner.Plan(), S_OK);
+    EXPECT_EQ(planner.GetHeapOffset(msaa) % D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT, 0u);
+    EXPECT_EQ(planner.GetHeapAlignment(), static_cast<UINT64>(D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT));
+
+    planner.AddResource(AllocInfo(1 << 16), 3, 2);
+    EXPECT_EQ(planner.Plan(), E_INVALIDARG);
+    EXPECT_FALSE(planner.IsPlanned());
+}
+
+// Descriptions are sized from the copyable footprints of all subresources
+TEST(TransientAliasingPlannerTest, EstimateFromDesc)
+{
+    D3D12_RESOURCE_ALLOCATION_INFO Info = D3DX12EstimateResourceAllocationInfo(
+        CD3DX12_RESOURCE_DESC1::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 256, 256, 1, 1));
+    EXPECT_EQ(Info.Alignment, static_cast<UINT64>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT));
+    EXPECT_EQ(Info.SizeInBytes, 256u * 256u * 4u);
+
+    Info = D3DX12EstimateResourceAllocationInfo(CD3DX12_RESOURCE_DESC1::Buffer(100));
+    EXPECT_EQ(Info.SizeInBytes, static_cast<UINT64>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT));
+
+    Info = D3DX12EstimateResourceAllocationInfo(
+        CD3DX12_RESOURCE_DESC1::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, 1920, 1080, 1, 1, 4));
+    EXPECT_EQ(Info.Alignment, static_cast<UINT64>(D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT));
+    EXPECT_GE(Info.SizeInBytes, 1920ull * 1080ull * 8ull * 4ull);
+}
+
+//------------------------------------------------------------------------------------------------
+// 64KB standard swizzle
+static void CheckSwizzleRoundTrip(DXGI_FORMAT Format, UINT Width, UINT Height)
+{
+    CD3DX12StandardSwizzle64KB swizzle;
+    ASSERT_EQ(swizzle.Init(Format), S_OK);
+    const UINT ElementWidth = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetWidthAlignment(Format);
+    const UINT ElementHeight = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetHeightAlignment(Format);
+    const UINT Columns = (Width + ElementWidth - 1) / ElementWidth;
+    const UINT Rows = (Height + ElementHeight - 1) / ElementHeight;
+    const UINT RowPitch = Columns * swizzle.GetBytesPerElement() + 12;
+
+    std::vector<BYTE> linear(SIZE_T(RowPitch) * Rows);
+    for (SIZE_T i = 0; i < linear.size(); ++i)
+    {
+        linear[i] = static_cast<BYTE>(i * 2654435761u >> 13);
+    }
+    std::vector<BYTE> swizzled(static_cast<SIZE_T>(swizzle.GetSubresourceSize(Width, Height)));
+    D3D12_SUBRESOURCE_DATA src = { linear.data(), LONG_PTR(RowPitch), LONG_PTR(linear.size()) };
+    swizzle.Swizzle(swizzled.data(), src, Width, Height);
+
+    // Every element lands at the address computed from its coordinates
+    const UINT TilesAcross = swizzle.GetTilesAcross(Width);
+    for (UINT y = 0; y < Rows; y += 7)
+    {
+        for (UINT x = 0; x < Columns; x += 5)
+        {
+            EXPECT_EQ(memcmp(&swizzled[static_cast<SIZE_T>(swizzle.GetElementOffset(x, y, TilesAcross))],
+                &linear[SIZE_T(y) * RowPitch + SIZE_T(x) * swizzle.GetBytesPerElement()], swizzle.GetBytesPerElement()), 0);
+        }
+    }
+
+    std::vector<BYTE> result(linear.size());
+    D3D12_MEMCPY_DEST dst = { result.data(), RowPitch, result.size() };
+    swizzle.Unswizzle(dst, swizzled.data(), Width, Height);
+    for (UINT y = 0; y < Rows; ++y)
+    {
+        EXPECT_EQ(memcmp(&result[SIZE_T(y) * RowPitch], &linear[SIZE_T(y) * RowPitch], SIZE_T(Columns) * swizzle.GetBytesPerElement()), 0);
+    }
+}
+
+// Each element size round trips, including partial tiles at the right and bottom edges
+TEST(StandardSwizzleTest, RoundTrip)
+{
+    CheckSwizzleRoundTrip(DXGI_FORMAT_R8_UNORM, 300, 260);
+    CheckSwizzleRoundTrip(DXGI_FORMAT_R16_FLOAT, 257, 129);
+    CheckSwizzleRoundTrip(DXGI_FORMAT_R8G8B8A8_UNORM, 200, 130);
+    CheckSwizzleRoundTrip(DXGI_FORMAT_R16G16B16A16_FLOAT, 129, 65);
+    CheckSwizzleRoundTrip(DXGI_FORMAT_R32G32B32A32_FLOAT, 65, 70);
+    CheckSwizzleRoundTrip(DXGI_FORMAT_BC1_UNORM, 516, 260);
+    CheckSwizzleRoundTrip(DXGI_FORMAT_BC7_UNORM, 260, 260);
+}
+
+// Tile shapes and in-tile addresses follow the standard swizzle bit patterns
+TEST(StandardSwizzleTest, Addressing)
+{
+    CD3DX12StandardSwizzle64KB swizzle;
+    ASSERT_EQ(swizzle.Init(DXGI_FORMAT_R8G8B8A8_UNORM), S_OK);
+    EXPECT_EQ(swizzle.GetTileWidthInElements(), 128u);
+    EXPECT_EQ(swizzle.GetTileHeightInElements(), 128u);
+    EXPECT_EQ(swizzle.GetElementOffset(1, 0, 1), 4u);
+    EXPECT_EQ(swizzle.GetElementOffset(0, 1, 1), 16u);
+    EXPECT_EQ(swizzle.GetElementOffset(4, 0, 1), 64u);
+    EXPECT_EQ(swizzle.GetElementOffset(0, 4, 1), 128u);
+    EXPECT_EQ(swizzle.GetElementOffset(127, 127, 1), 65535u - 3u);
+    EXPECT_EQ(swizzle.GetElementOffset(128, 0, 2), 65536u);
+    EXPECT_EQ(swizzle.GetSubresourceSize(129, 1), 2u * 65536u);
+
+    ASSERT_EQ(swizzle.Init(DXGI_FORMAT_BC1_UNORM), S_OK);
+    EXPECT_EQ(swizzle.GetTileWidthInElements(), 128u);
+    EXPECT_EQ(swizzle.GetTileHeightInElements(), 64u);
+
+    EXPECT_EQ(swizzle.Init(DXGI_FORMAT_R8G8B8A8_UNORM, D3D12_RESOURCE_DIMENSION_TEXTURE3D), E_INVALIDARG);
+    EXPECT_EQ(swizzle.Init(DXGI_FORMAT_R8G8B8A8_UNORM, D3D12_RESOURCE_DIMENSION_TEXTURE2D, 4), E_INVALIDARG);
+    EXPECT_EQ(swizzle.Init(DXGI_FORMAT_NV12), E_INVALIDARG);
+    EXPECT_EQ(swizzle.Init(DXGI_FORMAT_R32G32B32_FLOAT), E_INVALIDARG);
+    EXPECT_FALSE(swizzle.IsInitialized());
+}
+
+//------------------------------------------------------------------------------------------------
+// Planar uploads
+
+// Footprints of each NV12 plane are computed once and planes are placed at aligned offsets
+TEST(PlanarUploadTest, NV12Footprints)
+{
+    CD3DX12PlanarUpload upload;
+    ASSERT_EQ(upload.Init(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_NV12, 1920, 1080, 1, 1)), S_OK);
+    ASSERT_EQ(upload.GetNumPlanes(), 2u);
+
+    const auto& luma = upload.GetPlaneLayout(0);
+    EXPECT_EQ(luma.Offset, 0u);
+    EXPECT_EQ(luma.Footprint.Format, DXGI_FORMAT_R8_TYPELESS);
+    EXPECT_EQ(luma.Footprint.RowPitch, 2048u);
+    EXPECT_EQ(upload.GetPlaneNumRows(0), 1080u);
+    EXPECT_EQ(upload.GetPlaneRowSizeInBytes(0), 1920u);
+
+    const auto& chroma = upload.GetPlaneLayout(1);
+    EXPECT_EQ(chroma.Offset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, 0u);
+    EXPECT_GE(chroma.Offset, 2048u * 1080u);
+    EXPECT_EQ(chroma.Footprint.Format, DXGI_FORMAT_R8G8_TYPELESS);
+    EXPECT_EQ(chroma.Footprint.Width, 960u);
+    EXPECT_EQ(upload.GetPlaneNumRows(1), 540u);
+    EXPECT_EQ(upload.GetRequiredIntermediateSize(), chroma.Offset + 2048u * 540u);
+
+    EXPECT_EQ(upload.Init(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 64, 1, 1)), E_INVALIDARG);
+    EXPECT_EQ(upload.GetNumPlanes(), 0u);
+}
+
+// A contiguous P010 frame is split into planes and written to the intermediate layout
+TEST(PlanarUploadTest, WriteContiguousFrame)
+{
+    const UINT Width = 100, Height = 50;
+    CD3DX12PlanarUpload upload;
+    ASSERT_EQ(upload.Init(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_P010, Width, Height, 1, 1)), S_OK);
+
+    const LONG_PTR FramePitch = Width * 2;
+    std::vector<BYTE> frame(SIZE_T(FramePitch) * (Height + Height / 2));
+    for (SIZE_T i = 0; i < frame.size(); ++i)
+    {
+        frame[i] = static_cast<BYTE>(i % 251);
+    }
+
+    D3D12_SUBRESOURCE_DATA planes[CD3DX12PlanarUpload::MaxPlanes];
+    ASSERT_EQ(D3DX12GetContiguousPlanarSubresourceData(DXGI_FORMAT_P010, Width, Height, frame.data(), FramePitch, planes, _countof(planes)), 2u);
+    EXPECT_EQ(planes[1].pData, frame.data() + FramePitch * Height);
+    EXPECT_EQ(D3DX12GetContiguousPlanarSubresourceData(DXGI_FORMAT_R16_UNORM, Width, Height, frame.data(), FramePitch, planes, _countof(planes)), 0u);
+
+    std::vector<BYTE> intermediate(static_cast<SIZE_T>(upload.GetRequiredIntermediateSize()));
+    upload.WritePlanes(intermediate.data(), planes);
+    for (UINT Plane = 0; Plane < 2; ++Plane)
+    {
+        const auto& layout = upload.GetPlaneLayout(Plane);
+        for (UINT Row = 0; Row < upload.GetPlaneNumRows(Plane); ++Row)
+        {
+            EXPECT_EQ(memcmp(&intermediate[static_cast<SIZE_T>(layout.Offset) + SIZE_T(layout.Footprint.RowPitch) * Row],
+                static_cast<const BYTE*>(planes[Plane].pData) + planes[Plane].RowPitch * Row,
+                static_cast<SIZE_T>(upload.GetPlaneRowSizeInBytes(Plane))), 0);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// Texture streaming
+
+// Records the copies: destination subresource and staging offset
+class MockCopyCommandList
+{
+public:
+    void CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION* pDst, UINT, UINT, UINT, const D3D12_TEXTURE_COPY_LOCATION* pSrc, const D3D12_BOX*)
+    {
+        EXPECT_EQ(pDst->Type, D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX);
+        EXPECT_EQ(pSrc->Type, D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT);
+        m_Copies.push_back({ pDst->pResource, pSrc->PlacedFootprint.Offset });
+    }
+
+    std::vector<std::pair<ID3D12Resource*, UINT64>> m_Copies;
+};
+
+static ID3D12Resource* FakeTexture(UINT_PTR Id)
+{
+    return reinterpret_cast<ID3D12Resource*>(Id);
+}
+
+// Fills each row with the low byte of the request's UserData
+static void FillRows(const D3DX12_TEXTURE_STREAM_REQUEST& Request, void* pStaging, const D3D12_PLACED_SUBRESOURCE_FOOTPRINT* pLayouts, const UINT* pNumRows, const UINT64* pRowSizes)
+{
+    for (UINT i = 0; i < Request.NumSubresources; ++i)
+    {
+        for (UINT Row = 0; Row < pNumRows[i]; ++Row)
+        {
+            memset(static_cast<BYTE*>(pStaging) + pLayouts[i].Offset + SIZE_T(pLayouts[i].Footprint.RowPitch) * Row,
+                static_cast<BYTE>(Request.UserData), static_cast<SIZE_T>(pRowSizes[i]));
+        }
+    }
+}
+
+// Lane 0 streams first and the byte budget holds back the rest
+TEST(TextureStreamerTest, LanesAndBudget)
+{
+    CD3DX12TextureStreamer streamer;
+    EXPECT_EQ(streamer.Init(65536, 65537), E_INVALIDARG);
+    ASSERT_EQ(streamer.Init(65536, 40000, 2), S_OK);
+    std::vector<BYTE> staging(65536);
+    streamer.SetResources(FakeTexture(0x5), staging.data());
+
+    // 64x64 RGBA8: 16 KB of staging each
+    const D3D12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 64, 1, 1);
+    EXPECT_EQ(streamer.Enqueue({ FakeTexture(0xA), CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 128, 128, 1, 1), 0, 1, 0, 0 }), E_INVALIDARG);
+    EXPECT_EQ(streamer.Enqueue({ FakeTexture(0xA), Desc, 0, 1, 2, 0 }), E_INVALIDARG);
+    ASSERT_EQ(streamer.Enqueue({ FakeTexture(0xA), Desc, 0, 1, 1, 0xA }), S_OK);
+    ASSERT_EQ(streamer.Enqueue({ FakeTexture(0xB), Desc, 0, 1, 1, 0xB }), S_OK);
+    ASSERT_EQ(streamer.Enqueue({ FakeTexture(0xC), Desc, 0, 1, 0, 0xC }), S_OK);
+
+    MockCopyCommandList list;
+    EXPECT_EQ(streamer.Record(&list, FillRows), 2u);
+    ASSERT_EQ(list.m_Copies.size(), 2u);
+    EXPECT_EQ(list.m_Copies[0].first, FakeTexture(0xC));
+    EXPECT_EQ(list.m_Copies[0].second, 0u);
+    EXPECT_EQ(list.m_Copies[1].first, FakeTexture(0xA));
+    EXPECT_EQ(list.m_Copies[1].second, 16384u);
+    EXPECT_EQ(staging[0], 0xC);
+    EXPECT_EQ(staging[16384 + 255], 0xA);
+    EXPECT_EQ(streamer.GetBytesInFlight(), 32768u);
+    EXPECT_EQ(streamer.GetNumQueued(), 1u);
+    streamer.Submit(1);
+
+    std::vector<UINT64> completed;
+    auto OnComplete = [&](const D3DX12_TEXTURE_STREAM_REQUEST& Request) { completed.push_back(Request.UserData); };
+    EXPECT_EQ(streamer.Update(0, OnComplete), 0u);
+    EXPECT_EQ(streamer.Record(&list, FillRows), 0u);
+    EXPECT_EQ(streamer.Update(1, OnComplete), 2u);
+    EXPECT_EQ(completed, (std::vector<UINT64>{ 0xC, 0xA }));
+    EXPECT_EQ(streamer.Record(&list, FillRows), 1u);
+    EXPECT_EQ(list.m_Copies.back().first, FakeTexture(0xB));
+    EXPECT_EQ(streamer.GetNumInFlight(), 1u);
+}
+
+// Requests that would straddle the end of the staging ring wrap to its start once it is free
+TEST(TextureStreamerTest, RingWrap)
+{
+    CD3DX12TextureStreamer streamer;
+    ASSERT_EQ(streamer.Init(40960, 40960, 1), S_OK);
+    std::vector<BYTE> staging(40960);
+    streamer.SetResources(FakeTexture(0x5), staging.data());
+    const D3D12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 64, 1, 1);
+    MockCopyCommandList list;
+    auto Ignore = [](const D3DX12_TEXTURE_STREAM_REQUEST&) {};
+
+    for (UINT64 Fence = 1; Fence <= 2; ++Fence)
+    {
+        ASSERT_EQ(streamer.Enqueue({ FakeTexture(Fence), Desc, 0, 1, 0, Fence }), S_OK);
+        EXPECT_EQ(streamer.Record(&list, FillRows), 1u);
+        streamer.Submit(Fence);
+    }
+    ASSERT_EQ(streamer.Enqueue({ FakeTexture(3), Desc, 0, 1, 0, 3 }), S_OK);
+    EXPECT_EQ(streamer.Record(&list, FillRows), 0u);
+    EXPECT_EQ(streamer.Update(1, Ignore), 1u);
+    EXPECT_EQ(streamer.Record(&list, FillRows), 1u);
+    EXPECT_EQ(list.m_Copies.back().second, 0u);
+    EXPECT_EQ(staging[0], 3);
+    EXPECT_EQ(staging[16384], 2);
+}
+
+//------------------------------------------------------------------------------------------------
+// Texture container
+
+// Stands in for LZ4/zstd: a chunk of one repeated byte compresses to that byte
+static bool CompressUniform(const void* pSrc, UINT Size, std::vector<BYTE>& Compressed)
+{
+    const BYTE* pBytes = static_cast<const BYTE*>(pSrc);
+    for (UINT i = 1; i < Size; ++i)
+    {
+        if (pBytes[i] != pBytes[0])
+        {
+            return false;
+        }
+    }
+    Compressed.assign(1, pBytes[0]);
+    return true;
+}
+
+static bool DecompressUniform(const void* pSrc, UINT SrcSize, void* pDest, UINT DestSize)
+{
+    EXPECT_EQ(SrcSize, 1u);
+    memset(pDest, *static_cast<const BYTE*>(pSrc), DestSize);
+    return true;
+}
+
+// Writes a mipmapped array whose mip 0 of slice 0 varies and the rest is uniform
+static void WriteContainerTexture(CD3DX12TextureContainerWriter& writer, std::vector<BYTE>& mip0)
+{
+    ASSERT_EQ(writer.Init(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 100, 60, 2, 3)), S_OK);
+    ASSERT_EQ(writer.GetNumSubresources(), 6u);
+    mip0.resize(100 * 4 * 60);
+    for (SIZE_T i = 0; i < mip0.size(); ++i)
+    {
+        mip0[i] = static_cast<BYTE>(i % 253);
+    }
+    writer.SetSubresource(0, { mip0.data(), 400, 400 * 60 });
+}
+
+// Uncompressed payloads keep the footprint layout and are placement aligned in the file
+TEST(TextureContainerTest, UncompressedRoundTrip)
+{
+    CD3DX12TextureContainerWriter writer;
+    EXPECT_EQ(writer.Init(CD3DX12_RESOURCE_DESC::Buffer(256)), E_INVALIDARG);
+    std::vector<BYTE> mip0;
+    WriteContainerTexture(writer, mip0);
+
+    const D3D12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 100, 60, 2, 3);
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layouts[6];
+    UINT64 TotalBytes = 0;
+    ASSERT_TRUE(D3DX12GetCopyableFootprints(Desc, 0, 6, 0, Layouts, nullptr, nullptr, &TotalBytes));
+    EXPECT_EQ(writer.GetPayloadSize(), TotalBytes);
+
+    std::vector<BYTE> file;
+    writer.Serialize(file);
+    std::vector<UINT64> aligned((file.size() + 7) / 8);
+    memcpy(aligned.data(), file.data(), file.size());
+
+    CD3DX12TextureContainerReader reader;
+    ASSERT_EQ(reader.Init(aligned.data(), file.size()), S_OK);
+    EXPECT_EQ(reader.GetHeader().PayloadOffset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, 0u);
+    EXPECT_EQ(reader.GetNumChunks(), 0u);
+    const D3D12_RESOURCE_DESC ReadDesc = reader.GetResourceDesc();
+    EXPECT_EQ(ReadDesc.Width, 100u);
+    EXPECT_EQ(ReadDesc.DepthOrArraySize, 2u);
+    EXPECT_EQ(ReadDesc.MipLevels, 3u);
+    for (UINT i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(reader.GetLayout(i).Offset, Layouts[i].Offset);
+        EXPECT_EQ(reader.GetLayout(i).Footprint.RowPitch, Layouts[i].Footprint.RowPitch);
+        EXPECT_EQ(reader.GetLayout(i, 1024).Offset, Layouts[i].Offset + 1024);
+    }
+
+    const BYTE* pPayload = static_cast<const BYTE*>(reader.GetPayload());
+    ASSERT_NE(pPayload, nullptr);
+    EXPECT_EQ(Layouts[0].Footprint.RowPitch, 512u);
+    EXPECT_EQ(memcmp(pPayload + 512 * 7, mip0.data() + 400 * 7, 400), 0);
+
+    EXPECT_EQ(reader.Init(aligned.data(), file.size() - 1), E_INVALIDARG);
+    aligned[0] ^= 1;
+    EXPECT_EQ(reader.Init(aligned.data(), file.size()), E_INVALIDARG);
+}
+
+// Chunks that compress are stored compressed, the others as is, and both decompress to the payload
+TEST(TextureContainerTest, CompressedChunks)
+{
+    CD3DX12TextureContainerWriter writer;
+    std::vector<BYTE> mip0;
+    WriteContainerTexture(writer, mip0);
+
+    std::vector<BYTE> file;
+    EXPECT_EQ(writer.Serialize(file, D3DX12_TEXTURE_CONTAINER_COMPRESSION_NONE, 4096, CompressUniform), E_INVALIDARG);
+    ASSERT_EQ(writer.Serialize(file, D3DX12_TEXTURE_CONTAINER_COMPRESSION_LZ4, 4096, CompressUniform), S_OK);
+    std::vector<UINT64> aligned((file.size() + 7) / 8);
+    memcpy(aligned.data(), file.data(), file.size());
+
+    CD3DX12TextureContainerReader reader;
+    ASSERT_EQ(reader.Init(aligned.data(), file.size()), S_OK);
+    EXPECT_EQ(reader.GetPayload(), nullptr);
+    const UINT NumChunks = reader.GetNumChunks();
+    EXPECT_EQ(NumChunks, static_cast<UINT>((writer.GetPayloadSize() + 4095) / 4096));
+    EXPECT_LT(file.size(), writer.GetPayloadSize());
+    EXPECT_EQ(reader.GetChunk(0).CompressedSize, 4096u);
+    EXPECT_EQ(reader.GetChunk(NumChunks - 1).CompressedSize, 1u);
+
+    std::vector<BYTE> payload(static_cast<SIZE_T>(reader.GetPayloadSize()), 0xFF);
+    ASSERT_EQ(reader.ReadPayload(payload.data(), DecompressUniform), S_OK);
+    EXPECT_EQ(memcmp(payload.data(), writer.GetPayload(), payload.size()), 0);
+}
+
+//------------------------------------------------------------------------------------------------
+// Readback
+
+// Fills a pitched readback buffer the way the GPU copy would: each row of every slice of every
+// subresource holds its (subresource, slice, row) in its first bytes, and the padding holds 0xCD
+struct ReadbackFixture
+{
+    explicit ReadbackFixture(const D3D12_RESOURCE_DESC& Desc, UINT NumSubresources)
+        : Layouts(NumSubresources), NumRows(NumSubresources), RowSizes(NumSubresources)
+    {
+        EXPECT_TRUE(D3DX12GetCopyableFootprints(Desc, 0, NumSubresources, 0, Layouts.data(), NumRows.data(), RowSizes.data(), &TotalBytes));
+        Readback.assign(static_cast<SIZE_T>(TotalBytes), 0xCD);
+        for (UINT i = 0; i < NumSubresources; ++i)
+        {
+            for (UINT z = 0; z < Layouts[i].Footprint.Depth; ++z)
+            {
+                for (UINT y = 0; y < NumRows[i]; ++y)
+                {
+                    BYTE* pRow = &Readback[static_cast<SIZE_T>(Layouts[i].Offset) + SIZE_T(Layouts[i].Footprint.RowPitch) * (NumRows[i] * z + y)];
+                    memset(pRow, 0, static_cast<SIZE_T>(RowSizes[i]));
+                    pRow[0] = static_cast<BYTE>(i);
+                    pRow[1] = static_cast<BYTE>(z);
+                    pRow[2] = static_cast<BYTE>(y);
+                }
+            }
+        }
+    }
+
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Layouts;
+    std::vector<UINT> NumRows;
+    std::vector<UINT64> RowSizes;
+    UINT64 TotalBytes = 0;
+    std::vector<BYTE> Readback;
+};
+
+// Mips of a 2D texture unpack into tightly packed buffers with no trace of the row padding
+TEST(ReadbackTest, UnpackMips)
+{
+    ReadbackFixture fixture(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 33, 17, 1, 3), 3);
+    std::vector<std::vector<BYTE>> tight(3);
+    std::vector<D3D12_MEMCPY_DEST> dests(3);
+    for (UINT i = 0; i < 3; ++i)
+    {
+        const SIZE_T RowSize = static_cast<SIZE_T>(fixture.RowSizes[i]);
+        tight[i].assign(RowSize * fixture.NumRows[i], 0xEE);
+        dests[i] = { tight[i].data(), RowSize, RowSize * fixture.NumRows[i] };
+    }
+    EXPECT_EQ(fixture.RowSizes[1], 16u * 4);
+
+    UnpackSubresources(fixture.Readback.data(), 3, fixture.Layouts.data(), fixture.NumRows.data(), fixture.RowSizes.data(), dests.data());
+    for (UINT i = 0; i < 3; ++i)
+    {
+        const SIZE_T RowSize = static_cast<SIZE_T>(fixture.RowSizes[i]);
+        for (UINT y = 0; y < fixture.NumRows[i]; ++y)
+        {
+            EXPECT_EQ(tight[i][RowSize * y], i);
+            EXPECT_EQ(tight[i][RowSize * y + 2], y);
+            EXPECT_EQ(tight[i][RowSize * y + RowSize - 1], 0);
+        }
+    }
+}
+
+// The rows of a volume are split across threads, counting rows through the depth slices
+TEST(ReadbackTest, ParallelRows)
+{
+    ReadbackFixture fixture(CD3DX12_RESOURCE_DESC::Tex3D(DXGI_FORMAT_R16_FLOAT, 40, 10, 6, 1), 1);
+    const SIZE_T RowSize = static_cast<SIZE_T>(fixture.RowSizes[0]);
+    const UINT NumRows = fixture.NumRows[0];
+    const UINT Depth = fixture.Layouts[0].Footprint.Depth;
+    ASSERT_EQ(Depth, 6u);
+    std::vector<BYTE> tight(RowSize * NumRows * Depth, 0xEE);
+    const D3D12_MEMCPY_DEST Dest = { tight.data(), RowSize, RowSize * NumRows };
+
+    const UINT TotalRows = NumRows * Depth;
+    std::vector<std::thread> threads;
+    for (UINT t = 0; t < 4; ++t)
+    {
+        const UINT First = TotalRows * t / 4, End = TotalRows * (t + 1) / 4;
+        threads.emplace_back([&, First, End]()
+        {
+            UnpackSubresourceRows(fixture.Readback.data(), fixture.Layouts[0], NumRows, fixture.RowSizes[0], &Dest, First, End - First);
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (UINT z = 0; z < Depth; ++z)
+    {
+        for (UINT y = 0; y < NumRows; ++y)
+        {
+            const BYTE* pRow = &tight[RowSize * (NumRows * z + y)];
+            EXPECT_EQ(pRow[1], z);
+            EXPECT_EQ(pRow[2], y);
+            EXPECT_EQ(pRow[RowSize - 1], 0);
+        }
+    }
+}
+
+// A resource with just a description, backed by CPU memory when it is a readback buffer; records
+// the ranges of Map and Unmap
+class MockReadbackResource : public ID3D12Resource
+{
+public:
+    explicit MockReadbackResource(const D3D12_RESOURCE_DESC& Desc, std::vector<BYTE> Data = {})
+        : m_Desc(Desc), m_Data(std::move(Data)) {}
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, void** ppv) override { *ppv = this; return S_OK; }
+    ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+    ULONG STDMETHODCALLTYPE Release() override { return 1; }
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE SetName(LPCWSTR) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetDevice(REFIID, void**) override { return E_NOINTERFACE; }
+
+    HRESULT STDMETHODCALLTYPE Map(UINT Subresource, const D3D12_RANGE* pReadRange, void** ppData) override
+    {
+        EXPECT_EQ(Subresource, 0u);
+        m_ReadRange = *pReadRange;
+        ++m_NumMaps;
+        if (FAILED(m_MapResult))
+        {
+            return m_MapResult;
+        }
+        *ppData = m_Data.data();
+        return S_OK;
+    }
+    void STDMETHODCALLTYPE Unmap(UINT Subresource, const D3D12_RANGE* pWrittenRange) override
+    {
+        EXPECT_EQ(Subresource, 0u);
+        m_WrittenRange = *pWrittenRange;
+        ++m_NumUnmaps;
+    }
+    D3D12_RESOURCE_DESC STDMETHODCALLTYPE GetDesc() override { return m_Desc; }
+    D3D12_GPU_VIRTUAL_ADDRESS STDMETHODCALLTYPE GetGPUVirtualAddress() override { return 0; }
+    HRESULT STDMETHODCALLTYPE WriteToSubresource(UINT, const D3D12_BOX*, const void*, UINT, UINT) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE ReadFromSubresource(void*, UINT, UINT, UINT, const D3D12_BOX*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetHeapProperties(D3D12_HEAP_PROPERTIES*, D3D12_HEAP_FLAGS*) override { return E_NOTIMPL; }
+
+    D3D12_RESOURCE_DESC m_Desc;
+    std::vector<BYTE> m_Data;
+    HRESULT m_MapResult = S_OK;
+    D3D12_RANGE m_ReadRange = {};
+    D3D12_RANGE m_WrittenRange = { 1, 1 };
+    UINT m_NumMaps = 0;
+    UINT m_NumUnmaps = 0;
+};
+
+// Each subresource of a texture is copied to its footprint past the base offset, and nothing is
+// recorded when the readback buffer is too small or not a buffer
+TEST(ReadbackTest, RecordTextureCopies)
+{
+    const D3D12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 33, 17, 2, 3);
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layouts[6];
+    UINT64 RequiredSize = 0;
+    ASSERT_TRUE(D3DX12GetCopyableFootprints(Desc, 0, 6, 512, Layouts, nullptr, nullptr, &RequiredSize));
+    EXPECT_EQ(Layouts[0].Offset, 512u);
+
+    MockReadbackResource texture(Desc);
+    MockReadbackResource readback(CD3DX12_RESOURCE_DESC::Buffer(512 + RequiredSize));
+    MockGraphicsCommandList list;
+    EXPECT_EQ(ReadbackSubresources(&list, &texture, &readback, 0, 6, RequiredSize, Layouts), RequiredSize);
+    ASSERT_EQ(list.m_TextureCopies.size(), 6u);
+    EXPECT_TRUE(list.m_BufferCopies.empty());
+    for (UINT i = 0; i < 6; ++i)
+    {
+        const MockGraphicsCommandList::TextureCopy& Copy = list.m_TextureCopies[i];
+        EXPECT_EQ(Copy.Dst.pResource, &readback);
+        EXPECT_EQ(Copy.Dst.Type, D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT);
+        EXPECT_EQ(Copy.Dst.PlacedFootprint.Offset, Layouts[i].Offset);
+        EXPECT_EQ(Copy.Dst.PlacedFootprint.Footprint.RowPitch, Layouts[i].Footprint.RowPitch);
+        EXPECT_EQ(Copy.Src.pResource, &texture);
+        EXPECT_EQ(Copy.Src.Type, D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX);
+        EXPECT_EQ(Copy.Src.SubresourceIndex, i);
+    }
+
+    // A range of subresources keeps the source indices
+    list.m_TextureCopies.clear();
+    UINT64 RangeSize = 0;
+    ASSERT_TRUE(D3DX12GetCopyableFootprints(Desc, 4, 2, 512, Layouts, nullptr, nullptr, &RangeSize));
+    EXPECT_EQ(ReadbackSubresources(&list, &texture, &readback, 4, 2, RangeSize, Layouts), RangeSize);
+    ASSERT_EQ(list.m_TextureCopies.size(), 2u);
+    EXPECT_EQ(list.m_TextureCopies[1].Src.SubresourceIndex, 5u);
+    EXPECT_EQ(list.m_TextureCopies[1].Dst.PlacedFootprint.Offset, Layouts[1].Offset);
+    ASSERT_TRUE(D3DX12GetCopyableFootprints(Desc, 0, 6, 512, Layouts, nullptr, nullptr, &RequiredSize));
+
+    list.m_TextureCopies.clear();
+    MockReadbackResource small(CD3DX12_RESOURCE_DESC::Buffer(512 + RequiredSize - 1));
+    EXPECT_EQ(ReadbackSubresources(&list, &texture, &small, 0, 6, RequiredSize, Layouts), 0u);
+    EXPECT_EQ(ReadbackSubresources(&list, &texture, &texture, 0, 6, RequiredSize, Layouts), 0u);
+    EXPECT_TRUE(list.m_TextureCopies.empty());
+}
+
+// A buffer is copied whole with a single buffer copy; only its one subresource can be read back
+TEST(ReadbackTest, RecordBufferCopy)
+{
+    const D3D12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Buffer(1000);
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layout;
+    UINT64 RequiredSize = 0;
+    ASSERT_TRUE(D3DX12GetCopyableFootprints(Desc, 0, 1, 256, &Layout, nullptr, nullptr, &RequiredSize));
+
+    MockReadbackResource buffer(Desc);
+    MockReadbackResource readback(CD3DX12_RESOURCE_DESC::Buffer(256 + RequiredSize));
+    MockGraphicsCommandList list;
+    EXPECT_EQ(ReadbackSubresources(&list, &buffer, &readback, 0, 1, RequiredSize, &Layout), RequiredSize);
+    ASSERT_EQ(list.m_BufferCopies.size(), 1u);
+    EXPECT_TRUE(list.m_TextureCopies.empty());
+    const MockGraphicsCommandList::BufferCopy& Copy = list.m_BufferCopies[0];
+    EXPECT_EQ(Copy.pDstBuffer, &readback);
+    EXPECT_EQ(Copy.DstOffset, 256u);
+    EXPECT_EQ(Copy.pSrcBuffer, &buffer);
+    EXPECT_EQ(Copy.SrcOffset, 0u);
+    EXPECT_EQ(Copy.NumBytes, 1000u);
+
+    list.m_BufferCopies.clear();
+    EXPECT_EQ(ReadbackSubresources(&list, &buffer, &readback, 1, 1, RequiredSize, &Layout), 0u);
+    MockReadbackResource small(CD3DX12_RESOURCE_DESC::Buffer(256 + RequiredSize - 1));
+    EXPECT_EQ(ReadbackSubresources(&list, &buffer, &small, 0, 1, RequiredSize, &Layout), 0u);
+    EXPECT_TRUE(list.m_BufferCopies.empty());
+}
+
+// The readback buffer is mapped for exactly the copied range, unpacked and unmapped with nothing
+// written; a failed Map is returned without unmapping
+TEST(ReadbackTest, MapAndUnpack)
+{
+    ReadbackFixture fixture(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 33, 17, 1, 3), 3);
+    const UINT64 BaseOffset = 256;
+    std::vector<BYTE> data(static_cast<SIZE_T>(BaseOffset), 0);
+    data.insert(data.end(), fixture.Readback.begin(), fixture.Readback.end());
+    for (D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout : fixture.Layouts)
+    {
+        Layout.Offset += BaseOffset;
+    }
+    MockReadbackResource readback(CD3DX12_RESOURCE_DESC::Buffer(data.size()), std::move(data));
+
+    std::vector<std::vector<BYTE>> tight(3);
+    std::vector<D3D12_MEMCPY_DEST> dests(3);
+    for (UINT i = 0; i < 3; ++i)
+    {
+        const SIZE_T RowSize = static_cast<SIZE_T>(fixture.RowSizes[i]);
+        tight[i].assign(RowSize * fixture.NumRows[i], 0xEE);
+        dests[i] = { tight[i].data(), RowSize, RowSize * fixture.NumRows[i] };
+    }
+
+    ASSERT_EQ(ReadbackSubresources(&readback, 3, fixture.TotalBytes, fixture.Layouts.data(), fixture.NumRows.data(), fixture.RowSizes.data(), dests.data()), S_OK);
+    EXPECT_EQ(readback.m_NumMaps, 1u);
+    EXPECT_EQ(readback.m_ReadRange.Begin, BaseOffset);
+    EXPECT_EQ(readback.m_ReadRange.End, BaseOffset + fixture.TotalBytes);
+    EXPECT_EQ(readback.m_NumUnmaps, 1u);
+    EXPECT_EQ(readback.m_WrittenRange.Begin, 0u);
+    EXPECT_EQ(readback.m_WrittenRange.End, 0u);
+    for (UINT i = 0; i < 3; ++i)
+    {
+        const SIZE_T RowSize = static_cast<SIZE_T>(fixture.RowSizes[i]);
+        for (UINT y = 0; y < fixture.NumRows[i]; ++y)
+        {
+            EXPECT_EQ(tight[i][RowSize * y], i);
+            EXPECT_EQ(tight[i][RowSize * y + 2], y);
+            EXPECT_EQ(tight[i][RowSize * y + RowSize - 1], 0);
+        }
+    }
+
+    readback.m_MapResult = E_OUTOFMEMORY;
+    EXPECT_EQ(ReadbackSubresources(&readback, 3, fixture.TotalBytes, fixture.Layouts.data(), fixture.NumRows.data(), fixture.RowSizes.data(), dests.data()), E_OUTOFMEMORY);
+    EXPECT_EQ(readback.m_NumMaps, 2u);
+    EXPECT_EQ(readback.m_NumUnmaps, 1u);
+}
+
+//------------------------------------------------------------------------------------------------
+// Plane counts
+
+// Every format of the table resolves its plane count without a device call when the caller opts in,
+// matching the table; only formats the table does not know reach CheckFeatureSupport
+TEST(PlaneCountTest, DeviceCallsAvoided)
+{
+    MockDevice device(1);
+    device.m_PlaneCount = 5;
+    UINT NumTableFormats = 0;
+    for (UINT i = 0; i < D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetNumFormats(); ++i)
+    {
+        const DXGI_FORMAT Format = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(i);
+        if (Format == DXGI_FORMAT_UNKNOWN || !D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExistsInHeader(Format))
+        {
+            continue;
+        }
+        EXPECT_EQ(D3D12GetFormatPlaneCountFromTable(&device, Format), D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetPlaneCount(Format)) << Format;
+        ++NumTableFormats;
+    }
+    EXPECT_GT(NumTableFormats, 100u);
+    EXPECT_EQ(device.m_FormatInfoCalls, 0u);
+
+    // A barrier-style loop over the subresources of a depth-stencil array
+    const CD3DX12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_D24_UNORM_S8_UINT, 64, 64, 6, 4);
+    UINT NumSubresources = 0;
+    for (UINT i = 0; i < 1000; ++i)
+    {
+        NumSubresources = Desc.SubresourcesFromTable(&device);
+    }
+    EXPECT_EQ(NumSubresources, 4u * 6 * 2);
+    EXPECT_EQ(CD3DX12_RESOURCE_DESC1(Desc).PlaneCountFromTable(&device), 2u);
+    EXPECT_EQ(device.m_FormatInfoCalls, 0u);
+
+    EXPECT_EQ(D3D12GetFormatPlaneCountFromTable(&device, static_cast<DXGI_FORMAT>(0x7FFF)), 5u);
+    EXPECT_EQ(device.m_FormatInfoCalls, 1u);
+    EXPECT_EQ(device.m_FormatReceived, static_cast<DXGI_FORMAT>(0x7FFF));
+}
+
+// Without opting in, every query still reaches the device, and unsupported formats report no planes
+TEST(PlaneCountTest, DeviceQueriedByDefault)
+{
+    MockDevice device(1);
+    device.m_PlaneCount = 5;
+    const CD3DX12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 64, 6, 4);
+    EXPECT_EQ(Desc.Subresources(&device), 4u * 6 * 5);
+    EXPECT_EQ(device.m_FormatInfoCalls, 1u);
+
+    device.m_DXGIFormatSupported = false;
+    EXPECT_EQ(D3D12GetFormatPlaneCount(&device, DXGI_FORMAT_R8G8B8A8_UNORM), 0u);
+    EXPECT_EQ(CD3DX12_RESOURCE_DESC1(Desc).PlaneCount(&device), 0u);
+    EXPECT_EQ(device.m_FormatInfoCalls, 3u);
+    EXPECT_EQ(D3D12GetFormatPlaneCountFromTable(&device, DXGI_FORMAT_R8G8B8A8_UNORM), 1u);
+}
@@ -0,0 +1,393 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "gtest/gtest.h"
+
+#include <wsl/winadapter.h>
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12shader.h>
+#include "dxguids/dxguids.h"
+
+#include <cstring>
+#include <vector>
+
+// Device-free tests for the d3dx12shader.h helpers
+
+//------------------------------------------------------------------------------------------------
+// Shader reflection cache
+
+// Reflection of a small compute shader: one constant buffer with two variables, an SRV and a UAV.
+// Only the methods the flattener uses return data.
+class MockShaderReflectionType : public ID3D12ShaderReflectionType
+{
+public:
+    D3D12_SHADER_TYPE_DESC m_Desc = {};
+
+    HRESULT STDMETHODCALLTYPE GetDesc(D3D12_SHADER_TYPE_DESC* pDesc) override { *pDesc = m_Desc; return S_OK; }
+    ID3D12ShaderReflectionType* STDMETHODCALLTYPE GetMemberTypeByIndex(UINT) override { return nullptr; }
+    ID3D12ShaderReflectionType* STDMETHODCALLTYPE GetMemberTypeByName(LPCSTR) override { return nullptr; }
+    LPCSTR STDMETHODCALLTYPE GetMemberTypeName(UINT) override { return nullptr; }
+    HRESULT STDMETHODCALLTYPE IsEqual(ID3D12ShaderReflectionType*) override { return E_NOTIMPL; }
+    ID3D12ShaderReflectionType* STDMETHODCALLTYPE GetSubType() override { return nullptr; }
+    ID3D12ShaderReflectionType* STDMETHODCALLTYPE GetBaseClass() override { return nullptr; }
+    UINT STDMETHODCALLTYPE GetNumInterfaces() override { return 0; }
+    ID3D12ShaderReflectionType* STDMETHODCALLTYPE GetInterfaceByIndex(UINT) override { return nullptr; }
+    HRESULT STDMETHODCALLTYPE IsOfType(ID3D12ShaderReflectionType*) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE ImplementsInterface(ID3D12ShaderReflectionType*) override { return E_NOTIMPL; }
+};
+
+class MockShaderReflectionVariable : public ID3D12ShaderReflectionVariable
+{
+public:
+    D3D12_SHADER_VARIABLE_DESC m_Desc = {};
+    MockShaderReflectionType m_Type;
+
+    HRESULT STDMETHODCALLTYPE GetDesc(D3D12_SHADER_VARIABLE_DESC* pDesc) override { *pDesc = m_Desc; return S_OK; }
+    ID3D12ShaderReflectionType* STDMETHODCALLTYPE GetType() override { return &m_Type; }
+    ID3D12ShaderReflectionConstantBuffer* STDMETHODCALLTYPE GetBuffer() override { return nullptr; }
+    UINT STDMETHODCALLTYPE GetInterfaceSlot(UINT) override { return 0; }
+};
+
+class MockShaderReflectionConstantBuffer : public ID3D12ShaderReflectionConstantBuffer
+{
+public:
+    D3D12_SHADER_BUFFER_DESC m_Desc = {};
+    std::vector<MockShaderReflectionVariable> m_Variables;
+
+    HRESULT STDMETHODCALLTYPE GetDesc(D3D12_SHADER_BUFFER_DESC* pDesc) override { *pDesc = m_Desc; return S_OK; }
+    ID3D12ShaderReflectionVariable* STDMETHODCALLTYPE GetVariableByIndex(UINT Index) override { return &m_Variables[Index]; }
+    ID3D12ShaderReflectionVariable* STDMETHODCALLTYPE GetVariableByName(LPCSTR) override { return nullptr; }
+};
+
+class MockShaderReflection : public ID3D12ShaderReflection
+{
+public:
+    MockShaderReflection()
+    {
+        m_Desc.Version = (D3D12_SHVER_COMPUTE_SHADER << 16) | 0x60;
+        m_Bindings = {
+            { "Constants", D3D_SIT_CBUFFER, 0, 1, 0, D3D_RESOURCE_RETURN_TYPE(0), D3D_SRV_DIMENSION_UNKNOWN, 0, 0, 0 },
+            { "Input", D3D_SIT_TEXTURE, 0, 1, 0, D3D_RETURN_TYPE_FLOAT, D3D_SRV_DIMENSION_TEXTURE2D, 0, 0, 1 },
+            { "Output", D3D_SIT_UAV_RWTYPED, 0, 1, 0, D3D_RETURN_TYPE_FLOAT, D3D_SRV_DIMENSION_TEXTURE2D, 0, 0, 2 },
+        };
+        m_Buffer.m_Desc = { "Constants", D3D_CT_CBUFFER, 2, 32, 0 };
+        m_Buffer.m_Variables.resize(2);
+        m_Buffer.m_Variables[0].m_Desc = { "Scale", 0, 16, 2, nullptr, UINT_MAX, 0, UINT_MAX, 0 };
+        m_Buffer.m_Variables[0].m_Type.m_Desc = { D3D_SVC_VECTOR, D3D_SVT_FLOAT, 1, 4, 0, 0, 0, "float4" };
+        m_Buffer.m_Variables[1].m_Desc = { "Size", 16, 8, 2, nullptr, UINT_MAX, 0, UINT_MAX, 0 };
+        m_Buffer.m_Variables[1].m_Type.m_Desc = { D3D_SVC_VECTOR, D3D_SVT_UINT, 1, 2, 0, 0, 0, "uint2" };
+        m_Inputs = {
+            { "SV_DispatchThreadID", 0, 0, D3D_NAME_UNDEFINED, D3D_REGISTER_COMPONENT_UINT32, 0x7, 0x7, 0, D3D_MIN_PRECISION_DEFAULT },
+        };
+        m_Desc.ConstantBuffers = 1;
+        m_Desc.BoundResources = static_cast<UINT>(m_Bindings.size());
+        m_Desc.InputParameters = static_cast<UINT>(m_Inputs.size());
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, LPVOID* ppv) override { *ppv = this; return S_OK; }
+    ULONG STDMETHODCALLTYPE AddRef() override { return 0; }
+    ULONG STDMETHODCALLTYPE Release() override { return 0; }
+
+    HRESULT STDMETHODCALLTYPE GetDesc(D3D12_SHADER_DESC* pDesc) override { *pDesc = m_Desc; return S_OK; }
+    ID3D12ShaderReflectionConstantBuffer* STDMETHODCALLTYPE GetConstantBufferByIndex(UINT) override { return &m_Buffer; }
+    ID3D12ShaderReflectionConstantBuffer* STDMETHODCALLTYPE GetConstantBufferByName(LPCSTR) override { return &m_Buffer; }
+    HRESULT STDMETHODCALLTYPE GetResourceBindingDesc(UINT Index, D3D12_SHADER_INPUT_BIND_DESC* pDesc) override
+    {
+        if (Index >= m_Bindings.size()) return E_INVALIDARG;
+        *pDesc = m_Bindings[Index];
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetInputParameterDesc(UINT Index, D3D12_SIGNATURE_PARAMETER_DESC* pDesc) override
+    {
+        if (Index >= m_Inputs.size()) return E_INVALIDARG;
+        *pDesc = m_Inputs[Index];
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetOutputParameterDesc(UINT, D3D12_SIGNATURE_PARAMETER_DESC*) override { return E_INVALIDARG; }
+    HRESULT STDMETHODCALLTYPE GetPatchConstantParameterDesc(UINT, D3D12_SIGNATURE_PARAMETER_DESC*) override { return E_INVALIDARG; }
+    ID3D12ShaderReflectionVariable* STDMETHODCALLTYPE GetVariableByName(LPCSTR) override { return nullptr; }
+    HRESULT STDMETHODCALLTYPE GetResourceBindingDescByName(LPCSTR, D3D12_SHADER_INPUT_BIND_DESC*) override { return E_NOTIMPL; }
+    UINT STDMETHODCALLTYPE GetMovInstructionCount() override { return 0; }
+    UINT STDMETHODCALLTYPE GetMovcInstructionCount() override { return 0; }
+    UINT STDMETHODCALLTYPE GetConversionInstructionCount() override { return 0; }
+    UINT STDMETHODCALLTYPE GetBitwiseInstructionCount() override { return 0; }
+    D3D_PRIMITIVE STDMETHODCALLTYPE GetGSInputPrimitive() override { return D3D_PRIMITIVE_UNDEFINED; }
+    BOOL STDMETHODCALLTYPE IsSampleFrequencyShader() override { return FALSE; }
+    UINT STDMETHODCALLTYPE GetNumInterfaceSlots() override { return 0; }
+    HRESULT STDMETHODCALLTYPE GetMinFeatureLevel(D3D_FEATURE_LEVEL* pLevel) override { *pLevel = D3D_FEATURE_LEVEL_12_0; return S_OK; }
+    UINT STDMETHODCALLTYPE GetThreadGroupSize(UINT* pSizeX, UINT* pSizeY, UINT* pSizeZ) override
+    {
+        if (pSizeX) *pSizeX = 8;
+        if (pSizeY) *pSizeY = 8;
+        if (pSizeZ) *pSizeZ = 1;
+        return 64;
+    }
+    UINT64 STDMETHODCALLTYPE GetRequiresFlags() override { return D3D_SHADER_REQUIRES_WAVE_OPS; }
+
+    D3D12_SHADER_DESC m_Desc = {};
+    std::vector<D3D12_SHADER_INPUT_BIND_DESC> m_Bindings;
+    std::vector<D3D12_SIGNATURE_PARAMETER_DESC> m_Inputs;
+    MockShaderReflectionConstantBuffer m_Buffer;
+};
+
+// A blob copied to fresh storage reads back the same bindings, layouts and signature
+TEST(ShaderReflectionCacheTest, RoundTrip)
+{
+    MockShaderReflection reflection;
+    CD3DX12ShaderReflectionBlob blob;
+    ASSERT_EQ(blob.Init(&reflection), S_OK);
+    EXPECT_EQ(blob.GetSize() % 8, 0u);
+
+    // Stand-in for a mapped cache file
+    std::vector<UINT64> storage((blob.GetSize() + 7) / 8);
+    memcpy(storage.data(), blob.GetData(), blob.GetSize());
+    reflection.m_Bindings.clear(); // The view must not depend on the reflection
+
+    CD3DX12ShaderReflectionView view;
+    ASSERT_EQ(view.Init(storage.data(), blob.GetSize()), S_OK);
+    EXPECT_EQ(D3D12_SHVER_GET_TYPE(view.GetShaderVersion()), UINT(D3D12_SHVER_COMPUTE_SHADER));
+    EXPECT_EQ(view.GetRequiresFlags(), UINT64(D3D_SHADER_REQUIRES_WAVE_OPS));
+    UINT X, Y, Z;
+    view.GetThreadGroupSize(&X, &Y, &Z);
+    EXPECT_EQ(X, 8u);
+    EXPECT_EQ(Y, 8u);
+    EXPECT_EQ(Z, 1u);
+
+    ASSERT_EQ(view.GetNumBindings(), 3u);
+    const UINT Output = view.FindBinding("Output");
+    ASSERT_EQ(Output, 2u);
+    EXPECT_EQ(view.GetBinding(Output).Type, D3D_SIT_UAV_RWTYPED);
+    EXPECT_EQ(view.GetBinding(Output).Dimension, D3D_SRV_DIMENSION_TEXTURE2D);
+    EXPECT_EQ(view.FindBinding("Missing"), UINT_MAX);
+
+    ASSERT_EQ(view.GetNumConstantBuffers(), 1u);
+    const D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER& Buffer = view.GetConstantBuffer(view.FindConstantBuffer("Constants"));
+    EXPECT_EQ(Buffer.Size, 32u);
+    EXPECT_EQ(Buffer.BindingIndex, 0u);
+    // The buffer and its binding share one string
+    EXPECT_EQ(Buffer.NameOffset, view.GetBinding(0).NameOffset);
+    ASSERT_EQ(Buffer.NumVariables, 2u);
+    const D3DX12_SHADER_REFLECTION_VARIABLE& Size = view.GetVariable(Buffer, 1);
+    EXPECT_STREQ(view.GetString(Size.NameOffset), "Size");
+    EXPECT_EQ(Size.StartOffset, 16u);
+    EXPECT_EQ(Size.Type, D3D_SVT_UINT);
+    EXPECT_EQ(Size.Columns, 2u);
+
+    ASSERT_EQ(view.GetNumInputParameters(), 1u);
+    EXPECT_STREQ(view.GetString(view.GetInputParameter(0).SemanticNameOffset), "SV_DispatchThreadID");
+    EXPECT_EQ(view.GetInputParameter(0).Mask, 0x7u);
+    EXPECT_EQ(view.GetNumOutputParameters(), 0u);
+}
+
+// A shader without bindings, constant buffers or signature parameters writes an empty string table
+// and still reads back
+TEST(ShaderReflectionCacheTest, EmptyReflection)
+{
+    MockShaderReflection reflection;
+    reflection.m_Bindings.clear();
+    reflection.m_Inputs.clear();
+    reflection.m_Desc.ConstantBuffers = 0;
+    reflection.m_Desc.BoundResources = 0;
+    reflection.m_Desc.InputParameters = 0;
+    CD3DX12ShaderReflectionBlob blob;
+    ASSERT_EQ(blob.Init(&reflection), S_OK);
+    EXPECT_EQ(blob.GetSize(), sizeof(D3DX12_SHADER_REFLECTION_HEADER));
+
+    std::vector<UINT64> storage((blob.GetSize() + 7) / 8);
+    memcpy(storage.data(), blob.GetData(), blob.GetSize());
+    CD3DX12ShaderReflectionView view;
+    ASSERT_EQ(view.Init(storage.data(), blob.GetSize()), S_OK);
+    EXPECT_EQ(view.GetNumBindings(), 0u);
+    EXPECT_EQ(view.GetNumConstantBuffers(), 0u);
+    EXPECT_EQ(view.GetNumInputParameters(), 0u);
+    EXPECT_EQ(view.GetNumOutputParameters(), 0u);
+    EXPECT_EQ(view.FindBinding("Output"), UINT_MAX);
+    UINT X;
+    view.GetThreadGroupSize(&X, nullptr, nullptr);
+    EXPECT_EQ(X, 8u);
+}
+
+// Truncated, corrupted and misaligned blobs are rejected
+TEST(ShaderReflectionCacheTest, Validation)
+{
+    MockShaderReflection reflection;
+    CD3DX12ShaderReflectionBlob blob;
+    ASSERT_EQ(blob.Init(&reflection), S_OK);
+
+    std::vector<UINT64> storage(blob.GetSize() / 8 + 1);
+    BYTE* pBytes = reinterpret_cast<BYTE*>(storage.data());
+    memcpy(pBytes, blob.GetData(), blob.GetSize());
+
+    CD3DX12ShaderReflectionView view;
+    EXPECT_EQ(view.Init(pBytes, blob.GetSize() - 8), E_INVALIDARG);
+    memcpy(pBytes + 1, blob.GetData(), blob.GetSize());
+    EXPECT_EQ(view.Init(pBytes + 1, blob.GetSize()), E_INVALIDARG);
+
+    // A name offset past the string table
+    memcpy(pBytes, blob.GetData(), blob.GetSize());
+    D3DX12_SHADER_REFLECTION_BINDING* pBindings = reinterpret_cast<D3DX12_SHADER_REFLECTION_BINDING*>(pBytes + sizeof(D3DX12_SHADER_REFLECTION_HEADER));
+    pBindings[1].NameOffset = 0x10000;
+    EXPECT_EQ(view.Init(pBytes, blob.GetSize()), E_INVALIDARG);
+
+    // An unterminated string table
+    memcpy(pBytes, blob.GetData(), blob.GetSize());
+    pBytes[blob.GetSize() - 1] = 'x';
+    EXPECT_EQ(view.Init(pBytes, blob.GetSize()), E_INVALIDARG);
+
+    memcpy(pBytes, blob.GetData(), blob.GetSize());
+    EXPECT_EQ(view.Init(pBytes, blob.GetSize()), S_OK);
+
+    // Failures while walking the reflection are returned
+    reflection.m_Desc.OutputParameters = 1;
+    EXPECT_EQ(blob.Init(&reflection), E_INVALIDARG);
+}
+
+//------------------------------------------------------------------------------------------------
+// Root signature generation
+
+static D3D12_SHADER_INPUT_BIND_DESC BindDesc(D3D_SHADER_INPUT_TYPE Type, UINT BindPoint, UINT BindCount = 1, UINT Space = 0)
+{
+    D3D12_SHADER_INPUT_BIND_DESC Desc = {};
+    Desc.Type = Type;
+    Desc.BindPoint = BindPoint;
+    Desc.BindCount = BindCount;
+    Desc.Space = Space;
+    return Desc;
+}
+
+// Bindings shared by the vertex and pixel shaders become visible to all stages, single CBVs become
+// root CBVs and the unused stages are denied
+TEST(RootSignatureGeneratorTest, MergeStages)
+{
+    CD3DX12RootSignatureGenerator generator;
+    generator.AddBinding(BindDesc(D3D_SIT_CBUFFER, 0), D3D12_SHADER_VISIBILITY_VERTEX);
+    generator.AddBinding(BindDesc(D3D_SIT_TEXTURE, 0), D3D12_SHADER_VISIBILITY_VERTEX);
+    generator.AddBinding(BindDesc(D3D_SIT_CBUFFER, 0), D3D12_SHADER_VISIBILITY_PIXEL);
+    generator.AddBinding(BindDesc(D3D_SIT_CBUFFER, 1), D3D12_SHADER_VISIBILITY_PIXEL);
+    generator.AddBinding(BindDesc(D3D_SIT_TEXTURE, 0), D3D12_SHADER_VISIBILITY_PIXEL);
+    generator.AddBinding(BindDesc(D3D_SIT_TEXTURE, 1), D3D12_SHADER_VISIBILITY_PIXEL);
+    generator.AddBinding(BindDesc(D3D_SIT_SAMPLER, 0), D3D12_SHADER_VISIBILITY_PIXEL);
+    ASSERT_EQ(generator.Generate(D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT), S_OK);
+
+    const D3D12_ROOT_SIGNATURE_DESC1& Desc = generator.GetDesc().Desc_1_1;
+    EXPECT_EQ(generator.GetDesc().Version, D3D_ROOT_SIGNATURE_VERSION_1_1);
+    ASSERT_EQ(Desc.NumParameters, 5u);
+    EXPECT_EQ(Desc.pParameters[0].ParameterType, D3D12_ROOT_PARAMETER_TYPE_CBV);
+    EXPECT_EQ(Desc.pParameters[0].ShaderVisibility, D3D12_SHADER_VISIBILITY_ALL);
+    EXPECT_EQ(Desc.pParameters[0].Descriptor.Flags, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
+    EXPECT_EQ(Desc.pParameters[1].ParameterType, D3D12_ROOT_PARAMETER_TYPE_CBV);
+    EXPECT_EQ(Desc.pParameters[1].ShaderVisibility, D3D12_SHADER_VISIBILITY_PIXEL);
+    EXPECT_EQ(Desc.pParameters[1].Descriptor.ShaderRegister, 1u);
+    EXPECT_EQ(Desc.pParameters[2].ShaderVisibility, D3D12_SHADER_VISIBILITY_ALL);
+    EXPECT_EQ(Desc.pParameters[2].DescriptorTable.NumDescriptorRanges, 1u);
+    EXPECT_EQ(Desc.pParameters[3].ShaderVisibility, D3D12_SHADER_VISIBILITY_PIXEL);
+    EXPECT_EQ(Desc.pParameters[3].DescriptorTable.pDescriptorRanges[0].BaseShaderRegister, 1u);
+    EXPECT_EQ(Desc.pParameters[4].DescriptorTable.pDescriptorRanges[0].RangeType, D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER);
+    EXPECT_EQ(Desc.pParameters[4].DescriptorTable.pDescriptorRanges[0].Flags, D3D12_DESCRIPTOR_RANGE_FLAG_NONE);
+
+    EXPECT_EQ(Desc.Flags, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT
+        | D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS
+        | D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS
+        | D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS
+        | D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS
+        | D3D12_ROOT_SIGNATURE_FLAG_DENY_MESH_SHADER_ROOT_ACCESS);
+
+    const D3DX12_ROOT_SIGNATURE_BINDING* pSampler = generator.FindBinding(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, 0, 0);
+    ASSERT_NE(pSampler, nullptr);
+    EXPECT_EQ(pSampler->RootParameterIndex, 4u);
+    EXPECT_EQ(pSampler->TableOffset, 0u);
+    EXPECT_EQ(generator.FindBinding(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 0, 1)->TableOffset, UINT_MAX);
+    EXPECT_EQ(generator.FindBinding(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 0, 0), nullptr);
+}
+
+// Contiguous registers share a range, unbounded arrays get their own table, overlapping arrays are
+// merged, and permutations with the same bindings hash equally
+TEST(RootSignatureGeneratorTest, RangesAndHash)
+{
+    CD3DX12RootSignatureGenerator generator;
+    generator.AddBinding(BindDesc(D3D_SIT_TEXTURE, 0, 4), D3D12_SHADER_VISIBILITY_ALL);
+    generator.AddBinding(BindDesc(D3D_SIT_STRUCTURED, 4), D3D12_SHADER_VISIBILITY_ALL);
+    generator.AddBinding(BindDesc(D3D_SIT_TEXTURE, 10, 0), D3D12_SHADER_VISIBILITY_ALL);
+    generator.AddBinding(BindDesc(D3D_SIT_UAV_RWTYPED, 0), D3D12_SHADER_VISIBILITY_ALL);
+    generator.AddBinding(BindDesc(D3D_SIT_UAV_RWBYTEADDRESS, 1), D3D12_SHADER_VISIBILITY_ALL);
+    generator.AddBinding(BindDesc(D3D_SIT_CBUFFER, 0, 2), D3D12_SHADER_VISIBILITY_ALL);
+    ASSERT_EQ(generator.Generate(D3D12_ROOT_SIGNATURE_FLAG_NONE, true), S_OK);
+
+    const D3D12_ROOT_SIGNATURE_DESC1& Desc = generator.GetDesc().Desc_1_1;
+    EXPECT_EQ(Desc.Flags, D3D12_ROOT_SIGNATURE_FLAG_NONE);
+    ASSERT_EQ(Desc.NumParameters, 2u);
+    ASSERT_EQ(Desc.pParameters[0].DescriptorTable.NumDescriptorRanges, 3u);
+    const D3D12_DESCRIPTOR_RANGE1* pRanges = Desc.pParameters[0].DescriptorTable.pDescriptorRanges;
+    EXPECT_EQ(pRanges[0].RangeType, D3D12_DESCRIPTOR_RANGE_TYPE_SRV);
+    EXPECT_EQ(pRanges[0].NumDescriptors, 5u);
+    EXPECT_EQ(pRanges[0].Flags, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC);
+    EXPECT_EQ(pRanges[1].RangeType, D3D12_DESCRIPTOR_RANGE_TYPE_UAV);
+    EXPECT_EQ(pRanges[1].NumDescriptors, 2u);
+    EXPECT_EQ(pRanges[1].OffsetInDescriptorsFromTableStart, 5u);
+    EXPECT_EQ(pRanges[1].Flags, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE);
+    EXPECT_EQ(pRanges[2].RangeType, D3D12_DESCRIPTOR_RANGE_TYPE_CBV);
+    EXPECT_EQ(pRanges[2].OffsetInDescriptorsFromTableStart, 7u);
+
+    const D3D12_DESCRIPTOR_RANGE1& Unbounded = Desc.pParameters[1].DescriptorTable.pDescriptorRanges[0];
+    EXPECT_EQ(Unbounded.NumDescriptors, UINT_MAX);
+    EXPECT_EQ(Unbounded.BaseShaderRegister, 10u);
+    EXPECT_EQ(Unbounded.Flags, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
+    // Version 1.1 rejects volatile descriptors with static data in any range
+    for (UINT i = 0; i < Desc.NumParameters; ++i)
+    {
+        if (Desc.pParameters[i].ParameterType != D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
+        {
+            continue;
+        }
+        const D3D12_ROOT_DESCRIPTOR_TABLE1& Table = Desc.pParameters[i].DescriptorTable;
+        for (UINT r = 0; r < Table.NumDescriptorRanges; ++r)
+        {
+            const D3D12_DESCRIPTOR_RANGE_FLAGS Flags = Table.pDescriptorRanges[r].Flags;
+            EXPECT_FALSE((Flags & D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE) && (Flags & D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC));
+        }
+    }
+    EXPECT_EQ(generator.FindBinding(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 1000)->RootParameterIndex, 1u);
+    EXPECT_EQ(generator.FindBinding(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 0, 1)->TableOffset, 6u);
+
+    // The same bindings in another order
+    CD3DX12RootSignatureGenerator permutation;
+    permutation.AddBinding(BindDesc(D3D_SIT_CBUFFER, 0, 2), D3D12_SHADER_VISIBILITY_ALL);
+    permutation.AddBinding(BindDesc(D3D_SIT_UAV_RWBYTEADDRESS, 1), D3D12_SHADER_VISIBILITY_ALL);
+    permutation.AddBinding(BindDesc(D3D_SIT_TEXTURE, 10, 0), D3D12_SHADER_VISIBILITY_ALL);
+    permutation.AddBinding(BindDesc(D3D_SIT_UAV_RWTYPED, 0), D3D12_SHADER_VISIBILITY_ALL);
+    permutation.AddBinding(BindDesc(D3D_SIT_TEXTURE, 4), D3D12_SHADER_VISIBILITY_ALL);
+    permutation.AddBinding(BindDesc(D3D_SIT_TEXTURE, 0, 4), D3D12_SHADER_VISIBILITY_ALL);
+    ASSERT_EQ(permutation.Generate(D3D12_ROOT_SIGNATURE_FLAG_NONE, true), S_OK);
+    EXPECT_EQ(permutation.GetLayoutHash(), generator.GetLayoutHash());
+    ASSERT_EQ(permutation.Generate(D3D12_ROOT_SIGNATURE_FLAG_NONE, false), S_OK);
+    EXPECT_NE(permutation.GetLayoutHash(), generator.GetLayoutHash());
+
+    // Overlapping arrays from different stages
+    CD3DX12RootSignatureGenerator overlap;
+    overlap.AddBinding(BindDesc(D3D_SIT_TEXTURE, 0, 2), D3D12_SHADER_VISIBILITY_VERTEX);
+    overlap.AddBinding(BindDesc(D3D_SIT_TEXTURE, 1, 2), D3D12_SHADER_VISIBILITY_PIXEL);
+    ASSERT_EQ(overlap.Generate(), S_OK);
+    ASSERT_EQ(overlap.GetNumBindings(), 1u);
+    EXPECT_EQ(overlap.GetBinding(0).Count, 3u);
+    EXPECT_EQ(overlap.GetBinding(0).Visibility, D3D12_SHADER_VISIBILITY_ALL);
+}
+
+// Bindings can come straight from a cached reflection blob
+TEST(RootSignatureGeneratorTest, FromReflection)
+{
+    MockShaderReflection reflection;
+    CD3DX12ShaderReflectionBlob blob;
+    ASSERT_EQ(blob.Init(&reflection), S_OK);
+    std::vector<UINT64> storage((blob.GetSize() + 7) / 8);
+    memcpy(storage.data(), blob.GetData(), blob.GetSize());
+    CD3DX12ShaderReflectionView view;
+    ASSERT_EQ(view.Init(storage.data(), blob.GetSize()), S_OK);
+
+    CD3DX12RootSignatureGenerator generator;
+    generator.AddStage(view, D3D12_SHADER_VISIBILITY_ALL);
+    ASSERT_EQ(generator.Generate(), S_OK);
+    const D3D12_ROOT_SIGNATURE_DESC1& Desc = generator.GetDesc().Desc_1_1;
+    ASSERT_EQ(Desc.NumParameters, 2u);
+    EXPECT_EQ(Desc.pParameters[0].ParameterType, D3D12_ROOT_PARAMETER_TYPE_CBV);
+    EXPECT_EQ(Desc.pParameters[1].DescriptorTable.NumDescriptorRanges, 2u);
+}
@@ -0,0 +1,536 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "gtest/gtest.h"
+
+#include <wsl/winadapter.h>
+
+#include <directx/d3d12.h>
+#include <directx/d3dx12video.h>
+#include "dxguids/dxguids.h"
+#include "MockVideoDevice.hpp"
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+// Device-free tests for the d3dx12video.h helpers
+
+//------------------------------------------------------------------------------------------------
+// Video encoder output ring
+
+// Resources are never dereferenced by the helpers, so distinct fake addresses are enough
+static ID3D12Resource* FakeResource(UINT_PTR Id)
+{
+    return reinterpret_cast<ID3D12Resource*>(Id * 0x100);
+}
+
+// Stands in for the encoder: EncodeFrame writes opaque metadata for the frame, and the resolve turns
+// it into the documented layout in the CPU-visible resolved metadata buffer.
+class MockVideoEncoder
+{
+public:
+    static constexpr UINT MaxSubregions = 4;
+
+    explicit MockVideoEncoder(UINT NumFrames) : m_Resolved(NumFrames, std::vector<BYTE>(CD3DX12VideoEncoderOutputRing::GetResolvedMetadataSize(MaxSubregions)))
+    {
+        for (UINT i = 0; i < NumFrames; ++i)
+        {
+            D3DX12_VIDEO_ENCODER_FRAME_RESOURCES Frame = {};
+            Frame.Bitstream = { FakeResource(1), i * 0x10000ull };
+            Frame.EncoderOutputMetadata = { FakeResource(100 + i), 0 };
+            Frame.ResolvedMetadata = { FakeResource(200 + i), 0 };
+            Frame.pMappedResolvedMetadata = m_Resolved[i].data();
+            m_Frames.push_back(Frame);
+        }
+    }
+
+    void EncodeFrame(const D3D12_VIDEO_ENCODER_ENCODEFRAME_OUTPUT_ARGUMENTS& Output, UINT NumSlices)
+    {
+        m_PendingSlices[Output.EncoderOutputMetadata.pBuffer] = NumSlices;
+    }
+
+    void ResolveEncoderOutputMetadata(const D3DX12_VIDEO_ENCODER_RESOLVE_ARGUMENTS& Args)
+    {
+        const UINT Frame = static_cast<UINT>((reinterpret_cast<UINT_PTR>(Args.Output.ResolvedLayoutMetadata.pBuffer) / 0x100) - 200);
+        const UINT NumSlices = m_PendingSlices[Args.Input.HWLayoutMetadata.pBuffer];
+        D3D12_VIDEO_ENCODER_OUTPUT_METADATA Metadata = {};
+        Metadata.WrittenSubregionsCount = NumSlices;
+        Metadata.EncodedBitstreamWrittenBytesCount = NumSlices * 1000;
+        memcpy(m_Resolved[Frame].data(), &Metadata, sizeof(Metadata));
+        for (UINT i = 0; i < NumSlices; ++i)
+        {
+            const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA Slice = { 1000, 16, 10 };
+            memcpy(m_Resolved[Frame].data() + sizeof(Metadata) + i * sizeof(Slice), &Slice, sizeof(Slice));
+        }
+    }
+
+    std::vector<D3DX12_VIDEO_ENCODER_FRAME_RESOURCES> m_Frames;
+    std::vector<std::vector<BYTE>> m_Resolved;
+    std::map<ID3D12Resource*, UINT> m_PendingSlices;
+};
+
+// Resolves trail encodes by one submission and frames complete in order as the fence advances
+TEST(VideoEncoderOutputRingTest, PipelinedResolve)
+{
+    const UINT NumFrames = 3;
+    MockVideoEncoder encoder(NumFrames);
+    D3D12_VIDEO_ENCODER_RESOLVE_METADATA_INPUT_ARGUMENTS ResolveInput = {};
+    ResolveInput.EncoderCodec = D3D12_VIDEO_ENCODER_CODEC_H264;
+    ResolveInput.EncoderInputFormat = DXGI_FORMAT_NV12;
+
+    CD3DX12VideoEncoderOutputRing ring;
+    ASSERT_EQ(ring.Init(NumFrames, encoder.m_Frames.data(), MockVideoEncoder::MaxSubregions, ResolveInput), S_OK);
+
+    D3D12_VIDEO_ENCODER_ENCODEFRAME_OUTPUT_ARGUMENTS Output = {};
+    D3DX12_VIDEO_ENCODER_RESOLVE_ARGUMENTS Resolve;
+    bool HasResolve;
+
+    // Submission 1 encodes frame 0 only
+    ASSERT_TRUE(ring.BeginFrame(1, &Output, &Resolve, &HasResolve));
+    EXPECT_FALSE(HasResolve);
+    encoder.EncodeFrame(Output, 1);
+
+    // Submission 2 encodes frame 1 and resolves frame 0
+    ASSERT_TRUE(ring.BeginFrame(2, &Output, &Resolve, &HasResolve));
+    EXPECT_EQ(Output.Bitstream.FrameStartOffset, 0x10000u);
+    encoder.EncodeFrame(Output, 2);
+    ASSERT_TRUE(HasResolve);
+    EXPECT_EQ(Resolve.Input.EncoderCodec, D3D12_VIDEO_ENCODER_CODEC_H264);
+    EXPECT_EQ(Resolve.Input.HWLayoutMetadata.pBuffer, encoder.m_Frames[0].EncoderOutputMetadata.pBuffer);
+    encoder.ResolveEncoderOutputMetadata(Resolve);
+
+    // Submission 3 encodes frame 2 and resolves frame 1; the ring is then full
+    ASSERT_TRUE(ring.BeginFrame(3, &Output, &Resolve, &HasResolve));
+    encoder.EncodeFrame(Output, 3);
+    ASSERT_TRUE(HasResolve);
+    encoder.ResolveEncoderOutputMetadata(Resolve);
+    EXPECT_FALSE(ring.BeginFrame(4, &Output, &Resolve, &HasResolve));
+    EXPECT_EQ(ring.GetNumFramesInFlight(), 3u);
+
+    D3DX12_VIDEO_ENCODER_COMPLETED_FRAME Frame;
+    EXPECT_EQ(ring.GetCompletedFrame(1, &Frame), S_FALSE);
+    ASSERT_EQ(ring.GetCompletedFrame(2, &Frame), S_OK);
+    EXPECT_EQ(Frame.FrameIndex, 0u);
+    EXPECT_EQ(Frame.NumSubregions, 1u);
+    EXPECT_EQ(static_cast<const void*>(Frame.pMetadata), encoder.m_Resolved[0].data());
+    ring.ReleaseFrame();
+    EXPECT_EQ(ring.GetCompletedFrame(2, &Frame), S_FALSE);
+
+    // The released slot is reused by frame 3
+    ASSERT_TRUE(ring.BeginFrame(4, &Output, &Resolve, &HasResolve));
+    EXPECT_EQ(Output.Bitstream.FrameStartOffset, 0u);
+    encoder.EncodeFrame(Output, 1);
+    encoder.ResolveEncoderOutputMetadata(Resolve);
+    ASSERT_TRUE(ring.Flush(5, &Resolve));
+    encoder.ResolveEncoderOutputMetadata(Resolve);
+    EXPECT_FALSE(ring.Flush(6, &Resolve));
+
+    for (UINT64 Expected = 1; Expected < 4; ++Expected)
+    {
+        ASSERT_EQ(ring.GetCompletedFrame(5, &Frame), S_OK);
+        EXPECT_EQ(Frame.FrameIndex, Expected);
+        EXPECT_EQ(Frame.Bitstream.FrameStartOffset, (Expected % NumFrames) * 0x10000u);
+        ring.ReleaseFrame();
+    }
+    EXPECT_EQ(ring.GetNumFramesInFlight(), 0u);
+}
+
+// Subregion metadata is turned into absolute payload ranges in the bitstream
+TEST(VideoEncoderOutputRingTest, Subregions)
+{
+    BYTE Resolved[CD3DX12VideoEncoderOutputRing::GetResolvedMetadataSize(3)] = {};
+    D3D12_VIDEO_ENCODER_OUTPUT_METADATA Metadata = {};
+    Metadata.WrittenSubregionsCount = 3;
+    const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA Slices[3] = { { 100, 0, 8 }, { 64, 4, 8 }, { 200, 32, 12 } };
+    memcpy(Resolved, &Metadata, sizeof(Metadata));
+    memcpy(Resolved + sizeof(Metadata), Slices, sizeof(Slices));
+
+    const D3D12_VIDEO_ENCODER_OUTPUT_METADATA* pMetadata;
+    const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA* pSubregionMetadata;
+    ASSERT_EQ(D3DX12ParseVideoEncoderOutputMetadata(Resolved, sizeof(Resolved), &pMetadata, &pSubregionMetadata), S_OK);
+    EXPECT_EQ(D3DX12ParseVideoEncoderOutputMetadata(Resolved, sizeof(Resolved) - 1, &pMetadata, &pSubregionMetadata), E_INVALIDARG);
+    ASSERT_EQ(D3DX12ParseVideoEncoderOutputMetadata(Resolved, sizeof(Resolved), &pMetadata, &pSubregionMetadata), S_OK);
+
+    D3DX12_VIDEO_ENCODER_SUBREGION Subregions[3];
+    ASSERT_TRUE(D3DX12GetVideoEncoderSubregions(pSubregionMetadata, 3, 4096, Subregions));
+    EXPECT_EQ(Subregions[0].Offset, 4096u);
+    EXPECT_EQ(Subregions[0].Size, 100u);
+    EXPECT_EQ(Subregions[1].Offset, 4096u + 100u + 4u);
+    EXPECT_EQ(Subregions[1].Size, 60u);
+    EXPECT_EQ(Subregions[2].Offset, 4096u + 164u + 32u);
+    EXPECT_EQ(Subregions[2].Size, 168u);
+    EXPECT_EQ(Subregions[2].HeaderSize, 12u);
+
+    const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA Bad = { 10, 20, 0 };
+    EXPECT_FALSE(D3DX12GetVideoEncoderSubregions(&Bad, 1, 0, Subregions));
+}
+
+//------------------------------------------------------------------------------------------------
+// Video capability cache
+
+static void SetupVideoDevice(MockVideoDevice& device)
+{
+    device.m_DecodeProfiles.push_back({ D3D12_VIDEO_DECODE_PROFILE_H264, { DXGI_FORMAT_NV12 }, 4096, 2304 });
+    device.m_DecodeProfiles.push_back({ D3D12_VIDEO_DECODE_PROFILE_HEVC_MAIN10, { DXGI_FORMAT_P010, DXGI_FORMAT_NV12 }, 8192, 4352 });
+    device.m_EncodeProfiles[D3D12_VIDEO_ENCODER_CODEC_H264] = 3;
+    device.m_EncodeProfiles[D3D12_VIDEO_ENCODER_CODEC_HEVC] = 2;
+}
+
+// The capability matrix is enumerated once and answered from the cache
+TEST(VideoFeatureSupportTest, Lookup)
+{
+    MockVideoDevice device;
+    SetupVideoDevice(device);
+    CD3DX12VideoFeatureSupport features;
+    ASSERT_EQ(features.Init(&device, LUID{ 1, 2 }), S_OK);
+    const UINT Calls = device.m_CheckFeatureSupportCalls;
+
+    EXPECT_EQ(features.GetNumDecodeCaps(), 3u);
+    EXPECT_TRUE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_H264, DXGI_FORMAT_NV12, 3840, 2160));
+    EXPECT_FALSE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_H264, DXGI_FORMAT_NV12, 7680, 4320));
+    EXPECT_FALSE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_H264, DXGI_FORMAT_P010, 1920, 1080));
+    EXPECT_TRUE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_HEVC_MAIN10, DXGI_FORMAT_P010, 7680, 4320));
+    EXPECT_FALSE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_VP9, DXGI_FORMAT_NV12, 1920, 1080));
+    const D3DX12_VIDEO_DECODE_CAPS* pDecode = features.FindDecodeCaps(D3D12_VIDEO_DECODE_PROFILE_HEVC_MAIN10, DXGI_FORMAT_NV12);
+    ASSERT_NE(pDecode, nullptr);
+    EXPECT_EQ(pDecode->MaxWidth, 8192u);
+    EXPECT_EQ(pDecode->DecodeTier, D3D12_VIDEO_DECODE_TIER_1);
+
+    EXPECT_EQ(features.GetNumEncodeCaps(), 5u);
+    EXPECT_TRUE(features.EncodeSupported(D3D12_VIDEO_ENCODER_CODEC_H264, D3D12_VIDEO_ENCODER_PROFILE_H264_HIGH, DXGI_FORMAT_NV12, 1920, 1080));
+    EXPECT_FALSE(features.EncodeSupported(D3D12_VIDEO_ENCODER_CODEC_H264, D3D12_VIDEO_ENCODER_PROFILE_H264_HIGH, DXGI_FORMAT_NV12, 1921, 1080));
+    EXPECT_FALSE(features.EncodeSupported(D3D12_VIDEO_ENCODER_CODEC_H264, D3D12_VIDEO_ENCODER_PROFILE_H264_HIGH, DXGI_FORMAT_NV12, 7680, 4320));
+    EXPECT_FALSE(features.EncodeSupported(D3D12_VIDEO_ENCODER_CODEC_HEVC, D3D12_VIDEO_ENCODER_PROFILE_HEVC_MAIN, DXGI_FORMAT_P010, 1920, 1080));
+    const D3DX12_VIDEO_ENCODE_CAPS* pEncode = features.FindEncodeCaps(D3D12_VIDEO_ENCODER_CODEC_HEVC, D3D12_VIDEO_ENCODER_PROFILE_HEVC_MAIN10, DXGI_FORMAT_P010);
+    ASSERT_NE(pEncode, nullptr);
+    EXPECT_EQ(pEncode->MaxLevel, static_cast<UINT>(D3D12_VIDEO_ENCODER_LEVELS_HEVC_51));
+    EXPECT_EQ(pEncode->MaxTier, static_cast<UINT>(D3D12_VIDEO_ENCODER_TIER_HEVC_HIGH));
+
+    EXPECT_EQ(device.m_CheckFeatureSupportCalls, Calls);
+}
+
+// A decoder capped at a common size between ladder steps still reports that size
+TEST(VideoFeatureSupportTest, CommonResolutionCaps)
+{
+    MockVideoDevice device;
+    device.m_DecodeProfiles.push_back({ D3D12_VIDEO_DECODE_PROFILE_H264, { DXGI_FORMAT_NV12 }, 4096, 2160 });
+    device.m_DecodeProfiles.push_back({ D3D12_VIDEO_DECODE_PROFILE_HEVC_MAIN, { DXGI_FORMAT_NV12 }, 7680, 4320 });
+    CD3DX12VideoFeatureSupport features;
+    ASSERT_EQ(features.Init(&device, LUID{ 1, 2 }), S_OK);
+
+    EXPECT_TRUE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_H264, DXGI_FORMAT_NV12, 3840, 2160));
+    EXPECT_TRUE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_H264, DXGI_FORMAT_NV12, 4096, 2160));
+    EXPECT_FALSE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_H264, DXGI_FORMAT_NV12, 4096, 2304));
+    const D3DX12_VIDEO_DECODE_CAPS* pDecode = features.FindDecodeCaps(D3D12_VIDEO_DECODE_PROFILE_H264, DXGI_FORMAT_NV12);
+    ASSERT_NE(pDecode, nullptr);
+    EXPECT_EQ(pDecode->MaxWidth, 4096u);
+    EXPECT_EQ(pDecode->MaxHeight, 2160u);
+
+    EXPECT_TRUE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_HEVC_MAIN, DXGI_FORMAT_NV12, 7680, 4320));
+    EXPECT_FALSE(features.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_HEVC_MAIN, DXGI_FORMAT_NV12, 8192, 4320));
+}
+
+// A serialized cache reloads for the same adapter and is rejected for another one
+TEST(VideoFeatureSupportTest, Serialization)
+{
+    MockVideoDevice device;
+    SetupVideoDevice(device);
+    CD3DX12VideoFeatureSupport features;
+    ASSERT_EQ(features.Init(&device, LUID{ 7, 0 }), S_OK);
+
+    SIZE_T Size = 0;
+    ASSERT_EQ(features.Serialize(nullptr, &Size), S_OK);
+    std::vector<BYTE> blob(Size);
+    ASSERT_EQ(features.Serialize(blob.data(), &Size), S_OK);
+
+    CD3DX12VideoFeatureSupport cached;
+    EXPECT_EQ(cached.Deserialize(blob.data(), blob.size(), LUID{ 8, 0 }), E_INVALIDARG);
+    EXPECT_EQ(cached.Deserialize(blob.data(), blob.size() - 1, LUID{ 7, 0 }), E_INVALIDARG);
+    ASSERT_EQ(cached.Deserialize(blob.data(), blob.size(), LUID{ 7, 0 }), S_OK);
+    EXPECT_EQ(cached.GetNumDecodeCaps(), features.GetNumDecodeCaps());
+    EXPECT_EQ(cached.GetNumEncodeCaps(), features.GetNumEncodeCaps());
+    EXPECT_TRUE(cached.DecodeSupported(D3D12_VIDEO_DECODE_PROFILE_HEVC_MAIN10, DXGI_FORMAT_P010, 3840, 2160));
+    EXPECT_TRUE(cached.EncodeSupported(D3D12_VIDEO_ENCODER_CODEC_H264, D3D12_VIDEO_ENCODER_PROFILE_H264_MAIN, DXGI_FORMAT_NV12, 1280, 720));
+}
+
+//------------------------------------------------------------------------------------------------
+// Video encoder DPB
+
+// I/P only: the sliding window drops the oldest reference and its slice is reused
+TEST(VideoEncoderDPBTest, H264SlidingWindow)
+{
+    D3D12_VIDEO_ENCODER_SEQUENCE_GOP_STRUCTURE_H264 H264Gop = { 0, 1, 0, 0, 0 };
+    D3D12_VIDEO_ENCODER_SEQUENCE_GOP_STRUCTURE Gop = {};
+    Gop.DataSize = sizeof(H264Gop);
+    Gop.pH264GroupOfPictures = &H264Gop;
+
+    CD3DX12VideoEncoderDPB dpb;
+    ID3D12Resource* pRecon = FakeResource(1);
+    D3D12_VIDEO_ENCODER_SEQUENCE_GOP_STRUCTURE EmptyGop = {};
+    EXPECT_EQ(dpb.Init(D3D12_VIDEO_ENCODER_CODEC_H264, EmptyGop, 2, 1, 0, pRecon), E_INVALIDARG);
+    EXPECT_EQ(dpb.Init(D3D12_VIDEO_ENCODER_CODEC_H264, Gop, 17, 1, 0, pRecon), E_INVALIDARG);
+    ASSERT_EQ(dpb.Init(D3D12_VIDEO_ENCODER_CODEC_H264, Gop, 2, 1, 0, pRecon), S_OK);
+
+    D3D12_VIDEO_ENCODER_PICTURE_CONTROL_DESC Control;
+    D3D12_VIDEO_ENCODER_RECONSTRUCTED_PICTURE Recon;
+    dpb.BeginFrame(&Control, &Recon);
+    const auto& PicData = dpb.GetH264PictureData();
+    EXPECT_EQ(Control.PictureControlCodecData.pH264PicData, &PicData);
+    EXPECT_EQ(PicData.FrameType, D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_IDR_FRAME);
+    EXPECT_EQ(Control.ReferenceFrames.NumTexture2Ds, 0u);
+    EXPECT_EQ(Recon.pReconstructedPicture, pRecon);
+    EXPECT_EQ(Recon.ReconstructedPictureSubresource, 0u);
+
+    dpb.BeginFrame(&Control, &Recon);
+    EXPECT_EQ(PicData.FrameType, D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_P_FRAME);
+    EXPECT_EQ(PicData.FrameDecodingOrderNumber, 1u);
+    EXPECT_EQ(PicData.PictureOrderCountNumber, 2u);
+    ASSERT_EQ(PicData.List0ReferenceFramesCount, 1u);
+    EXPECT_EQ(Recon.ReconstructedPictureSubresource, 1u);
+
+    // Two references, the most recent first in L0 (clamped to one entry)
+    dpb.BeginFrame(&Control, &Recon);
+    EXPECT_EQ(Control.ReferenceFrames.NumTexture2Ds, 2u);
+    ASSERT_EQ(PicData.List0ReferenceFramesCount, 1u);
+    EXPECT_EQ(PicData.pReferenceFramesReconPictureDescriptors[PicData.pList0ReferenceFrames[0]].FrameDecodingOrderNumber, 1u);
+    EXPECT_EQ(Recon.ReconstructedPictureSubresource, 2u);
+
+    // The IDR frame left the window, so its slice is reused
+    dpb.BeginFrame(&Control, &Recon);
+    EXPECT_EQ(dpb.GetNumReferences(), 2u);
+    EXPECT_EQ(Control.ReferenceFrames.pSubresources[0], 1u);
+    EXPECT_EQ(Control.ReferenceFrames.pSubresources[1], 2u);
+    EXPECT_EQ(Recon.ReconstructedPictureSubresource, 0u);
+    EXPECT_EQ(dpb.GetDisplayIndex(), 3u);
+
+    dpb.Reset();
+    dpb.BeginFrame(&Control, &Recon);
+    EXPECT_EQ(PicData.FrameType, D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_IDR_FRAME);
+    EXPECT_EQ(PicData.FrameDecodingOrderNumber, 0u);
+    EXPECT_EQ(dpb.GetDisplayIndex(), 4u);
+    EXPECT_EQ(dpb.GetNumReferences(), 0u);
+}
+
+// With B frames, anchors are coded first and B frames reference both neighbours
+TEST(VideoEncoderDPBTest, HEVCBFrames)
+{
+    D3D12_VIDEO_ENCODER_SEQUENCE_GOP_STRUCTURE_HEVC HEVCGop = { 7, 3, 0 };
+    D3D12_VIDEO_ENCODER_SEQUENCE_GOP_STRUCTURE Gop = {};
+    Gop.DataSize = sizeof(HEVCGop);
+    Gop.pHEVCGroupOfPictures = &HEVCGop;
+
+    CD3DX12VideoEncoderDPB dpb;
+    ASSERT_EQ(dpb.Init(D3D12_VIDEO_ENCODER_CODEC_HEVC, Gop, 2, 1, 1, FakeResource(1)), S_OK);
+
+    const UINT64 ExpectedDisplay[] = { 0, 3, 1, 2, 6, 4, 5, 7, 10 };
+    const D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC ExpectedType[] =
+    {
+        D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_IDR_FRAME, D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_P_FRAME,
+        D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_B_FRAME, D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_B_FRAME,
+        D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_P_FRAME, D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_B_FRAME,
+        D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_B_FRAME, D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_IDR_FRAME,
+        D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_P_FRAME,
+    };
+    const auto& PicData = dpb.GetHEVCPictureData();
+    for (UINT i = 0; i < _countof(ExpectedDisplay); ++i)
+    {
+        D3D12_VIDEO_ENCODER_PICTURE_CONTROL_DESC Control;
+        D3D12_VIDEO_ENCODER_RECONSTRUCTED_PICTURE Recon;
+        dpb.BeginFrame(&Control, &Recon);
+        EXPECT_EQ(dpb.GetDisplayIndex(), ExpectedDisplay[i]);
+        EXPECT_EQ(PicData.FrameType, ExpectedType[i]);
+
+        if (PicData.FrameType == D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC_B_FRAME)
+        {
+            EXPECT_FALSE(dpb.IsReference());
+            EXPECT_EQ(Recon.pReconstructedPicture, nullptr);
+            ASSERT_EQ(PicData.List0ReferenceFramesCount, 1u);
+            ASSERT_EQ(PicData.List1ReferenceFramesCount, 1u);
+            const auto* pDescriptors = PicData.pReferenceFramesReconPictureDescriptors;
+            EXPECT_LT(pDescriptors[PicData.pList0ReferenceFrames[0]].PictureOrderCountNumber, PicData.PictureOrderCountNumber);
+            EXPECT_GT(pDescriptors[PicData.pList1ReferenceFrames[0]].PictureOrderCountNumber, PicData.PictureOrderCountNumber);
+            EXPECT_TRUE(pDescriptors[PicData.pList0ReferenceFrames[0]].IsRefUsedByCurrentPic);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// Video decode bitstream pool
+
+// Bitstreams are written in place, wrap around the ring, and are recycled by fence value
+TEST(VideoDecodeBitstreamPoolTest, RingRecycling)
+{
+    std::vector<BYTE> mapped(4096);
+    CD3DX12VideoDecodeBitstreamPool pool;
+    EXPECT_EQ(pool.Init(FakeResource(1), mapped.data(), mapped.size(), 100), E_INVALIDARG);
+    ASSERT_EQ(pool.Init(FakeResource(1), mapped.data(), mapped.size()), S_OK);
+
+    // Gather two slices, then parse a third directly into mapped memory
+    D3D12_VIDEO_DECODE_COMPRESSED_BITSTREAM Bitstream;
+    ASSERT_TRUE(pool.Begin(1024));
+    const BYTE Slice[] = { 0, 0, 1, 0x65 };
+    EXPECT_TRUE(pool.Append(Slice, sizeof(Slice)));
+    EXPECT_TRUE(pool.Append(Slice, sizeof(Slice)));
+    memset(pool.GetWritePointer(), 0xab, 100);
+    pool.Advance(100);
+    EXPECT_FALSE(pool.Append(mapped.data(), 1024));
+    pool.End(1, &Bitstream);
+    EXPECT_EQ(Bitstream.pBuffer, FakeResource(1));
+    EXPECT_EQ(Bitstream.Offset, 0u);
+    EXPECT_EQ(Bitstream.Size, 108u);
+    EXPECT_EQ(mapped[4], 0u);
+    EXPECT_EQ(mapped[7], 0x65u);
+    EXPECT_EQ(mapped[107], 0xabu);
+
+    // Unused reserved space is returned, so the next bitstream starts at the next aligned offset
+    ASSERT_TRUE(pool.Begin(2048));
+    pool.Advance(2000);
+    pool.End(2, &Bitstream);
+    EXPECT_EQ(Bitstream.Offset, 256u);
+
+    // 1792 bytes are left at the end and only [0, 256) would free up at the front
+    EXPECT_FALSE(pool.Begin(2048));
+    pool.Recycle(1);
+    EXPECT_EQ(pool.GetNumInFlight(), 1u);
+    EXPECT_TRUE(pool.Begin(1792));
+    pool.Advance(1792);
+    pool.End(3, &Bitstream);
+    EXPECT_EQ(Bitstream.Offset, 2304u);
+
+    // The ring wraps once the front has been recycled
+    EXPECT_FALSE(pool.Begin(512));
+    pool.Recycle(2);
+    ASSERT_TRUE(pool.Begin(512));
+    pool.End(4, &Bitstream);
+    EXPECT_EQ(Bitstream.Offset, 0u);
+    EXPECT_EQ(Bitstream.Size, 0u);
+
+    pool.Recycle(4);
+    EXPECT_EQ(pool.GetNumInFlight(), 0u);
+    EXPECT_TRUE(pool.Begin(4096));
+    pool.Cancel();
+    EXPECT_FALSE(pool.Begin(4097));
+}
+
+// The builder fills the fixed argument array and rejects arguments past the limit
+TEST(VideoDecodeBitstreamPoolTest, InputStreamArguments)
+{
+    const D3D12_VIDEO_DECODE_COMPRESSED_BITSTREAM Bitstream = { FakeResource(1), 256, 1000 };
+    CD3DX12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS Args(Bitstream, nullptr);
+    EXPECT_EQ(Args.CompressedBitstream.Offset, 256u);
+
+    // Stand-ins for the codec's DXVA structures
+    struct PictureParameters { UINT Data[32]; } PicParams = {};
+    struct SliceControl { UINT Offset; UINT Size; USHORT Flags; } Slices[3] = {};
+    EXPECT_TRUE(Args.AddFrameArgument(D3D12_VIDEO_DECODE_ARGUMENT_TYPE_PICTURE_PARAMETERS, PicParams));
+    EXPECT_TRUE(Args.AddSliceControl(Slices, 3));
+    EXPECT_EQ(Args.NumFrameArguments, 2u);
+    EXPECT_EQ(Args.FrameArguments[0].Size, sizeof(PicParams));
+    EXPECT_EQ(Args.FrameArguments[1].Type, D3D12_VIDEO_DECODE_ARGUMENT_TYPE_SLICE_CONTROL);
+    EXPECT_EQ(Args.FrameArguments[1].Size, 3 * sizeof(SliceControl));
+    EXPECT_EQ(Args.FrameArguments[1].pData, Slices);
+
+    for (UINT i = 2; i < D3D12_VIDEO_DECODE_MAX_ARGUMENTS; ++i)
+    {
+        EXPECT_TRUE(Args.AddSliceControl(Slices, 1));
+    }
+    EXPECT_FALSE(Args.AddSliceControl(Slices, 1));
+}
+
+//------------------------------------------------------------------------------------------------
+// Heaps are created once, pairs cycle through the slots, and completed vectors point into the
+// mapped readback buffer.
+TEST(VideoMotionEstimationBatchTest, SlotRing)
+{
+    MockVideoDevice device;
+    D3D12_VIDEO_MOTION_ESTIMATOR_DESC Desc = { 0, DXGI_FORMAT_NV12,
+        D3D12_VIDEO_MOTION_ESTIMATOR_SEARCH_BLOCK_SIZE_16X16, D3D12_VIDEO_MOTION_ESTIMATOR_VECTOR_PRECISION_QUARTER_PEL,
+        { 1920, 1080, 64, 64 } };
+
+    {
+        CD3DX12VideoMotionEstimationBatch batch;
+        Desc.InputFormat = DXGI_FORMAT_P010;
+        EXPECT_EQ(batch.Init(&device, Desc, 3), E_INVALIDARG);
+        Desc.InputFormat = DXGI_FORMAT_NV12;
+        ASSERT_EQ(batch.Init(&device, Desc, 3), S_OK);
+        EXPECT_EQ(device.m_CreateMotionVectorHeapCalls, 3u);
+        EXPECT_EQ(device.m_LiveMotionVectorHeaps, 3u);
+
+        const D3D12_RESOURCE_DESC Resolved = batch.GetResolvedTextureDesc();
+        EXPECT_EQ(Resolved.Format, DXGI_FORMAT_R16G16_SINT);
+        EXPECT_EQ(Resolved.Width, 120u);
+        EXPECT_EQ(Resolved.Height, 68u);
+        EXPECT_EQ(Resolved.DepthOrArraySize, 3u);
+        // 120 blocks * 4 bytes pitched to 512, times 68 rows
+        EXPECT_EQ(batch.GetReadbackBufferSize(), 3u * 512u * 68u);
+
+        std::vector<BYTE> mapped(static_cast<size_t>(batch.GetReadbackBufferSize()));
+        batch.SetOutputResources(FakeResource(10), FakeResource(11), mapped.data());
+
+        const D3DX12_VIDEO_MOTION_ESTIMATION_PAIR Pair = { FakeResource(1), 0, FakeResource(2), 0, 1280, 720 };
+        D3DX12_VIDEO_MOTION_ESTIMATION_PAIR TooSmall = Pair;
+        TooSmall.PixelWidth = 32;
+        EXPECT_FALSE(batch.AddPair(TooSmall));
+        EXPECT_TRUE(batch.AddPair(Pair));
+        EXPECT_TRUE(batch.AddPair(Pair));
+        batch.Submit(1);
+        EXPECT_TRUE(batch.AddPair(Pair));
+        EXPECT_FALSE(batch.AddPair(Pair));
+        EXPECT_EQ(batch.GetNumPending(), 1u);
+        batch.Submit(2);
+
+        D3DX12_VIDEO_MOTION_VECTORS Vectors;
+        EXPECT_FALSE(batch.GetCompletedPair(0, &Vectors));
+        ASSERT_TRUE(batch.GetCompletedPair(1, &Vectors));
+        EXPECT_EQ(Vectors.PairIndex, 0u);
+        EXPECT_EQ(reinterpret_cast<const BYTE*>(Vectors.pData), mapped.data());
+        EXPECT_EQ(Vectors.RowPitch, 512u);
+        EXPECT_EQ(Vectors.BlocksWide, 80u);
+        EXPECT_EQ(Vectors.BlocksHigh, 45u);
+        batch.ReleasePair();
+        ASSERT_TRUE(batch.GetCompletedPair(1, &Vectors));
+        EXPECT_EQ(reinterpret_cast<const BYTE*>(Vectors.pData), mapped.data() + 512 * 68);
+        batch.ReleasePair();
+        EXPECT_FALSE(batch.GetCompletedPair(1, &Vectors));
+
+        // The released slot is reused without creating another heap
+        EXPECT_TRUE(batch.AddPair(Pair));
+        EXPECT_EQ(device.m_CreateMotionVectorHeapCalls, 3u);
+    }
+    EXPECT_EQ(device.m_LiveMotionVectorHeaps, 0u);
+}
+
+// Estimate and resolve arguments of a pending pair refer to its slot's heap and texture slice
+TEST(VideoMotionEstimationBatchTest, PairArguments)
+{
+    MockVideoDevice device;
+    const D3D12_VIDEO_MOTION_ESTIMATOR_DESC Desc = { 0, DXGI_FORMAT_NV12,
+        D3D12_VIDEO_MOTION_ESTIMATOR_SEARCH_BLOCK_SIZE_8X8, D3D12_VIDEO_MOTION_ESTIMATOR_VECTOR_PRECISION_QUARTER_PEL,
+        { 640, 480, 32, 32 } };
+    CD3DX12VideoMotionEstimationBatch batch;
+    ASSERT_EQ(batch.Init(&device, Desc, 2), S_OK);
+    batch.SetOutputResources(FakeResource(10), FakeResource(11), nullptr);
+
+    const D3DX12_VIDEO_MOTION_ESTIMATION_PAIR First = { FakeResource(1), 0, FakeResource(2), 1, 640, 480 };
+    const D3DX12_VIDEO_MOTION_ESTIMATION_PAIR Second = { FakeResource(3), 2, FakeResource(1), 0, 320, 240 };
+    ASSERT_TRUE(batch.AddPair(First));
+    batch.Submit(1);
+    ASSERT_TRUE(batch.AddPair(Second));
+
+    D3D12_VIDEO_MOTION_ESTIMATOR_OUTPUT EstimateOutput;
+    D3D12_VIDEO_MOTION_ESTIMATOR_INPUT EstimateInput;
+    D3D12_RESOLVE_VIDEO_MOTION_VECTOR_HEAP_OUTPUT ResolveOutput;
+    D3D12_RESOLVE_VIDEO_MOTION_VECTOR_HEAP_INPUT ResolveInput;
+    batch.GetPairArguments(0, &EstimateOutput, &EstimateInput, &ResolveOutput, &ResolveInput);
+    EXPECT_NE(EstimateOutput.pMotionVectorHeap, nullptr);
+    EXPECT_EQ(EstimateInput.pInputTexture2D, FakeResource(3));
+    EXPECT_EQ(EstimateInput.InputSubresourceIndex, 2u);
+    EXPECT_EQ(EstimateInput.pReferenceTexture2D, FakeResource(1));
+    EXPECT_EQ(EstimateInput.pHintMotionVectorHeap, nullptr);
+    EXPECT_EQ(ResolveOutput.pMotionVectorTexture2D, FakeResource(10));
+    EXPECT_EQ(ResolveOutput.MotionVectorCoordinate.SubresourceIndex, 1u);
+    EXPECT_EQ(ResolveInput.pMotionVectorHeap, EstimateOutput.pMotionVectorHeap);
+    EXPECT_EQ(ResolveInput.PixelWidth, 320u);
+    EXPECT_EQ(ResolveInput.PixelHeight, 240u);
+    EXPECT_EQ(batch.GetResolvedTextureDesc().Width, 80u);
+}
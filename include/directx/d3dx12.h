@@ -1840,6 +1840,23 @@ inline UINT8 D3D12GetFormatPlaneCount(
     return formatInfo.PlaneCount;
 }
 
+//------------------------------------------------------------------------------------------------
+// Opt-in alternative to D3D12GetFormatPlaneCount for hot loops: formats of the property format
+// table are resolved without a call into the driver, and only formats unknown to the table are
+// queried from the device. Unlike D3D12GetFormatPlaneCount, formats of the table the device does
+// not support still report their plane count. Requires linking the property format table.
+inline UINT8 D3D12GetFormatPlaneCountFromTable(
+    _In_ ID3D12Device* pDevice,
+    DXGI_FORMAT Format
+    ) noexcept
+{
+    if (Format != DXGI_FORMAT_UNKNOWN && D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExistsInHeader(Format))
+    {
+        return D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetPlaneCount(Format);
+    }
+    return D3D12GetFormatPlaneCount(pDevice, Format);
+}
+
 //------------------------------------------------------------------------------------------------
 struct CD3DX12_RESOURCE_DESC : public D3D12_RESOURCE_DESC
 {
@@ -1935,6 +1952,10 @@ struct CD3DX12_RESOURCE_DESC : public D3D12_RESOURCE_DESC
     { return D3D12GetFormatPlaneCount(pDevice, Format); }
     inline UINT Subresources(_In_ ID3D12Device* pDevice) const noexcept
     { return static_cast<UINT>(MipLevels) * ArraySize() * PlaneCount(pDevice); }
+    inline UINT8 PlaneCountFromTable(_In_ ID3D12Device* pDevice) const noexcept
+    { return D3D12GetFormatPlaneCountFromTable(pDevice, Format); }
+    inline UINT SubresourcesFromTable(_In_ ID3D12Device* pDevice) const noexcept
+    { return static_cast<UINT>(MipLevels) * ArraySize() * PlaneCountFromTable(pDevice); }
     inline UINT CalcSubresource(UINT MipSlice, UINT ArraySlice, UINT PlaneSlice) noexcept
     { return D3D12CalcSubresource(MipSlice, ArraySlice, PlaneSlice, MipLevels, ArraySize()); }
 };
@@ -2074,6 +2095,10 @@ struct CD3DX12_RESOURCE_DESC1 : public D3D12_RESOURCE_DESC1
     { return D3D12GetFormatPlaneCount(pDevice, Format); }
     inline UINT Subresources(_In_ ID3D12Device* pDevice) const noexcept
     { return static_cast<UINT>(MipLevels) * ArraySize() * PlaneCount(pDevice); }
+    inline UINT8 PlaneCountFromTable(_In_ ID3D12Device* pDevice) const noexcept
+    { return D3D12GetFormatPlaneCountFromTable(pDevice, Format); }
+    inline UINT SubresourcesFromTable(_In_ ID3D12Device* pDevice) const noexcept
+    { return static_cast<UINT>(MipLevels) * ArraySize() * PlaneCountFromTable(pDevice); }
     inline UINT CalcSubresource(UINT MipSlice, UINT ArraySlice, UINT PlaneSlice) noexcept
     { return D3D12CalcSubresource(MipSlice, ArraySlice, PlaneSlice, MipLevels, ArraySize()); }
 };
@@ -2429,6 +2454,120 @@ inline UINT64 UpdateSubresources(
     return UpdateSubresources(pCmdList, pDestinationResource, pIntermediate, FirstSubresource, NumSubresources, RequiredSize, Layouts, NumRows, RowSizesInBytes, pResourceData, pSrcData);
 }
 
+//------------------------------------------------------------------------------------------------
+// Records the copy of subresources into a readback buffer at the given footprints; the reverse of
+// UpdateSubresources. All arrays must be populated (e.g. by calling GetCopyableFootprints), and
+// the same layouts are used to unpack the data once the copy has completed.
+inline UINT64 ReadbackSubresources(
+    _In_ ID3D12GraphicsCommandList* pCmdList,
+    _In_ ID3D12Resource* pSourceResource,
+    _In_ ID3D12Resource* pReadback,
+    _In_range_(0,D3D12_REQ_SUBRESOURCES) UINT FirstSubresource,
+    _In_range_(0,D3D12_REQ_SUBRESOURCES-FirstSubresource) UINT NumSubresources,
+    UINT64 RequiredSize,
+    _In_reads_(NumSubresources) const D3D12_PLACED_SUBRESOURCE_FOOTPRINT* pLayouts) noexcept
+{
+    // Minor validation
+    const auto ReadbackDesc = pReadback->GetDesc();
+    const auto SourceDesc = pSourceResource->GetDesc();
+    if (ReadbackDesc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER ||
+        ReadbackDesc.Width < RequiredSize + pLayouts[0].Offset ||
+        RequiredSize > SIZE_T(-1) ||
+        (SourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER &&
+            (FirstSubresource != 0 || NumSubresources != 1)))
+    {
+        return 0;
+    }
+
+    if (SourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        pCmdList->CopyBufferRegion(
+            pReadback, pLayouts[0].Offset, pSourceResource, 0, pLayouts[0].Footprint.Width);
+    }
+    else
+    {
+        for (UINT i = 0; i < NumSubresources; ++i)
+        {
+            const CD3DX12_TEXTURE_COPY_LOCATION Dst(pReadback, pLayouts[i]);
+            const CD3DX12_TEXTURE_COPY_LOCATION Src(pSourceResource, i + FirstSubresource);
+            pCmdList->CopyTextureRegion(&Dst, 0, 0, 0, &Src, nullptr);
+        }
+    }
+    return RequiredSize;
+}
+
+//------------------------------------------------------------------------------------------------
+// Strips the row pitch of rows [FirstRow, FirstRow + NumRowsToCopy) of a read back subresource,
+// counting rows across depth slices. Disjoint row ranges can be unpacked on different threads.
+inline void UnpackSubresourceRows(
+    _In_ const void* pReadbackData,
+    _In_ const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout,
+    UINT NumRows,
+    UINT64 RowSizeInBytes,
+    _In_ const D3D12_MEMCPY_DEST* pDestData,
+    UINT FirstRow,
+    UINT NumRowsToCopy) noexcept
+{
+    const BYTE* pSrc = static_cast<const BYTE*>(pReadbackData) + Layout.Offset;
+    const UINT EndRow = FirstRow + NumRowsToCopy;
+    for (UINT Row = FirstRow; Row < EndRow; ++Row)
+    {
+        const UINT z = Row / NumRows;
+        const UINT y = Row % NumRows;
+        memcpy(static_cast<BYTE*>(pDestData->pData) + pDestData->SlicePitch * z + pDestData->RowPitch * y,
+            pSrc + SIZE_T(Layout.Footprint.RowPitch) * (SIZE_T(NumRows) * z + y),
+            static_cast<SIZE_T>(RowSizeInBytes));
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// Strips the row pitch of read back subresources into the destination buffers. pReadbackData
+// points at the mapped readback buffer the layouts are relative to.
+inline void UnpackSubresources(
+    _In_ const void* pReadbackData,
+    UINT NumSubresources,
+    _In_reads_(NumSubresources) const D3D12_PLACED_SUBRESOURCE_FOOTPRINT* pLayouts,
+    _In_reads_(NumSubresources) const UINT* pNumRows,
+    _In_reads_(NumSubresources) const UINT64* pRowSizesInBytes,
+    _In_reads_(NumSubresources) const D3D12_MEMCPY_DEST* pDestData) noexcept
+{
+    for (UINT i = 0; i < NumSubresources; ++i)
+    {
+        const D3D12_SUBRESOURCE_DATA SrcData = { static_cast<const BYTE*>(pReadbackData) + pLayouts[i].Offset,
+            LONG_PTR(pLayouts[i].Footprint.RowPitch), LONG_PTR(pLayouts[i].Footprint.RowPitch) * pNumRows[i] };
+        MemcpySubresource(&pDestData[i], &SrcData, static_cast<SIZE_T>(pRowSizesInBytes[i]), pNumRows[i], pLayouts[i].Footprint.Depth);
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// Maps the readback buffer once the copy recorded by ReadbackSubresources has completed, unpacks
+// the subresources and unmaps it
+inline HRESULT ReadbackSubresources(
+    _In_ ID3D12Resource* pReadback,
+    UINT NumSubresources,
+    UINT64 RequiredSize,
+    _In_reads_(NumSubresources) const D3D12_PLACED_SUBRESOURCE_FOOTPRINT* pLayouts,
+    _In_reads_(NumSubresources) const UINT* pNumRows,
+    _In_reads_(NumSubresources) const UINT64* pRowSizesInBytes,
+    _In_reads_(NumSubresources) const D3D12_MEMCPY_DEST* pDestData) noexcept
+{
+    if (RequiredSize > SIZE_T(-1) || pLayouts[0].Offset > SIZE_T(-1) - RequiredSize)
+    {
+        return E_INVALIDARG;
+    }
+    const D3D12_RANGE ReadRange = { static_cast<SIZE_T>(pLayouts[0].Offset), static_cast<SIZE_T>(pLayouts[0].Offset + RequiredSize) };
+    void* pData = nullptr;
+    const HRESULT hr = pReadback->Map(0, &ReadRange, &pData);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+    UnpackSubresources(pData, NumSubresources, pLayouts, pNumRows, pRowSizesInBytes, pDestData);
+    const D3D12_RANGE WrittenRange = { 0, 0 };
+    pReadback->Unmap(0, &WrittenRange);
+    return S_OK;
+}
+
 //------------------------------------------------------------------------------------------------
 constexpr bool D3D12IsLayoutOpaque( D3D12_TEXTURE_LAYOUT Layout ) noexcept
 { return Layout == D3D12_TEXTURE_LAYOUT_UNKNOWN || Layout == D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE; }
@@ -5450,6 +5589,16 @@ inline HRESULT CD3DX12FeatureSupport::QueryProtectedResourceSessionTypes(UINT No
     return result;
 }
 
+#undef FEATURE_SUPPORT_GET
+#undef FEATURE_SUPPORT_GET_NAME
+#undef FEATURE_SUPPORT_GET_NODE_INDEXED
+#undef FEATURE_SUPPORT_GET_NODE_INDEXED_NAME
+
+// end CD3DX12FeatureSupport
+
+#endif // !D3DX12_NO_CHECK_FEATURE_SUPPORT_CLASS
+
+//------------------------------------------------------------------------------------------------
 template< typename T >
 inline T D3DX12Align(T uValue, T uAlign)
 {
@@ -5541,8 +5690,9 @@ inline bool D3DX12GetCopyableFootprints(
 
     const DXGI_FORMAT Format = pResourceDesc.Format;
 
-    CD3DX12_RESOURCE_DESC1 resourceDesc;
-    D3DX12ConditionallyExpandAPIDesc(resourceDesc, &pResourceDesc);
+    CD3DX12_RESOURCE_DESC1 LclDesc;
+    const CD3DX12_RESOURCE_DESC1& resourceDesc = *static_cast<const CD3DX12_RESOURCE_DESC1*>(
+        D3DX12ConditionallyExpandAPIDesc(LclDesc, &pResourceDesc));
 
     // Check if its a valid format
     D3DX12_ASSERT(D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExists(Format));
@@ -5703,14 +5853,4449 @@ inline bool D3DX12GetCopyableFootprints(
         pRowSizeInBytes,
         pTotalBytes);
 }
-#undef FEATURE_SUPPORT_GET
-#undef FEATURE_SUPPORT_GET_NAME
-#undef FEATURE_SUPPORT_GET_NODE_INDEXED
-#undef FEATURE_SUPPORT_GET_NODE_INDEXED_NAME
 
-// end CD3DX12FeatureSupport
+#ifndef D3DX12_NO_TRANSIENT_ALIASING_HELPERS
 
-#endif // !D3DX12_NO_CHECK_FEATURE_SUPPORT_CLASS
+//================================================================================================
+// D3DX12 Transient Resource Aliasing Helpers
+//
+// Plans placement of transient resources in a single heap, so resources whose lifetimes (expressed
+// as inclusive [FirstPass, LastPass] ranges of frame graph pass indices) do not overlap share memory.
+// Uses STL
+//
+// Add every transient resource with AddResource(), call Plan(), then create the heap with
+// GetHeapSize()/GetHeapAlignment() and place each resource at GetHeapOffset(). Before each pass,
+// record the barriers returned by GetAliasingBarriers() for that pass. A resource that has just been
+// aliased in has undefined contents, so its first use must be a clear, a DiscardResource, or a full
+// overwrite.
+//
+//================================================================================================
+#include <algorithm>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+// Device-free estimate of the heap footprint of a resource, based on the copyable layout of all of
+// its subresources. This is not guaranteed to match ID3D12Device::GetResourceAllocationInfo, which
+// accounts for driver-specific tiling and padding; pass the device-reported value to
+// CD3DX12TransientAliasingPlanner::AddResource when exact sizes are required.
+inline D3D12_RESOURCE_ALLOCATION_INFO D3DX12EstimateResourceAllocationInfo(
+    _In_ const D3D12_RESOURCE_DESC1& Desc)
+{
+    CD3DX12_RESOURCE_DESC1 LclDesc;
+    const CD3DX12_RESOURCE_DESC1& ExpandedDesc = *static_cast<const CD3DX12_RESOURCE_DESC1*>(
+        D3DX12ConditionallyExpandAPIDesc(LclDesc, &Desc));
+
+    D3D12_RESOURCE_ALLOCATION_INFO Info;
+    Info.Alignment = ExpandedDesc.Alignment;
+    if (ExpandedDesc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        Info.SizeInBytes = D3DX12Align<UINT64>(ExpandedDesc.Width, Info.Alignment);
+        return Info;
+    }
+
+    const UINT NumSubresources = static_cast<UINT>(ExpandedDesc.MipLevels) * ExpandedDesc.ArraySize()
+        * D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetPlaneCount(ExpandedDesc.Format);
+    UINT64 TotalBytes = 0;
+    if (!D3DX12GetCopyableFootprints(ExpandedDesc, 0, NumSubresources, 0, nullptr, nullptr, nullptr, &TotalBytes))
+    {
+        Info.SizeInBytes = UINT64_MAX;
+        return Info;
+    }
+    Info.SizeInBytes = D3DX12Align<UINT64>(TotalBytes * ExpandedDesc.SampleDesc.Count, Info.Alignment);
+    return Info;
+}
+
+//------------------------------------------------------------------------------------------------
+// An aliasing barrier required before pass Pass. Resources are identified by the index returned from
+// CD3DX12TransientAliasingPlanner::AddResource. Before is UINT_MAX when more than one resource
+// previously occupied the memory, in which case a NULL pResourceBefore must be used.
+struct D3DX12_TRANSIENT_ALIASING_BARRIER
+{
+    UINT Pass;
+    UINT Before;
+    UINT After;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12TransientAliasingPlanner
+{
+public:
+    CD3DX12TransientAliasingPlanner() = default;
+
+    // Returns the index used to identify the resource in the plan.
+    UINT AddResource(const D3D12_RESOURCE_ALLOCATION_INFO& AllocationInfo, UINT FirstPass, UINT LastPass)
+    {
+        TRANSIENT_RESOURCE Resource = {};
+        Resource.SizeInBytes = AllocationInfo.SizeInBytes;
+        Resource.Alignment = AllocationInfo.Alignment ? AllocationInfo.Alignment : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        Resource.FirstPass = FirstPass;
+        Resource.LastPass = LastPass;
+        m_Resources.push_back(Resource);
+        m_bPlanned = false;
+        return static_cast<UINT>(m_Resources.size() - 1);
+    }
+    UINT AddResource(const D3D12_RESOURCE_DESC1& Desc, UINT FirstPass, UINT LastPass)
+    {
+        return AddResource(D3DX12EstimateResourceAllocationInfo(Desc), FirstPass, LastPass);
+    }
+    UINT AddResource(const D3D12_RESOURCE_DESC& Desc, UINT FirstPass, UINT LastPass)
+    {
+        return AddResource(CD3DX12_RESOURCE_DESC1(Desc), FirstPass, LastPass);
+    }
+
+    void Reset() noexcept
+    {
+        m_Resources.clear();
+        m_Barriers.clear();
+        m_HeapSize = 0;
+        m_HeapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        m_bPlanned = false;
+    }
+
+    // Assigns a heap offset to every resource and computes the aliasing barriers.
+    // Returns E_INVALIDARG if a resource has FirstPass > LastPass or an unknown size.
+    HRESULT Plan()
+    {
+        m_Barriers.clear();
+        m_HeapSize = 0;
+        m_HeapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        m_bPlanned = false;
+
+        const UINT NumResources = static_cast<UINT>(m_Resources.size());
+        for (const auto& Resource : m_Resources)
+        {
+            if (Resource.FirstPass > Resource.LastPass || Resource.SizeInBytes == UINT64_MAX
+                || (Resource.Alignment & (Resource.Alignment - 1)) != 0)
+            {
+                return E_INVALIDARG;
+            }
+        }
+
+        // Place the largest resources first; this is the classic greedy approach for interval
+        // packing and keeps small, short-lived resources filling the gaps left by large ones.
+        std::vector<UINT> Order(NumResources);
+        for (UINT i = 0; i < NumResources; ++i)
+        {
+            Order[i] = i;
+        }
+        std::sort(Order.begin(), Order.end(), [this](UINT a, UINT b)
+        {
+            const auto& A = m_Resources[a];
+            const auto& B = m_Resources[b];
+            if (A.SizeInBytes != B.SizeInBytes) return A.SizeInBytes > B.SizeInBytes;
+            if (A.FirstPass != B.FirstPass) return A.FirstPass < B.FirstPass;
+            return a < b;
+        });
+
+        std::vector<UINT> Placed;
+        Placed.reserve(NumResources);
+        std::vector<UINT> Live;
+        for (UINT Index : Order)
+        {
+            auto& Resource = m_Resources[Index];
+
+            // Collect the memory ranges of already-placed resources that are alive at the same time.
+            Live.clear();
+            for (UINT Other : Placed)
+            {
+                if (LifetimesOverlap(Resource, m_Resources[Other]))
+                {
+                    Live.push_back(Other);
+                }
+            }
+            std::sort(Live.begin(), Live.end(), [this](UINT a, UINT b)
+            { return m_Resources[a].HeapOffset < m_Resources[b].HeapOffset; });
+
+            // First fit: the lowest aligned offset that does not intersect any live range.
+            UINT64 Offset = 0;
+            for (UINT Other : Live)
+            {
+                const auto& O = m_Resources[Other];
+                if (Offset + Resource.SizeInBytes <= O.HeapOffset)
+                {
+                    break;
+                }
+                Offset = (std::max)(Offset, D3DX12Align<UINT64>(O.HeapOffset + O.SizeInBytes, Resource.Alignment));
+            }
+            Resource.HeapOffset = Offset;
+            Placed.push_back(Index);
+
+            m_HeapSize = (std::max)(m_HeapSize, Offset + Resource.SizeInBytes);
+            m_HeapAlignment = (std::max)(m_HeapAlignment, Resource.Alignment);
+        }
+        m_HeapSize = D3DX12Align<UINT64>(m_HeapSize, m_HeapAlignment);
+
+        // A resource needs an aliasing barrier when it reuses memory last occupied by a resource
+        // whose lifetime has already ended. Predecessors whose overlap with the new resource was
+        // entirely taken over by a later resource are already covered by that resource's barrier.
+        std::vector<UINT> Predecessors;
+        for (UINT After = 0; After < NumResources; ++After)
+        {
+            const auto& A = m_Resources[After];
+            Predecessors.clear();
+            for (UINT Other = 0; Other < NumResources; ++Other)
+            {
+                const auto& O = m_Resources[Other];
+                if (Other != After && O.LastPass < A.FirstPass && MemoryOverlaps(A, O))
+                {
+                    Predecessors.push_back(Other);
+                }
+            }
+            UINT Before = UINT_MAX;
+            UINT NumPredecessors = 0;
+            for (UINT Other : Predecessors)
+            {
+                const auto& O = m_Resources[Other];
+                const UINT64 Start = (std::max)(A.HeapOffset, O.HeapOffset);
+                const UINT64 End = (std::min)(A.HeapOffset + A.SizeInBytes, O.HeapOffset + O.SizeInBytes);
+                bool bSuperseded = false;
+                for (UINT Later : Predecessors)
+                {
+                    const auto& L = m_Resources[Later];
+                    if (L.FirstPass > O.LastPass && L.HeapOffset <= Start && L.HeapOffset + L.SizeInBytes >= End)
+                    {
+                        bSuperseded = true;
+                        break;
+                    }
+                }
+                if (!bSuperseded)
+                {
+                    Before = Other;
+                    ++NumPredecessors;
+                }
+            }
+            if (NumPredecessors != 0)
+            {
+                D3DX12_TRANSIENT_ALIASING_BARRIER Barrier;
+                Barrier.Pass = A.FirstPass;
+                Barrier.Before = NumPredecessors == 1 ? Before : UINT_MAX;
+                Barrier.After = After;
+                m_Barriers.push_back(Barrier);
+            }
+        }
+        std::stable_sort(m_Barriers.begin(), m_Barriers.end(),
+            [](const D3DX12_TRANSIENT_ALIASING_BARRIER& a, const D3DX12_TRANSIENT_ALIASING_BARRIER& b)
+            { return a.Pass < b.Pass; });
+
+        m_bPlanned = true;
+        return S_OK;
+    }
+
+    bool IsPlanned() const noexcept { return m_bPlanned; }
+    UINT GetNumResources() const noexcept { return static_cast<UINT>(m_Resources.size()); }
+    UINT64 GetHeapSize() const noexcept { return m_HeapSize; }
+    UINT64 GetHeapAlignment() const noexcept { return m_HeapAlignment; }
+    UINT64 GetHeapOffset(UINT Index) const noexcept { return m_Resources[Index].HeapOffset; }
+    UINT64 GetSizeInBytes(UINT Index) const noexcept { return m_Resources[Index].SizeInBytes; }
+
+    // Memory that would be needed without aliasing, for comparison with GetHeapSize()
+    UINT64 GetUnaliasedSize() const noexcept
+    {
+        UINT64 Size = 0;
+        for (const auto& Resource : m_Resources)
+        {
+            Size = D3DX12Align<UINT64>(Size, Resource.Alignment) + Resource.SizeInBytes;
+        }
+        return Size;
+    }
+
+    UINT GetNumAliasingBarriers() const noexcept { return static_cast<UINT>(m_Barriers.size()); }
+    const D3DX12_TRANSIENT_ALIASING_BARRIER* GetAliasingBarriers() const noexcept { return m_Barriers.data(); }
+
+    // Fills pBarriers with the aliasing barriers for the given pass, using ppResources (indexed the same
+    // way as AddResource) for the resource pointers. Returns the number of barriers required, which may
+    // exceed MaxBarriers, in which case only the first MaxBarriers are written.
+    UINT GetAliasingBarriers(
+        UINT Pass,
+        _In_reads_(GetNumResources()) ID3D12Resource* const* ppResources,
+        _Out_writes_opt_(MaxBarriers) D3D12_RESOURCE_BARRIER* pBarriers,
+        UINT MaxBarriers) const noexcept
+    {
+        UINT Count = 0;
+        for (const auto& Barrier : m_Barriers)
+        {
+            if (Barrier.Pass != Pass)
+            {
+                continue;
+            }
+            if (pBarriers && Count < MaxBarriers)
+            {
+                pBarriers[Count] = CD3DX12_RESOURCE_BARRIER::Aliasing(
+                    Barrier.Before == UINT_MAX ? nullptr : ppResources[Barrier.Before],
+                    ppResources[Barrier.After]);
+            }
+            ++Count;
+        }
+        return Count;
+    }
+
+private:
+    struct TRANSIENT_RESOURCE
+    {
+        UINT64 SizeInBytes;
+        UINT64 Alignment;
+        UINT64 HeapOffset;
+        UINT FirstPass;
+        UINT LastPass;
+    };
+
+    static bool LifetimesOverlap(const TRANSIENT_RESOURCE& a, const TRANSIENT_RESOURCE& b) noexcept
+    { return a.FirstPass <= b.LastPass && b.FirstPass <= a.LastPass; }
+    static bool MemoryOverlaps(const TRANSIENT_RESOURCE& a, const TRANSIENT_RESOURCE& b) noexcept
+    { return a.HeapOffset < b.HeapOffset + b.SizeInBytes && b.HeapOffset < a.HeapOffset + a.SizeInBytes; }
+
+    std::vector<TRANSIENT_RESOURCE> m_Resources;
+    std::vector<D3DX12_TRANSIENT_ALIASING_BARRIER> m_Barriers;
+    UINT64 m_HeapSize = 0;
+    UINT64 m_HeapAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    bool m_bPlanned = false;
+};
+
+#endif // !D3DX12_NO_TRANSIENT_ALIASING_HELPERS
+
+#ifndef D3DX12_NO_STANDARD_SWIZZLE_HELPERS
+
+//================================================================================================
+// D3DX12 Standard Swizzle Helpers
+//
+// CPU encoder/decoder for the D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE layout of 2D, single
+// sampled, non-planar textures. On adapters reporting StandardSwizzle64KBSupported (typically UMA),
+// this lets texel data be written straight into a mapped resource in its final layout instead of
+// going through an upload buffer and a GPU copy.
+//
+// A subresource is a row-major grid of 64KB tiles, each covering the tile shape reported by
+// D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetTileShape. Inside a tile, the byte address of an element
+// is formed by interleaving the bits of its x and y coordinates; the interleave depends only on the
+// element size. The offset of each subresource within the resource, including the packed mip tail,
+// must be obtained from ID3D12Device::GetResourceTiling.
+//
+//================================================================================================
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12StandardSwizzle64KB
+{
+public:
+    CD3DX12StandardSwizzle64KB() = default;
+
+    // Returns E_INVALIDARG for formats, dimensions and sample counts the standard swizzle helpers do
+    // not cover (buffers, 1D and 3D textures, MSAA, planar and video formats, 96-bit formats).
+    HRESULT Init(DXGI_FORMAT Format, D3D12_RESOURCE_DIMENSION Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D, UINT SampleCount = 1)
+    {
+        m_BytesPerElement = 0;
+        if (Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D || SampleCount != 1
+            || !D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExists(Format)
+            || Format == DXGI_FORMAT_UNKNOWN
+            || D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::Planar(Format)
+            || D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::YUV(Format))
+        {
+            return E_INVALIDARG;
+        }
+
+        // Bit patterns of the in-tile byte address, least significant bit first. B bits address bytes
+        // within an element, X and Y bits take successive bits of the element coordinates.
+        LPCSTR pPattern = nullptr;
+        const UINT BytesPerElement = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetByteAlignment(Format);
+        switch (BytesPerElement)
+        {
+        case 1:  pPattern = "XXXXYYYYXYXYXYXY"; break;
+        case 2:  pPattern = "BXXXYYYXYXYXYXYX"; break;
+        case 4:  pPattern = "BBXXYYXYXYXYXYXY"; break;
+        case 8:  pPattern = "BBBXYXXYXYXYXYXY"; break;
+        case 16: pPattern = "BBBBXYXYXYXYXYXY"; break;
+        default: return E_INVALIDARG;
+        }
+
+        D3D12_TILE_SHAPE TileShape;
+        D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetTileShape(&TileShape, Format, Dimension, SampleCount);
+        m_ElementWidth = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetWidthAlignment(Format);
+        m_ElementHeight = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetHeightAlignment(Format);
+        m_TileWidth = TileShape.WidthInTexels / m_ElementWidth;
+        m_TileHeight = TileShape.HeightInTexels / m_ElementHeight;
+
+        UINT XBit = 0, YBit = 0;
+        for (UINT Bit = 0; Bit < 16; ++Bit)
+        {
+            if (pPattern[Bit] == 'X') m_XBitPositions[XBit++] = static_cast<UINT8>(Bit);
+            if (pPattern[Bit] == 'Y') m_YBitPositions[YBit++] = static_cast<UINT8>(Bit);
+        }
+        if ((1u << XBit) != m_TileWidth || (1u << YBit) != m_TileHeight)
+        {
+            return E_INVALIDARG;
+        }
+        for (UINT i = 0; i < m_TileWidth; ++i)
+        {
+            m_XOffsets[i] = Deposit(i, m_XBitPositions, XBit);
+        }
+        for (UINT i = 0; i < m_TileHeight; ++i)
+        {
+            m_YOffsets[i] = Deposit(i, m_YBitPositions, YBit);
+        }
+
+        // Elements whose x coordinates only differ in the X bits directly above the byte bits are
+        // contiguous in memory, so rows are moved in runs of that many elements.
+        UINT FirstAddressBit = 0;
+        while (pPattern[FirstAddressBit] == 'B') ++FirstAddressBit;
+        UINT RunBits = 0;
+        while (FirstAddressBit + RunBits < 16 && pPattern[FirstAddressBit + RunBits] == 'X') ++RunBits;
+        m_RunElements = 1u << RunBits;
+
+        m_BytesPerElement = BytesPerElement;
+        return S_OK;
+    }
+
+    bool IsInitialized() const noexcept { return m_BytesPerElement != 0; }
+    UINT GetBytesPerElement() const noexcept { return m_BytesPerElement; }
+    UINT GetTileWidthInElements() const noexcept { return m_TileWidth; }
+    UINT GetTileHeightInElements() const noexcept { return m_TileHeight; }
+
+    UINT GetTilesAcross(UINT Width) const noexcept
+    { return (ElementsAcross(Width) + m_TileWidth - 1) / m_TileWidth; }
+    UINT GetTilesDown(UINT Height) const noexcept
+    { return (ElementsDown(Height) + m_TileHeight - 1) / m_TileHeight; }
+
+    // Size of one subresource of the given dimensions (in texels) in the swizzled layout
+    UINT64 GetSubresourceSize(UINT Width, UINT Height) const noexcept
+    { return UINT64(GetTilesAcross(Width)) * GetTilesDown(Height) * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES; }
+
+    // Byte offset of element (X, Y) (in elements, i.e. blocks for block compressed formats)
+    UINT64 GetElementOffset(UINT X, UINT Y, UINT TilesAcross) const noexcept
+    {
+        const UINT64 Tile = UINT64(Y / m_TileHeight) * TilesAcross + X / m_TileWidth;
+        return Tile * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES
+            + (m_XOffsets[X & (m_TileWidth - 1)] | m_YOffsets[Y & (m_TileHeight - 1)]);
+    }
+
+    // Swizzles a linear subresource (RowPitch is the pitch of a row of elements) of Width x Height
+    // texels into pSwizzled, which must hold GetSubresourceSize(Width, Height) bytes.
+    void Swizzle(
+        _Out_writes_bytes_(GetSubresourceSize(Width, Height)) void* pSwizzled,
+        _In_ const D3D12_SUBRESOURCE_DATA& Linear,
+        UINT Width,
+        UINT Height) const noexcept
+    {
+        Copy<true>(static_cast<BYTE*>(pSwizzled), static_cast<BYTE*>(const_cast<void*>(Linear.pData)), Linear.RowPitch, Width, Height);
+    }
+
+    // Inverse of Swizzle
+    void Unswizzle(
+        _In_ const D3D12_MEMCPY_DEST& Linear,
+        _In_reads_bytes_(GetSubresourceSize(Width, Height)) const void* pSwizzled,
+        UINT Width,
+        UINT Height) const noexcept
+    {
+        Copy<false>(static_cast<BYTE*>(const_cast<void*>(pSwizzled)), static_cast<BYTE*>(Linear.pData), static_cast<LONG_PTR>(Linear.RowPitch), Width, Height);
+    }
+
+private:
+    static UINT16 Deposit(UINT Value, const UINT8* pBitPositions, UINT NumBits) noexcept
+    {
+        UINT Result = 0;
+        for (UINT i = 0; i < NumBits; ++i)
+        {
+            Result |= ((Value >> i) & 1u) << pBitPositions[i];
+        }
+        return static_cast<UINT16>(Result);
+    }
+
+    UINT ElementsAcross(UINT Width) const noexcept { return (Width + m_ElementWidth - 1) / m_ElementWidth; }
+    UINT ElementsDown(UINT Height) const noexcept { return (Height + m_ElementHeight - 1) / m_ElementHeight; }
+
+    template <bool bSwizzle>
+    static void Move(BYTE* pSwizzled, BYTE* pLinear, SIZE_T NumBytes) noexcept
+    {
+        if (bSwizzle)
+        {
+            memcpy(pSwizzled, pLinear, NumBytes);
+        }
+        else
+        {
+            memcpy(pLinear, pSwizzled, NumBytes);
+        }
+    }
+
+    template <bool bSwizzle>
+    void Copy(BYTE* pSwizzled, BYTE* pLinear, LONG_PTR RowPitch, UINT Width, UINT Height) const noexcept
+    {
+        const UINT NumColumns = ElementsAcross(Width);
+        const UINT NumRows = ElementsDown(Height);
+        const UINT TilesAcross = GetTilesAcross(Width);
+        const SIZE_T RunBytes = SIZE_T(m_RunElements) * m_BytesPerElement;
+
+        for (UINT y = 0; y < NumRows; ++y)
+        {
+            BYTE* pRow = pLinear + RowPitch * LONG_PTR(y);
+            BYTE* pTileRow = pSwizzled + UINT64(y / m_TileHeight) * TilesAcross * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES
+                + m_YOffsets[y & (m_TileHeight - 1)];
+
+            // Full runs have a constant size, which lets the compiler emit a single vector move.
+            UINT x = 0;
+            for (; x + m_RunElements <= NumColumns; x += m_RunElements)
+            {
+                BYTE* pElement = pTileRow + UINT64(x / m_TileWidth) * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES
+                    + m_XOffsets[x & (m_TileWidth - 1)];
+                if (RunBytes == 16)
+                {
+                    Move<bSwizzle>(pElement, pRow + x * m_BytesPerElement, 16);
+                }
+                else
+                {
+                    Move<bSwizzle>(pElement, pRow + x * m_BytesPerElement, RunBytes);
+                }
+            }
+            for (; x < NumColumns; ++x)
+            {
+                BYTE* pElement = pTileRow + UINT64(x / m_TileWidth) * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES
+                    + m_XOffsets[x & (m_TileWidth - 1)];
+                Move<bSwizzle>(pElement, pRow + x * m_BytesPerElement, m_BytesPerElement);
+            }
+        }
+    }
+
+    UINT m_BytesPerElement = 0;
+    UINT m_ElementWidth = 1;
+    UINT m_ElementHeight = 1;
+    UINT m_TileWidth = 0;
+    UINT m_TileHeight = 0;
+    UINT m_RunElements = 1;
+    UINT8 m_XBitPositions[16] = {};
+    UINT8 m_YBitPositions[16] = {};
+    UINT16 m_XOffsets[256] = {};
+    UINT16 m_YOffsets[256] = {};
+};
+
+#endif // !D3DX12_NO_STANDARD_SWIZZLE_HELPERS
+
+#ifndef D3DX12_NO_PLANAR_UPLOAD_HELPERS
+
+//================================================================================================
+// D3DX12 Planar Upload Helpers
+//
+// Uploads frames of planar formats (NV12, P010, P016, ...) to a texture. The per-plane footprints
+// in the intermediate buffer are computed once by Init() and reused for every frame. Each plane
+// is a separate subresource of the destination, with the plane index as the PlaneSlice.
+//
+// Upload() maps the intermediate, copies every plane and records the copies. Streaming callers that
+// keep a persistently mapped upload ring can call WritePlanes() (on any thread) and RecordCopies()
+// separately instead.
+//
+//================================================================================================
+
+//------------------------------------------------------------------------------------------------
+// Describes the planes of a frame whose planes are stored one after another with a common row pitch,
+// which is the usual system memory layout for NV12, P010 and P016. Returns the number of planes
+// written, or 0 if Format is not planar or NumPlanes is too small.
+inline UINT D3DX12GetContiguousPlanarSubresourceData(
+    DXGI_FORMAT Format,
+    UINT Width,
+    UINT Height,
+    _In_ const void* pFrame,
+    LONG_PTR RowPitch,
+    _Out_writes_(NumPlanes) D3D12_SUBRESOURCE_DATA* pPlanes,
+    UINT NumPlanes) noexcept
+{
+    if (!D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::Planar(Format))
+    {
+        return 0;
+    }
+    const UINT PlaneCount = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetPlaneCount(Format);
+    if (NumPlanes < PlaneCount)
+    {
+        return 0;
+    }
+
+    auto pPlane = static_cast<const BYTE*>(pFrame);
+    for (UINT Plane = 0; Plane < PlaneCount; ++Plane)
+    {
+        DXGI_FORMAT PlaneFormat;
+        UINT MinPlanePitchWidth, PlaneWidth, PlaneHeight;
+        D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetPlaneSubsampledSizeAndFormatForCopyableLayout(
+            Plane, Format, Width, Height, PlaneFormat, MinPlanePitchWidth, PlaneWidth, PlaneHeight);
+
+        pPlanes[Plane].pData = pPlane;
+        pPlanes[Plane].RowPitch = RowPitch;
+        pPlanes[Plane].SlicePitch = RowPitch * LONG_PTR(PlaneHeight);
+        pPlane += pPlanes[Plane].SlicePitch;
+    }
+    return PlaneCount;
+}
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12PlanarUpload
+{
+public:
+    static constexpr UINT MaxPlanes = 3;
+
+    CD3DX12PlanarUpload() = default;
+
+    // Desc must be a 2D planar texture with a single mip level
+    HRESULT Init(const D3D12_RESOURCE_DESC& Desc) noexcept
+    {
+        m_NumPlanes = 0;
+        if (Desc.Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D || Desc.MipLevels != 1
+            || !D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::Planar(Desc.Format))
+        {
+            return E_INVALIDARG;
+        }
+        const UINT NumPlanes = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetPlaneCount(Desc.Format);
+        if (NumPlanes > MaxPlanes)
+        {
+            return E_INVALIDARG;
+        }
+
+        // Footprints do not depend on the array slice, so they are computed for slice 0 and the
+        // destination subresource is picked when the copies are recorded.
+        UINT64 Offset = 0;
+        for (UINT Plane = 0; Plane < NumPlanes; ++Plane)
+        {
+            UINT64 PlaneBytes = 0;
+            if (!D3DX12GetCopyableFootprints(Desc, D3D12CalcSubresource(0, 0, Plane, 1, Desc.DepthOrArraySize), 1, Offset,
+                    &m_Layouts[Plane], &m_NumRows[Plane], &m_RowSizesInBytes[Plane], &PlaneBytes)
+                || m_RowSizesInBytes[Plane] > SIZE_T(-1))
+            {
+                return E_INVALIDARG;
+            }
+            Offset = D3DX12Align<UINT64>(Offset + PlaneBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        }
+        m_RequiredSize = m_Layouts[NumPlanes - 1].Offset + UINT64(m_Layouts[NumPlanes - 1].Footprint.RowPitch) * m_NumRows[NumPlanes - 1];
+        m_ArraySize = Desc.DepthOrArraySize;
+        m_NumPlanes = NumPlanes;
+        return S_OK;
+    }
+
+    UINT GetNumPlanes() const noexcept { return m_NumPlanes; }
+
+    // Intermediate bytes needed per frame; the frame's base offset in the intermediate must be a
+    // multiple of D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT.
+    UINT64 GetRequiredIntermediateSize() const noexcept { return m_RequiredSize; }
+
+    const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& GetPlaneLayout(UINT Plane) const noexcept { return m_Layouts[Plane]; }
+    UINT GetPlaneNumRows(UINT Plane) const noexcept { return m_NumRows[Plane]; }
+    UINT64 GetPlaneRowSizeInBytes(UINT Plane) const noexcept { return m_RowSizesInBytes[Plane]; }
+
+    // Copies one frame (one D3D12_SUBRESOURCE_DATA per plane) to pIntermediateData, which points at
+    // the frame's base offset in a mapped intermediate buffer.
+    void WritePlanes(
+        _Out_writes_bytes_(GetRequiredIntermediateSize()) void* pIntermediateData,
+        _In_reads_(GetNumPlanes()) const D3D12_SUBRESOURCE_DATA* pPlanes) const noexcept
+    {
+        for (UINT Plane = 0; Plane < m_NumPlanes; ++Plane)
+        {
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout = m_Layouts[Plane];
+            BYTE* pDest = static_cast<BYTE*>(pIntermediateData) + Layout.Offset;
+            const SIZE_T RowSize = static_cast<SIZE_T>(m_RowSizesInBytes[Plane]);
+            if (pPlanes[Plane].RowPitch == LONG_PTR(Layout.Footprint.RowPitch))
+            {
+                // Matching pitches (e.g. 1920 or 3840 wide 8-bit luma) copy the whole plane at once
+                memcpy(pDest, pPlanes[Plane].pData, SIZE_T(Layout.Footprint.RowPitch) * (m_NumRows[Plane] - 1) + RowSize);
+            }
+            else
+            {
+                const D3D12_MEMCPY_DEST DestData = { pDest, Layout.Footprint.RowPitch, SIZE_T(Layout.Footprint.RowPitch) * m_NumRows[Plane] };
+                MemcpySubresource(&DestData, &pPlanes[Plane], RowSize, m_NumRows[Plane], 1);
+            }
+        }
+    }
+
+    // Records one CopyTextureRegion per plane from the frame at IntermediateOffset
+    void RecordCopies(
+        _In_ ID3D12GraphicsCommandList* pCmdList,
+        _In_ ID3D12Resource* pDestinationResource,
+        _In_ ID3D12Resource* pIntermediate,
+        UINT64 IntermediateOffset,
+        UINT ArraySlice = 0) const noexcept
+    {
+        for (UINT Plane = 0; Plane < m_NumPlanes; ++Plane)
+        {
+            D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layout = m_Layouts[Plane];
+            Layout.Offset += IntermediateOffset;
+            const CD3DX12_TEXTURE_COPY_LOCATION Dst(pDestinationResource, D3D12CalcSubresource(0, ArraySlice, Plane, 1, m_ArraySize));
+            const CD3DX12_TEXTURE_COPY_LOCATION Src(pIntermediate, Layout);
+            pCmdList->CopyTextureRegion(&Dst, 0, 0, 0, &Src, nullptr);
+        }
+    }
+
+    // Maps pIntermediate, writes all planes at IntermediateOffset and records the copies. Returns the
+    // number of intermediate bytes used, or 0 on failure (like UpdateSubresources).
+    UINT64 Upload(
+        _In_ ID3D12GraphicsCommandList* pCmdList,
+        _In_ ID3D12Resource* pDestinationResource,
+        _In_ ID3D12Resource* pIntermediate,
+        UINT64 IntermediateOffset,
+        _In_reads_(GetNumPlanes()) const D3D12_SUBRESOURCE_DATA* pPlanes,
+        UINT ArraySlice = 0) const noexcept
+    {
+        const auto IntermediateDesc = pIntermediate->GetDesc();
+        if (m_NumPlanes == 0 ||
+            IntermediateDesc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER ||
+            IntermediateDesc.Width < IntermediateOffset + m_RequiredSize ||
+            IntermediateOffset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT != 0 ||
+            m_RequiredSize > SIZE_T(-1))
+        {
+            return 0;
+        }
+
+        BYTE* pData;
+        HRESULT hr = pIntermediate->Map(0, nullptr, reinterpret_cast<void**>(&pData));
+        if (FAILED(hr))
+        {
+            return 0;
+        }
+        WritePlanes(pData + IntermediateOffset, pPlanes);
+        pIntermediate->Unmap(0, nullptr);
+
+        RecordCopies(pCmdList, pDestinationResource, pIntermediate, IntermediateOffset, ArraySlice);
+        return m_RequiredSize;
+    }
+
+private:
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT m_Layouts[MaxPlanes] = {};
+    UINT m_NumRows[MaxPlanes] = {};
+    UINT64 m_RowSizesInBytes[MaxPlanes] = {};
+    UINT64 m_RequiredSize = 0;
+    UINT m_ArraySize = 1;
+    UINT m_NumPlanes = 0;
+};
+
+#endif // !D3DX12_NO_PLANAR_UPLOAD_HELPERS
+
+#ifndef D3DX12_NO_GPU_PROFILER_HELPERS
+
+//================================================================================================
+// D3DX12 GPU Profiler Helpers
+//
+// Hierarchical GPU timing of the work on one queue with timestamp queries. Every frame in flight has
+// its own range of the query heap and of the readback buffer, so resolving frame N never waits for
+// frame N - 1 to be read back.
+// Uses STL
+//
+// Per frame:
+//   BeginFrame()              - starts a frame; returns false while its slot is still in flight.
+//   BeginScope() / EndScope() - bracket GPU work with timestamps; may be called concurrently from the
+//                               threads recording the frame's command lists.
+//   ResolveFrame()            - records a single ResolveQueryData for the frame, on the last command
+//                               list executed on the queue.
+//   EndFrame()                - associates the frame with the fence value signaled after it.
+//   Update()                  - reads back the completed frames and updates the statistics.
+//
+// Scope names must outlive the profiler (string literals). Statistics are kept per scope path, i.e.
+// per name under a given parent scope, over a rolling window of frames.
+//
+//================================================================================================
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+// Statistics of a scope path over the frames of the rolling window in which it was recorded. A scope
+// recorded several times in a frame contributes the sum of its durations.
+struct D3DX12_GPU_PROFILER_SCOPE_STATS
+{
+    LPCSTR pName;
+    UINT Parent; // Index of the parent scope path, or UINT_MAX
+    UINT Depth;
+    UINT NumSamples;
+    UINT64 LastNs;
+    UINT64 AverageNs;
+    UINT64 MinNs;
+    UINT64 MaxNs;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12GpuProfiler
+{
+public:
+    static constexpr UINT InvalidScope = UINT_MAX;
+
+    CD3DX12GpuProfiler() = default;
+    CD3DX12GpuProfiler(const CD3DX12GpuProfiler&) = delete;
+    CD3DX12GpuProfiler& operator=(const CD3DX12GpuProfiler&) = delete;
+    ~CD3DX12GpuProfiler() { ReleaseResources(); }
+
+    // TimestampFrequency comes from ID3D12CommandQueue::GetTimestampFrequency. Scopes beyond
+    // MaxScopesPerFrame in a frame are not timed.
+    HRESULT Init(UINT64 TimestampFrequency, UINT MaxScopesPerFrame, UINT NumFrames, UINT WindowSize = 64)
+    {
+        ReleaseResources();
+        if (TimestampFrequency == 0 || MaxScopesPerFrame == 0 || NumFrames == 0 || WindowSize == 0
+            || UINT64(MaxScopesPerFrame) * 2 * NumFrames > UINT_MAX)
+        {
+            return E_INVALIDARG;
+        }
+        m_Frequency = TimestampFrequency;
+        m_MaxScopes = MaxScopesPerFrame;
+        m_WindowSize = WindowSize;
+        std::vector<Frame>(NumFrames).swap(m_Frames);
+        for (Frame& Slot : m_Frames)
+        {
+            Slot.Scopes.resize(MaxScopesPerFrame);
+        }
+        m_Stats.clear();
+        m_Samples.clear();
+        m_ScopeStats.assign(MaxScopesPerFrame, InvalidScope);
+        m_FrameTotals.clear();
+        m_FrameTouched.clear();
+        m_CurrentFrame = 0;
+        m_NumFramesBegun = 0;
+        m_pCurrent = nullptr;
+        return S_OK;
+    }
+
+    // Description of the query heap covering every frame in flight; copy queues need
+    // D3D12_QUERY_HEAP_TYPE_COPY_QUEUE_TIMESTAMP.
+    D3D12_QUERY_HEAP_DESC GetQueryHeapDesc(D3D12_COMMAND_LIST_TYPE Type = D3D12_COMMAND_LIST_TYPE_DIRECT) const noexcept
+    {
+        D3D12_QUERY_HEAP_DESC Desc = {};
+        Desc.Type = Type == D3D12_COMMAND_LIST_TYPE_COPY ? D3D12_QUERY_HEAP_TYPE_COPY_QUEUE_TIMESTAMP : D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+        Desc.Count = m_MaxScopes * 2 * static_cast<UINT>(m_Frames.size());
+        return Desc;
+    }
+
+    UINT64 GetReadbackBufferSize() const noexcept { return UINT64(GetQueryHeapDesc().Count) * sizeof(UINT64); }
+
+    // Uses caller-created resources; the readback buffer stays mapped at pMappedReadback
+    void SetResources(_In_ ID3D12QueryHeap* pQueryHeap, _In_ ID3D12Resource* pReadback, _In_ const UINT64* pMappedReadback) noexcept
+    {
+        ReleaseResources();
+        m_pQueryHeap = pQueryHeap;
+        m_pReadback = pReadback;
+        m_pTimestamps = pMappedReadback;
+    }
+
+    // Creates and maps the query heap and readback buffer for a queue of the given type
+    HRESULT CreateResources(_In_ ID3D12Device* pDevice, D3D12_COMMAND_LIST_TYPE Type, UINT NodeMask = 0)
+    {
+        ReleaseResources();
+        m_bOwnsResources = true;
+        D3D12_QUERY_HEAP_DESC HeapDesc = GetQueryHeapDesc(Type);
+        HeapDesc.NodeMask = NodeMask;
+        const CD3DX12_HEAP_PROPERTIES HeapProperties(D3D12_HEAP_TYPE_READBACK, NodeMask, NodeMask);
+        const CD3DX12_RESOURCE_DESC BufferDesc = CD3DX12_RESOURCE_DESC::Buffer(GetReadbackBufferSize());
+        HRESULT hr = pDevice->CreateQueryHeap(&HeapDesc, IID_ID3D12QueryHeap, reinterpret_cast<void**>(&m_pQueryHeap));
+        if (SUCCEEDED(hr))
+        {
+            hr = pDevice->CreateCommittedResource(&HeapProperties, D3D12_HEAP_FLAG_NONE, &BufferDesc, D3D12_RESOURCE_STATE_COPY_DEST,
+                nullptr, IID_ID3D12Resource, reinterpret_cast<void**>(&m_pReadback));
+        }
+        void* pMapped = nullptr;
+        if (SUCCEEDED(hr))
+        {
+            hr = m_pReadback->Map(0, nullptr, &pMapped);
+        }
+        if (FAILED(hr))
+        {
+            ReleaseResources();
+            return hr;
+        }
+        m_pTimestamps = static_cast<const UINT64*>(pMapped);
+        return S_OK;
+    }
+
+    // Starts the next frame. Returns false, and the frame's scopes are not timed, while the slot it
+    // would use has not been read back by Update().
+    bool BeginFrame() noexcept
+    {
+        Frame& Slot = m_Frames[m_NumFramesBegun % m_Frames.size()];
+        if (Slot.bPending)
+        {
+            m_pCurrent = nullptr;
+            return false;
+        }
+        m_CurrentFrame = static_cast<UINT>(m_NumFramesBegun % m_Frames.size());
+        ++m_NumFramesBegun;
+        Slot.NumScopes.store(0, std::memory_order_relaxed);
+        m_pCurrent = &Slot;
+        return true;
+    }
+
+    // Records the begin timestamp of a scope. Returns the scope to pass to EndScope() and as the
+    // parent of nested scopes, or InvalidScope if the scope is not timed.
+    template <typename TCommandList>
+    UINT BeginScope(_In_ TCommandList* pCmdList, _In_z_ LPCSTR pName, UINT ParentScope = InvalidScope) noexcept
+    {
+        Frame* pFrame = m_pCurrent;
+        if (pFrame == nullptr)
+        {
+            return InvalidScope;
+        }
+        const UINT Scope = pFrame->NumScopes.fetch_add(1, std::memory_order_relaxed);
+        if (Scope >= m_MaxScopes)
+        {
+            return InvalidScope;
+        }
+        pFrame->Scopes[Scope] = { pName, ParentScope < Scope ? ParentScope : InvalidScope };
+        pCmdList->EndQuery(m_pQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, GetQueryIndex(Scope));
+        return Scope;
+    }
+
+    template <typename TCommandList>
+    void EndScope(_In_ TCommandList* pCmdList, UINT Scope) noexcept
+    {
+        if (Scope != InvalidScope && m_pCurrent)
+        {
+            pCmdList->EndQuery(m_pQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, GetQueryIndex(Scope) + 1);
+        }
+    }
+
+    // Records the resolve of every timestamp of the frame. No scope may be begun after this.
+    template <typename TCommandList>
+    void ResolveFrame(_In_ TCommandList* pCmdList) noexcept
+    {
+        const UINT NumScopes = GetNumScopes();
+        if (NumScopes)
+        {
+            const UINT FirstQuery = GetQueryIndex(0);
+            pCmdList->ResolveQueryData(m_pQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, FirstQuery, NumScopes * 2,
+                m_pReadback, UINT64(FirstQuery) * sizeof(UINT64));
+        }
+    }
+
+    // Ends the frame; its timestamps are read back once FenceValue has completed
+    void EndFrame(UINT64 FenceValue) noexcept
+    {
+        if (m_pCurrent)
+        {
+            m_pCurrent->NumResolved = GetNumScopes();
+            m_pCurrent->FenceValue = FenceValue;
+            m_pCurrent->bPending = true;
+            m_pCurrent = nullptr;
+        }
+    }
+
+    // Reads back every frame whose fence has completed, oldest first, and updates the statistics
+    void Update(UINT64 CompletedFenceValue)
+    {
+        const UINT NumFrames = static_cast<UINT>(m_Frames.size());
+        for (UINT i = 0; i < NumFrames; ++i)
+        {
+            Frame& Slot = m_Frames[(m_NumFramesBegun + i) % NumFrames];
+            if (Slot.bPending && Slot.FenceValue <= CompletedFenceValue)
+            {
+                ReadFrame(Slot, static_cast<UINT>((m_NumFramesBegun + i) % NumFrames));
+                Slot.bPending = false;
+            }
+        }
+    }
+
+    UINT GetNumScopeStats() const noexcept { return static_cast<UINT>(m_Stats.size()); }
+    const D3DX12_GPU_PROFILER_SCOPE_STATS& GetScopeStats(UINT Index) const noexcept { return m_Stats[Index]; }
+
+    // Returns the index of the scope path Name under Parent, or UINT_MAX
+    UINT FindScopeStats(_In_z_ LPCSTR pName, UINT Parent = UINT_MAX) const noexcept
+    {
+        for (UINT i = 0; i < m_Stats.size(); ++i)
+        {
+            if (m_Stats[i].Parent == Parent && strcmp(m_Stats[i].pName, pName) == 0)
+            {
+                return i;
+            }
+        }
+        return UINT_MAX;
+    }
+
+    UINT64 TicksToNanoseconds(UINT64 Ticks) const noexcept
+    {
+        // Split to avoid overflowing Ticks * 1e9
+        return Ticks / m_Frequency * 1000000000ull + Ticks % m_Frequency * 1000000000ull / m_Frequency;
+    }
+
+private:
+    struct Scope
+    {
+        LPCSTR pName;
+        UINT Parent;
+    };
+
+    struct Frame
+    {
+        std::vector<Scope> Scopes;
+        std::atomic<UINT> NumScopes{ 0 };
+        UINT NumResolved = 0;
+        UINT64 FenceValue = 0;
+        bool bPending = false;
+    };
+
+    UINT GetNumScopes() const noexcept
+    {
+        if (m_pCurrent == nullptr)
+        {
+            return 0;
+        }
+        const UINT NumScopes = m_pCurrent->NumScopes.load(std::memory_order_relaxed);
+        return NumScopes < m_MaxScopes ? NumScopes : m_MaxScopes;
+    }
+
+    UINT GetQueryIndex(UINT Scope) const noexcept { return (m_CurrentFrame * m_MaxScopes + Scope) * 2; }
+
+    void ReadFrame(const Frame& Slot, UINT FrameIndex)
+    {
+        const UINT64* pTimestamps = m_pTimestamps + SIZE_T(FrameIndex) * m_MaxScopes * 2;
+        m_FrameTotals.assign(m_Stats.size(), 0);
+        m_FrameTouched.assign(m_Stats.size(), false);
+        for (UINT i = 0; i < Slot.NumResolved; ++i)
+        {
+            const Scope& Entry = Slot.Scopes[i];
+            const UINT ParentStat = Entry.Parent == InvalidScope ? UINT_MAX : m_ScopeStats[Entry.Parent];
+            UINT Stat = FindScopeStats(Entry.pName, ParentStat);
+            if (Stat == UINT_MAX)
+            {
+                Stat = static_cast<UINT>(m_Stats.size());
+                const UINT Depth = ParentStat == UINT_MAX ? 0 : m_Stats[ParentStat].Depth + 1;
+                m_Stats.push_back({ Entry.pName, ParentStat, Depth, 0, 0, 0, 0, 0 });
+                m_Samples.resize(m_Samples.size() + m_WindowSize);
+                m_FrameTotals.push_back(0);
+                m_FrameTouched.push_back(false);
+            }
+            m_ScopeStats[i] = Stat;
+            const UINT64 Begin = pTimestamps[i * 2];
+            const UINT64 End = pTimestamps[i * 2 + 1];
+            m_FrameTotals[Stat] += End > Begin ? TicksToNanoseconds(End - Begin) : 0;
+            m_FrameTouched[Stat] = true;
+        }
+
+        for (UINT Stat = 0; Stat < m_Stats.size(); ++Stat)
+        {
+            if (!m_FrameTouched[Stat])
+            {
+                continue;
+            }
+            D3DX12_GPU_PROFILER_SCOPE_STATS& Stats = m_Stats[Stat];
+            UINT64* pWindow = &m_Samples[SIZE_T(Stat) * m_WindowSize];
+            pWindow[Stats.NumSamples % m_WindowSize] = m_FrameTotals[Stat];
+            ++Stats.NumSamples;
+            Stats.LastNs = m_FrameTotals[Stat];
+
+            const UINT NumValid = Stats.NumSamples < m_WindowSize ? Stats.NumSamples : m_WindowSize;
+            UINT64 Sum = 0;
+            Stats.MinNs = UINT64_MAX;
+            Stats.MaxNs = 0;
+            for (UINT s = 0; s < NumValid; ++s)
+            {
+                Sum += pWindow[s];
+                Stats.MinNs = pWindow[s] < Stats.MinNs ? pWindow[s] : Stats.MinNs;
+                Stats.MaxNs = pWindow[s] > Stats.MaxNs ? pWindow[s] : Stats.MaxNs;
+            }
+            Stats.AverageNs = Sum / NumValid;
+        }
+    }
+
+    void ReleaseResources() noexcept
+    {
+        if (m_bOwnsResources)
+        {
+            if (m_pReadback)
+            {
+                if (m_pTimestamps)
+                {
+                    m_pReadback->Unmap(0, nullptr);
+                }
+                m_pReadback->Release();
+            }
+            if (m_pQueryHeap)
+            {
+                m_pQueryHeap->Release();
+            }
+        }
+        m_pQueryHeap = nullptr;
+        m_pReadback = nullptr;
+        m_pTimestamps = nullptr;
+        m_bOwnsResources = false;
+    }
+
+    std::vector<Frame> m_Frames;
+    std::vector<D3DX12_GPU_PROFILER_SCOPE_STATS> m_Stats;
+    std::vector<UINT64> m_Samples; // WindowSize samples per scope path
+    std::vector<UINT> m_ScopeStats; // Scope path of each scope of the frame being read
+    std::vector<UINT64> m_FrameTotals;
+    std::vector<bool> m_FrameTouched;
+    Frame* m_pCurrent = nullptr;
+    UINT m_CurrentFrame = 0;
+    UINT64 m_NumFramesBegun = 0;
+    UINT64 m_Frequency = 0;
+    UINT m_MaxScopes = 0;
+    UINT m_WindowSize = 0;
+    ID3D12QueryHeap* m_pQueryHeap = nullptr;
+    ID3D12Resource* m_pReadback = nullptr;
+    const UINT64* m_pTimestamps = nullptr;
+    bool m_bOwnsResources = false;
+};
+
+#endif // !D3DX12_NO_GPU_PROFILER_HELPERS
+
+#ifndef D3DX12_NO_QUERY_POOL_HELPERS
+
+//================================================================================================
+// D3DX12 Query Pool Helpers
+//
+// Pools the queries of one query heap (occlusion, pipeline statistics, stream output, timestamps).
+// Indices are handed out and returned in O(1). The queries ended since the last Resolve() are
+// resolved with one ResolveQueryData per run of contiguous indices, into the same slots of a
+// persistently mapped readback buffer. Update() then hands the results of every batch whose fence
+// has completed to a callback and returns the queries to the pool, so results arrive without
+// waiting on the GPU.
+// Uses STL
+//
+// Per batch: Allocate(), Begin() / End() while recording, Resolve() on the last command list of the
+// batch, then Submit() with the fence value signaled after it.
+//
+//================================================================================================
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12QueryPool
+{
+public:
+    CD3DX12QueryPool() = default;
+    CD3DX12QueryPool(const CD3DX12QueryPool&) = delete;
+    CD3DX12QueryPool& operator=(const CD3DX12QueryPool&) = delete;
+
+    // For occlusion heaps, bBinaryOcclusion selects D3D12_QUERY_TYPE_BINARY_OCCLUSION queries
+    HRESULT Init(D3D12_QUERY_HEAP_TYPE HeapType, UINT Capacity, bool bBinaryOcclusion = false)
+    {
+        m_ResultSize = GetResultSize(HeapType);
+        if (m_ResultSize == 0 || Capacity == 0)
+        {
+            return E_INVALIDARG;
+        }
+        m_HeapType = HeapType;
+        m_QueryType = GetQueryType(HeapType, bBinaryOcclusion);
+        m_Capacity = Capacity;
+        m_Free.resize(Capacity);
+        for (UINT i = 0; i < Capacity; ++i)
+        {
+            m_Free[i] = Capacity - 1 - i;
+        }
+        m_Ended.clear();
+        m_Ended.reserve(Capacity);
+        m_Resolved.clear();
+        m_Resolved.reserve(Capacity);
+        m_Submitted.clear();
+        m_Batches.clear();
+        m_pQueryHeap = nullptr;
+        m_pReadback = nullptr;
+        m_pResults = nullptr;
+        return S_OK;
+    }
+
+    D3D12_QUERY_HEAP_DESC GetQueryHeapDesc(UINT NodeMask = 0) const noexcept
+    {
+        return { m_HeapType, m_Capacity, NodeMask };
+    }
+
+    UINT64 GetReadbackBufferSize() const noexcept { return UINT64(m_Capacity) * m_ResultSize; }
+
+    // Size of the result of one query, e.g. sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS)
+    UINT GetResultSize() const noexcept { return m_ResultSize; }
+
+    // The readback buffer stays mapped at pMappedReadback
+    void SetResources(_In_ ID3D12QueryHeap* pQueryHeap, _In_ ID3D12Resource* pReadback, _In_ const void* pMappedReadback) noexcept
+    {
+        m_pQueryHeap = pQueryHeap;
+        m_pReadback = pReadback;
+        m_pResults = static_cast<const BYTE*>(pMappedReadback);
+    }
+
+    // Returns a free query index, or UINT_MAX if every query is in use
+    UINT Allocate() noexcept
+    {
+        if (m_Free.empty())
+        {
+            return UINT_MAX;
+        }
+        const UINT Index = m_Free.back();
+        m_Free.pop_back();
+        return Index;
+    }
+
+    // Returns a query that was allocated but never ended
+    void Free(UINT Index)
+    {
+        D3DX12_ASSERT(Index < m_Capacity);
+        m_Free.push_back(Index);
+    }
+
+    UINT GetNumFree() const noexcept { return static_cast<UINT>(m_Free.size()); }
+
+    template <typename TCommandList>
+    void Begin(_In_ TCommandList* pCmdList, UINT Index) const noexcept
+    {
+        pCmdList->BeginQuery(m_pQueryHeap, m_QueryType, Index);
+    }
+
+    template <typename TCommandList>
+    void End(_In_ TCommandList* pCmdList, UINT Index)
+    {
+        pCmdList->EndQuery(m_pQueryHeap, m_QueryType, Index);
+        m_Ended.push_back(Index);
+    }
+
+    // Records the resolve of every query ended since the last call, one ResolveQueryData per run of
+    // contiguous indices. Returns the number of ResolveQueryData calls recorded.
+    template <typename TCommandList>
+    UINT Resolve(_In_ TCommandList* pCmdList)
+    {
+        std::sort(m_Ended.begin(), m_Ended.end());
+        UINT NumResolves = 0;
+        for (size_t First = 0; First < m_Ended.size();)
+        {
+            size_t Last = First;
+            while (Last + 1 < m_Ended.size() && m_Ended[Last + 1] == m_Ended[Last] + 1)
+            {
+                ++Last;
+            }
+            pCmdList->ResolveQueryData(m_pQueryHeap, m_QueryType, m_Ended[First], static_cast<UINT>(Last - First + 1),
+                m_pReadback, UINT64(m_Ended[First]) * m_ResultSize);
+            ++NumResolves;
+            First = Last + 1;
+        }
+        m_Resolved.insert(m_Resolved.end(), m_Ended.begin(), m_Ended.end());
+        m_Ended.clear();
+        return NumResolves;
+    }
+
+    // The queries resolved since the last call are read back once FenceValue has completed
+    void Submit(UINT64 FenceValue)
+    {
+        if (m_Resolved.empty())
+        {
+            return;
+        }
+        m_Submitted.insert(m_Submitted.end(), m_Resolved.begin(), m_Resolved.end());
+        m_Batches.push_back({ FenceValue, static_cast<UINT>(m_Resolved.size()) });
+        m_Resolved.clear();
+    }
+
+    // Calls Func(UINT Index, const void* pResult) for every query of the batches whose fence has
+    // completed, then returns them to the pool. Returns the number of results delivered.
+    template <typename TFunc>
+    UINT Update(UINT64 CompletedFenceValue, TFunc&& Func)
+    {
+        UINT NumDelivered = 0;
+        while (!m_Batches.empty() && m_Batches.front().FenceValue <= CompletedFenceValue)
+        {
+            for (UINT i = 0; i < m_Batches.front().NumQueries; ++i)
+            {
+                const UINT Index = m_Submitted.front();
+                m_Submitted.pop_front();
+                Func(Index, static_cast<const void*>(m_pResults + SIZE_T(Index) * m_ResultSize));
+                m_Free.push_back(Index);
+                ++NumDelivered;
+            }
+            m_Batches.pop_front();
+        }
+        return NumDelivered;
+    }
+
+    static UINT GetResultSize(D3D12_QUERY_HEAP_TYPE HeapType) noexcept
+    {
+        switch (HeapType)
+        {
+        case D3D12_QUERY_HEAP_TYPE_OCCLUSION:
+        case D3D12_QUERY_HEAP_TYPE_TIMESTAMP:
+        case D3D12_QUERY_HEAP_TYPE_COPY_QUEUE_TIMESTAMP:
+            return sizeof(UINT64);
+        case D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS:
+            return sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS);
+        case D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS1:
+            return sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS1);
+        case D3D12_QUERY_HEAP_TYPE_SO_STATISTICS:
+            return sizeof(D3D12_QUERY_DATA_SO_STATISTICS);
+        default:
+            return 0;
+        }
+    }
+
+private:
+    static D3D12_QUERY_TYPE GetQueryType(D3D12_QUERY_HEAP_TYPE HeapType, bool bBinaryOcclusion) noexcept
+    {
+        switch (HeapType)
+        {
+        case D3D12_QUERY_HEAP_TYPE_OCCLUSION:
+            return bBinaryOcclusion ? D3D12_QUERY_TYPE_BINARY_OCCLUSION : D3D12_QUERY_TYPE_OCCLUSION;
+        case D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS:
+            return D3D12_QUERY_TYPE_PIPELINE_STATISTICS;
+        case D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS1:
+            return D3D12_QUERY_TYPE_PIPELINE_STATISTICS1;
+        case D3D12_QUERY_HEAP_TYPE_SO_STATISTICS:
+            return D3D12_QUERY_TYPE_SO_STATISTICS_STREAM0;
+        default:
+            return D3D12_QUERY_TYPE_TIMESTAMP;
+        }
+    }
+
+    struct Batch
+    {
+        UINT64 FenceValue;
+        UINT NumQueries;
+    };
+
+    D3D12_QUERY_HEAP_TYPE m_HeapType = D3D12_QUERY_HEAP_TYPE_OCCLUSION;
+    D3D12_QUERY_TYPE m_QueryType = D3D12_QUERY_TYPE_OCCLUSION;
+    UINT m_Capacity = 0;
+    UINT m_ResultSize = 0;
+    std::vector<UINT> m_Free;
+    std::vector<UINT> m_Ended;
+    std::vector<UINT> m_Resolved;
+    std::deque<UINT> m_Submitted;
+    std::deque<Batch> m_Batches;
+    ID3D12QueryHeap* m_pQueryHeap = nullptr;
+    ID3D12Resource* m_pReadback = nullptr;
+    const BYTE* m_pResults = nullptr;
+};
+
+#endif // !D3DX12_NO_QUERY_POOL_HELPERS
+
+#ifndef D3DX12_NO_COMMAND_LIST_POOL_HELPERS
+
+//================================================================================================
+// D3DX12 Command List Pool Helpers
+//
+// Recycles command allocators and command lists for one recording thread, so the fast path takes no
+// locks. Allocators and lists are kept per D3D12_COMMAND_LIST_TYPE. An allocator takes only one open
+// list at a time, so each list acquired since the last Execute() records into its own allocator.
+// The lists go to the queue in one ExecuteCommandLists. Their allocators are then retired with the
+// fence value the caller signals after the submit, and are reset and reused only once that value
+// has completed.
+// Uses STL
+//
+//================================================================================================
+#include <deque>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_COMMAND_ALLOCATOR_STATS
+{
+    UINT NumResets;     // Times the allocator was recycled
+    UINT NumLists;      // Lists recorded into it since it was created
+    UINT64 FenceValue;  // Fence value of its last submit
+};
+
+//------------------------------------------------------------------------------------------------
+template <typename TCommandList = ID3D12GraphicsCommandList>
+class CD3DX12CommandListPool
+{
+public:
+    CD3DX12CommandListPool() = default;
+    CD3DX12CommandListPool(const CD3DX12CommandListPool&) = delete;
+    CD3DX12CommandListPool& operator=(const CD3DX12CommandListPool&) = delete;
+    ~CD3DX12CommandListPool() { ReleaseAll(); }
+
+    void Init(UINT NodeMask = 0) noexcept
+    {
+        ReleaseAll();
+        m_NodeMask = NodeMask;
+    }
+
+    // Returns an open command list recording into an allocator of its own. Retired allocators are
+    // reused once their fence value is at most CompletedFenceValue; new allocators and lists are
+    // created through pDevice when none can be recycled.
+    template <typename TDevice>
+    HRESULT Acquire(_In_ TDevice* pDevice, D3D12_COMMAND_LIST_TYPE Type, UINT64 CompletedFenceValue,
+        _In_opt_ ID3D12PipelineState* pInitialState, _Outptr_ TCommandList** ppCommandList)
+    {
+        *ppCommandList = nullptr;
+        if (UINT(Type) >= NumTypes || Type == D3D12_COMMAND_LIST_TYPE_BUNDLE)
+        {
+            return E_INVALIDARG;
+        }
+        TypePool& Pool = m_Types[Type];
+        UINT Index = UINT_MAX;
+        HRESULT hr = AcquireAllocator(pDevice, Type, CompletedFenceValue, &Index);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        Allocator& Current = Pool.Allocators[Index];
+        TCommandList* pList = nullptr;
+        if (!Pool.FreeLists.empty())
+        {
+            pList = Pool.FreeLists.back();
+            hr = pList->Reset(Current.pAllocator, pInitialState);
+            if (SUCCEEDED(hr))
+            {
+                Pool.FreeLists.pop_back();
+            }
+        }
+        else
+        {
+            hr = pDevice->CreateCommandList(m_NodeMask, Type, Current.pAllocator, pInitialState,
+                __uuidof(TCommandList), reinterpret_cast<void**>(&pList));
+        }
+        if (FAILED(hr))
+        {
+            // The allocator is idle and its fence value completed, so it is the next to recycle
+            Pool.Retired.push_front(Index);
+            return hr;
+        }
+        Pool.Pending.push_back(pList);
+        Pool.PendingAllocators.push_back(Index);
+        ++Current.Stats.NumLists;
+        *ppCommandList = pList;
+        return S_OK;
+    }
+
+    // Closes the lists acquired for Type since the last call and submits them in one
+    // ExecuteCommandLists. The caller signals FenceValue on pQueue afterwards; it retires the
+    // allocators of all these lists.
+    template <typename TQueue>
+    HRESULT Execute(_In_ TQueue* pQueue, D3D12_COMMAND_LIST_TYPE Type, UINT64 FenceValue)
+    {
+        if (UINT(Type) >= NumTypes)
+        {
+            return E_INVALIDARG;
+        }
+        TypePool& Pool = m_Types[Type];
+        if (Pool.Pending.empty())
+        {
+            return S_OK;
+        }
+        for (TCommandList* pList : Pool.Pending)
+        {
+            const HRESULT hr = pList->Close();
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+        pQueue->ExecuteCommandLists(static_cast<UINT>(Pool.Pending.size()), CommandListCast(Pool.Pending.data()));
+
+        // Lists can be reset as soon as they are submitted; their allocator cannot
+        Pool.FreeLists.insert(Pool.FreeLists.end(), Pool.Pending.begin(), Pool.Pending.end());
+        Pool.Pending.clear();
+        for (UINT Index : Pool.PendingAllocators)
+        {
+            Pool.Allocators[Index].Stats.FenceValue = FenceValue;
+            Pool.Retired.push_back(Index);
+        }
+        Pool.PendingAllocators.clear();
+        return S_OK;
+    }
+
+    UINT GetNumAllocators(D3D12_COMMAND_LIST_TYPE Type) const noexcept
+    {
+        return UINT(Type) < NumTypes ? static_cast<UINT>(m_Types[Type].Allocators.size()) : 0;
+    }
+
+    UINT GetNumCommandLists(D3D12_COMMAND_LIST_TYPE Type) const noexcept
+    {
+        return UINT(Type) < NumTypes ? static_cast<UINT>(m_Types[Type].FreeLists.size() + m_Types[Type].Pending.size()) : 0;
+    }
+
+    const D3DX12_COMMAND_ALLOCATOR_STATS& GetAllocatorStats(D3D12_COMMAND_LIST_TYPE Type, UINT Index) const noexcept
+    {
+        return m_Types[Type].Allocators[Index].Stats;
+    }
+
+private:
+    static constexpr UINT NumTypes = D3D12_COMMAND_LIST_TYPE_VIDEO_ENCODE + 1;
+
+    struct Allocator
+    {
+        ID3D12CommandAllocator* pAllocator;
+        D3DX12_COMMAND_ALLOCATOR_STATS Stats;
+    };
+
+    struct TypePool
+    {
+        std::vector<Allocator> Allocators;
+        std::deque<UINT> Retired;            // In submit order, so fence values increase
+        std::vector<TCommandList*> FreeLists;
+        std::vector<TCommandList*> Pending;
+        std::vector<UINT> PendingAllocators; // Allocator of each pending list
+    };
+
+    template <typename TDevice>
+    HRESULT AcquireAllocator(TDevice* pDevice, D3D12_COMMAND_LIST_TYPE Type, UINT64 CompletedFenceValue, UINT* pIndex)
+    {
+        TypePool& Pool = m_Types[Type];
+        if (!Pool.Retired.empty() && Pool.Allocators[Pool.Retired.front()].Stats.FenceValue <= CompletedFenceValue)
+        {
+            Allocator& Recycled = Pool.Allocators[Pool.Retired.front()];
+            const HRESULT hr = Recycled.pAllocator->Reset();
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            ++Recycled.Stats.NumResets;
+            *pIndex = Pool.Retired.front();
+            Pool.Retired.pop_front();
+            return S_OK;
+        }
+        ID3D12CommandAllocator* pAllocator = nullptr;
+        const HRESULT hr = pDevice->CreateCommandAllocator(Type, IID_ID3D12CommandAllocator, reinterpret_cast<void**>(&pAllocator));
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        Pool.Allocators.push_back({ pAllocator, {} });
+        *pIndex = static_cast<UINT>(Pool.Allocators.size() - 1);
+        return S_OK;
+    }
+
+    void ReleaseAll() noexcept
+    {
+        for (TypePool& Pool : m_Types)
+        {
+            for (TCommandList* pList : Pool.FreeLists)
+            {
+                pList->Release();
+            }
+            for (TCommandList* pList : Pool.Pending)
+            {
+                pList->Release();
+            }
+            for (Allocator& Entry : Pool.Allocators)
+            {
+                Entry.pAllocator->Release();
+            }
+            Pool = TypePool();
+        }
+    }
+
+    TypePool m_Types[NumTypes];
+    UINT m_NodeMask = 0;
+};
+
+#endif // !D3DX12_NO_COMMAND_LIST_POOL_HELPERS
+
+#ifndef D3DX12_NO_QUEUE_SCHEDULER_HELPERS
+
+//================================================================================================
+// D3DX12 Queue Scheduler Helpers
+//
+// Submits work across the direct, compute and copy queues. Each work item names the resources it
+// reads and writes. The scheduler orders items after the earlier items they conflict with
+// (read-after-write, write-after-read and write-after-write). Items on the same queue are already
+// ordered, so only dependencies across queues cost a Signal/Wait pair. A wait is skipped when the
+// waiting queue is already ordered after the value through an earlier wait, which it tracks with a
+// vector clock per queue. Items that need no wait between them are batched into one
+// ExecuteCommandLists. Independent work on the async queues overlaps the direct queue.
+// Uses STL
+//
+// Resource state transitions stay with the caller: the scheduler only orders the submissions.
+// Resources are tracked by address until Forget() is called for them, which the caller does when
+// releasing one, so that the record neither grows without bound nor orders a new resource created
+// at the same address after the work of the old one.
+//
+//================================================================================================
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_QUEUE_WORK_DESC
+{
+    D3D12_COMMAND_LIST_TYPE Type;
+    UINT NumCommandLists;
+    ID3D12CommandList* const* ppCommandLists;
+    UINT NumReads;
+    ID3D12Resource* const* ppReads;
+    UINT NumWrites;
+    ID3D12Resource* const* ppWrites;
+};
+
+//------------------------------------------------------------------------------------------------
+template <typename TQueue = ID3D12CommandQueue>
+class CD3DX12QueueScheduler
+{
+public:
+    static constexpr UINT NumQueues = 3;
+
+    // Queue slot of a command list type: direct, compute or copy; UINT_MAX otherwise
+    static UINT GetQueueIndex(D3D12_COMMAND_LIST_TYPE Type) noexcept
+    {
+        switch (Type)
+        {
+        case D3D12_COMMAND_LIST_TYPE_DIRECT: return 0;
+        case D3D12_COMMAND_LIST_TYPE_COMPUTE: return 1;
+        case D3D12_COMMAND_LIST_TYPE_COPY: return 2;
+        default: return UINT_MAX;
+        }
+    }
+
+    // Queue description using PreferredPriority when the device supports it for Type, and
+    // D3D12_COMMAND_QUEUE_PRIORITY_NORMAL otherwise
+    static D3D12_COMMAND_QUEUE_DESC GetQueueDesc(CD3DX12FeatureSupport& Features, D3D12_COMMAND_LIST_TYPE Type,
+        INT PreferredPriority = D3D12_COMMAND_QUEUE_PRIORITY_HIGH, UINT NodeMask = 0)
+    {
+        D3D12_COMMAND_QUEUE_DESC Desc = {};
+        Desc.Type = Type;
+        Desc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
+        Desc.NodeMask = NodeMask;
+        if (PreferredPriority != D3D12_COMMAND_QUEUE_PRIORITY_NORMAL && Features.CommandQueuePrioritySupported(Type, static_cast<UINT>(PreferredPriority)))
+        {
+            Desc.Priority = PreferredPriority;
+        }
+        return Desc;
+    }
+
+    // LastSignaledValue is the last value signaled on pFence before the scheduler takes over
+    void SetQueue(D3D12_COMMAND_LIST_TYPE Type, _In_ TQueue* pQueue, _In_ ID3D12Fence* pFence, UINT64 LastSignaledValue = 0) noexcept
+    {
+        const UINT Index = GetQueueIndex(Type);
+        D3DX12_ASSERT(Index < NumQueues);
+        Queue& Slot = m_Queues[Index];
+        Slot.pQueue = pQueue;
+        Slot.pFence = pFence;
+        Slot.Value = LastSignaledValue;
+        Slot.Known[Index] = LastSignaledValue;
+    }
+
+    // Schedules one work item. Work of other queues it depends on is submitted and signaled if it
+    // was not yet, and the item's queue waits for it; the item's own lists stay batched until a
+    // later wait, Flush() or a dependent item on another queue submits them.
+    HRESULT AddWork(const D3DX12_QUEUE_WORK_DESC& Desc, _Out_opt_ UINT* pWorkIndex = nullptr)
+    {
+        const UINT Q = GetQueueIndex(Desc.Type);
+        if (Q >= NumQueues || m_Queues[Q].pQueue == nullptr)
+        {
+            return E_INVALIDARG;
+        }
+        const UINT Self = static_cast<UINT>(m_Items.size());
+
+        // Latest conflicting item on each other queue
+        UINT Deps[NumQueues] = { UINT_MAX, UINT_MAX, UINT_MAX };
+        auto AddDep = [&](UINT Item)
+        {
+            if (Item != UINT_MAX && m_Items[Item].Queue != Q && (Deps[m_Items[Item].Queue] == UINT_MAX || Deps[m_Items[Item].Queue] < Item))
+            {
+                Deps[m_Items[Item].Queue] = Item;
+            }
+        };
+        for (UINT i = 0; i < Desc.NumReads; ++i)
+        {
+            AddDep(m_Resources[Desc.ppReads[i]].LastWrite);
+        }
+        for (UINT i = 0; i < Desc.NumWrites; ++i)
+        {
+            const Resource& Record = m_Resources[Desc.ppWrites[i]];
+            AddDep(Record.LastWrite);
+            for (UINT Reader : Record.Reads)
+            {
+                AddDep(Reader);
+            }
+        }
+
+        HRESULT hr = S_OK;
+        for (UINT P = 0; P < NumQueues && SUCCEEDED(hr); ++P)
+        {
+            if (Deps[P] != UINT_MAX && m_Items[Deps[P]].Fence == 0)
+            {
+                hr = Signal(P);
+            }
+        }
+        for (UINT P = 0; P < NumQueues && SUCCEEDED(hr); ++P)
+        {
+            if (Deps[P] != UINT_MAX && m_Queues[Q].Known[P] < m_Items[Deps[P]].Fence)
+            {
+                hr = Wait(Q, Deps[P]);
+            }
+        }
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_Items.push_back({ Q, 0, {} });
+        m_Queues[Q].Pending.insert(m_Queues[Q].Pending.end(), Desc.ppCommandLists, Desc.ppCommandLists + Desc.NumCommandLists);
+        m_Queues[Q].Unsignaled.push_back(Self);
+        for (UINT i = 0; i < Desc.NumReads; ++i)
+        {
+            m_Resources[Desc.ppReads[i]].Reads[Q] = Self;
+        }
+        for (UINT i = 0; i < Desc.NumWrites; ++i)
+        {
+            Resource& Record = m_Resources[Desc.ppWrites[i]];
+            Record.LastWrite = Self;
+            Record.Reads[0] = Record.Reads[1] = Record.Reads[2] = UINT_MAX;
+        }
+        if (pWorkIndex)
+        {
+            *pWorkIndex = Self;
+        }
+        return S_OK;
+    }
+
+    // Submits and signals every queue with outstanding work
+    HRESULT Flush()
+    {
+        for (UINT Q = 0; Q < NumQueues; ++Q)
+        {
+            if (!m_Queues[Q].Unsignaled.empty())
+            {
+                const HRESULT hr = Signal(Q);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+        }
+        return S_OK;
+    }
+
+    // Fence value on the item's queue that marks its completion, or 0 until it is signaled
+    UINT64 GetFenceValue(UINT WorkIndex) const noexcept { return m_Items[WorkIndex].Fence; }
+
+    UINT64 GetLastSignaledValue(D3D12_COMMAND_LIST_TYPE Type) const noexcept { return m_Queues[GetQueueIndex(Type)].Value; }
+
+    UINT GetNumWorkItems() const noexcept { return static_cast<UINT>(m_Items.size()); }
+
+    UINT GetNumTrackedResources() const noexcept { return static_cast<UINT>(m_Resources.size()); }
+
+    // Stops tracking a resource that is being released. Later work naming the same address is not
+    // ordered after the work scheduled so far, and the next Reset() drops the items only it kept.
+    void Forget(_In_ ID3D12Resource* pResource)
+    {
+        m_Resources.erase(pResource);
+    }
+
+    // Forgets the work items after a Flush(), keeping what later work must still be ordered after.
+    // Work indices returned before are invalidated.
+    void Reset()
+    {
+        std::vector<UINT> Remap(m_Items.size(), UINT_MAX);
+        std::vector<Item> Kept;
+        auto Keep = [&](UINT& ItemIndex)
+        {
+            if (ItemIndex == UINT_MAX)
+            {
+                return;
+            }
+            D3DX12_ASSERT(m_Items[ItemIndex].Fence != 0);
+            if (Remap[ItemIndex] == UINT_MAX)
+            {
+                Remap[ItemIndex] = static_cast<UINT>(Kept.size());
+                Kept.push_back(m_Items[ItemIndex]);
+            }
+            ItemIndex = Remap[ItemIndex];
+        };
+        for (auto& Entry : m_Resources)
+        {
+            Keep(Entry.second.LastWrite);
+            for (UINT& Reader : Entry.second.Reads)
+            {
+                Keep(Reader);
+            }
+        }
+        m_Items.swap(Kept);
+    }
+
+private:
+    struct Item
+    {
+        UINT Queue;
+        UINT64 Fence;
+        UINT64 Clock[NumQueues]; // Values of each queue that Fence is ordered after
+    };
+
+    struct Queue
+    {
+        TQueue* pQueue = nullptr;
+        ID3D12Fence* pFence = nullptr;
+        UINT64 Value = 0;
+        UINT64 Known[NumQueues] = {};
+        std::vector<ID3D12CommandList*> Pending;
+        std::vector<UINT> Unsignaled;
+    };
+
+    struct Resource
+    {
+        UINT LastWrite = UINT_MAX;
+        UINT Reads[NumQueues] = { UINT_MAX, UINT_MAX, UINT_MAX }; // Latest read per queue since LastWrite
+    };
+
+    void ExecutePending(UINT Q)
+    {
+        Queue& Slot = m_Queues[Q];
+        if (!Slot.Pending.empty())
+        {
+            Slot.pQueue->ExecuteCommandLists(static_cast<UINT>(Slot.Pending.size()), Slot.Pending.data());
+            Slot.Pending.clear();
+        }
+    }
+
+    HRESULT Signal(UINT Q)
+    {
+        Queue& Slot = m_Queues[Q];
+        ExecutePending(Q);
+        const HRESULT hr = Slot.pQueue->Signal(Slot.pFence, Slot.Value + 1);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        Slot.Known[Q] = ++Slot.Value;
+        for (UINT ItemIndex : Slot.Unsignaled)
+        {
+            Item& Signaled = m_Items[ItemIndex];
+            Signaled.Fence = Slot.Value;
+            std::copy(Slot.Known, Slot.Known + NumQueues, Signaled.Clock);
+        }
+        Slot.Unsignaled.clear();
+        return S_OK;
+    }
+
+    HRESULT Wait(UINT Q, UINT Dep)
+    {
+        Queue& Slot = m_Queues[Q];
+        const Item& Source = m_Items[Dep];
+        ExecutePending(Q);
+        const HRESULT hr = Slot.pQueue->Wait(m_Queues[Source.Queue].pFence, Source.Fence);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+        for (UINT P = 0; P < NumQueues; ++P)
+        {
+            Slot.Known[P] = (std::max)(Slot.Known[P], Source.Clock[P]);
+        }
+        return S_OK;
+    }
+
+    Queue m_Queues[NumQueues];
+    std::vector<Item> m_Items;
+    std::unordered_map<ID3D12Resource*, Resource> m_Resources;
+};
+
+#endif // !D3DX12_NO_QUEUE_SCHEDULER_HELPERS
+
+#ifndef D3DX12_NO_TEXTURE_STREAMING_HELPERS
+
+//================================================================================================
+// D3DX12 Texture Streaming Helpers
+//
+// Streams texture uploads through a copy queue without blocking the caller the way the synchronous
+// UpdateSubresources pattern does. Requests wait in priority lanes, lane 0 first. Record() moves
+// the next requests into a persistently mapped staging ring: the caller's fill callback writes the
+// subresource data (for instance from a completed file read) at the footprints computed by
+// D3DX12GetCopyableFootprints, and one CopyTextureRegion per subresource is recorded on the copy
+// list. A bounded in-flight byte budget keeps streaming from flooding the staging memory. Update()
+// retires the requests whose fence has completed and frees their staging space.
+// Uses STL
+//
+//================================================================================================
+#include <deque>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_TEXTURE_STREAM_REQUEST
+{
+    ID3D12Resource* pDestination;
+    D3D12_RESOURCE_DESC Desc;
+    UINT FirstSubresource;
+    UINT NumSubresources;
+    UINT Lane;          // Priority lane, 0 is streamed first
+    UINT64 UserData;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12TextureStreamer
+{
+public:
+    CD3DX12TextureStreamer() = default;
+    CD3DX12TextureStreamer(const CD3DX12TextureStreamer&) = delete;
+    CD3DX12TextureStreamer& operator=(const CD3DX12TextureStreamer&) = delete;
+    ~CD3DX12TextureStreamer() { ReleaseResources(); }
+
+    // MaxBytesInFlight bounds the staging bytes of requests recorded but not yet completed; it is at
+    // most StagingSize
+    HRESULT Init(UINT64 StagingSize, UINT64 MaxBytesInFlight, UINT NumLanes = 2)
+    {
+        if (StagingSize == 0 || StagingSize % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT != 0
+            || MaxBytesInFlight == 0 || MaxBytesInFlight > StagingSize || NumLanes == 0)
+        {
+            return E_INVALIDARG;
+        }
+        ReleaseResources();
+        m_StagingSize = StagingSize;
+        m_MaxBytesInFlight = MaxBytesInFlight;
+        m_Lanes.assign(NumLanes, {});
+        m_Recorded.clear();
+        m_InFlight.clear();
+        m_Head = m_Tail = 0;
+        m_BytesInFlight = 0;
+        return S_OK;
+    }
+
+    // Uses a caller-created upload buffer of at least StagingSize bytes, mapped at pMappedStaging
+    void SetResources(_In_ ID3D12Resource* pStaging, _In_ void* pMappedStaging) noexcept
+    {
+        ReleaseResources();
+        m_pStaging = pStaging;
+        m_pMapped = static_cast<BYTE*>(pMappedStaging);
+    }
+
+    // Creates and maps the upload buffer used as the staging ring
+    HRESULT CreateResources(_In_ ID3D12Device* pDevice, UINT NodeMask = 0)
+    {
+        ReleaseResources();
+        const CD3DX12_HEAP_PROPERTIES HeapProperties(D3D12_HEAP_TYPE_UPLOAD, NodeMask, NodeMask);
+        const CD3DX12_RESOURCE_DESC BufferDesc = CD3DX12_RESOURCE_DESC::Buffer(m_StagingSize);
+        HRESULT hr = pDevice->CreateCommittedResource(&HeapProperties, D3D12_HEAP_FLAG_NONE, &BufferDesc, D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr, IID_ID3D12Resource, reinterpret_cast<void**>(&m_pStaging));
+        void* pMapped = nullptr;
+        if (SUCCEEDED(hr))
+        {
+            m_bOwnsResources = true;
+            const D3D12_RANGE NoRead = { 0, 0 };
+            hr = m_pStaging->Map(0, &NoRead, &pMapped);
+        }
+        if (FAILED(hr))
+        {
+            ReleaseResources();
+            return hr;
+        }
+        m_pMapped = static_cast<BYTE*>(pMapped);
+        return S_OK;
+    }
+
+    // Queues a request; fails if its staging footprint can never fit the budget
+    HRESULT Enqueue(const D3DX12_TEXTURE_STREAM_REQUEST& Request)
+    {
+        UINT64 Size = 0;
+        if (Request.pDestination == nullptr || Request.NumSubresources == 0 || Request.Lane >= m_Lanes.size()
+            || !D3DX12GetCopyableFootprints(Request.Desc, Request.FirstSubresource, Request.NumSubresources, 0, nullptr, nullptr, nullptr, &Size)
+            || Size > m_MaxBytesInFlight)
+        {
+            return E_INVALIDARG;
+        }
+        m_Lanes[Request.Lane].push_back({ Request, Size, 0, 0 });
+        return S_OK;
+    }
+
+    // Moves queued requests into staging, highest priority first, until the budget or the ring is
+    // full. Fill(const D3DX12_TEXTURE_STREAM_REQUEST&, void* pStagingData,
+    // const D3D12_PLACED_SUBRESOURCE_FOOTPRINT* pLayouts, const UINT* pNumRows,
+    // const UINT64* pRowSizesInBytes) writes the subresources, where each layout offset is relative
+    // to pStagingData. Returns the number of requests recorded.
+    template <typename TCommandList, typename TFunc>
+    UINT Record(_In_ TCommandList* pCopyList, TFunc&& Fill)
+    {
+        UINT NumRecorded = 0;
+        for (std::deque<Entry>& Lane : m_Lanes)
+        {
+            while (!Lane.empty())
+            {
+                Entry& Next = Lane.front();
+                if (m_BytesInFlight + Next.Size > m_MaxBytesInFlight || !AllocateStaging(Next))
+                {
+                    return NumRecorded;
+                }
+                const D3DX12_TEXTURE_STREAM_REQUEST& Request = Next.Request;
+                m_Layouts.resize(Request.NumSubresources);
+                m_NumRows.resize(Request.NumSubresources);
+                m_RowSizes.resize(Request.NumSubresources);
+                const UINT64 Base = Next.End - Next.Size;
+                D3DX12GetCopyableFootprints(Request.Desc, Request.FirstSubresource, Request.NumSubresources, Base % m_StagingSize,
+                    m_Layouts.data(), m_NumRows.data(), m_RowSizes.data(), nullptr);
+                Fill(Request, static_cast<void*>(m_pMapped), static_cast<const D3D12_PLACED_SUBRESOURCE_FOOTPRINT*>(m_Layouts.data()),
+                    static_cast<const UINT*>(m_NumRows.data()), static_cast<const UINT64*>(m_RowSizes.data()));
+                for (UINT i = 0; i < Request.NumSubresources; ++i)
+                {
+                    const CD3DX12_TEXTURE_COPY_LOCATION Dst(Request.pDestination, Request.FirstSubresource + i);
+                    const CD3DX12_TEXTURE_COPY_LOCATION Src(m_pStaging, m_Layouts[i]);
+                    pCopyList->CopyTextureRegion(&Dst, 0, 0, 0, &Src, nullptr);
+                }
+                m_BytesInFlight += Next.Size;
+                m_Recorded.push_back(Next);
+                Lane.pop_front();
+                ++NumRecorded;
+            }
+        }
+        return NumRecorded;
+    }
+
+    // The requests recorded since the last call complete once FenceValue is signaled on the copy queue
+    void Submit(UINT64 FenceValue)
+    {
+        for (Entry& Recorded : m_Recorded)
+        {
+            Recorded.FenceValue = FenceValue;
+            m_InFlight.push_back(Recorded);
+        }
+        m_Recorded.clear();
+    }
+
+    // Calls OnComplete(const D3DX12_TEXTURE_STREAM_REQUEST&) for every request whose fence has
+    // completed and frees its staging space. Returns the number of requests completed.
+    template <typename TFunc>
+    UINT Update(UINT64 CompletedFenceValue, TFunc&& OnComplete)
+    {
+        UINT NumCompleted = 0;
+        while (!m_InFlight.empty() && m_InFlight.front().FenceValue <= CompletedFenceValue)
+        {
+            const Entry& Completed = m_InFlight.front();
+            m_Tail = Completed.End;
+            m_BytesInFlight -= Completed.Size;
+            OnComplete(Completed.Request);
+            m_InFlight.pop_front();
+            ++NumCompleted;
+        }
+        if (m_InFlight.empty() && m_Recorded.empty())
+        {
+            m_Head = m_Tail = 0;
+        }
+        return NumCompleted;
+    }
+
+    UINT64 GetBytesInFlight() const noexcept { return m_BytesInFlight; }
+
+    UINT GetNumQueued() const noexcept
+    {
+        size_t NumQueued = 0;
+        for (const std::deque<Entry>& Lane : m_Lanes)
+        {
+            NumQueued += Lane.size();
+        }
+        return static_cast<UINT>(NumQueued);
+    }
+
+    UINT GetNumInFlight() const noexcept { return static_cast<UINT>(m_Recorded.size() + m_InFlight.size()); }
+
+private:
+    struct Entry
+    {
+        D3DX12_TEXTURE_STREAM_REQUEST Request;
+        UINT64 Size;
+        UINT64 End;         // Ring position past its staging data; positions grow monotonically
+        UINT64 FenceValue;
+    };
+
+    // Places the entry at the next aligned ring position, wrapping to the start of the buffer when
+    // it would straddle the end
+    bool AllocateStaging(Entry& Next) noexcept
+    {
+        UINT64 Offset = D3DX12Align<UINT64>(m_Head, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        if (Offset % m_StagingSize + Next.Size > m_StagingSize)
+        {
+            Offset = (Offset / m_StagingSize + 1) * m_StagingSize;
+        }
+        if (Offset + Next.Size - m_Tail > m_StagingSize)
+        {
+            return false;
+        }
+        m_Head = Next.End = Offset + Next.Size;
+        return true;
+    }
+
+    void ReleaseResources() noexcept
+    {
+        if (m_bOwnsResources && m_pStaging)
+        {
+            m_pStaging->Release();
+        }
+        m_pStaging = nullptr;
+        m_pMapped = nullptr;
+        m_bOwnsResources = false;
+    }
+
+    UINT64 m_StagingSize = 0;
+    UINT64 m_MaxBytesInFlight = 0;
+    UINT64 m_BytesInFlight = 0;
+    UINT64 m_Head = 0;
+    UINT64 m_Tail = 0;
+    std::vector<std::deque<Entry>> m_Lanes;
+    std::vector<Entry> m_Recorded;
+    std::deque<Entry> m_InFlight;
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> m_Layouts;
+    std::vector<UINT> m_NumRows;
+    std::vector<UINT64> m_RowSizes;
+    ID3D12Resource* m_pStaging = nullptr;
+    BYTE* m_pMapped = nullptr;
+    bool m_bOwnsResources = false;
+};
+
+#endif // !D3DX12_NO_TEXTURE_STREAMING_HELPERS
+
+#ifndef D3DX12_NO_TEXTURE_CONTAINER_HELPERS
+
+//================================================================================================
+// D3DX12 Texture Container Helpers
+//
+// A texture file format whose payload is already in the upload layout that
+// D3DX12GetCopyableFootprints computes: rows are pitched to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+// and subresources start at D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT. An uncompressed payload is
+// itself placement aligned within the file. It can be read or mapped straight into an upload heap
+// and copied with no CPU reformatting.
+//
+// The payload can be split into chunks compressed by a caller-supplied codec (LZ4, zstd, ...); the
+// container only records the codec id. Chunks decompress independently into disjoint ranges of
+// the payload, so they can be decompressed in parallel.
+// Uses STL
+//
+// Layout: header, subresource table, chunk table, then the payload or the compressed chunks.
+//
+//================================================================================================
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+enum D3DX12_TEXTURE_CONTAINER_COMPRESSION
+{
+    D3DX12_TEXTURE_CONTAINER_COMPRESSION_NONE = 0,
+    D3DX12_TEXTURE_CONTAINER_COMPRESSION_LZ4 = 1,
+    D3DX12_TEXTURE_CONTAINER_COMPRESSION_ZSTD = 2,
+};
+
+struct D3DX12_TEXTURE_CONTAINER_HEADER
+{
+    UINT Magic;                 // D3DX12_TEXTURE_CONTAINER_MAGIC
+    UINT Version;
+    UINT64 Width;
+    UINT Height;
+    UINT Format;                // DXGI_FORMAT
+    UINT Dimension;             // D3D12_RESOURCE_DIMENSION
+    UINT Flags;                 // D3D12_RESOURCE_FLAGS
+    UINT16 DepthOrArraySize;
+    UINT16 MipLevels;
+    UINT NumSubresources;
+    UINT Compression;           // D3DX12_TEXTURE_CONTAINER_COMPRESSION or a codec id of the caller's
+    UINT ChunkSize;             // Uncompressed bytes per chunk, 0 without compression
+    UINT NumChunks;
+    UINT Reserved;
+    UINT64 PayloadSize;         // Uncompressed
+    UINT64 PayloadOffset;       // Of the payload or of the first chunk
+};
+static_assert(sizeof(D3DX12_TEXTURE_CONTAINER_HEADER) == 72, "Texture container header layout changed");
+
+struct D3DX12_TEXTURE_CONTAINER_SUBRESOURCE
+{
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layout; // Offset relative to the payload
+    UINT NumRows;
+    UINT Reserved;
+    UINT64 RowSizeInBytes;
+};
+
+struct D3DX12_TEXTURE_CONTAINER_CHUNK
+{
+    UINT64 Offset;              // In the file
+    UINT CompressedSize;        // Equal to UncompressedSize when the chunk is stored uncompressed
+    UINT UncompressedSize;
+};
+
+constexpr UINT D3DX12_TEXTURE_CONTAINER_MAGIC = 0x43545844; // 'DXTC'
+constexpr UINT D3DX12_TEXTURE_CONTAINER_VERSION = 1;
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12TextureContainerWriter
+{
+public:
+    // All the subresources of Desc are stored; its layout must be D3D12_TEXTURE_LAYOUT_UNKNOWN
+    HRESULT Init(const D3D12_RESOURCE_DESC& Desc)
+    {
+        m_Subresources.clear();
+        m_Payload.clear();
+        if (Desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER || Desc.Dimension == D3D12_RESOURCE_DIMENSION_UNKNOWN
+            || Desc.Layout != D3D12_TEXTURE_LAYOUT_UNKNOWN || Desc.MipLevels == 0 || Desc.SampleDesc.Count > 1
+            || !D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExists(Desc.Format))
+        {
+            return E_INVALIDARG;
+        }
+        const UINT NumSubresources = Desc.MipLevels * D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetPlaneCount(Desc.Format)
+            * (Desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? 1u : Desc.DepthOrArraySize);
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Layouts(NumSubresources);
+        std::vector<UINT> NumRows(NumSubresources);
+        std::vector<UINT64> RowSizes(NumSubresources);
+        UINT64 PayloadSize = 0;
+        if (!D3DX12GetCopyableFootprints(Desc, 0, NumSubresources, 0, Layouts.data(), NumRows.data(), RowSizes.data(), &PayloadSize)
+            || PayloadSize > SIZE_T(-1))
+        {
+            return E_INVALIDARG;
+        }
+        m_Desc = Desc;
+        m_Subresources.resize(NumSubresources);
+        for (UINT i = 0; i < NumSubresources; ++i)
+        {
+            m_Subresources[i] = { Layouts[i], NumRows[i], 0, RowSizes[i] };
+        }
+        m_Payload.assign(static_cast<SIZE_T>(PayloadSize), 0);
+        return S_OK;
+    }
+
+    UINT GetNumSubresources() const noexcept { return static_cast<UINT>(m_Subresources.size()); }
+    const D3DX12_TEXTURE_CONTAINER_SUBRESOURCE& GetSubresource(UINT Subresource) const noexcept { return m_Subresources[Subresource]; }
+
+    // The payload can also be written directly at the subresource layouts
+    BYTE* GetPayload() noexcept { return m_Payload.data(); }
+    UINT64 GetPayloadSize() const noexcept { return m_Payload.size(); }
+
+    void SetSubresource(UINT Subresource, const D3D12_SUBRESOURCE_DATA& Data) noexcept
+    {
+        const D3DX12_TEXTURE_CONTAINER_SUBRESOURCE& Entry = m_Subresources[Subresource];
+        const D3D12_MEMCPY_DEST Dest = { m_Payload.data() + Entry.Layout.Offset, Entry.Layout.Footprint.RowPitch,
+            SIZE_T(Entry.Layout.Footprint.RowPitch) * Entry.NumRows };
+        MemcpySubresource(&Dest, &Data, static_cast<SIZE_T>(Entry.RowSizeInBytes), Entry.NumRows, Entry.Layout.Footprint.Depth);
+    }
+
+    // Writes the container with the payload uncompressed
+    void Serialize(std::vector<BYTE>& File) const
+    {
+        WriteTables(File, D3DX12_TEXTURE_CONTAINER_COMPRESSION_NONE, 0, 0);
+        File.resize(static_cast<SIZE_T>(GetHeader(File).PayloadOffset));
+        File.insert(File.end(), m_Payload.begin(), m_Payload.end());
+    }
+
+    // Writes the container with the payload split into ChunkSize chunks, each passed to
+    // Compress(const void* pSrc, UINT SrcSize, std::vector<BYTE>& Compressed). A chunk is stored
+    // uncompressed when Compress returns false or does not make it smaller.
+    template <typename TFunc>
+    HRESULT Serialize(std::vector<BYTE>& File, UINT Compression, UINT ChunkSize, TFunc&& Compress) const
+    {
+        if (Compression == D3DX12_TEXTURE_CONTAINER_COMPRESSION_NONE || ChunkSize == 0)
+        {
+            return E_INVALIDARG;
+        }
+        const UINT NumChunks = static_cast<UINT>((m_Payload.size() + ChunkSize - 1) / ChunkSize);
+        WriteTables(File, Compression, ChunkSize, NumChunks);
+        std::vector<BYTE> Compressed;
+        for (UINT i = 0; i < NumChunks; ++i)
+        {
+            const SIZE_T Begin = SIZE_T(i) * ChunkSize;
+            const UINT Size = static_cast<UINT>((std::min)(SIZE_T(ChunkSize), m_Payload.size() - Begin));
+            Compressed.clear();
+            const bool bCompressed = Compress(static_cast<const void*>(m_Payload.data() + Begin), Size, Compressed) && Compressed.size() < Size;
+            const D3DX12_TEXTURE_CONTAINER_CHUNK Chunk = { File.size(), bCompressed ? static_cast<UINT>(Compressed.size()) : Size, Size };
+            if (bCompressed)
+            {
+                File.insert(File.end(), Compressed.begin(), Compressed.end());
+            }
+            else
+            {
+                File.insert(File.end(), m_Payload.begin() + Begin, m_Payload.begin() + Begin + Size);
+            }
+            memcpy(File.data() + ChunkTableOffset() + sizeof(Chunk) * i, &Chunk, sizeof(Chunk));
+        }
+        return S_OK;
+    }
+
+private:
+    SIZE_T ChunkTableOffset() const noexcept
+    {
+        return sizeof(D3DX12_TEXTURE_CONTAINER_HEADER) + sizeof(D3DX12_TEXTURE_CONTAINER_SUBRESOURCE) * m_Subresources.size();
+    }
+
+    static const D3DX12_TEXTURE_CONTAINER_HEADER& GetHeader(const std::vector<BYTE>& File) noexcept
+    {
+        return *reinterpret_cast<const D3DX12_TEXTURE_CONTAINER_HEADER*>(File.data());
+    }
+
+    void WriteTables(std::vector<BYTE>& File, UINT Compression, UINT ChunkSize, UINT NumChunks) const
+    {
+        const SIZE_T TablesEnd = ChunkTableOffset() + sizeof(D3DX12_TEXTURE_CONTAINER_CHUNK) * NumChunks;
+        D3DX12_TEXTURE_CONTAINER_HEADER Header = {};
+        Header.Magic = D3DX12_TEXTURE_CONTAINER_MAGIC;
+        Header.Version = D3DX12_TEXTURE_CONTAINER_VERSION;
+        Header.Width = m_Desc.Width;
+        Header.Height = m_Desc.Height;
+        Header.Format = m_Desc.Format;
+        Header.Dimension = m_Desc.Dimension;
+        Header.Flags = m_Desc.Flags;
+        Header.DepthOrArraySize = m_Desc.DepthOrArraySize;
+        Header.MipLevels = m_Desc.MipLevels;
+        Header.NumSubresources = static_cast<UINT>(m_Subresources.size());
+        Header.Compression = Compression;
+        Header.ChunkSize = ChunkSize;
+        Header.NumChunks = NumChunks;
+        Header.PayloadSize = m_Payload.size();
+        Header.PayloadOffset = NumChunks ? TablesEnd : D3DX12Align<UINT64>(TablesEnd, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+        File.assign(TablesEnd, 0);
+        memcpy(File.data(), &Header, sizeof(Header));
+        memcpy(File.data() + sizeof(Header), m_Subresources.data(), sizeof(D3DX12_TEXTURE_CONTAINER_SUBRESOURCE) * m_Subresources.size());
+    }
+
+    D3D12_RESOURCE_DESC m_Desc = {};
+    std::vector<D3DX12_TEXTURE_CONTAINER_SUBRESOURCE> m_Subresources;
+    std::vector<BYTE> m_Payload;
+};
+
+//------------------------------------------------------------------------------------------------
+// Reads a container in place; the data must stay valid and be 8-byte aligned
+class CD3DX12TextureContainerReader
+{
+public:
+    HRESULT Init(_In_reads_bytes_(Size) const void* pData, SIZE_T Size) noexcept
+    {
+        m_pHeader = nullptr;
+        const auto* pHeader = static_cast<const D3DX12_TEXTURE_CONTAINER_HEADER*>(pData);
+        if (pData == nullptr || reinterpret_cast<UINT_PTR>(pData) % 8 != 0 || Size < sizeof(*pHeader)
+            || pHeader->Magic != D3DX12_TEXTURE_CONTAINER_MAGIC || pHeader->Version != D3DX12_TEXTURE_CONTAINER_VERSION)
+        {
+            return E_INVALIDARG;
+        }
+        const UINT64 TablesEnd = sizeof(*pHeader) + UINT64(sizeof(D3DX12_TEXTURE_CONTAINER_SUBRESOURCE)) * pHeader->NumSubresources
+            + UINT64(sizeof(D3DX12_TEXTURE_CONTAINER_CHUNK)) * pHeader->NumChunks;
+        if (TablesEnd > Size || pHeader->PayloadOffset < TablesEnd || pHeader->PayloadOffset > Size
+            || (pHeader->NumChunks == 0 && pHeader->PayloadSize > Size - pHeader->PayloadOffset))
+        {
+            return E_INVALIDARG;
+        }
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        const auto* pSubresources = reinterpret_cast<const D3DX12_TEXTURE_CONTAINER_SUBRESOURCE*>(pBytes + sizeof(*pHeader));
+        for (UINT i = 0; i < pHeader->NumSubresources; ++i)
+        {
+            const D3DX12_TEXTURE_CONTAINER_SUBRESOURCE& Entry = pSubresources[i];
+            const UINT64 NumRows = UINT64(Entry.NumRows) * Entry.Layout.Footprint.Depth;
+            if (NumRows == 0 || Entry.RowSizeInBytes > Entry.Layout.Footprint.RowPitch || Entry.Layout.Offset > pHeader->PayloadSize
+                || Entry.Layout.Footprint.RowPitch * (NumRows - 1) + Entry.RowSizeInBytes > pHeader->PayloadSize - Entry.Layout.Offset)
+            {
+                return E_INVALIDARG;
+            }
+        }
+        const auto* pChunks = reinterpret_cast<const D3DX12_TEXTURE_CONTAINER_CHUNK*>(pSubresources + pHeader->NumSubresources);
+        UINT64 Uncompressed = 0;
+        for (UINT i = 0; i < pHeader->NumChunks; ++i)
+        {
+            if (pChunks[i].Offset > Size || pChunks[i].CompressedSize > Size - pChunks[i].Offset
+                || pChunks[i].UncompressedSize > pHeader->ChunkSize
+                || UINT64(i) * pHeader->ChunkSize + pChunks[i].UncompressedSize > pHeader->PayloadSize)
+            {
+                return E_INVALIDARG;
+            }
+            Uncompressed += pChunks[i].UncompressedSize;
+        }
+        if (pHeader->NumChunks != 0 && Uncompressed != pHeader->PayloadSize)
+        {
+            return E_INVALIDARG;
+        }
+        m_pHeader = pHeader;
+        m_pSubresources = pSubresources;
+        m_pChunks = pChunks;
+        m_pBytes = pBytes;
+        return S_OK;
+    }
+
+    D3D12_RESOURCE_DESC GetResourceDesc() const noexcept
+    {
+        D3D12_RESOURCE_DESC Desc = {};
+        Desc.Dimension = static_cast<D3D12_RESOURCE_DIMENSION>(m_pHeader->Dimension);
+        Desc.Width = m_pHeader->Width;
+        Desc.Height = m_pHeader->Height;
+        Desc.DepthOrArraySize = m_pHeader->DepthOrArraySize;
+        Desc.MipLevels = m_pHeader->MipLevels;
+        Desc.Format = static_cast<DXGI_FORMAT>(m_pHeader->Format);
+        Desc.SampleDesc.Count = 1;
+        Desc.Flags = static_cast<D3D12_RESOURCE_FLAGS>(m_pHeader->Flags);
+        return Desc;
+    }
+
+    const D3DX12_TEXTURE_CONTAINER_HEADER& GetHeader() const noexcept { return *m_pHeader; }
+    UINT GetNumSubresources() const noexcept { return m_pHeader->NumSubresources; }
+    const D3DX12_TEXTURE_CONTAINER_SUBRESOURCE& GetSubresource(UINT Subresource) const noexcept { return m_pSubresources[Subresource]; }
+    UINT64 GetPayloadSize() const noexcept { return m_pHeader->PayloadSize; }
+    UINT GetNumChunks() const noexcept { return m_pHeader->NumChunks; }
+    const D3DX12_TEXTURE_CONTAINER_CHUNK& GetChunk(UINT Chunk) const noexcept { return m_pChunks[Chunk]; }
+
+    // Layout of a subresource once the payload is placed at BaseOffset of an upload buffer; BaseOffset
+    // must be a multiple of D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT GetLayout(UINT Subresource, UINT64 BaseOffset = 0) const noexcept
+    {
+        D3DX12_ASSERT(BaseOffset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT == 0);
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layout = m_pSubresources[Subresource].Layout;
+        Layout.Offset += BaseOffset;
+        return Layout;
+    }
+
+    // The payload in the file, or nullptr when it is compressed
+    const void* GetPayload() const noexcept { return m_pHeader->NumChunks ? nullptr : m_pBytes + m_pHeader->PayloadOffset; }
+
+    // Decompresses one chunk into its range of the payload at pPayload, calling
+    // Decompress(const void* pSrc, UINT SrcSize, void* pDest, UINT DestSize) for compressed chunks.
+    // Chunks write disjoint ranges, so they may be decompressed concurrently.
+    template <typename TFunc>
+    HRESULT DecompressChunk(UINT Chunk, _Out_ void* pPayload, TFunc&& Decompress) const
+    {
+        const D3DX12_TEXTURE_CONTAINER_CHUNK& Entry = m_pChunks[Chunk];
+        BYTE* pDest = static_cast<BYTE*>(pPayload) + SIZE_T(Chunk) * m_pHeader->ChunkSize;
+        if (Entry.CompressedSize == Entry.UncompressedSize)
+        {
+            memcpy(pDest, m_pBytes + Entry.Offset, Entry.UncompressedSize);
+            return S_OK;
+        }
+        return Decompress(static_cast<const void*>(m_pBytes + Entry.Offset), Entry.CompressedSize, static_cast<void*>(pDest), Entry.UncompressedSize)
+            ? S_OK : E_FAIL;
+    }
+
+    // Writes the whole payload, GetPayloadSize() bytes, to pPayload
+    template <typename TFunc>
+    HRESULT ReadPayload(_Out_ void* pPayload, TFunc&& Decompress) const
+    {
+        if (m_pHeader->NumChunks == 0)
+        {
+            memcpy(pPayload, GetPayload(), static_cast<SIZE_T>(m_pHeader->PayloadSize));
+            return S_OK;
+        }
+        for (UINT i = 0; i < m_pHeader->NumChunks; ++i)
+        {
+            const HRESULT hr = DecompressChunk(i, pPayload, Decompress);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+        return S_OK;
+    }
+
+private:
+    const D3DX12_TEXTURE_CONTAINER_HEADER* m_pHeader = nullptr;
+    const D3DX12_TEXTURE_CONTAINER_SUBRESOURCE* m_pSubresources = nullptr;
+    const D3DX12_TEXTURE_CONTAINER_CHUNK* m_pChunks = nullptr;
+    const BYTE* m_pBytes = nullptr;
+};
+
+#endif // !D3DX12_NO_TEXTURE_CONTAINER_HELPERS
+
+#ifndef D3DX12_NO_PIXEL_CODEC_HELPERS
+
+//================================================================================================
+// D3DX12 Pixel Codec Helpers
+//
+// Decodes rows of pixels of any uncompressed, fully typed, standard-layout format to RGBA floats
+// and encodes them back, using the component names, bit widths and interpretations of
+// D3D12_PROPERTY_LAYOUT_FORMAT_TABLE. Components are packed from the least significant bit in
+// table order; sRGB components are converted to and from linear space, and missing channels
+// decode as (0, 0, 0, 1). Depth decodes to the red channel; planar formats (including depth-stencil)
+// are not supported.
+// Uses STL
+//
+//================================================================================================
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12PixelCodec
+{
+public:
+    static constexpr UINT MaxBytesPerPixel = 16;
+
+    HRESULT Init(DXGI_FORMAT Format) noexcept
+    {
+        m_Format = DXGI_FORMAT_UNKNOWN;
+        m_NumComponents = 0;
+        if (!D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExists(Format) || Format == DXGI_FORMAT_UNKNOWN
+            || D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::IsBlockCompressFormat(Format)
+            || D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::Planar(Format)
+            || D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::YUV(Format)
+            || D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetLayout(Format) != D3DFL_STANDARD
+            || D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetTypeLevel(Format) != D3DFTL_FULL_TYPE)
+        {
+            return E_INVALIDARG;
+        }
+        const UINT BitsPerPixel = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetBitsPerUnit(Format);
+        if (BitsPerPixel == 0 || BitsPerPixel % 8 != 0 || BitsPerPixel / 8 > MaxBytesPerPixel)
+        {
+            return E_INVALIDARG;
+        }
+        UINT Offset = 0;
+        for (UINT i = 0; i < 4; ++i)
+        {
+            const UINT Bits = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetBitsPerComponent(Format, i);
+            const D3D_FORMAT_COMPONENT_NAME Name = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetComponentName(Format, i);
+            D3D_FORMAT_COMPONENT_INTERPRETATION Interpretation = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormatComponentInterpretation(Format, i);
+            if (Bits != 0 && Name != D3DFCN_X)
+            {
+                if (Bits > 32 || Interpretation == D3DFCI_TYPELESS)
+                {
+                    return E_INVALIDARG;
+                }
+                if (Interpretation == D3DFCI_FLOAT && Bits != 32 && Bits != 16 && Bits != 11 && Bits != 10)
+                {
+                    return E_INVALIDARG;
+                }
+
+                // Alpha is never stored in sRGB space
+                if (Interpretation == D3DFCI_UNORM_SRGB && Name == D3DFCN_A)
+                {
+                    Interpretation = D3DFCI_UNORM;
+                }
+                Component& Entry = m_Components[m_NumComponents++];
+                Entry.Channel = GetChannel(Name);
+                Entry.ByteOffset = Offset / 8;
+                Entry.Shift = Offset % 8;
+                Entry.NumBytes = (Offset % 8 + Bits + 7) / 8;
+                Entry.Bits = Bits;
+                Entry.Interpretation = Interpretation;
+            }
+            Offset += Bits;
+        }
+        if (m_NumComponents == 0)
+        {
+            return E_INVALIDARG;
+        }
+        m_Format = Format;
+        m_BytesPerPixel = BitsPerPixel / 8;
+        return S_OK;
+    }
+
+    DXGI_FORMAT GetFormat() const noexcept { return m_Format; }
+    UINT GetBytesPerPixel() const noexcept { return m_BytesPerPixel; }
+
+    // Writes 4 floats per pixel to pRGBA. Rows are processed one component at a time, so the
+    // interpretation is resolved once per component rather than once per texel.
+    void DecodeRow(_In_reads_bytes_(NumPixels * GetBytesPerPixel()) const void* pSrc, UINT NumPixels,
+        _Out_writes_(NumPixels * 4) float* pRGBA) const noexcept
+    {
+        for (UINT x = 0; x < NumPixels; ++x)
+        {
+            pRGBA[x * 4] = pRGBA[x * 4 + 1] = pRGBA[x * 4 + 2] = 0.0f;
+            pRGBA[x * 4 + 3] = 1.0f;
+        }
+        const BYTE* pBytes = static_cast<const BYTE*>(pSrc);
+        for (UINT i = 0; i < m_NumComponents; ++i)
+        {
+            const Component& Entry = m_Components[i];
+            switch (Entry.Interpretation)
+            {
+            case D3DFCI_FLOAT: DecodeComponent<D3DFCI_FLOAT>(Entry, pBytes, NumPixels, pRGBA); break;
+            case D3DFCI_UNORM: DecodeComponent<D3DFCI_UNORM>(Entry, pBytes, NumPixels, pRGBA); break;
+            case D3DFCI_UNORM_SRGB: DecodeComponent<D3DFCI_UNORM_SRGB>(Entry, pBytes, NumPixels, pRGBA); break;
+            case D3DFCI_SNORM: DecodeComponent<D3DFCI_SNORM>(Entry, pBytes, NumPixels, pRGBA); break;
+            case D3DFCI_UINT: DecodeComponent<D3DFCI_UINT>(Entry, pBytes, NumPixels, pRGBA); break;
+            case D3DFCI_SINT: DecodeComponent<D3DFCI_SINT>(Entry, pBytes, NumPixels, pRGBA); break;
+            case D3DFCI_BIASED_FIXED_2_8: DecodeComponent<D3DFCI_BIASED_FIXED_2_8>(Entry, pBytes, NumPixels, pRGBA); break;
+            default: DecodeComponent<D3DFCI_TYPELESS>(Entry, pBytes, NumPixels, pRGBA); break;
+            }
+        }
+    }
+
+    // Reads 4 floats per pixel from pRGBA; values out of range are clamped and padding bits are zero
+    void EncodeRow(_In_reads_(NumPixels * 4) const float* pRGBA, UINT NumPixels,
+        _Out_writes_bytes_(NumPixels * GetBytesPerPixel()) void* pDst) const noexcept
+    {
+        BYTE* pBytes = static_cast<BYTE*>(pDst);
+        memset(pBytes, 0, SIZE_T(NumPixels) * m_BytesPerPixel);
+        for (UINT i = 0; i < m_NumComponents; ++i)
+        {
+            const Component& Entry = m_Components[i];
+            switch (Entry.Interpretation)
+            {
+            case D3DFCI_FLOAT: EncodeComponent<D3DFCI_FLOAT>(Entry, pRGBA, NumPixels, pBytes); break;
+            case D3DFCI_UNORM: EncodeComponent<D3DFCI_UNORM>(Entry, pRGBA, NumPixels, pBytes); break;
+            case D3DFCI_UNORM_SRGB: EncodeComponent<D3DFCI_UNORM_SRGB>(Entry, pRGBA, NumPixels, pBytes); break;
+            case D3DFCI_SNORM: EncodeComponent<D3DFCI_SNORM>(Entry, pRGBA, NumPixels, pBytes); break;
+            case D3DFCI_UINT: EncodeComponent<D3DFCI_UINT>(Entry, pRGBA, NumPixels, pBytes); break;
+            case D3DFCI_SINT: EncodeComponent<D3DFCI_SINT>(Entry, pRGBA, NumPixels, pBytes); break;
+            case D3DFCI_BIASED_FIXED_2_8: EncodeComponent<D3DFCI_BIASED_FIXED_2_8>(Entry, pRGBA, NumPixels, pBytes); break;
+            default: break;
+            }
+        }
+    }
+
+    static float SRGBToLinear(float Value) noexcept
+    {
+        return Value <= 0.04045f ? Value / 12.92f : std::pow((Value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float LinearToSRGB(float Value) noexcept
+    {
+        return Value <= 0.0031308f ? Value * 12.92f : 1.055f * std::pow(Value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    // Unsigned or signed float with the given exponent and mantissa widths, exponent bias 2^(E-1)-1
+    static float SmallFloatToFloat(UINT Bits, UINT ExponentBits, UINT MantissaBits, bool bSigned) noexcept
+    {
+        const UINT Mantissa = Bits & ((1u << MantissaBits) - 1);
+        const UINT Exponent = (Bits >> MantissaBits) & ((1u << ExponentBits) - 1);
+        const int Bias = (1 << (ExponentBits - 1)) - 1;
+        const float Sign = (bSigned && (Bits >> (MantissaBits + ExponentBits)) & 1) ? -1.0f : 1.0f;
+        if (Exponent == (1u << ExponentBits) - 1)
+        {
+            return Mantissa ? NAN : Sign * INFINITY;
+        }
+        if (Exponent == 0)
+        {
+            return Sign * std::ldexp(float(Mantissa), 1 - Bias - int(MantissaBits));
+        }
+        return Sign * std::ldexp(float(Mantissa | (1u << MantissaBits)), int(Exponent) - Bias - int(MantissaBits));
+    }
+
+    // Rounds to nearest even; unsigned formats clamp negative values to zero
+    static UINT FloatToSmallFloat(float Value, UINT ExponentBits, UINT MantissaBits, bool bSigned) noexcept
+    {
+        const UINT ExponentMask = (1u << ExponentBits) - 1;
+        UINT Sign = 0;
+        if (std::isnan(Value))
+        {
+            return (ExponentMask << MantissaBits) | 1u;
+        }
+        if (Value < 0.0f || (Value == 0.0f && std::signbit(Value)))
+        {
+            if (!bSigned)
+            {
+                return 0;
+            }
+            Sign = 1u << (ExponentBits + MantissaBits);
+            Value = -Value;
+        }
+        const int Bias = (1 << (ExponentBits - 1)) - 1;
+        const float MaxValue = std::ldexp(float((2u << MantissaBits) - 1), int(ExponentMask) - 1 - Bias - int(MantissaBits));
+        if (Value >= MaxValue)
+        {
+            // Values that round past the largest finite value become infinity
+            const float Limit = std::ldexp(float((4u << MantissaBits) - 1), int(ExponentMask) - 2 - Bias - int(MantissaBits));
+            return Sign | (Value < Limit ? (ExponentMask << MantissaBits) - 1 : ExponentMask << MantissaBits);
+        }
+        int Exponent = 0;
+        std::frexp(Value, &Exponent);
+        Exponent = (std::max)(Exponent - 1, 1 - Bias);
+        const float Scaled = std::ldexp(Value, int(MantissaBits) - Exponent);
+        UINT Mantissa = static_cast<UINT>(std::nearbyint(Scaled));
+        UINT BiasedExponent = static_cast<UINT>(Exponent + Bias);
+        if (Mantissa < (1u << MantissaBits))
+        {
+            BiasedExponent = 0; // Denormal
+        }
+        else if (Mantissa >= (2u << MantissaBits))
+        {
+            Mantissa >>= 1;
+            ++BiasedExponent;
+        }
+        return Sign | (BiasedExponent << MantissaBits) | (Mantissa & ((1u << MantissaBits) - 1));
+    }
+
+private:
+    struct Component
+    {
+        UINT Channel;
+        UINT ByteOffset;
+        UINT Shift;
+        UINT NumBytes;  // Bytes spanned by the component, so reads never run past the pixel
+        UINT Bits;
+        D3D_FORMAT_COMPONENT_INTERPRETATION Interpretation;
+    };
+
+    static UINT GetChannel(D3D_FORMAT_COMPONENT_NAME Name) noexcept
+    {
+        switch (Name)
+        {
+        case D3DFCN_G: case D3DFCN_S: return 1;
+        case D3DFCN_B: return 2;
+        case D3DFCN_A: return 3;
+        default: return 0;
+        }
+    }
+
+    static UINT ReadBits(const BYTE* pPixel, const Component& Entry) noexcept
+    {
+        UINT64 Window = 0;
+        memcpy(&Window, pPixel + Entry.ByteOffset, Entry.NumBytes);
+        return static_cast<UINT>((Window >> Entry.Shift) & ((UINT64(1) << Entry.Bits) - 1));
+    }
+
+    static void WriteBits(BYTE* pPixel, const Component& Entry, UINT Value) noexcept
+    {
+        UINT64 Window = 0;
+        memcpy(&Window, pPixel + Entry.ByteOffset, Entry.NumBytes);
+        Window |= UINT64(Value) << Entry.Shift;
+        memcpy(pPixel + Entry.ByteOffset, &Window, Entry.NumBytes);
+    }
+
+    template<D3D_FORMAT_COMPONENT_INTERPRETATION Interpretation>
+    void DecodeComponent(const Component& Entry, const BYTE* pSrc, UINT NumPixels, float* pRGBA) const noexcept
+    {
+        for (UINT x = 0; x < NumPixels; ++x, pSrc += m_BytesPerPixel)
+        {
+            pRGBA[x * 4 + Entry.Channel] = DecodeValue<Interpretation>(Entry, ReadBits(pSrc, Entry));
+        }
+    }
+
+    template<D3D_FORMAT_COMPONENT_INTERPRETATION Interpretation>
+    void EncodeComponent(const Component& Entry, const float* pRGBA, UINT NumPixels, BYTE* pDst) const noexcept
+    {
+        for (UINT x = 0; x < NumPixels; ++x, pDst += m_BytesPerPixel)
+        {
+            WriteBits(pDst, Entry, EncodeValue<Interpretation>(Entry, pRGBA[x * 4 + Entry.Channel]));
+        }
+    }
+
+    template<D3D_FORMAT_COMPONENT_INTERPRETATION Interpretation>
+    static float DecodeValue(const Component& Entry, UINT Bits) noexcept
+    {
+        const double MaxUnsigned = double((UINT64(1) << Entry.Bits) - 1);
+        const UINT SignBit = 1u << (Entry.Bits - 1);
+        const INT Signed = Entry.Bits == 32 ? INT(Bits) : INT(Bits ^ SignBit) - INT(SignBit);
+        switch (Interpretation)
+        {
+        case D3DFCI_FLOAT:
+            if (Entry.Bits == 32)
+            {
+                float Value;
+                memcpy(&Value, &Bits, sizeof(Value));
+                return Value;
+            }
+            return Entry.Bits == 16 ? SmallFloatToFloat(Bits, 5, 10, true) : SmallFloatToFloat(Bits, 5, Entry.Bits - 5, false);
+        case D3DFCI_UNORM:
+            return float(Bits / MaxUnsigned);
+        case D3DFCI_UNORM_SRGB:
+            return SRGBToLinear(float(Bits / MaxUnsigned));
+        case D3DFCI_SNORM:
+            return (std::max)(float(Signed / double(SignBit - 1)), -1.0f);
+        case D3DFCI_UINT:
+            return float(Bits);
+        case D3DFCI_SINT:
+            return float(Signed);
+        case D3DFCI_BIASED_FIXED_2_8:
+            return float((double(Bits) - 384.0) / 510.0);
+        default:
+            return 0.0f;
+        }
+    }
+
+    template<D3D_FORMAT_COMPONENT_INTERPRETATION Interpretation>
+    static UINT EncodeValue(const Component& Entry, float Value) noexcept
+    {
+        const double MaxUnsigned = double((UINT64(1) << Entry.Bits) - 1);
+        const UINT Mask = UINT((UINT64(1) << Entry.Bits) - 1);
+        const double MaxSigned = double((UINT64(1) << (Entry.Bits - 1)) - 1);
+        const double Clamped = std::isnan(Value) ? 0.0 : double(Value);
+        switch (Interpretation)
+        {
+        case D3DFCI_FLOAT:
+            if (Entry.Bits == 32)
+            {
+                UINT Bits;
+                memcpy(&Bits, &Value, sizeof(Bits));
+                return Bits;
+            }
+            return Entry.Bits == 16 ? FloatToSmallFloat(Value, 5, 10, true) : FloatToSmallFloat(Value, 5, Entry.Bits - 5, false);
+        case D3DFCI_UNORM_SRGB:
+            return UINT(std::floor(LinearToSRGB(float((std::min)((std::max)(Clamped, 0.0), 1.0))) * MaxUnsigned + 0.5));
+        case D3DFCI_UNORM:
+            return UINT(std::floor((std::min)((std::max)(Clamped, 0.0), 1.0) * MaxUnsigned + 0.5));
+        case D3DFCI_SNORM:
+            return UINT(INT(std::floor((std::min)((std::max)(Clamped, -1.0), 1.0) * MaxSigned + 0.5))) & Mask;
+        case D3DFCI_UINT:
+            return UINT((std::min)((std::max)(std::floor(Clamped + 0.5), 0.0), MaxUnsigned));
+        case D3DFCI_SINT:
+            return UINT(INT((std::min)((std::max)(std::floor(Clamped + 0.5), -MaxSigned - 1.0), MaxSigned))) & Mask;
+        case D3DFCI_BIASED_FIXED_2_8:
+            return UINT((std::min)((std::max)(std::floor(Clamped * 510.0 + 384.0 + 0.5), 0.0), MaxUnsigned));
+        default:
+            return 0;
+        }
+    }
+
+    DXGI_FORMAT m_Format = DXGI_FORMAT_UNKNOWN;
+    UINT m_BytesPerPixel = 0;
+    UINT m_NumComponents = 0;
+    Component m_Components[4] = {};
+};
+
+#endif // !D3DX12_NO_PIXEL_CODEC_HELPERS
+
+#if !defined(D3DX12_NO_PIXEL_CONVERSION_HELPERS) && !defined(D3DX12_NO_PIXEL_CODEC_HELPERS)
+
+//================================================================================================
+// D3DX12 Pixel Conversion Helpers
+//
+// Converts rows of pixels between any two formats supported by CD3DX12PixelCodec. Pixels are
+// decoded to RGBA floats and re-encoded in batches. The most common conversions use dedicated
+// loops with the same results: RGBA8 <-> BGRA8, 8-bit UNORM <-> UNORM_SRGB (in either channel
+// order), R16/R16G16/R16G16B16A16_FLOAT <-> their 32-bit float counterparts, and
+// R10G10B10A2_UNORM <-> R16G16B16A16_FLOAT. These loops have no per-texel branches on the
+// format, so compilers vectorize them.
+//
+//================================================================================================
+
+//------------------------------------------------------------------------------------------------
+enum D3DX12_PIXEL_CONVERSION_PATH
+{
+    D3DX12_PIXEL_CONVERSION_PATH_GENERIC = 0,               // Decode and encode with CD3DX12PixelCodec
+    D3DX12_PIXEL_CONVERSION_PATH_COPY = 1,                  // Same format
+    D3DX12_PIXEL_CONVERSION_PATH_SWIZZLE_RB = 2,            // RGBA8 <-> BGRA8
+    D3DX12_PIXEL_CONVERSION_PATH_SRGB_LOOKUP = 3,           // 8-bit UNORM <-> UNORM_SRGB, optionally swizzled
+    D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_FLOAT = 4,         // 16-bit to 32-bit float
+    D3DX12_PIXEL_CONVERSION_PATH_FLOAT_TO_HALF = 5,         // 32-bit to 16-bit float
+    D3DX12_PIXEL_CONVERSION_PATH_R10G10B10A2_TO_HALF = 6,   // R10G10B10A2_UNORM to R16G16B16A16_FLOAT
+    D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_R10G10B10A2 = 7,   // R16G16B16A16_FLOAT to R10G10B10A2_UNORM
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12PixelConverter
+{
+public:
+    static constexpr UINT BatchPixels = 64;
+
+    // bAllowFastPaths = false forces the generic path, e.g. for validation
+    HRESULT Init(DXGI_FORMAT SrcFormat, DXGI_FORMAT DstFormat, bool bAllowFastPaths = true) noexcept
+    {
+        m_Path = D3DX12_PIXEL_CONVERSION_PATH_GENERIC;
+        m_bSwizzle = false;
+        if (FAILED(m_Src.Init(SrcFormat)) || FAILED(m_Dst.Init(DstFormat)))
+        {
+            return E_INVALIDARG;
+        }
+        if (!bAllowFastPaths)
+        {
+            return S_OK;
+        }
+
+        bool bSrcBGRA, bSrcSRGB, bDstBGRA, bDstSRGB;
+        if (SrcFormat == DstFormat)
+        {
+            m_Path = D3DX12_PIXEL_CONVERSION_PATH_COPY;
+        }
+        else if (GetByteOrder(SrcFormat, bSrcBGRA, bSrcSRGB) && GetByteOrder(DstFormat, bDstBGRA, bDstSRGB))
+        {
+            m_bSwizzle = bSrcBGRA != bDstBGRA;
+            if (bSrcSRGB == bDstSRGB)
+            {
+                m_Path = D3DX12_PIXEL_CONVERSION_PATH_SWIZZLE_RB;
+            }
+            else
+            {
+                // Tabulate the generic path, so both give identical results
+                m_Path = D3DX12_PIXEL_CONVERSION_PATH_SRGB_LOOKUP;
+                for (UINT i = 0; i < 256; ++i)
+                {
+                    const UINT Pixel = i * 0x01010101u;
+                    UINT Converted;
+                    ConvertGeneric(&Pixel, 1, &Converted);
+                    m_ByteLookup[i] = static_cast<BYTE>(Converted);
+                }
+            }
+        }
+        else if (GetFloatWidening(SrcFormat) == DstFormat)
+        {
+            m_Path = D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_FLOAT;
+        }
+        else if (GetFloatWidening(DstFormat) == SrcFormat)
+        {
+            m_Path = D3DX12_PIXEL_CONVERSION_PATH_FLOAT_TO_HALF;
+        }
+        else if (SrcFormat == DXGI_FORMAT_R10G10B10A2_UNORM && DstFormat == DXGI_FORMAT_R16G16B16A16_FLOAT)
+        {
+            m_Path = D3DX12_PIXEL_CONVERSION_PATH_R10G10B10A2_TO_HALF;
+            for (UINT i = 0; i < 1024; ++i)
+            {
+                const UINT Pixel = i | (i << 10) | (i << 20) | (i << 30);
+                UINT16 Converted[4];
+                ConvertGeneric(&Pixel, 1, Converted);
+                m_HalfLookup[i] = Converted[0];
+                if (i < 4)
+                {
+                    m_AlphaHalfLookup[i] = Converted[3];
+                }
+            }
+        }
+        else if (SrcFormat == DXGI_FORMAT_R16G16B16A16_FLOAT && DstFormat == DXGI_FORMAT_R10G10B10A2_UNORM)
+        {
+            m_Path = D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_R10G10B10A2;
+        }
+        m_NumElements = m_Path == D3DX12_PIXEL_CONVERSION_PATH_FLOAT_TO_HALF ? m_Src.GetBytesPerPixel() / 4 : m_Src.GetBytesPerPixel() / 2;
+        return S_OK;
+    }
+
+    DXGI_FORMAT GetSrcFormat() const noexcept { return m_Src.GetFormat(); }
+    DXGI_FORMAT GetDstFormat() const noexcept { return m_Dst.GetFormat(); }
+    D3DX12_PIXEL_CONVERSION_PATH GetPath() const noexcept { return m_Path; }
+
+    void ConvertRow(_In_reads_bytes_(NumPixels * m_Src.GetBytesPerPixel()) const void* pSrc, UINT NumPixels,
+        _Out_writes_bytes_(NumPixels * m_Dst.GetBytesPerPixel()) void* pDst) const noexcept
+    {
+        switch (m_Path)
+        {
+        case D3DX12_PIXEL_CONVERSION_PATH_COPY:
+            memcpy(pDst, pSrc, SIZE_T(NumPixels) * m_Src.GetBytesPerPixel());
+            break;
+        case D3DX12_PIXEL_CONVERSION_PATH_SWIZZLE_RB:
+        case D3DX12_PIXEL_CONVERSION_PATH_SRGB_LOOKUP:
+            ConvertBytes(static_cast<const BYTE*>(pSrc), NumPixels, static_cast<BYTE*>(pDst));
+            break;
+        case D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_FLOAT:
+            ConvertHalfToFloat(static_cast<const BYTE*>(pSrc), NumPixels * m_NumElements, static_cast<BYTE*>(pDst));
+            break;
+        case D3DX12_PIXEL_CONVERSION_PATH_FLOAT_TO_HALF:
+            ConvertFloatToHalf(static_cast<const BYTE*>(pSrc), NumPixels * m_NumElements, static_cast<BYTE*>(pDst));
+            break;
+        case D3DX12_PIXEL_CONVERSION_PATH_R10G10B10A2_TO_HALF:
+            ConvertR10G10B10A2ToHalf(static_cast<const BYTE*>(pSrc), NumPixels, static_cast<BYTE*>(pDst));
+            break;
+        case D3DX12_PIXEL_CONVERSION_PATH_HALF_TO_R10G10B10A2:
+            ConvertHalfToR10G10B10A2(static_cast<const BYTE*>(pSrc), NumPixels, static_cast<BYTE*>(pDst));
+            break;
+        default:
+            ConvertGeneric(pSrc, NumPixels, pDst);
+            break;
+        }
+    }
+
+    // Same arguments as MemcpySubresource, with the row size given in pixels
+    void ConvertSubresource(
+        _In_ const D3D12_MEMCPY_DEST* pDest,
+        _In_ const D3D12_SUBRESOURCE_DATA* pSrc,
+        UINT NumPixels,
+        UINT NumRows,
+        UINT NumSlices) const noexcept
+    {
+        for (UINT z = 0; z < NumSlices; ++z)
+        {
+            auto pDestSlice = static_cast<BYTE*>(pDest->pData) + pDest->SlicePitch * z;
+            auto pSrcSlice = static_cast<const BYTE*>(pSrc->pData) + pSrc->SlicePitch * LONG_PTR(z);
+            for (UINT y = 0; y < NumRows; ++y)
+            {
+                ConvertRow(pSrcSlice + pSrc->RowPitch * LONG_PTR(y), NumPixels, pDestSlice + pDest->RowPitch * y);
+            }
+        }
+    }
+
+    // Bit-exact with CD3DX12PixelCodec::SmallFloatToFloat(Half, 5, 10, true), except that NaN
+    // payloads are preserved
+    static float HalfToFloat(UINT16 Half) noexcept
+    {
+        const UINT ShiftedExponent = 0x7C00u << 13;
+        UINT Bits = UINT(Half & 0x7FFF) << 13;
+        const UINT Exponent = Bits & ShiftedExponent;
+        Bits += (127 - 15) << 23;
+        if (Exponent == ShiftedExponent)
+        {
+            Bits += (128 - 16) << 23; // Infinity or NaN
+        }
+        else if (Exponent == 0)
+        {
+            // Denormal: renormalize through a float subtraction that never involves a float denormal
+            const UINT MagicBits = 113u << 23;
+            float Magic, Value;
+            Bits += 1 << 23;
+            memcpy(&Magic, &MagicBits, sizeof(Magic));
+            memcpy(&Value, &Bits, sizeof(Value));
+            Value -= Magic;
+            memcpy(&Bits, &Value, sizeof(Bits));
+        }
+        Bits |= UINT(Half & 0x8000) << 16;
+        float Result;
+        memcpy(&Result, &Bits, sizeof(Result));
+        return Result;
+    }
+
+    // Bit-exact with CD3DX12PixelCodec::FloatToSmallFloat(Value, 5, 10, true)
+    static UINT16 FloatToHalf(float Value) noexcept
+    {
+        UINT Bits;
+        memcpy(&Bits, &Value, sizeof(Bits));
+        const UINT Sign = (Bits >> 16) & 0x8000;
+        Bits &= 0x7FFFFFFF;
+        if (Bits > 0x7F800000)
+        {
+            return 0x7C01; // NaN
+        }
+        if (Bits >= (127u + 16) << 23)
+        {
+            return static_cast<UINT16>(Sign | 0x7C00);
+        }
+        if (Bits < 113u << 23)
+        {
+            // Denormal or zero: let the float addition round the mantissa to nearest even
+            const UINT MagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+            float Magic, Magnitude;
+            memcpy(&Magic, &MagicBits, sizeof(Magic));
+            memcpy(&Magnitude, &Bits, sizeof(Magnitude));
+            Magnitude += Magic;
+            memcpy(&Bits, &Magnitude, sizeof(Bits));
+            return static_cast<UINT16>(Sign | (Bits - MagicBits));
+        }
+        // Rebias and round to nearest even; a mantissa carry correctly rounds up to infinity
+        Bits += (UINT(15 - 127) << 23) + 0xFFF + ((Bits >> 13) & 1);
+        return static_cast<UINT16>(Sign | (Bits >> 13));
+    }
+
+private:
+    static bool GetByteOrder(DXGI_FORMAT Format, bool& bBGRA, bool& bSRGB) noexcept
+    {
+        bBGRA = Format == DXGI_FORMAT_B8G8R8A8_UNORM || Format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+        bSRGB = Format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB || Format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+        return bBGRA || bSRGB || Format == DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+
+    static DXGI_FORMAT GetFloatWidening(DXGI_FORMAT Format) noexcept
+    {
+        switch (Format)
+        {
+        case DXGI_FORMAT_R16_FLOAT: return DXGI_FORMAT_R32_FLOAT;
+        case DXGI_FORMAT_R16G16_FLOAT: return DXGI_FORMAT_R32G32_FLOAT;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+        default: return DXGI_FORMAT_UNKNOWN;
+        }
+    }
+
+    void ConvertGeneric(const void* pSrc, UINT NumPixels, void* pDst) const noexcept
+    {
+        float RGBA[BatchPixels * 4];
+        const BYTE* pSrcBytes = static_cast<const BYTE*>(pSrc);
+        BYTE* pDstBytes = static_cast<BYTE*>(pDst);
+        for (UINT x = 0; x < NumPixels; x += BatchPixels)
+        {
+            const UINT Count = (std::min)(BatchPixels, NumPixels - x);
+            m_Src.DecodeRow(pSrcBytes + SIZE_T(x) * m_Src.GetBytesPerPixel(), Count, RGBA);
+            m_Dst.EncodeRow(RGBA, Count, pDstBytes + SIZE_T(x) * m_Dst.GetBytesPerPixel());
+        }
+    }
+
+    // Alpha is UNORM in all four formats and is never looked up
+    void ConvertBytes(const BYTE* pSrc, UINT NumPixels, BYTE* pDst) const noexcept
+    {
+        const bool bLookup = m_Path == D3DX12_PIXEL_CONVERSION_PATH_SRGB_LOOKUP;
+        for (UINT x = 0; x < NumPixels; ++x)
+        {
+            UINT Pixel;
+            memcpy(&Pixel, pSrc + x * 4, sizeof(Pixel));
+            if (bLookup)
+            {
+                Pixel = UINT(m_ByteLookup[Pixel & 0xFF]) | (UINT(m_ByteLookup[(Pixel >> 8) & 0xFF]) << 8)
+                    | (UINT(m_ByteLookup[(Pixel >> 16) & 0xFF]) << 16) | (Pixel & 0xFF000000);
+            }
+            if (m_bSwizzle)
+            {
+                Pixel = (Pixel & 0xFF00FF00) | ((Pixel >> 16) & 0xFF) | ((Pixel & 0xFF) << 16);
+            }
+            memcpy(pDst + x * 4, &Pixel, sizeof(Pixel));
+        }
+    }
+
+    static void ConvertHalfToFloat(const BYTE* pSrc, UINT NumElements, BYTE* pDst) noexcept
+    {
+        for (UINT i = 0; i < NumElements; ++i)
+        {
+            UINT16 Half;
+            memcpy(&Half, pSrc + i * 2, sizeof(Half));
+            const float Value = HalfToFloat(Half);
+            memcpy(pDst + i * 4, &Value, sizeof(Value));
+        }
+    }
+
+    static void ConvertFloatToHalf(const BYTE* pSrc, UINT NumElements, BYTE* pDst) noexcept
+    {
+        for (UINT i = 0; i < NumElements; ++i)
+        {
+            float Value;
+            memcpy(&Value, pSrc + i * 4, sizeof(Value));
+            const UINT16 Half = FloatToHalf(Value);
+            memcpy(pDst + i * 2, &Half, sizeof(Half));
+        }
+    }
+
+    void ConvertR10G10B10A2ToHalf(const BYTE* pSrc, UINT NumPixels, BYTE* pDst) const noexcept
+    {
+        for (UINT x = 0; x < NumPixels; ++x)
+        {
+            UINT Pixel;
+            memcpy(&Pixel, pSrc + x * 4, sizeof(Pixel));
+            const UINT16 Halves[4] = { m_HalfLookup[Pixel & 0x3FF], m_HalfLookup[(Pixel >> 10) & 0x3FF],
+                m_HalfLookup[(Pixel >> 20) & 0x3FF], m_AlphaHalfLookup[Pixel >> 30] };
+            memcpy(pDst + x * 8, Halves, sizeof(Halves));
+        }
+    }
+
+    // Same rounding as CD3DX12PixelCodec::EncodeRow for UNORM components
+    static UINT HalfToUNORM(UINT16 Half, double MaxValue) noexcept
+    {
+        const float Value = HalfToFloat(Half);
+        const double Clamped = std::isnan(Value) ? 0.0 : (std::min)((std::max)(double(Value), 0.0), 1.0);
+        return UINT(std::floor(Clamped * MaxValue + 0.5));
+    }
+
+    static void ConvertHalfToR10G10B10A2(const BYTE* pSrc, UINT NumPixels, BYTE* pDst) noexcept
+    {
+        for (UINT x = 0; x < NumPixels; ++x)
+        {
+            UINT16 Halves[4];
+            memcpy(Halves, pSrc + x * 8, sizeof(Halves));
+            const UINT Pixel = HalfToUNORM(Halves[0], 1023.0) | (HalfToUNORM(Halves[1], 1023.0) << 10)
+                | (HalfToUNORM(Halves[2], 1023.0) << 20) | (HalfToUNORM(Halves[3], 3.0) << 30);
+            memcpy(pDst + x * 4, &Pixel, sizeof(Pixel));
+        }
+    }
+
+    CD3DX12PixelCodec m_Src;
+    CD3DX12PixelCodec m_Dst;
+    D3DX12_PIXEL_CONVERSION_PATH m_Path = D3DX12_PIXEL_CONVERSION_PATH_GENERIC;
+    UINT m_NumElements = 0;
+    bool m_bSwizzle = false;
+    BYTE m_ByteLookup[256] = {};
+    UINT16 m_HalfLookup[1024] = {};
+    UINT16 m_AlphaHalfLookup[4] = {};
+};
+
+#endif // !D3DX12_NO_PIXEL_CONVERSION_HELPERS
+
+#if !defined(D3DX12_NO_MIP_GENERATION_HELPERS) && !defined(D3DX12_NO_PIXEL_CODEC_HELPERS)
+
+//================================================================================================
+// D3DX12 Mip Generation Helpers
+//
+// Generates the mip chain of 1D and 2D textures (and arrays) on the CPU, for tools and for paths
+// that cannot run a compute shader. Each level is decoded with CD3DX12PixelCodec, filtered in
+// linear space from the level above and re-encoded straight into the upload footprint layout, so
+// the result is copied with CopyTextureRegion exactly like the output of UpdateSubresources.
+// Filter weights are computed once per level by Init(); GenerateSlice() only reads them, so array
+// slices can be generated concurrently on the caller's threads.
+// Uses STL
+//
+//================================================================================================
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+enum D3DX12_MIP_FILTER
+{
+    D3DX12_MIP_FILTER_BOX = 0,      // Area-weighted average of the texels covered
+    D3DX12_MIP_FILTER_KAISER = 1,   // Kaiser-windowed sinc, 3 lobes
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12MipGenerator
+{
+public:
+    // Desc.MipLevels of 0 generates the full chain. The layouts are those of
+    // D3DX12GetCopyableFootprints for all subresources at BaseOffset.
+    HRESULT Init(const D3D12_RESOURCE_DESC& Desc, D3DX12_MIP_FILTER Filter = D3DX12_MIP_FILTER_BOX, UINT64 BaseOffset = 0)
+    {
+        m_Layouts.clear();
+        m_Levels.clear();
+        if ((Desc.Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE1D && Desc.Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D)
+            || Desc.Layout != D3D12_TEXTURE_LAYOUT_UNKNOWN || Desc.SampleDesc.Count > 1 || Desc.Width == 0 || Desc.Width > UINT_MAX
+            || Desc.Height == 0 || Desc.DepthOrArraySize == 0 || FAILED(m_Codec.Init(Desc.Format)))
+        {
+            return E_INVALIDARG;
+        }
+        const UINT Width = static_cast<UINT>(Desc.Width);
+        UINT FullChain = 1;
+        while ((std::max)(Width, Desc.Height) >> FullChain)
+        {
+            ++FullChain;
+        }
+        if (Desc.MipLevels > FullChain)
+        {
+            return E_INVALIDARG;
+        }
+        m_Desc = Desc;
+        m_Desc.MipLevels = static_cast<UINT16>(Desc.MipLevels ? Desc.MipLevels : FullChain);
+
+        const UINT NumSubresources = UINT(m_Desc.MipLevels) * m_Desc.DepthOrArraySize;
+        m_Layouts.resize(NumSubresources);
+        m_NumRows.resize(NumSubresources);
+        m_RowSizes.resize(NumSubresources);
+        if (!D3DX12GetCopyableFootprints(m_Desc, 0, NumSubresources, BaseOffset, m_Layouts.data(), m_NumRows.data(), m_RowSizes.data(), &m_RequiredSize))
+        {
+            return E_INVALIDARG;
+        }
+
+        m_Levels.resize(m_Desc.MipLevels - 1u);
+        for (UINT Mip = 1; Mip < m_Desc.MipLevels; ++Mip)
+        {
+            ComputeWeights(m_Levels[Mip - 1].X, (std::max)(Width >> (Mip - 1), 1u), (std::max)(Width >> Mip, 1u), Filter);
+            ComputeWeights(m_Levels[Mip - 1].Y, (std::max)(Desc.Height >> (Mip - 1), 1u), (std::max)(Desc.Height >> Mip, 1u), Filter);
+        }
+        return S_OK;
+    }
+
+    const D3D12_RESOURCE_DESC& GetDesc() const noexcept { return m_Desc; }
+
+    // Bytes from BaseOffset to the end of the last subresource
+    UINT64 GetRequiredSize() const noexcept { return m_RequiredSize; }
+
+    const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& GetLayout(UINT Subresource) const noexcept { return m_Layouts[Subresource]; }
+
+    // Writes mip 0 of ArraySlice from Mip0 and generates the other levels into pUploadData, the
+    // mapped buffer the layouts are relative to
+    HRESULT GenerateSlice(UINT ArraySlice, const D3D12_SUBRESOURCE_DATA& Mip0, _Out_ void* pUploadData) const
+    {
+        if (ArraySlice >= m_Desc.DepthOrArraySize || m_Layouts.empty())
+        {
+            return E_INVALIDARG;
+        }
+        BYTE* pUpload = static_cast<BYTE*>(pUploadData);
+        UINT Width = static_cast<UINT>(m_Desc.Width);
+        UINT Height = m_Desc.Height;
+
+        const UINT Top = D3D12CalcSubresource(0, ArraySlice, 0, m_Desc.MipLevels, m_Desc.DepthOrArraySize);
+        const D3D12_MEMCPY_DEST TopDest = { pUpload + m_Layouts[Top].Offset, m_Layouts[Top].Footprint.RowPitch,
+            SIZE_T(m_Layouts[Top].Footprint.RowPitch) * m_NumRows[Top] };
+        MemcpySubresource(&TopDest, &Mip0, static_cast<SIZE_T>(m_RowSizes[Top]), m_NumRows[Top], 1);
+
+        std::vector<float> Level(SIZE_T(Width) * Height * 4);
+        for (UINT y = 0; y < Height; ++y)
+        {
+            m_Codec.DecodeRow(static_cast<const BYTE*>(Mip0.pData) + Mip0.RowPitch * LONG_PTR(y), Width, &Level[SIZE_T(Width) * y * 4]);
+        }
+
+        std::vector<float> Horizontal;
+        std::vector<float> Next;
+        for (UINT Mip = 1; Mip < m_Desc.MipLevels; ++Mip)
+        {
+            const Weights& X = m_Levels[Mip - 1].X;
+            const Weights& Y = m_Levels[Mip - 1].Y;
+            const UINT NextWidth = static_cast<UINT>(X.First.size());
+            const UINT NextHeight = static_cast<UINT>(Y.First.size());
+
+            Horizontal.assign(SIZE_T(NextWidth) * Height * 4, 0.0f);
+            for (UINT y = 0; y < Height; ++y)
+            {
+                const float* pSrcRow = &Level[SIZE_T(Width) * y * 4];
+                float* pDstRow = &Horizontal[SIZE_T(NextWidth) * y * 4];
+                for (UINT x = 0; x < NextWidth; ++x)
+                {
+                    Accumulate(pDstRow + SIZE_T(x) * 4, pSrcRow, 4, X, x);
+                }
+            }
+
+            Next.assign(SIZE_T(NextWidth) * NextHeight * 4, 0.0f);
+            for (UINT y = 0; y < NextHeight; ++y)
+            {
+                float* pDstRow = &Next[SIZE_T(NextWidth) * y * 4];
+                for (UINT x = 0; x < NextWidth; ++x)
+                {
+                    Accumulate(pDstRow + SIZE_T(x) * 4, &Horizontal[SIZE_T(x) * 4], SIZE_T(NextWidth) * 4, Y, y);
+                }
+            }
+
+            const UINT Subresource = D3D12CalcSubresource(Mip, ArraySlice, 0, m_Desc.MipLevels, m_Desc.DepthOrArraySize);
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout = m_Layouts[Subresource];
+            for (UINT y = 0; y < NextHeight; ++y)
+            {
+                m_Codec.EncodeRow(&Next[SIZE_T(NextWidth) * y * 4], NextWidth, pUpload + Layout.Offset + SIZE_T(Layout.Footprint.RowPitch) * y);
+            }
+            Level.swap(Next);
+            Width = NextWidth;
+            Height = NextHeight;
+        }
+        return S_OK;
+    }
+
+private:
+    // Taps of each destination texel along one axis
+    struct Weights
+    {
+        std::vector<UINT> First;    // Index in Values of the first tap
+        std::vector<UINT> Count;
+        std::vector<UINT> Source;   // Source texel of each tap
+        std::vector<float> Values;
+    };
+
+    struct LevelWeights
+    {
+        Weights X;
+        Weights Y;
+    };
+
+    static void Accumulate(float* pDst, const float* pSrc, SIZE_T SrcStride, const Weights& W, UINT Index) noexcept
+    {
+        const UINT First = W.First[Index];
+        const UINT End = First + W.Count[Index];
+        float Sum[4] = {};
+        for (UINT Tap = First; Tap < End; ++Tap)
+        {
+            const float* pTexel = pSrc + SrcStride * W.Source[Tap];
+            const float Weight = W.Values[Tap];
+            for (UINT c = 0; c < 4; ++c)
+            {
+                Sum[c] += pTexel[c] * Weight;
+            }
+        }
+        memcpy(pDst, Sum, sizeof(Sum));
+    }
+
+    static double Kaiser(double x) noexcept
+    {
+        // I0(Beta * sqrt(1 - x^2)) / I0(Beta), Beta = 4
+        auto BesselI0 = [](double v)
+        {
+            double Sum = 1.0, Term = 1.0;
+            for (int k = 1; k < 20; ++k)
+            {
+                Term *= (v * 0.5 / k) * (v * 0.5 / k);
+                Sum += Term;
+            }
+            return Sum;
+        };
+        const double Beta = 4.0;
+        return x >= 1.0 ? 0.0 : BesselI0(Beta * std::sqrt(1.0 - x * x)) / BesselI0(Beta);
+    }
+
+    static void ComputeWeights(Weights& W, UINT SrcSize, UINT DstSize, D3DX12_MIP_FILTER Filter)
+    {
+        const double Scale = double(SrcSize) / DstSize;
+        std::vector<double> Taps(SrcSize);
+        W.First.resize(DstSize);
+        W.Count.resize(DstSize);
+        for (UINT x = 0; x < DstSize; ++x)
+        {
+            // Taps[Lo, Hi] covers the source texels this destination texel reads
+            int Lo, Hi;
+            if (Filter == D3DX12_MIP_FILTER_KAISER)
+            {
+                const double Center = (x + 0.5) * Scale - 0.5;
+                const double Radius = 3.0 * Scale;
+                const int Begin = static_cast<int>(std::ceil(Center - Radius));
+                const int End = static_cast<int>(std::floor(Center + Radius));
+                Lo = (std::max)(Begin, 0);
+                Hi = (std::min)(End, int(SrcSize) - 1);
+                std::fill(Taps.begin() + Lo, Taps.begin() + Hi + 1, 0.0);
+                for (int i = Begin; i <= End; ++i)
+                {
+                    const double t = (i - Center) / Scale;
+                    const double Sinc = t == 0.0 ? 1.0 : std::sin(3.14159265358979323846 * t) / (3.14159265358979323846 * t);
+                    Taps[(std::min)((std::max)(i, 0), int(SrcSize) - 1)] += Sinc * Kaiser(std::fabs(t) / 3.0);
+                }
+            }
+            else
+            {
+                const double Begin = x * Scale, End = (x + 1) * Scale;
+                Lo = static_cast<int>(Begin);
+                Hi = (std::min)(static_cast<int>(std::ceil(End)), int(SrcSize)) - 1;
+                for (int i = Lo; i <= Hi; ++i)
+                {
+                    Taps[i] = (std::min)(End, i + 1.0) - (std::max)(Begin, double(i));
+                }
+            }
+            double Sum = 0.0;
+            for (int i = Lo; i <= Hi; ++i)
+            {
+                Sum += Taps[i];
+            }
+            W.First[x] = static_cast<UINT>(W.Values.size());
+            for (int i = Lo; i <= Hi; ++i)
+            {
+                if (Taps[i] != 0.0)
+                {
+                    W.Source.push_back(static_cast<UINT>(i));
+                    W.Values.push_back(static_cast<float>(Taps[i] / Sum));
+                }
+            }
+            W.Count[x] = static_cast<UINT>(W.Values.size()) - W.First[x];
+        }
+    }
+
+    CD3DX12PixelCodec m_Codec;
+    D3D12_RESOURCE_DESC m_Desc = {};
+    UINT64 m_RequiredSize = 0;
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> m_Layouts;
+    std::vector<UINT> m_NumRows;
+    std::vector<UINT64> m_RowSizes;
+    std::vector<LevelWeights> m_Levels;
+};
+
+#endif // !D3DX12_NO_MIP_GENERATION_HELPERS
+
+#if !defined(D3DX12_NO_BLOCK_COMPRESSION_HELPERS) && !defined(D3DX12_NO_PIXEL_CODEC_HELPERS)
+
+//================================================================================================
+// D3DX12 Block Compression Helpers
+//
+// Decodes 4x4 blocks of every BC format (BC1-BC7, UNORM, SRGB, SNORM and both BC6H variants) to
+// RGBA floats with the same conventions as CD3DX12PixelCodec, and encodes BC1, BC4 and BC5 in real
+// time: the inset bounding box of the block is quantized to the endpoints and every texel takes
+// the nearest palette entry. BC1 blocks with texels of alpha below 0.5 use the 3-color mode.
+// DecodeRows() and EncodeRows() work on block rows of a subresource in the upload footprint layout
+// from D3DX12GetCopyableFootprints, against an RGBA float image of the footprint's width, height
+// and depth. They only read the codec, so disjoint block row ranges can be processed concurrently
+// on the caller's threads.
+//
+//================================================================================================
+#include <utility>
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12BlockCodec
+{
+public:
+    static constexpr UINT BlockDimension = 4;
+
+    HRESULT Init(DXGI_FORMAT Format) noexcept
+    {
+        m_Format = DXGI_FORMAT_UNKNOWN;
+        m_Type = 0;
+        switch (Format)
+        {
+        case DXGI_FORMAT_BC1_UNORM: case DXGI_FORMAT_BC1_UNORM_SRGB: m_Type = 1; break;
+        case DXGI_FORMAT_BC2_UNORM: case DXGI_FORMAT_BC2_UNORM_SRGB: m_Type = 2; break;
+        case DXGI_FORMAT_BC3_UNORM: case DXGI_FORMAT_BC3_UNORM_SRGB: m_Type = 3; break;
+        case DXGI_FORMAT_BC4_UNORM: case DXGI_FORMAT_BC4_SNORM: m_Type = 4; break;
+        case DXGI_FORMAT_BC5_UNORM: case DXGI_FORMAT_BC5_SNORM: m_Type = 5; break;
+        case DXGI_FORMAT_BC6H_UF16: case DXGI_FORMAT_BC6H_SF16: m_Type = 6; break;
+        case DXGI_FORMAT_BC7_UNORM: case DXGI_FORMAT_BC7_UNORM_SRGB: m_Type = 7; break;
+        default: return E_INVALIDARG;
+        }
+        m_Format = Format;
+        m_bSRGB = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::IsSRGBFormat(Format);
+        m_bSigned = Format == DXGI_FORMAT_BC4_SNORM || Format == DXGI_FORMAT_BC5_SNORM || Format == DXGI_FORMAT_BC6H_SF16;
+        return S_OK;
+    }
+
+    DXGI_FORMAT GetFormat() const noexcept { return m_Format; }
+    UINT GetBytesPerBlock() const noexcept { return (m_Type == 1 || m_Type == 4) ? 8 : 16; }
+    bool CanEncode() const noexcept { return m_Type == 1 || m_Type == 4 || m_Type == 5; }
+
+    // Block rows of all depth slices of the footprint, in upload layout order
+    static UINT GetNumBlockRows(const D3D12_SUBRESOURCE_FOOTPRINT& Footprint) noexcept
+    {
+        return (Footprint.Height + BlockDimension - 1) / BlockDimension * Footprint.Depth;
+    }
+
+    // Writes 16 texels of 4 floats, row by row
+    void DecodeBlock(_In_reads_bytes_(GetBytesPerBlock()) const void* pBlock, _Out_writes_(64) float* pRGBA) const noexcept
+    {
+        const BYTE* pBytes = static_cast<const BYTE*>(pBlock);
+        for (UINT i = 0; i < 16; ++i)
+        {
+            pRGBA[i * 4] = pRGBA[i * 4 + 1] = pRGBA[i * 4 + 2] = 0.0f;
+            pRGBA[i * 4 + 3] = 1.0f;
+        }
+        switch (m_Type)
+        {
+        case 1:
+            DecodeBC1(pBytes, true, pRGBA);
+            break;
+        case 2:
+            DecodeBC1(pBytes + 8, false, pRGBA);
+            for (UINT i = 0; i < 16; ++i)
+            {
+                pRGBA[i * 4 + 3] = float((pBytes[i / 2] >> (4 * (i % 2))) & 0xF) / 15.0f;
+            }
+            break;
+        case 3:
+            DecodeBC1(pBytes + 8, false, pRGBA);
+            DecodeBC4(pBytes, false, pRGBA + 3);
+            break;
+        case 4:
+            DecodeBC4(pBytes, m_bSigned, pRGBA);
+            break;
+        case 5:
+            DecodeBC4(pBytes, m_bSigned, pRGBA);
+            DecodeBC4(pBytes + 8, m_bSigned, pRGBA + 1);
+            break;
+        case 6:
+            DecodeBC6H(pBytes, pRGBA);
+            break;
+        case 7:
+            DecodeBC7(pBytes, pRGBA);
+            break;
+        default:
+            break;
+        }
+        if (m_bSRGB)
+        {
+            for (UINT i = 0; i < 64; ++i)
+            {
+                pRGBA[i] = i % 4 == 3 ? pRGBA[i] : CD3DX12PixelCodec::SRGBToLinear(pRGBA[i]);
+            }
+        }
+    }
+
+    // Reads 16 texels of 4 floats, row by row; only valid when CanEncode()
+    void EncodeBlock(_In_reads_(64) const float* pRGBA, _Out_writes_bytes_(GetBytesPerBlock()) void* pBlock) const noexcept
+    {
+        D3DX12_ASSERT(CanEncode());
+        BYTE* pBytes = static_cast<BYTE*>(pBlock);
+        switch (m_Type)
+        {
+        case 1:
+            EncodeBC1(pRGBA, pBytes);
+            break;
+        case 4:
+            EncodeBC4(pRGBA, m_bSigned, pBytes);
+            break;
+        case 5:
+            EncodeBC4(pRGBA, m_bSigned, pBytes);
+            EncodeBC4(pRGBA + 1, m_bSigned, pBytes + 8);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // pRGBA is the whole image (Width * Height * Depth texels of the footprint); only the texel rows
+    // of the given block rows are written
+    void DecodeRows(
+        _In_ const void* pUpload,
+        const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout,
+        UINT FirstBlockRow,
+        UINT NumBlockRows,
+        _Out_ float* pRGBA) const noexcept
+    {
+        float Block[64];
+        for (UINT Row = FirstBlockRow; Row < FirstBlockRow + NumBlockRows; ++Row)
+        {
+            const BYTE* pRow = static_cast<const BYTE*>(pUpload) + Layout.Offset + UINT64(Layout.Footprint.RowPitch) * Row;
+            for (UINT x = 0; x < Layout.Footprint.Width; x += BlockDimension)
+            {
+                DecodeBlock(pRow + SIZE_T(x / BlockDimension) * GetBytesPerBlock(), Block);
+                ForEachTexel(Layout.Footprint, Row, x, false, [&](UINT i, SIZE_T Texel)
+                {
+                    memcpy(pRGBA + Texel * 4, Block + i * 4, sizeof(float) * 4);
+                });
+            }
+        }
+    }
+
+    // Texels of partial blocks at the right and bottom edges are replicated from the edge
+    void EncodeRows(
+        _In_ const float* pRGBA,
+        const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout,
+        UINT FirstBlockRow,
+        UINT NumBlockRows,
+        _Out_ void* pUpload) const noexcept
+    {
+        float Block[64];
+        for (UINT Row = FirstBlockRow; Row < FirstBlockRow + NumBlockRows; ++Row)
+        {
+            BYTE* pRow = static_cast<BYTE*>(pUpload) + Layout.Offset + UINT64(Layout.Footprint.RowPitch) * Row;
+            for (UINT x = 0; x < Layout.Footprint.Width; x += BlockDimension)
+            {
+                ForEachTexel(Layout.Footprint, Row, x, true, [&](UINT i, SIZE_T Texel)
+                {
+                    memcpy(Block + i * 4, pRGBA + Texel * 4, sizeof(float) * 4);
+                });
+                EncodeBlock(Block, pRow + SIZE_T(x / BlockDimension) * GetBytesPerBlock());
+            }
+        }
+    }
+
+private:
+    // Texels of the block at (x, Row) that lie in the image, or all of them clamped to the image
+    template<typename TFunc>
+    static void ForEachTexel(const D3D12_SUBRESOURCE_FOOTPRINT& Footprint, UINT Row, UINT x, bool bClamp, TFunc Func)
+    {
+        const UINT RowsPerSlice = (Footprint.Height + BlockDimension - 1) / BlockDimension;
+        const UINT z = Row / RowsPerSlice;
+        const UINT y = (Row % RowsPerSlice) * BlockDimension;
+        for (UINT i = 0; i < 16; ++i)
+        {
+            if (!bClamp && (x + i % 4 >= Footprint.Width || y + i / 4 >= Footprint.Height))
+            {
+                continue;
+            }
+            const UINT TexelX = (std::min)(x + i % 4, Footprint.Width - 1);
+            const UINT TexelY = (std::min)(y + i / 4, Footprint.Height - 1);
+            Func(i, (SIZE_T(z) * Footprint.Height + TexelY) * Footprint.Width + TexelX);
+        }
+    }
+
+    // Reads the 128 bits of a block from the least significant bit of the first byte
+    struct BlockBits
+    {
+        explicit BlockBits(const BYTE* pBlock) noexcept
+        {
+            memcpy(&Lo, pBlock, sizeof(Lo));
+            memcpy(&Hi, pBlock + 8, sizeof(Hi));
+        }
+
+        UINT Read(UINT NumBits) noexcept
+        {
+            UINT64 Window = Position >= 64 ? Hi >> (Position - 64) : Lo >> Position;
+            if (Position > 0 && Position < 64)
+            {
+                Window |= Hi << (64 - Position);
+            }
+            Position += NumBits;
+            return static_cast<UINT>(Window & ((UINT64(1) << NumBits) - 1));
+        }
+
+        UINT64 Lo;
+        UINT64 Hi;
+        UINT Position = 0;
+    };
+
+    static void GetBC1Palette(UINT16 Color0, UINT16 Color1, bool bFourColors, float Palette[4][4]) noexcept
+    {
+        const UINT16 Colors[2] = { Color0, Color1 };
+        for (UINT i = 0; i < 2; ++i)
+        {
+            Palette[i][0] = float(Colors[i] >> 11) / 31.0f;
+            Palette[i][1] = float((Colors[i] >> 5) & 0x3F) / 63.0f;
+            Palette[i][2] = float(Colors[i] & 0x1F) / 31.0f;
+            Palette[i][3] = 1.0f;
+        }
+        for (UINT c = 0; c < 3; ++c)
+        {
+            if (bFourColors)
+            {
+                Palette[2][c] = (2.0f * Palette[0][c] + Palette[1][c]) / 3.0f;
+                Palette[3][c] = (Palette[0][c] + 2.0f * Palette[1][c]) / 3.0f;
+            }
+            else
+            {
+                Palette[2][c] = (Palette[0][c] + Palette[1][c]) / 2.0f;
+                Palette[3][c] = 0.0f;
+            }
+        }
+        Palette[2][3] = 1.0f;
+        Palette[3][3] = bFourColors ? 1.0f : 0.0f;
+    }
+
+    // BC2 and BC3 color blocks always use four colors
+    static void DecodeBC1(const BYTE* pBlock, bool bAllowTransparent, float* pRGBA) noexcept
+    {
+        UINT16 Color0, Color1;
+        UINT Indices;
+        memcpy(&Color0, pBlock, sizeof(Color0));
+        memcpy(&Color1, pBlock + 2, sizeof(Color1));
+        memcpy(&Indices, pBlock + 4, sizeof(Indices));
+        float Palette[4][4];
+        GetBC1Palette(Color0, Color1, !bAllowTransparent || Color0 > Color1, Palette);
+        for (UINT i = 0; i < 16; ++i)
+        {
+            const float* pColor = Palette[(Indices >> (2 * i)) & 3];
+            pRGBA[i * 4] = pColor[0];
+            pRGBA[i * 4 + 1] = pColor[1];
+            pRGBA[i * 4 + 2] = pColor[2];
+            if (bAllowTransparent)
+            {
+                pRGBA[i * 4 + 3] = pColor[3];
+            }
+        }
+    }
+
+    // Writes one channel, at a stride of 4 floats
+    static void DecodeBC4(const BYTE* pBlock, bool bSigned, float* pChannel) noexcept
+    {
+        const INT Raw0 = bSigned ? INT(INT8(pBlock[0])) : INT(pBlock[0]);
+        const INT Raw1 = bSigned ? INT(INT8(pBlock[1])) : INT(pBlock[1]);
+        const float Scale = bSigned ? 127.0f : 255.0f;
+        float Palette[8];
+        Palette[0] = float((std::max)(Raw0, -127)) / Scale;
+        Palette[1] = float((std::max)(Raw1, -127)) / Scale;
+        if (Raw0 > Raw1)
+        {
+            for (UINT i = 2; i < 8; ++i)
+            {
+                Palette[i] = (float(8 - i) * Palette[0] + float(i - 1) * Palette[1]) / 7.0f;
+            }
+        }
+        else
+        {
+            for (UINT i = 2; i < 6; ++i)
+            {
+                Palette[i] = (float(6 - i) * Palette[0] + float(i - 1) * Palette[1]) / 5.0f;
+            }
+            Palette[6] = bSigned ? -1.0f : 0.0f;
+            Palette[7] = 1.0f;
+        }
+        UINT64 Indices = 0;
+        memcpy(&Indices, pBlock + 2, 6);
+        for (UINT i = 0; i < 16; ++i)
+        {
+            pChannel[i * 4] = Palette[(Indices >> (3 * i)) & 7];
+        }
+    }
+
+    static const BYTE* GetWeights(UINT NumIndexBits) noexcept
+    {
+        static const BYTE s_Weights2[4] = { 0, 21, 43, 64 };
+        static const BYTE s_Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+        static const BYTE s_Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        return NumIndexBits == 2 ? s_Weights2 : (NumIndexBits == 3 ? s_Weights3 : s_Weights4);
+    }
+
+    // Bit i is the subset of texel i; BC6H uses the first 32
+    static UINT GetSubset2(UINT Partition, UINT Texel) noexcept
+    {
+        static const UINT16 s_Partitions[64] =
+        {
+            0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+            0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+            0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+            0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+            0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+            0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+            0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+            0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+        };
+        return (s_Partitions[Partition] >> Texel) & 1;
+    }
+
+    // Bits 2i and 2i+1 are the subset of texel i
+    static UINT GetSubset3(UINT Partition, UINT Texel) noexcept
+    {
+        static const UINT s_Partitions[64] =
+        {
+            0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+            0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+            0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+            0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+            0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+            0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+            0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+            0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+        };
+        return (s_Partitions[Partition] >> (2 * Texel)) & 3;
+    }
+
+    // The anchor texel of each subset stores its index with one bit less
+    static bool IsAnchor(UINT NumSubsets, UINT Partition, UINT Texel) noexcept
+    {
+        static const BYTE s_Anchors2[64] =
+        {
+            15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+            15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+            15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+            6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+        };
+        static const BYTE s_Anchors3Second[64] =
+        {
+            3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+            3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+            8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+            3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+        };
+        static const BYTE s_Anchors3Third[64] =
+        {
+            15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+            15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+            15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+            15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+        };
+        return Texel == 0
+            || (NumSubsets == 2 && Texel == s_Anchors2[Partition])
+            || (NumSubsets == 3 && (Texel == s_Anchors3Second[Partition] || Texel == s_Anchors3Third[Partition]));
+    }
+
+    static INT SignExtend(INT Value, UINT NumBits) noexcept
+    {
+        const INT SignBit = 1 << (NumBits - 1);
+        return ((Value & ((1 << NumBits) - 1)) ^ SignBit) - SignBit;
+    }
+
+    INT UnquantizeBC6H(INT Value, UINT NumBits) const noexcept
+    {
+        if (!m_bSigned)
+        {
+            if (NumBits >= 15 || Value == 0)
+            {
+                return Value;
+            }
+            return Value == (1 << NumBits) - 1 ? 0xFFFF : ((Value << 16) + 0x8000) >> NumBits;
+        }
+        if (NumBits >= 16)
+        {
+            return Value;
+        }
+        const INT Magnitude = Value < 0 ? -Value : Value;
+        INT Result = 0;
+        if (Magnitude >= (1 << (NumBits - 1)) - 1)
+        {
+            Result = 0x7FFF;
+        }
+        else if (Magnitude != 0)
+        {
+            Result = ((Magnitude << 15) + 0x4000) >> (NumBits - 1);
+        }
+        return Value < 0 ? -Result : Result;
+    }
+
+    void DecodeBC6H(const BYTE* pBlock, float* pRGBA) const noexcept
+    {
+        enum : BYTE { END, D, RW, RX, RY, RZ, GW, GX, GY, GZ, BW, BX, BY, BZ };
+        struct Segment
+        {
+            BYTE Field;
+            BYTE First; // Bits of the field in stream order, from First to Last
+            BYTE Last;
+        };
+        struct ModeInfo
+        {
+            BYTE Mode;
+            bool bTwoRegions;
+            bool bTransformed;
+            BYTE EndpointBits;
+            BYTE DeltaBits[3];
+            Segment Layout[24];
+        };
+        static const ModeInfo s_Modes[14] =
+        {
+            { 0, true, true, 10, { 5, 5, 5 }, { { GY, 4, 4 }, { BY, 4, 4 }, { BZ, 4, 4 }, { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+            { 1, true, true, 7, { 6, 6, 6 }, { { GY, 5, 5 }, { GZ, 4, 4 }, { GZ, 5, 5 }, { RW, 0, 6 }, { BZ, 0, 0 }, { BZ, 1, 1 }, { BY, 4, 4 }, { GW, 0, 6 }, { BY, 5, 5 }, { BZ, 2, 2 }, { GY, 4, 4 }, { BW, 0, 6 }, { BZ, 3, 3 }, { BZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 5 }, { GY, 0, 3 }, { GX, 0, 5 }, { GZ, 0, 3 }, { BX, 0, 5 }, { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 }, { D, 0, 4 } } },
+            { 2, true, true, 11, { 5, 4, 4 }, { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 4 }, { RW, 10, 10 }, { GY, 0, 3 }, { GX, 0, 3 }, { GW, 10, 10 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 3 }, { BW, 10, 10 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+            { 6, true, true, 11, { 4, 5, 4 }, { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 10, 10 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 }, { GW, 10, 10 }, { GZ, 0, 3 }, { BX, 0, 3 }, { BW, 10, 10 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 3 }, { BZ, 0, 0 }, { BZ, 2, 2 }, { RZ, 0, 3 }, { GY, 4, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+            { 10, true, true, 11, { 4, 4, 5 }, { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 10, 10 }, { BY, 4, 4 }, { GY, 0, 3 }, { GX, 0, 3 }, { GW, 10, 10 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BW, 10, 10 }, { BY, 0, 3 }, { RY, 0, 3 }, { BZ, 1, 1 }, { BZ, 2, 2 }, { RZ, 0, 3 }, { BZ, 4, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+            { 14, true, true, 9, { 5, 5, 5 }, { { RW, 0, 8 }, { BY, 4, 4 }, { GW, 0, 8 }, { GY, 4, 4 }, { BW, 0, 8 }, { BZ, 4, 4 }, { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+            { 18, true, true, 8, { 6, 5, 5 }, { { RW, 0, 7 }, { GZ, 4, 4 }, { BY, 4, 4 }, { GW, 0, 7 }, { BZ, 2, 2 }, { GY, 4, 4 }, { BW, 0, 7 }, { BZ, 3, 3 }, { BZ, 4, 4 }, { RX, 0, 5 }, { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 }, { D, 0, 4 } } },
+            { 22, true, true, 8, { 5, 6, 5 }, { { RW, 0, 7 }, { BZ, 0, 0 }, { BY, 4, 4 }, { GW, 0, 7 }, { GY, 5, 5 }, { GY, 4, 4 }, { BW, 0, 7 }, { GZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 5 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+            { 26, true, true, 8, { 5, 5, 6 }, { { RW, 0, 7 }, { BZ, 1, 1 }, { BY, 4, 4 }, { GW, 0, 7 }, { BY, 5, 5 }, { GY, 4, 4 }, { BW, 0, 7 }, { BZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 5 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+            { 30, true, false, 6, { 6, 6, 6 }, { { RW, 0, 5 }, { GZ, 4, 4 }, { BZ, 0, 0 }, { BZ, 1, 1 }, { BY, 4, 4 }, { GW, 0, 5 }, { GY, 5, 5 }, { BY, 5, 5 }, { BZ, 2, 2 }, { GY, 4, 4 }, { BW, 0, 5 }, { GZ, 5, 5 }, { BZ, 3, 3 }, { BZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 5 }, { GY, 0, 3 }, { GX, 0, 5 }, { GZ, 0, 3 }, { BX, 0, 5 }, { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 }, { D, 0, 4 } } },
+            { 3, false, false, 10, { 10, 10, 10 }, { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 9 }, { GX, 0, 9 }, { BX, 0, 9 } } },
+            { 7, false, true, 11, { 9, 9, 9 }, { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 8 }, { RW, 10, 10 }, { GX, 0, 8 }, { GW, 10, 10 }, { BX, 0, 8 }, { BW, 10, 10 } } },
+            { 11, false, true, 12, { 8, 8, 8 }, { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 7 }, { RW, 11, 10 }, { GX, 0, 7 }, { GW, 11, 10 }, { BX, 0, 7 }, { BW, 11, 10 } } },
+            { 15, false, true, 16, { 4, 4, 4 }, { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 15, 10 }, { GX, 0, 3 }, { GW, 15, 10 }, { BX, 0, 3 }, { BW, 15, 10 } } },
+        };
+
+        BlockBits Bits(pBlock);
+        UINT Mode = Bits.Read(2);
+        if (Mode > 1)
+        {
+            Mode |= Bits.Read(3) << 2;
+        }
+        const ModeInfo* pInfo = nullptr;
+        for (const ModeInfo& Info : s_Modes)
+        {
+            pInfo = Info.Mode == Mode ? &Info : pInfo;
+        }
+        if (!pInfo)
+        {
+            return; // Reserved modes decode to black
+        }
+
+        INT Fields[BZ + 1] = {};
+        for (const Segment& Entry : pInfo->Layout)
+        {
+            if (Entry.Field == END)
+            {
+                break;
+            }
+            const INT Step = Entry.First <= Entry.Last ? 1 : -1;
+            for (INT b = Entry.First; ; b += Step)
+            {
+                Fields[Entry.Field] |= INT(Bits.Read(1)) << b;
+                if (b == Entry.Last)
+                {
+                    break;
+                }
+            }
+        }
+
+        // Endpoints A and B of each region, per channel
+        const UINT NumEndpoints = pInfo->bTwoRegions ? 4 : 2;
+        INT Endpoints[4][3];
+        for (UINT c = 0; c < 3; ++c)
+        {
+            const INT Base = m_bSigned ? SignExtend(Fields[RW + c * 4], pInfo->EndpointBits) : Fields[RW + c * 4];
+            Endpoints[0][c] = UnquantizeBC6H(Base, pInfo->EndpointBits);
+            for (UINT e = 1; e < NumEndpoints; ++e)
+            {
+                INT Value = Fields[RW + c * 4 + e];
+                if (pInfo->bTransformed)
+                {
+                    Value = (Base + SignExtend(Value, pInfo->DeltaBits[c])) & ((1 << pInfo->EndpointBits) - 1);
+                }
+                Value = m_bSigned ? SignExtend(Value, pInfo->EndpointBits) : Value;
+                Endpoints[e][c] = UnquantizeBC6H(Value, pInfo->EndpointBits);
+            }
+        }
+
+        const UINT Partition = static_cast<UINT>(Fields[D]);
+        const UINT NumIndexBits = pInfo->bTwoRegions ? 3 : 4;
+        const BYTE* pWeights = GetWeights(NumIndexBits);
+        for (UINT i = 0; i < 16; ++i)
+        {
+            const UINT Region = pInfo->bTwoRegions ? GetSubset2(Partition, i) : 0;
+            const INT Weight = pWeights[Bits.Read(NumIndexBits - (IsAnchor(NumEndpoints / 2, Partition, i) ? 1 : 0))];
+            for (UINT c = 0; c < 3; ++c)
+            {
+                const INT Value = ((64 - Weight) * Endpoints[Region * 2][c] + Weight * Endpoints[Region * 2 + 1][c] + 32) >> 6;
+                UINT Half;
+                if (!m_bSigned)
+                {
+                    Half = UINT(Value * 31) >> 6;
+                }
+                else
+                {
+                    Half = Value < 0 ? 0x8000 | (UINT(-Value * 31) >> 5) : UINT(Value * 31) >> 5;
+                }
+                pRGBA[i * 4 + c] = CD3DX12PixelCodec::SmallFloatToFloat(Half, 5, 10, true);
+            }
+        }
+    }
+
+    static void DecodeBC7(const BYTE* pBlock, float* pRGBA) noexcept
+    {
+        struct ModeInfo
+        {
+            BYTE NumSubsets;
+            BYTE PartitionBits;
+            BYTE RotationBits;
+            BYTE IndexSelectionBits;
+            BYTE ColorBits;
+            BYTE AlphaBits;
+            BYTE EndpointPBits;
+            BYTE SharedPBits;
+            BYTE IndexBits;
+            BYTE SecondaryIndexBits;
+        };
+        static const ModeInfo s_Modes[8] =
+        {
+            { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+            { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+            { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+            { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+            { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+            { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+            { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+            { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+        };
+
+        BlockBits Bits(pBlock);
+        UINT Mode = 0;
+        while (Mode < 8 && !Bits.Read(1))
+        {
+            ++Mode;
+        }
+        if (Mode == 8)
+        {
+            for (UINT i = 0; i < 64; ++i)
+            {
+                pRGBA[i] = 0.0f; // Reserved mode decodes to transparent black
+            }
+            return;
+        }
+        const ModeInfo& Info = s_Modes[Mode];
+        const UINT Partition = Bits.Read(Info.PartitionBits);
+        const UINT Rotation = Bits.Read(Info.RotationBits);
+        const UINT IndexSelection = Bits.Read(Info.IndexSelectionBits);
+
+        // Channels of both endpoints of every subset, then the P-bits
+        UINT Endpoints[3][2][4] = {};
+        const UINT NumChannels = Info.AlphaBits ? 4 : 3;
+        for (UINT c = 0; c < NumChannels; ++c)
+        {
+            for (UINT s = 0; s < Info.NumSubsets; ++s)
+            {
+                Endpoints[s][0][c] = Bits.Read(c < 3 ? Info.ColorBits : Info.AlphaBits);
+                Endpoints[s][1][c] = Bits.Read(c < 3 ? Info.ColorBits : Info.AlphaBits);
+            }
+        }
+        UINT PBits[3][2] = {};
+        for (UINT s = 0; s < Info.NumSubsets; ++s)
+        {
+            if (Info.EndpointPBits)
+            {
+                PBits[s][0] = Bits.Read(1);
+                PBits[s][1] = Bits.Read(1);
+            }
+        }
+        for (UINT s = 0; s < Info.NumSubsets; ++s)
+        {
+            if (Info.SharedPBits)
+            {
+                PBits[s][0] = PBits[s][1] = Bits.Read(1);
+            }
+        }
+        const UINT HasPBit = (Info.EndpointPBits || Info.SharedPBits) ? 1 : 0;
+        for (UINT s = 0; s < Info.NumSubsets; ++s)
+        {
+            for (UINT e = 0; e < 2; ++e)
+            {
+                for (UINT c = 0; c < NumChannels; ++c)
+                {
+                    // Append the P-bit and replicate the high bits into the low bits
+                    const UINT NumBits = (c < 3 ? Info.ColorBits : Info.AlphaBits) + HasPBit;
+                    const UINT Value = (Endpoints[s][e][c] << HasPBit) | (HasPBit ? PBits[s][e] : 0);
+                    Endpoints[s][e][c] = ((Value << (8 - NumBits)) | (Value >> (2 * NumBits - 8))) & 0xFF;
+                }
+                Endpoints[s][e][3] = Info.AlphaBits ? Endpoints[s][e][3] : 255;
+            }
+        }
+
+        UINT Indices[16];
+        UINT SecondaryIndices[16] = {};
+        for (UINT i = 0; i < 16; ++i)
+        {
+            Indices[i] = Bits.Read(Info.IndexBits - (IsAnchor(Info.NumSubsets, Partition, i) ? 1 : 0));
+        }
+        for (UINT i = 0; Info.SecondaryIndexBits && i < 16; ++i)
+        {
+            SecondaryIndices[i] = Bits.Read(Info.SecondaryIndexBits - (i == 0 ? 1 : 0));
+        }
+
+        // The index selection bit swaps which index set drives color and alpha
+        const bool bSwap = IndexSelection != 0;
+        const BYTE* pColorWeights = GetWeights(bSwap ? Info.SecondaryIndexBits : Info.IndexBits);
+        const BYTE* pAlphaWeights = GetWeights(Info.SecondaryIndexBits && !bSwap ? Info.SecondaryIndexBits : Info.IndexBits);
+        for (UINT i = 0; i < 16; ++i)
+        {
+            const UINT Subset = Info.NumSubsets == 1 ? 0 : (Info.NumSubsets == 2 ? GetSubset2(Partition, i) : GetSubset3(Partition, i));
+            const UINT ColorIndex = bSwap ? SecondaryIndices[i] : Indices[i];
+            const UINT AlphaIndex = Info.SecondaryIndexBits && !bSwap ? SecondaryIndices[i] : Indices[i];
+            UINT Texel[4];
+            for (UINT c = 0; c < 4; ++c)
+            {
+                const UINT Weight = c < 3 ? pColorWeights[ColorIndex] : pAlphaWeights[AlphaIndex];
+                Texel[c] = ((64 - Weight) * Endpoints[Subset][0][c] + Weight * Endpoints[Subset][1][c] + 32) >> 6;
+            }
+            if (Rotation)
+            {
+                std::swap(Texel[3], Texel[Rotation - 1]);
+            }
+            for (UINT c = 0; c < 4; ++c)
+            {
+                pRGBA[i * 4 + c] = float(Texel[c]) / 255.0f;
+            }
+        }
+    }
+
+    void EncodeBC1(const float* pRGBA, BYTE* pBlock) const noexcept
+    {
+        float Colors[16][3];
+        bool bTransparent[16];
+        bool bAnyTransparent = false;
+        float Min[3] = { 1.0f, 1.0f, 1.0f };
+        float Max[3] = { 0.0f, 0.0f, 0.0f };
+        float Mean[3] = {};
+        UINT NumOpaque = 0;
+        for (UINT i = 0; i < 16; ++i)
+        {
+            bTransparent[i] = pRGBA[i * 4 + 3] < 0.5f;
+            bAnyTransparent = bAnyTransparent || bTransparent[i];
+            for (UINT c = 0; c < 3; ++c)
+            {
+                const float Value = (std::min)((std::max)(pRGBA[i * 4 + c], 0.0f), 1.0f);
+                Colors[i][c] = m_bSRGB ? CD3DX12PixelCodec::LinearToSRGB(Value) : Value;
+                if (!bTransparent[i])
+                {
+                    Min[c] = (std::min)(Min[c], Colors[i][c]);
+                    Max[c] = (std::max)(Max[c], Colors[i][c]);
+                    Mean[c] += Colors[i][c];
+                }
+            }
+            NumOpaque += bTransparent[i] ? 0 : 1;
+        }
+        if (NumOpaque == 0)
+        {
+            const UINT16 Black = 0;
+            const UINT AllTransparent = 0xFFFFFFFF;
+            memcpy(pBlock, &Black, sizeof(Black));
+            memcpy(pBlock + 2, &Black, sizeof(Black));
+            memcpy(pBlock + 4, &AllTransparent, sizeof(AllTransparent));
+            return;
+        }
+
+        // Pick the diagonal of the bounding box that follows the colors, relative to green
+        float Covariance[3] = {};
+        for (UINT i = 0; i < 16; ++i)
+        {
+            for (UINT c = 0; c < 3 && !bTransparent[i]; ++c)
+            {
+                Covariance[c] += (Colors[i][c] - Mean[c] / float(NumOpaque)) * (Colors[i][1] - Mean[1] / float(NumOpaque));
+            }
+        }
+        for (UINT c = 0; c < 3; ++c)
+        {
+            const float Inset = (Max[c] - Min[c]) / 16.0f;
+            Min[c] += Inset;
+            Max[c] -= Inset;
+            if (Covariance[c] < 0.0f)
+            {
+                std::swap(Min[c], Max[c]);
+            }
+        }
+        UINT16 Color0 = static_cast<UINT16>((UINT(Max[0] * 31.0f + 0.5f) << 11) | (UINT(Max[1] * 63.0f + 0.5f) << 5) | UINT(Max[2] * 31.0f + 0.5f));
+        UINT16 Color1 = static_cast<UINT16>((UINT(Min[0] * 31.0f + 0.5f) << 11) | (UINT(Min[1] * 63.0f + 0.5f) << 5) | UINT(Min[2] * 31.0f + 0.5f));
+
+        // Four colors need Color0 > Color1; transparency needs Color0 <= Color1
+        if (bAnyTransparent ? Color0 > Color1 : Color0 < Color1)
+        {
+            std::swap(Color0, Color1);
+        }
+        const bool bFourColors = Color0 > Color1;
+        float Palette[4][4];
+        GetBC1Palette(Color0, Color1, bFourColors, Palette);
+        UINT Indices = 0;
+        for (UINT i = 0; i < 16; ++i)
+        {
+            UINT Best = 3;
+            float BestError = INFINITY;
+            for (UINT p = 0; p < (bFourColors ? 4u : 3u) && !bTransparent[i]; ++p)
+            {
+                float Error = 0.0f;
+                for (UINT c = 0; c < 3; ++c)
+                {
+                    Error += (Palette[p][c] - Colors[i][c]) * (Palette[p][c] - Colors[i][c]);
+                }
+                if (Error < BestError)
+                {
+                    BestError = Error;
+                    Best = p;
+                }
+            }
+            Indices |= Best << (2 * i);
+        }
+        memcpy(pBlock, &Color0, sizeof(Color0));
+        memcpy(pBlock + 2, &Color1, sizeof(Color1));
+        memcpy(pBlock + 4, &Indices, sizeof(Indices));
+    }
+
+    // Reads one channel, at a stride of 4 floats; always uses the 8-value mode
+    static void EncodeBC4(const float* pChannel, bool bSigned, BYTE* pBlock) noexcept
+    {
+        const float Scale = bSigned ? 127.0f : 255.0f;
+        const float Lowest = bSigned ? -1.0f : 0.0f;
+        float Values[16];
+        float Min = Scale;
+        float Max = -Scale;
+        for (UINT i = 0; i < 16; ++i)
+        {
+            Values[i] = (std::min)((std::max)(pChannel[i * 4], Lowest), 1.0f) * Scale;
+            Min = (std::min)(Min, Values[i]);
+            Max = (std::max)(Max, Values[i]);
+        }
+        const INT Raw0 = INT(std::floor(Max + 0.5f));
+        const INT Raw1 = INT(std::floor(Min + 0.5f));
+        pBlock[0] = static_cast<BYTE>(Raw0);
+        pBlock[1] = static_cast<BYTE>(Raw1);
+        UINT64 Indices = 0;
+        for (UINT i = 0; Raw0 > Raw1 && i < 16; ++i)
+        {
+            // Step 7 is endpoint 0 and step 0 is endpoint 1; steps in between are indices 6 down to 2
+            const float Step = (Values[i] - float(Raw1)) * 7.0f / float(Raw0 - Raw1);
+            const UINT Nearest = UINT((std::min)((std::max)(std::floor(Step + 0.5f), 0.0f), 7.0f));
+            Indices |= UINT64(Nearest == 7 ? 0 : (Nearest == 0 ? 1 : 8 - Nearest)) << (3 * i);
+        }
+        memcpy(pBlock + 2, &Indices, 6);
+    }
+
+    DXGI_FORMAT m_Format = DXGI_FORMAT_UNKNOWN;
+    UINT m_Type = 0; // BC number
+    bool m_bSRGB = false;
+    bool m_bSigned = false;
+};
+
+#endif // !D3DX12_NO_BLOCK_COMPRESSION_HELPERS
+
+#ifndef D3DX12_NO_FORMAT_CAST_HELPERS
+
+//================================================================================================
+// D3DX12 Format Cast Helpers
+//
+// Bit matrices over all pairs of formats in D3D12_PROPERTY_LAYOUT_FORMAT_TABLE, so that view
+// validation answers cast questions with a single lookup instead of walking cast sets and
+// comparing components. Get() builds the matrix of a feature level on first use and keeps it for
+// the lifetime of the process; the matrices of the feature level independent functions are
+// shared by all feature levels. Formats outside the table are never compatible.
+// Uses STL
+//
+//================================================================================================
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12FormatCastMatrix
+{
+public:
+    explicit CD3DX12FormatCastMatrix(D3D_FEATURE_LEVEL FeatureLevel)
+        : m_FeatureLevel(FeatureLevel)
+        , m_pShared(&GetShared())
+        , m_CanView(m_pShared->NumWords)
+    {
+        const UINT NumFormats = m_pShared->NumFormats;
+        for (UINT ResourceIndex = 0; ResourceIndex < NumFormats; ++ResourceIndex)
+        {
+            const DXGI_FORMAT ResourceFormat = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(ResourceIndex);
+            const bool bTypeless = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetTypeLevel(ResourceFormat) != D3DFTL_FULL_TYPE;
+            const bool bCastable = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::CanBeCastEvenFullyTyped(ResourceFormat, FeatureLevel);
+            SetBit(m_CanView, ResourceIndex * NumFormats + ResourceIndex);
+            for (const DXGI_FORMAT* pCast = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormatCastSet(ResourceFormat);
+                pCast && *pCast != DXGI_FORMAT_UNKNOWN; ++pCast)
+            {
+                if (UINT(*pCast) < NumFormats
+                    && (bTypeless || (bCastable && D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::CanBeCastEvenFullyTyped(*pCast, FeatureLevel))))
+                {
+                    SetBit(m_CanView, ResourceIndex * NumFormats + UINT(*pCast));
+                }
+            }
+        }
+    }
+
+    // Feature levels the table does not know use the highest one it defines
+    static const CD3DX12FormatCastMatrix& Get(D3D_FEATURE_LEVEL FeatureLevel)
+    {
+        switch (FeatureLevel)
+        {
+        case D3D_FEATURE_LEVEL_1_0_CORE: return GetStatic<D3D_FEATURE_LEVEL_1_0_CORE>();
+        case D3D_FEATURE_LEVEL_9_1: return GetStatic<D3D_FEATURE_LEVEL_9_1>();
+        case D3D_FEATURE_LEVEL_9_2: return GetStatic<D3D_FEATURE_LEVEL_9_2>();
+        case D3D_FEATURE_LEVEL_9_3: return GetStatic<D3D_FEATURE_LEVEL_9_3>();
+        case D3D_FEATURE_LEVEL_10_0: return GetStatic<D3D_FEATURE_LEVEL_10_0>();
+        case D3D_FEATURE_LEVEL_10_1: return GetStatic<D3D_FEATURE_LEVEL_10_1>();
+        case D3D_FEATURE_LEVEL_11_0: return GetStatic<D3D_FEATURE_LEVEL_11_0>();
+        case D3D_FEATURE_LEVEL_11_1: return GetStatic<D3D_FEATURE_LEVEL_11_1>();
+        case D3D_FEATURE_LEVEL_12_0: return GetStatic<D3D_FEATURE_LEVEL_12_0>();
+        case D3D_FEATURE_LEVEL_12_1: return GetStatic<D3D_FEATURE_LEVEL_12_1>();
+        default: return GetStatic<D3D_FEATURE_LEVEL_12_2>();
+        }
+    }
+
+    D3D_FEATURE_LEVEL GetFeatureLevel() const noexcept { return m_FeatureLevel; }
+
+    // True when the formats are equal, or when ViewFormat is in the cast set of ResourceFormat and
+    // either ResourceFormat is not fully typed or both formats CanBeCastEvenFullyTyped
+    bool CanViewFormat(DXGI_FORMAT ResourceFormat, DXGI_FORMAT ViewFormat) const noexcept
+    {
+        return GetBit(m_CanView, ResourceFormat, ViewFormat);
+    }
+
+    // Same results as the D3D12_PROPERTY_LAYOUT_FORMAT_TABLE functions of the same names
+    bool ValidCastToR32UAV(DXGI_FORMAT From, DXGI_FORMAT To) const noexcept
+    {
+        return GetBit(m_pShared->ValidCastToR32UAV, From, To);
+    }
+    bool FloatAndNotFloatFormats(DXGI_FORMAT FormatA, DXGI_FORMAT FormatB) const noexcept
+    {
+        return GetBit(m_pShared->FloatAndNotFloatFormats, FormatA, FormatB);
+    }
+    bool SNORMAndUNORMFormats(DXGI_FORMAT FormatA, DXGI_FORMAT FormatB) const noexcept
+    {
+        return GetBit(m_pShared->SNORMAndUNORMFormats, FormatA, FormatB);
+    }
+
+private:
+    struct SharedMatrices
+    {
+        UINT NumFormats;
+        SIZE_T NumWords;
+        std::vector<UINT64> ValidCastToR32UAV;
+        std::vector<UINT64> FloatAndNotFloatFormats;
+        std::vector<UINT64> SNORMAndUNORMFormats;
+    };
+
+    static void SetBit(std::vector<UINT64>& Matrix, SIZE_T Index) noexcept
+    {
+        Matrix[Index / 64] |= UINT64(1) << (Index % 64);
+    }
+
+    // Format values are the indices of the format table
+    bool GetBit(const std::vector<UINT64>& Matrix, DXGI_FORMAT Row, DXGI_FORMAT Column) const noexcept
+    {
+        const UINT NumFormats = m_pShared->NumFormats;
+        if (UINT(Row) >= NumFormats || UINT(Column) >= NumFormats)
+        {
+            return false;
+        }
+        const SIZE_T Index = SIZE_T(Row) * NumFormats + UINT(Column);
+        return (Matrix[Index / 64] >> (Index % 64)) & 1;
+    }
+
+    static const SharedMatrices& GetShared()
+    {
+        static const SharedMatrices s_Shared = []()
+        {
+            SharedMatrices Shared;
+            Shared.NumFormats = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetNumFormats();
+            Shared.NumWords = (SIZE_T(Shared.NumFormats) * Shared.NumFormats + 63) / 64;
+            Shared.ValidCastToR32UAV.resize(Shared.NumWords);
+            Shared.FloatAndNotFloatFormats.resize(Shared.NumWords);
+            Shared.SNORMAndUNORMFormats.resize(Shared.NumWords);
+            for (UINT a = 0; a < Shared.NumFormats; ++a)
+            {
+                const DXGI_FORMAT FormatA = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(a);
+                for (UINT b = 0; b < Shared.NumFormats; ++b)
+                {
+                    const DXGI_FORMAT FormatB = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(b);
+                    const SIZE_T Index = SIZE_T(a) * Shared.NumFormats + b;
+                    if (D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::ValidCastToR32UAV(FormatA, FormatB))
+                    {
+                        SetBit(Shared.ValidCastToR32UAV, Index);
+                    }
+                    if (D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FloatAndNotFloatFormats(FormatA, FormatB))
+                    {
+                        SetBit(Shared.FloatAndNotFloatFormats, Index);
+                    }
+                    if (D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::SNORMAndUNORMFormats(FormatA, FormatB))
+                    {
+                        SetBit(Shared.SNORMAndUNORMFormats, Index);
+                    }
+                }
+            }
+            return Shared;
+        }();
+        return s_Shared;
+    }
+
+    // Function statics are initialized once, even when first used concurrently
+    template<D3D_FEATURE_LEVEL FeatureLevel>
+    static const CD3DX12FormatCastMatrix& GetStatic()
+    {
+        static const CD3DX12FormatCastMatrix s_Matrix(FeatureLevel);
+        return s_Matrix;
+    }
+
+    D3D_FEATURE_LEVEL m_FeatureLevel;
+    const SharedMatrices* m_pShared;
+    std::vector<UINT64> m_CanView;
+};
+
+#endif // !D3DX12_NO_FORMAT_CAST_HELPERS
+
+#ifndef D3DX12_NO_FORMAT_NAME_HELPERS
+
+//================================================================================================
+// D3DX12 Format Name Helpers
+//
+// Parses format names back to DXGI_FORMAT in constant time, for loaders that read formats from
+// text. Names are those of D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetName(), with or without the
+// DXGI_FORMAT_ prefix, in any case. The names are placed in a perfect hash table on first use:
+// a first hash picks a bucket, and each bucket stores the seed of a second hash that sends its
+// names to distinct slots, so a lookup hashes twice and compares a single name. The table is
+// sized from the format table, with at least twice as many slots as formats.
+// Only formats listed in D3D12_PROPERTY_LAYOUT_FORMAT_TABLE are recognized. Header formats past
+// its end, such as B4G4R4A4_UNORM, P208, V208, V408, A4B4G4R4_UNORM and the SAMPLER_FEEDBACK
+// formats, have no name there and fail to parse with E_INVALIDARG.
+// Uses STL
+//
+//================================================================================================
+#include <cstring>
+#include <vector>
+//------------------------------------------------------------------------------------------------
+class CD3DX12FormatNameParser
+{
+public:
+    static HRESULT Parse(_In_reads_(Length) const char* pName, SIZE_T Length, _Out_ DXGI_FORMAT* pFormat) noexcept
+    {
+        *pFormat = DXGI_FORMAT_UNKNOWN;
+        static const char s_Prefix[] = "DXGI_FORMAT_";
+        const SIZE_T PrefixLength = sizeof(s_Prefix) - 1;
+        if (Length > PrefixLength && EqualsIgnoreCase(pName, s_Prefix, PrefixLength))
+        {
+            pName += PrefixLength;
+            Length -= PrefixLength;
+        }
+
+        const Table& Names = GetTable();
+        const UINT Bucket = Hash(pName, Length, 0) % Names.NumBuckets;
+        const UINT Slot = Hash(pName, Length, Names.Seeds[Bucket]) % Names.NumSlots;
+        const UINT Index = Names.Slots[Slot];
+        if (Index == 0 || Names.Lengths[Slot] != Length || !EqualsIgnoreCase(pName, Names.pNames[Slot], Length))
+        {
+            return E_INVALIDARG;
+        }
+        *pFormat = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(Index - 1);
+        return S_OK;
+    }
+
+    static HRESULT Parse(_In_z_ const char* pName, _Out_ DXGI_FORMAT* pFormat) noexcept
+    {
+        return Parse(pName, strlen(pName), pFormat);
+    }
+
+private:
+    struct Table
+    {
+        UINT NumBuckets;
+        UINT NumSlots;
+        std::vector<UINT> Seeds;
+        std::vector<UINT16> Slots;  // Index in the format table + 1, 0 when empty
+        std::vector<UINT8> Lengths;
+        std::vector<LPCSTR> pNames;
+    };
+
+    static char ToUpper(char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    static bool EqualsIgnoreCase(const char* pA, const char* pB, SIZE_T Length) noexcept
+    {
+        for (SIZE_T i = 0; i < Length; ++i)
+        {
+            if (ToUpper(pA[i]) != ToUpper(pB[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Seeded FNV-1a over the upper-cased name, with a final avalanche so the low bits are usable
+    static UINT Hash(const char* pName, SIZE_T Length, UINT Seed) noexcept
+    {
+        UINT Value = 2166136261u ^ (Seed * 0x9E3779B9u);
+        for (SIZE_T i = 0; i < Length; ++i)
+        {
+            Value = (Value ^ static_cast<BYTE>(ToUpper(pName[i]))) * 16777619u;
+        }
+        Value ^= Value >> 16;
+        Value *= 0x85EBCA6Bu;
+        Value ^= Value >> 13;
+        Value *= 0xC2B2AE35u;
+        return Value ^ (Value >> 16);
+    }
+
+    static const Table& GetTable()
+    {
+        static const Table s_Table = []()
+        {
+            Table Names;
+            const UINT NumFormats = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetNumFormats();
+            D3DX12_ASSERT(NumFormats < 0xFFFF);
+
+            // A load factor of at most one half keeps the seed search short
+            Names.NumSlots = 64;
+            while (Names.NumSlots < 2 * NumFormats)
+            {
+                Names.NumSlots *= 2;
+            }
+            Names.NumBuckets = Names.NumSlots / 4;
+            Names.Seeds.resize(Names.NumBuckets);
+            Names.Slots.resize(Names.NumSlots);
+            Names.Lengths.resize(Names.NumSlots);
+            Names.pNames.resize(Names.NumSlots);
+
+            // Group the names by bucket, largest buckets first, since those are hardest to place
+            std::vector<UINT16> BucketSizes(Names.NumBuckets);
+            std::vector<UINT16> BucketOf(NumFormats);
+            for (UINT i = 0; i < NumFormats; ++i)
+            {
+                const DXGI_FORMAT Format = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(i);
+                if (D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExistsInHeader(Format))
+                {
+                    const LPCSTR pName = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetName(Format);
+                    BucketOf[i] = static_cast<UINT16>(Hash(pName, strlen(pName), 0) % Names.NumBuckets);
+                    ++BucketSizes[BucketOf[i]];
+                }
+            }
+            for (UINT Size = NumFormats; Size > 0; --Size)
+            {
+                for (UINT Bucket = 0; Bucket < Names.NumBuckets; ++Bucket)
+                {
+                    if (BucketSizes[Bucket] == Size)
+                    {
+                        PlaceBucket(Names, Bucket, BucketOf.data(), NumFormats);
+                    }
+                }
+            }
+            return Names;
+        }();
+        return s_Table;
+    }
+
+    // Tries seeds until every name of the bucket lands in a distinct free slot
+    static void PlaceBucket(Table& Names, UINT Bucket, const UINT16* BucketOf, UINT NumFormats)
+    {
+        std::vector<UINT> Placed;
+        for (UINT Seed = 1; ; ++Seed)
+        {
+            bool bFits = true;
+            for (UINT i = 0; i < NumFormats && bFits; ++i)
+            {
+                const DXGI_FORMAT Format = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetFormat(i);
+                if (BucketOf[i] != Bucket || !D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::FormatExistsInHeader(Format))
+                {
+                    continue;
+                }
+                const LPCSTR pName = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetName(Format);
+                const SIZE_T Length = strlen(pName);
+                const UINT Slot = Hash(pName, Length, Seed) % Names.NumSlots;
+                bFits = Names.Slots[Slot] == 0;
+                if (bFits)
+                {
+                    Names.Slots[Slot] = static_cast<UINT16>(i + 1);
+                    Names.Lengths[Slot] = static_cast<UINT8>(Length);
+                    Names.pNames[Slot] = pName;
+                    Placed.push_back(Slot);
+                }
+            }
+            if (bFits)
+            {
+                Names.Seeds[Bucket] = Seed;
+                return;
+            }
+            for (UINT Slot : Placed)
+            {
+                Names.Slots[Slot] = 0;
+            }
+            Placed.clear();
+        }
+    }
+};
+
+#endif // !D3DX12_NO_FORMAT_NAME_HELPERS
 
 #undef D3DX12_COM_PTR
 #undef D3DX12_COM_PTR_GET
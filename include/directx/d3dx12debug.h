@@ -0,0 +1,652 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License (MIT).
+//
+//*********************************************************
+
+#ifndef __D3DX12_DEBUG_H__
+#define __D3DX12_DEBUG_H__
+
+#include "d3dx12.h"
+#include "d3d12sdklayers.h"
+
+#if defined( __cplusplus )
+
+#ifndef D3DX12_NO_INFO_QUEUE_SINK_HELPERS
+
+//================================================================================================
+// D3DX12 Info Queue Sink Helpers
+//
+// CD3DX12InfoQueueSink receives debug layer messages through an ID3D12InfoQueue1 callback and queues
+// them in a fixed size lock-free ring, so the thread that triggered a message only pays for a copy of
+// its text. Any number of threads may produce messages; one thread at a time calls Drain() to hand
+// them to a logger.
+// Uses STL
+//
+// Message storms are rate limited per D3D12_MESSAGE_ID: at most MaxMessagesPerId of each ID are
+// queued between two calls to Drain(). Further repeats are only counted and reported with the next
+// queued message of that ID. Messages arriving while the ring is full are dropped and counted.
+//
+//================================================================================================
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+// pDescription is only valid during the Drain() callback
+struct D3DX12_INFO_QUEUE_MESSAGE
+{
+    D3D12_MESSAGE_CATEGORY Category;
+    D3D12_MESSAGE_SEVERITY Severity;
+    D3D12_MESSAGE_ID ID;
+    UINT NumSuppressed; // Repeats of this ID suppressed by rate limiting since the last one queued
+    LPCSTR pDescription;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12InfoQueueSink
+{
+public:
+    CD3DX12InfoQueueSink() = default;
+    CD3DX12InfoQueueSink(const CD3DX12InfoQueueSink&) = delete;
+    CD3DX12InfoQueueSink& operator=(const CD3DX12InfoQueueSink&) = delete;
+    ~CD3DX12InfoQueueSink() { Unregister(); }
+
+    // Capacity must be a power of two. Descriptions longer than MaxDescriptionLength - 1 characters
+    // are truncated.
+    HRESULT Init(UINT Capacity, UINT MaxDescriptionLength = 512, UINT MaxMessagesPerId = 4)
+    {
+        Unregister();
+        if (Capacity == 0 || (Capacity & (Capacity - 1)) != 0 || MaxDescriptionLength == 0 || MaxMessagesPerId == 0)
+        {
+            return E_INVALIDARG;
+        }
+        std::vector<Slot>(Capacity).swap(m_Slots);
+        m_Text.assign(SIZE_T(Capacity) * MaxDescriptionLength, '\0');
+        for (UINT i = 0; i < Capacity; ++i)
+        {
+            m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+        for (UINT i = 0; i < NumIdBuckets; ++i)
+        {
+            m_QueuedPerId[i].store(0, std::memory_order_relaxed);
+            m_SuppressedPerId[i].store(0, std::memory_order_relaxed);
+        }
+        m_Mask = Capacity - 1;
+        m_MaxDescriptionLength = MaxDescriptionLength;
+        m_MaxMessagesPerId = MaxMessagesPerId;
+        m_Tail.store(0, std::memory_order_relaxed);
+        m_Head = 0;
+        m_NumDropped.store(0, std::memory_order_relaxed);
+        return S_OK;
+    }
+
+    HRESULT Register(_In_ ID3D12InfoQueue1* pInfoQueue, D3D12_MESSAGE_CALLBACK_FLAGS Flags = D3D12_MESSAGE_CALLBACK_FLAG_NONE)
+    {
+        Unregister();
+        if (m_Slots.empty())
+        {
+            return E_FAIL;
+        }
+        HRESULT hr = pInfoQueue->RegisterMessageCallback(&CD3DX12InfoQueueSink::OnMessage, Flags, this, &m_CallbackCookie);
+        if (SUCCEEDED(hr))
+        {
+            m_pInfoQueue = pInfoQueue;
+            m_pInfoQueue->AddRef();
+        }
+        return hr;
+    }
+
+    void Unregister() noexcept
+    {
+        if (m_pInfoQueue)
+        {
+            m_pInfoQueue->UnregisterMessageCallback(m_CallbackCookie);
+            m_pInfoQueue->Release();
+            m_pInfoQueue = nullptr;
+        }
+    }
+
+    // D3D12MessageFunc; pContext is the sink. Never blocks.
+    static void __stdcall OnMessage(D3D12_MESSAGE_CATEGORY Category, D3D12_MESSAGE_SEVERITY Severity, D3D12_MESSAGE_ID ID,
+        LPCSTR pDescription, void* pContext) noexcept
+    {
+        static_cast<CD3DX12InfoQueueSink*>(pContext)->Push(Category, Severity, ID, pDescription);
+    }
+
+    // Hands queued messages to Func(const D3DX12_INFO_QUEUE_MESSAGE&) in arrival order and starts a new
+    // rate limiting window. Must not be called from more than one thread at a time. Returns the number
+    // of messages drained.
+    template <typename TFunc>
+    UINT Drain(TFunc&& Func)
+    {
+        UINT NumDrained = 0;
+        for (;; ++m_Head, ++NumDrained)
+        {
+            Slot& Entry = m_Slots[m_Head & m_Mask];
+            if (Entry.Sequence.load(std::memory_order_acquire) != m_Head + 1)
+            {
+                break;
+            }
+            const D3DX12_INFO_QUEUE_MESSAGE Message = { Entry.Category, Entry.Severity, Entry.ID, Entry.NumSuppressed,
+                &m_Text[SIZE_T(m_Head & m_Mask) * m_MaxDescriptionLength] };
+            Func(Message);
+            Entry.Sequence.store(m_Head + m_Mask + 1, std::memory_order_release);
+        }
+        for (UINT i = 0; i < NumIdBuckets; ++i)
+        {
+            if (m_QueuedPerId[i].load(std::memory_order_relaxed))
+            {
+                m_QueuedPerId[i].store(0, std::memory_order_relaxed);
+            }
+        }
+        return NumDrained;
+    }
+
+    // Messages lost because the ring was full
+    UINT64 GetNumDropped() const noexcept { return m_NumDropped.load(std::memory_order_relaxed); }
+
+private:
+    // IDs past the end of the known range share the last bucket
+    static constexpr UINT NumIdBuckets = D3D12_MESSAGE_ID_D3D12_MESSAGES_END + 1;
+
+    struct Slot
+    {
+        std::atomic<UINT64> Sequence;
+        D3D12_MESSAGE_CATEGORY Category;
+        D3D12_MESSAGE_SEVERITY Severity;
+        D3D12_MESSAGE_ID ID;
+        UINT NumSuppressed;
+    };
+
+    void Push(D3D12_MESSAGE_CATEGORY Category, D3D12_MESSAGE_SEVERITY Severity, D3D12_MESSAGE_ID ID, LPCSTR pDescription) noexcept
+    {
+        const UINT Bucket = (static_cast<UINT>(ID) < NumIdBuckets) ? static_cast<UINT>(ID) : NumIdBuckets - 1;
+        if (m_QueuedPerId[Bucket].fetch_add(1, std::memory_order_relaxed) >= m_MaxMessagesPerId)
+        {
+            m_SuppressedPerId[Bucket].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Claim the slot at the tail; a slot is free once its sequence equals the claiming position
+        UINT64 Position = m_Tail.load(std::memory_order_relaxed);
+        Slot* pEntry;
+        for (;;)
+        {
+            pEntry = &m_Slots[Position & m_Mask];
+            const INT64 Difference = static_cast<INT64>(pEntry->Sequence.load(std::memory_order_acquire) - Position);
+            if (Difference == 0)
+            {
+                if (m_Tail.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (Difference < 0)
+            {
+                m_NumDropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else
+            {
+                Position = m_Tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        pEntry->Category = Category;
+        pEntry->Severity = Severity;
+        pEntry->ID = ID;
+        pEntry->NumSuppressed = m_SuppressedPerId[Bucket].exchange(0, std::memory_order_relaxed);
+        char* pText = &m_Text[SIZE_T(Position & m_Mask) * m_MaxDescriptionLength];
+        const SIZE_T Length = pDescription ? strnlen(pDescription, m_MaxDescriptionLength - 1) : 0;
+        if (Length)
+        {
+            memcpy(pText, pDescription, Length);
+        }
+        pText[Length] = '\0';
+        pEntry->Sequence.store(Position + 1, std::memory_order_release);
+    }
+
+    std::vector<Slot> m_Slots;
+    std::vector<char> m_Text;
+    UINT64 m_Mask = 0;
+    UINT m_MaxDescriptionLength = 0;
+    UINT m_MaxMessagesPerId = 0;
+    std::atomic<UINT64> m_Tail{ 0 };
+    UINT64 m_Head = 0;
+    std::atomic<UINT64> m_NumDropped{ 0 };
+    std::atomic<UINT> m_QueuedPerId[NumIdBuckets] = {};
+    std::atomic<UINT> m_SuppressedPerId[NumIdBuckets] = {};
+    ID3D12InfoQueue1* m_pInfoQueue = nullptr;
+    DWORD m_CallbackCookie = 0;
+};
+
+#endif // !D3DX12_NO_INFO_QUEUE_SINK_HELPERS
+
+#ifndef D3DX12_NO_DRED_HELPERS
+
+//================================================================================================
+// D3DX12 DRED Helpers
+//
+// CD3DX12DREDRecord flattens the auto-breadcrumb and page fault output of
+// ID3D12DeviceRemovedExtendedData2 into a compact binary crash record. The record buffer is allocated
+// by Init() at startup; Capture() only walks the DRED lists and copies into it, so it is safe to call
+// from a crash handler. The caller writes GetData() / GetSize() to a file as is.
+// Uses STL
+//
+// To bound the record size, only a window of operations around the last completed one is kept for
+// each command list; if the buffer still fills up, the rest is dropped and the record is marked
+// truncated. CD3DX12DREDRecordReader parses a record offline.
+//
+// Record layout, every block 4 byte aligned:
+//   D3DX12_DRED_RECORD_HEADER
+//   per command list: D3DX12_DRED_RECORD_COMMAND_LIST, list name, queue name, one byte per operation,
+//                     then per breadcrumb context: D3DX12_DRED_RECORD_STRING, text
+//   per allocation:   D3DX12_DRED_RECORD_ALLOCATION, name
+//
+//================================================================================================
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+enum D3DX12_DRED_RECORD_FLAGS
+{
+    D3DX12_DRED_RECORD_FLAG_NONE = 0,
+    D3DX12_DRED_RECORD_FLAG_TRUNCATED = 0x1,
+    D3DX12_DRED_RECORD_FLAG_PAGE_FAULT = 0x2,
+};
+
+struct D3DX12_DRED_RECORD_HEADER
+{
+    UINT32 Magic;
+    UINT32 Version;
+    UINT32 Size;
+    UINT32 Flags;
+    HRESULT DeviceRemovedReason;
+    D3D12_DRED_DEVICE_STATE DeviceState;
+    UINT32 NumCommandLists;
+    UINT32 NumAllocations;
+    UINT64 PageFaultVA;
+};
+
+// Operations [FirstOp, FirstOp + NumOps) of the BreadcrumbCount recorded are stored
+struct D3DX12_DRED_RECORD_COMMAND_LIST
+{
+    UINT32 BreadcrumbCount;
+    UINT32 LastCompletedOp;
+    UINT32 FirstOp;
+    UINT32 NumOps;
+    UINT32 NumContexts;
+    UINT32 CommandListNameLength;
+    UINT32 CommandQueueNameLength;
+};
+
+struct D3DX12_DRED_RECORD_STRING
+{
+    UINT32 Index;
+    UINT32 Length;
+};
+
+struct D3DX12_DRED_RECORD_ALLOCATION
+{
+    D3D12_DRED_ALLOCATION_TYPE AllocationType;
+    UINT32 bRecentlyFreed;
+    UINT32 NameLength;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12DREDRecord
+{
+public:
+    static constexpr UINT32 Magic = 0x52445844; // 'DXDR'
+    static constexpr UINT32 Version = 1;
+
+    // Allocates the record buffer; MaxOpsPerCommandList bounds the operation window kept per list
+    HRESULT Init(SIZE_T Capacity = 64 * 1024, UINT MaxOpsPerCommandList = 64)
+    {
+        if (Capacity < sizeof(D3DX12_DRED_RECORD_HEADER) || Capacity > UINT32_MAX || MaxOpsPerCommandList == 0)
+        {
+            return E_INVALIDARG;
+        }
+        m_Data.assign(Capacity, 0);
+        m_MaxOps = MaxOpsPerCommandList;
+        m_Size = 0;
+        return S_OK;
+    }
+
+    // Queries the DRED output of a removed device and captures it
+    HRESULT Capture(_In_ ID3D12DeviceRemovedExtendedData2* pDred, HRESULT DeviceRemovedReason) noexcept
+    {
+        D3D12_DRED_AUTO_BREADCRUMBS_OUTPUT1 Breadcrumbs = {};
+        D3D12_DRED_PAGE_FAULT_OUTPUT2 PageFault = {};
+        HRESULT hr = pDred->GetAutoBreadcrumbsOutput1(&Breadcrumbs);
+        if (FAILED(hr))
+        {
+            Breadcrumbs = {};
+        }
+        const bool bPageFault = SUCCEEDED(pDred->GetPageFaultAllocationOutput2(&PageFault));
+        return Capture(Breadcrumbs, bPageFault ? &PageFault : nullptr, DeviceRemovedReason, pDred->GetDeviceState());
+    }
+
+    HRESULT Capture(
+        const D3D12_DRED_AUTO_BREADCRUMBS_OUTPUT1& Breadcrumbs,
+        _In_opt_ const D3D12_DRED_PAGE_FAULT_OUTPUT2* pPageFault,
+        HRESULT DeviceRemovedReason,
+        D3D12_DRED_DEVICE_STATE DeviceState) noexcept
+    {
+        if (m_Data.empty())
+        {
+            return E_FAIL;
+        }
+        D3DX12_DRED_RECORD_HEADER Header = {};
+        Header.Magic = Magic;
+        Header.Version = Version;
+        Header.DeviceRemovedReason = DeviceRemovedReason;
+        Header.DeviceState = DeviceState;
+        m_Size = sizeof(Header);
+        m_bTruncated = false;
+
+        for (const D3D12_AUTO_BREADCRUMB_NODE1* pNode = Breadcrumbs.pHeadAutoBreadcrumbNode; pNode && !m_bTruncated; pNode = pNode->pNext)
+        {
+            if (WriteCommandList(*pNode))
+            {
+                ++Header.NumCommandLists;
+            }
+        }
+        // DRED fills the page fault output with zeroes when the removal was not caused by a fault
+        if (pPageFault && (pPageFault->PageFaultVA != 0 || pPageFault->pHeadExistingAllocationNode || pPageFault->pHeadRecentFreedAllocationNode))
+        {
+            Header.Flags |= D3DX12_DRED_RECORD_FLAG_PAGE_FAULT;
+            Header.PageFaultVA = pPageFault->PageFaultVA;
+            for (UINT bFreed = 0; bFreed < 2; ++bFreed)
+            {
+                const D3D12_DRED_ALLOCATION_NODE1* pNode = bFreed ? pPageFault->pHeadRecentFreedAllocationNode : pPageFault->pHeadExistingAllocationNode;
+                for (; pNode && !m_bTruncated; pNode = pNode->pNext)
+                {
+                    if (WriteAllocation(*pNode, bFreed))
+                    {
+                        ++Header.NumAllocations;
+                    }
+                }
+            }
+        }
+
+        if (m_bTruncated)
+        {
+            Header.Flags |= D3DX12_DRED_RECORD_FLAG_TRUNCATED;
+        }
+        Header.Size = static_cast<UINT32>(m_Size);
+        memcpy(m_Data.data(), &Header, sizeof(Header));
+        return S_OK;
+    }
+
+    const void* GetData() const noexcept { return m_Data.data(); }
+    SIZE_T GetSize() const noexcept { return m_Size; }
+
+private:
+    bool WriteCommandList(const D3D12_AUTO_BREADCRUMB_NODE1& Node) noexcept
+    {
+        const SIZE_T Start = m_Size;
+        D3DX12_DRED_RECORD_COMMAND_LIST Record = {};
+        Record.BreadcrumbCount = Node.BreadcrumbCount;
+        Record.LastCompletedOp = Node.pLastBreadcrumbValue ? *Node.pLastBreadcrumbValue : 0;
+
+        // Keep the window of operations around the last completed one, a quarter of it before
+        const UINT Last = Record.LastCompletedOp < Record.BreadcrumbCount ? Record.LastCompletedOp : Record.BreadcrumbCount;
+        Record.FirstOp = Last > m_MaxOps / 4 ? Last - m_MaxOps / 4 : 0;
+        Record.NumOps = Node.pCommandHistory ? (std::min)(Record.BreadcrumbCount - Record.FirstOp, m_MaxOps) : 0;
+        Record.CommandListNameLength = NameLength(Node.pCommandListDebugNameA, Node.pCommandListDebugNameW);
+        Record.CommandQueueNameLength = NameLength(Node.pCommandQueueDebugNameA, Node.pCommandQueueDebugNameW);
+
+        m_Size += sizeof(Record);
+        bool bFits = m_Size <= m_Data.size()
+            && WriteName(Node.pCommandListDebugNameA, Node.pCommandListDebugNameW, Record.CommandListNameLength)
+            && WriteName(Node.pCommandQueueDebugNameA, Node.pCommandQueueDebugNameW, Record.CommandQueueNameLength)
+            && Reserve(Record.NumOps);
+        if (bFits)
+        {
+            BYTE* pOps = m_Data.data() + m_Size - Record.NumOps;
+            for (UINT i = 0; i < Record.NumOps; ++i)
+            {
+                pOps[i] = static_cast<BYTE>(Node.pCommandHistory[Record.FirstOp + i]);
+            }
+            bFits = Align();
+        }
+        for (UINT i = 0; bFits && Node.pBreadcrumbContexts && i < Node.BreadcrumbContextsCount; ++i)
+        {
+            const D3D12_DRED_BREADCRUMB_CONTEXT& Context = Node.pBreadcrumbContexts[i];
+            if (Context.BreadcrumbIndex < Record.FirstOp || Context.BreadcrumbIndex - Record.FirstOp >= Record.NumOps)
+            {
+                continue;
+            }
+            const D3DX12_DRED_RECORD_STRING String = { Context.BreadcrumbIndex, NameLength(nullptr, Context.pContextString) };
+            bFits = Reserve(sizeof(String));
+            if (bFits)
+            {
+                memcpy(m_Data.data() + m_Size - sizeof(String), &String, sizeof(String));
+                bFits = WriteName(nullptr, Context.pContextString, String.Length) && Align();
+                ++Record.NumContexts;
+            }
+        }
+
+        if (!bFits)
+        {
+            m_Size = Start;
+            m_bTruncated = true;
+            return false;
+        }
+        memcpy(m_Data.data() + Start, &Record, sizeof(Record));
+        return true;
+    }
+
+    bool WriteAllocation(const D3D12_DRED_ALLOCATION_NODE1& Node, UINT bFreed) noexcept
+    {
+        const SIZE_T Start = m_Size;
+        const D3DX12_DRED_RECORD_ALLOCATION Record = { Node.AllocationType, bFreed, NameLength(Node.ObjectNameA, Node.ObjectNameW) };
+        if (!Reserve(sizeof(Record)) || !WriteName(Node.ObjectNameA, Node.ObjectNameW, Record.NameLength) || !Align())
+        {
+            m_Size = Start;
+            m_bTruncated = true;
+            return false;
+        }
+        memcpy(m_Data.data() + Start, &Record, sizeof(Record));
+        return true;
+    }
+
+    static UINT32 NameLength(const char* pNameA, const wchar_t* pNameW) noexcept
+    {
+        SIZE_T Length = 0;
+        if (pNameA)
+        {
+            Length = strlen(pNameA);
+        }
+        else if (pNameW)
+        {
+            while (pNameW[Length]) ++Length;
+        }
+        return static_cast<UINT32>(std::min<SIZE_T>(Length, UINT16_MAX));
+    }
+
+    // Wide names are narrowed to ASCII, anything else becomes '?'
+    bool WriteName(const char* pNameA, const wchar_t* pNameW, UINT32 Length) noexcept
+    {
+        if (!Reserve(Length))
+        {
+            return false;
+        }
+        char* pDst = reinterpret_cast<char*>(m_Data.data() + m_Size - Length);
+        for (UINT32 i = 0; i < Length; ++i)
+        {
+            pDst[i] = pNameA ? pNameA[i] : (pNameW[i] < 0x80 ? static_cast<char>(pNameW[i]) : '?');
+        }
+        return true;
+    }
+
+    bool Reserve(SIZE_T Size) noexcept
+    {
+        if (Size > m_Data.size() - m_Size)
+        {
+            return false;
+        }
+        m_Size += Size;
+        return true;
+    }
+
+    bool Align() noexcept
+    {
+        const SIZE_T Padding = D3DX12Align<SIZE_T>(m_Size, 4) - m_Size;
+        if (!Reserve(Padding))
+        {
+            return false;
+        }
+        memset(m_Data.data() + m_Size - Padding, 0, Padding);
+        return true;
+    }
+
+    std::vector<BYTE> m_Data;
+    SIZE_T m_Size = 0;
+    UINT m_MaxOps = 0;
+    bool m_bTruncated = false;
+};
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_DRED_COMMAND_LIST_INFO
+{
+    std::string CommandListName;
+    std::string CommandQueueName;
+    UINT BreadcrumbCount;
+    UINT LastCompletedOp;
+    UINT FirstOp;
+    std::vector<D3D12_AUTO_BREADCRUMB_OP> Ops; // Operations FirstOp and up
+    std::vector<std::pair<UINT, std::string>> Contexts; // Breadcrumb index, context string
+};
+
+struct D3DX12_DRED_ALLOCATION_INFO
+{
+    std::string Name;
+    D3D12_DRED_ALLOCATION_TYPE AllocationType;
+    bool bRecentlyFreed;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12DREDRecordReader
+{
+public:
+    // Parses a record written by CD3DX12DREDRecord; returns E_INVALIDARG if it is malformed
+    HRESULT Init(_In_reads_bytes_(Size) const void* pData, SIZE_T Size)
+    {
+        m_CommandLists.clear();
+        m_Allocations.clear();
+        m_pBytes = static_cast<const BYTE*>(pData);
+        m_Size = Size;
+        m_Offset = 0;
+        if (!Read(&m_Header) || m_Header.Magic != CD3DX12DREDRecord::Magic || m_Header.Version != CD3DX12DREDRecord::Version
+            || m_Header.Size != Size || Size % 4 != 0)
+        {
+            return E_INVALIDARG;
+        }
+
+        for (UINT i = 0; i < m_Header.NumCommandLists; ++i)
+        {
+            D3DX12_DRED_RECORD_COMMAND_LIST Record;
+            D3DX12_DRED_COMMAND_LIST_INFO Info = {};
+            if (!Read(&Record) || !ReadString(Record.CommandListNameLength, &Info.CommandListName)
+                || !ReadString(Record.CommandQueueNameLength, &Info.CommandQueueName) || Record.NumOps > m_Size - m_Offset)
+            {
+                return E_INVALIDARG;
+            }
+            Info.BreadcrumbCount = Record.BreadcrumbCount;
+            Info.LastCompletedOp = Record.LastCompletedOp;
+            Info.FirstOp = Record.FirstOp;
+            Info.Ops.resize(Record.NumOps);
+            for (UINT Op = 0; Op < Record.NumOps; ++Op)
+            {
+                Info.Ops[Op] = static_cast<D3D12_AUTO_BREADCRUMB_OP>(m_pBytes[m_Offset + Op]);
+            }
+            m_Offset += Record.NumOps;
+            if (!Align())
+            {
+                return E_INVALIDARG;
+            }
+            for (UINT c = 0; c < Record.NumContexts; ++c)
+            {
+                D3DX12_DRED_RECORD_STRING String;
+                std::string Text;
+                if (!Read(&String) || !ReadString(String.Length, &Text) || !Align())
+                {
+                    return E_INVALIDARG;
+                }
+                Info.Contexts.emplace_back(String.Index, std::move(Text));
+            }
+            m_CommandLists.push_back(std::move(Info));
+        }
+
+        for (UINT i = 0; i < m_Header.NumAllocations; ++i)
+        {
+            D3DX12_DRED_RECORD_ALLOCATION Record;
+            D3DX12_DRED_ALLOCATION_INFO Info = {};
+            if (!Read(&Record) || !ReadString(Record.NameLength, &Info.Name) || !Align())
+            {
+                return E_INVALIDARG;
+            }
+            Info.AllocationType = Record.AllocationType;
+            Info.bRecentlyFreed = Record.bRecentlyFreed != 0;
+            m_Allocations.push_back(std::move(Info));
+        }
+        return m_Offset == m_Size ? S_OK : E_INVALIDARG;
+    }
+
+    HRESULT GetDeviceRemovedReason() const noexcept { return m_Header.DeviceRemovedReason; }
+    D3D12_DRED_DEVICE_STATE GetDeviceState() const noexcept { return m_Header.DeviceState; }
+    bool IsTruncated() const noexcept { return (m_Header.Flags & D3DX12_DRED_RECORD_FLAG_TRUNCATED) != 0; }
+    bool HasPageFault() const noexcept { return (m_Header.Flags & D3DX12_DRED_RECORD_FLAG_PAGE_FAULT) != 0; }
+    D3D12_GPU_VIRTUAL_ADDRESS GetPageFaultVA() const noexcept { return m_Header.PageFaultVA; }
+    const std::vector<D3DX12_DRED_COMMAND_LIST_INFO>& GetCommandLists() const noexcept { return m_CommandLists; }
+    const std::vector<D3DX12_DRED_ALLOCATION_INFO>& GetAllocations() const noexcept { return m_Allocations; }
+
+private:
+    template <typename T>
+    bool Read(T* pValue) noexcept
+    {
+        if (sizeof(T) > m_Size - m_Offset)
+        {
+            return false;
+        }
+        memcpy(pValue, m_pBytes + m_Offset, sizeof(T));
+        m_Offset += sizeof(T);
+        return true;
+    }
+
+    bool ReadString(UINT32 Length, std::string* pString)
+    {
+        if (Length > m_Size - m_Offset)
+        {
+            return false;
+        }
+        pString->assign(reinterpret_cast<const char*>(m_pBytes + m_Offset), Length);
+        m_Offset += Length;
+        return true;
+    }
+
+    // Skips the padding after variable-length data; fails if the padding runs past the end
+    bool Align() noexcept
+    {
+        m_Offset = D3DX12Align<SIZE_T>(m_Offset, 4);
+        return m_Offset <= m_Size;
+    }
+
+    D3DX12_DRED_RECORD_HEADER m_Header = {};
+    std::vector<D3DX12_DRED_COMMAND_LIST_INFO> m_CommandLists;
+    std::vector<D3DX12_DRED_ALLOCATION_INFO> m_Allocations;
+    const BYTE* m_pBytes = nullptr;
+    SIZE_T m_Size = 0;
+    SIZE_T m_Offset = 0;
+};
+
+#endif // !D3DX12_NO_DRED_HELPERS
+
+#endif // defined( __cplusplus )
+
+#endif // __D3DX12_DEBUG_H__
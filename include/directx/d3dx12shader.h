@@ -0,0 +1,861 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License (MIT).
+//
+//*********************************************************
+
+#ifndef __D3DX12_SHADER_H__
+#define __D3DX12_SHADER_H__
+
+#include "d3dx12.h"
+#include "d3d12shader.h"
+
+#if defined( __cplusplus )
+
+#ifndef D3DX12_NO_SHADER_REFLECTION_CACHE_HELPERS
+
+//================================================================================================
+// D3DX12 Shader Reflection Cache Helpers
+//
+// CD3DX12ShaderReflectionBlob walks an ID3D12ShaderReflection once and flattens the parts needed to
+// drive binding into a single relocatable blob: resource bindings, constant buffer layouts (top level
+// variables only), input and output signatures, thread group size and required feature flags. The
+// blob contains no pointers; names are offsets into a string table at its end.
+// Uses STL
+//
+// CD3DX12ShaderReflectionView reads a blob in place, e.g. straight out of a memory mapped cache file,
+// after validating it once in Init().
+//
+// Layout: header, bindings, constant buffers, variables, input parameters, output parameters,
+// strings. Every array is stored at its natural alignment when the blob is 8 byte aligned.
+//
+//================================================================================================
+#include <cstring>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_SHADER_REFLECTION_HEADER
+{
+    UINT32 Magic;
+    UINT32 Version;
+    UINT32 Size;
+    UINT32 ShaderVersion;
+    UINT64 RequiresFlags;
+    UINT32 ThreadGroupSize[3];
+    UINT32 NumBindings;
+    UINT32 NumConstantBuffers;
+    UINT32 NumVariables;
+    UINT32 NumInputParameters;
+    UINT32 NumOutputParameters;
+    UINT32 StringsSize;
+    UINT32 Reserved;
+};
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_SHADER_REFLECTION_BINDING
+{
+    UINT32 NameOffset;
+    D3D_SHADER_INPUT_TYPE Type;
+    UINT32 BindPoint;
+    UINT32 BindCount;
+    UINT32 Space;
+    UINT32 Flags;
+    D3D_RESOURCE_RETURN_TYPE ReturnType;
+    D3D_SRV_DIMENSION Dimension;
+    UINT32 NumSamples;
+};
+
+//------------------------------------------------------------------------------------------------
+// Variables of a constant buffer are [FirstVariable, FirstVariable + NumVariables) in the variable
+// array. BindingIndex is the binding of the same name, or UINT32_MAX if the buffer is not bound.
+struct D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER
+{
+    UINT32 NameOffset;
+    D3D_CBUFFER_TYPE Type;
+    UINT32 Size;
+    UINT32 Flags;
+    UINT32 FirstVariable;
+    UINT32 NumVariables;
+    UINT32 BindingIndex;
+};
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_SHADER_REFLECTION_VARIABLE
+{
+    UINT32 NameOffset;
+    UINT32 StartOffset;
+    UINT32 Size;
+    UINT32 Flags;
+    D3D_SHADER_VARIABLE_CLASS Class;
+    D3D_SHADER_VARIABLE_TYPE Type;
+    UINT32 Rows;
+    UINT32 Columns;
+    UINT32 Elements;
+    UINT32 Members;
+};
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER
+{
+    UINT32 SemanticNameOffset;
+    UINT32 SemanticIndex;
+    UINT32 Register;
+    D3D_NAME SystemValueType;
+    D3D_REGISTER_COMPONENT_TYPE ComponentType;
+    BYTE Mask;
+    BYTE ReadWriteMask;
+    BYTE Reserved[2];
+    UINT32 Stream;
+    D3D_MIN_PRECISION MinPrecision;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12ShaderReflectionBlob
+{
+public:
+    static constexpr UINT32 Magic = 0x52535844; // 'DXSR'
+    static constexpr UINT32 Version = 1;
+
+    HRESULT Init(_In_ ID3D12ShaderReflection* pReflection)
+    {
+        m_Data.clear();
+        m_Bindings.clear();
+        m_ConstantBuffers.clear();
+        m_Variables.clear();
+        m_InputParameters.clear();
+        m_OutputParameters.clear();
+        m_Strings.clear();
+
+        D3D12_SHADER_DESC ShaderDesc;
+        HRESULT hr = pReflection->GetDesc(&ShaderDesc);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_Bindings.resize(ShaderDesc.BoundResources);
+        for (UINT i = 0; i < ShaderDesc.BoundResources; ++i)
+        {
+            D3D12_SHADER_INPUT_BIND_DESC Desc;
+            hr = pReflection->GetResourceBindingDesc(i, &Desc);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            m_Bindings[i] = { AddString(Desc.Name), Desc.Type, Desc.BindPoint, Desc.BindCount, Desc.Space, Desc.uFlags,
+                Desc.ReturnType, Desc.Dimension, Desc.NumSamples };
+        }
+
+        m_ConstantBuffers.resize(ShaderDesc.ConstantBuffers);
+        for (UINT i = 0; i < ShaderDesc.ConstantBuffers; ++i)
+        {
+            ID3D12ShaderReflectionConstantBuffer* pBuffer = pReflection->GetConstantBufferByIndex(i);
+            D3D12_SHADER_BUFFER_DESC Desc;
+            hr = pBuffer->GetDesc(&Desc);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            const UINT32 NameOffset = AddString(Desc.Name);
+            m_ConstantBuffers[i] = { NameOffset, Desc.Type, Desc.Size, Desc.uFlags,
+                static_cast<UINT32>(m_Variables.size()), Desc.Variables, FindBinding(NameOffset) };
+            for (UINT v = 0; v < Desc.Variables; ++v)
+            {
+                ID3D12ShaderReflectionVariable* pVariable = pBuffer->GetVariableByIndex(v);
+                D3D12_SHADER_VARIABLE_DESC VariableDesc;
+                D3D12_SHADER_TYPE_DESC TypeDesc;
+                hr = pVariable->GetDesc(&VariableDesc);
+                if (SUCCEEDED(hr))
+                {
+                    hr = pVariable->GetType()->GetDesc(&TypeDesc);
+                }
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+                m_Variables.push_back({ AddString(VariableDesc.Name), VariableDesc.StartOffset, VariableDesc.Size,
+                    VariableDesc.uFlags, TypeDesc.Class, TypeDesc.Type, TypeDesc.Rows, TypeDesc.Columns,
+                    TypeDesc.Elements, TypeDesc.Members });
+            }
+        }
+
+        hr = AddSignature(pReflection, ShaderDesc.InputParameters, &ID3D12ShaderReflection::GetInputParameterDesc, m_InputParameters);
+        if (SUCCEEDED(hr))
+        {
+            hr = AddSignature(pReflection, ShaderDesc.OutputParameters, &ID3D12ShaderReflection::GetOutputParameterDesc, m_OutputParameters);
+        }
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // Pad the string table so the next blob in a concatenated cache file stays 8 byte aligned
+        m_Strings.resize(D3DX12Align<SIZE_T>(m_Strings.size(), 8), '\0');
+
+        D3DX12_SHADER_REFLECTION_HEADER Header = {};
+        Header.Magic = Magic;
+        Header.Version = Version;
+        Header.ShaderVersion = ShaderDesc.Version;
+        Header.RequiresFlags = pReflection->GetRequiresFlags();
+        pReflection->GetThreadGroupSize(&Header.ThreadGroupSize[0], &Header.ThreadGroupSize[1], &Header.ThreadGroupSize[2]);
+        Header.NumBindings = static_cast<UINT32>(m_Bindings.size());
+        Header.NumConstantBuffers = static_cast<UINT32>(m_ConstantBuffers.size());
+        Header.NumVariables = static_cast<UINT32>(m_Variables.size());
+        Header.NumInputParameters = static_cast<UINT32>(m_InputParameters.size());
+        Header.NumOutputParameters = static_cast<UINT32>(m_OutputParameters.size());
+        Header.StringsSize = static_cast<UINT32>(m_Strings.size());
+        Header.Size = static_cast<UINT32>(sizeof(Header)
+            + m_Bindings.size() * sizeof(D3DX12_SHADER_REFLECTION_BINDING)
+            + m_ConstantBuffers.size() * sizeof(D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER)
+            + m_Variables.size() * sizeof(D3DX12_SHADER_REFLECTION_VARIABLE)
+            + (m_InputParameters.size() + m_OutputParameters.size()) * sizeof(D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER)
+            + m_Strings.size());
+
+        m_Data.resize(Header.Size);
+        BYTE* pBytes = m_Data.data();
+        pBytes = Write(pBytes, &Header, 1);
+        pBytes = Write(pBytes, m_Bindings.data(), m_Bindings.size());
+        pBytes = Write(pBytes, m_ConstantBuffers.data(), m_ConstantBuffers.size());
+        pBytes = Write(pBytes, m_Variables.data(), m_Variables.size());
+        pBytes = Write(pBytes, m_InputParameters.data(), m_InputParameters.size());
+        pBytes = Write(pBytes, m_OutputParameters.data(), m_OutputParameters.size());
+        Write(pBytes, m_Strings.data(), m_Strings.size());
+        return S_OK;
+    }
+
+    const void* GetData() const noexcept { return m_Data.data(); }
+    SIZE_T GetSize() const noexcept { return m_Data.size(); }
+
+private:
+    typedef HRESULT (STDMETHODCALLTYPE ID3D12ShaderReflection::*PFN_GET_PARAMETER_DESC)(UINT, D3D12_SIGNATURE_PARAMETER_DESC*);
+
+    HRESULT AddSignature(ID3D12ShaderReflection* pReflection, UINT NumParameters, PFN_GET_PARAMETER_DESC pfnGetDesc,
+        std::vector<D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER>& Parameters)
+    {
+        Parameters.resize(NumParameters);
+        for (UINT i = 0; i < NumParameters; ++i)
+        {
+            D3D12_SIGNATURE_PARAMETER_DESC Desc;
+            HRESULT hr = (pReflection->*pfnGetDesc)(i, &Desc);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            Parameters[i] = { AddString(Desc.SemanticName), Desc.SemanticIndex, Desc.Register, Desc.SystemValueType,
+                Desc.ComponentType, Desc.Mask, Desc.ReadWriteMask, { 0, 0 }, Desc.Stream, Desc.MinPrecision };
+        }
+        return S_OK;
+    }
+
+    // Semantic and binding names repeat, so identical strings share one entry
+    UINT32 AddString(LPCSTR pString)
+    {
+        if (pString == nullptr)
+        {
+            pString = "";
+        }
+        const SIZE_T Length = strlen(pString);
+        for (SIZE_T Offset = 0; Offset < m_Strings.size(); Offset += strlen(&m_Strings[Offset]) + 1)
+        {
+            if (strcmp(&m_Strings[Offset], pString) == 0)
+            {
+                return static_cast<UINT32>(Offset);
+            }
+        }
+        const UINT32 Offset = static_cast<UINT32>(m_Strings.size());
+        m_Strings.insert(m_Strings.end(), pString, pString + Length + 1);
+        return Offset;
+    }
+
+    UINT32 FindBinding(UINT32 NameOffset) const noexcept
+    {
+        for (SIZE_T i = 0; i < m_Bindings.size(); ++i)
+        {
+            if (m_Bindings[i].NameOffset == NameOffset && m_Bindings[i].Type == D3D_SIT_CBUFFER)
+            {
+                return static_cast<UINT32>(i);
+            }
+        }
+        return UINT32_MAX;
+    }
+
+    template <typename T>
+    static BYTE* Write(BYTE* pDst, const T* pSrc, SIZE_T Count) noexcept
+    {
+        if (Count)
+        {
+            memcpy(pDst, pSrc, Count * sizeof(T));
+        }
+        return pDst + Count * sizeof(T);
+    }
+
+    std::vector<BYTE> m_Data;
+    std::vector<D3DX12_SHADER_REFLECTION_BINDING> m_Bindings;
+    std::vector<D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER> m_ConstantBuffers;
+    std::vector<D3DX12_SHADER_REFLECTION_VARIABLE> m_Variables;
+    std::vector<D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER> m_InputParameters;
+    std::vector<D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER> m_OutputParameters;
+    std::vector<char> m_Strings;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12ShaderReflectionView
+{
+public:
+    CD3DX12ShaderReflectionView() = default;
+
+    // Validates a blob written by CD3DX12ShaderReflectionBlob. The blob must be 8 byte aligned and
+    // outlive the view. Returns E_INVALIDARG if it is malformed or was written by another version.
+    HRESULT Init(_In_reads_bytes_(Size) const void* pData, SIZE_T Size) noexcept
+    {
+        *this = CD3DX12ShaderReflectionView();
+        const D3DX12_SHADER_REFLECTION_HEADER* pHeader = static_cast<const D3DX12_SHADER_REFLECTION_HEADER*>(pData);
+        if (pData == nullptr || reinterpret_cast<UINT_PTR>(pData) % 8 != 0 || Size < sizeof(*pHeader)
+            || pHeader->Magic != CD3DX12ShaderReflectionBlob::Magic || pHeader->Version != CD3DX12ShaderReflectionBlob::Version
+            || pHeader->Size != Size)
+        {
+            return E_INVALIDARG;
+        }
+        const UINT64 Expected = sizeof(*pHeader)
+            + UINT64(pHeader->NumBindings) * sizeof(D3DX12_SHADER_REFLECTION_BINDING)
+            + UINT64(pHeader->NumConstantBuffers) * sizeof(D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER)
+            + UINT64(pHeader->NumVariables) * sizeof(D3DX12_SHADER_REFLECTION_VARIABLE)
+            + (UINT64(pHeader->NumInputParameters) + pHeader->NumOutputParameters) * sizeof(D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER)
+            + pHeader->StringsSize;
+        if (Expected != Size)
+        {
+            return E_INVALIDARG;
+        }
+
+        const BYTE* pBytes = static_cast<const BYTE*>(pData) + sizeof(*pHeader);
+        m_pHeader = pHeader;
+        pBytes = Read(pBytes, pHeader->NumBindings, &m_pBindings);
+        pBytes = Read(pBytes, pHeader->NumConstantBuffers, &m_pConstantBuffers);
+        pBytes = Read(pBytes, pHeader->NumVariables, &m_pVariables);
+        pBytes = Read(pBytes, pHeader->NumInputParameters, &m_pInputParameters);
+        pBytes = Read(pBytes, pHeader->NumOutputParameters, &m_pOutputParameters);
+        m_pStrings = reinterpret_cast<const char*>(pBytes);
+
+        // Every name must lie inside the string table, which must itself be terminated unless it is
+        // empty, as it is for a shader without names
+        bool bValid = pHeader->StringsSize == 0 || m_pStrings[pHeader->StringsSize - 1] == '\0';
+        for (UINT i = 0; bValid && i < pHeader->NumBindings; ++i)
+        {
+            bValid = m_pBindings[i].NameOffset < pHeader->StringsSize;
+        }
+        for (UINT i = 0; bValid && i < pHeader->NumConstantBuffers; ++i)
+        {
+            const D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER& Buffer = m_pConstantBuffers[i];
+            bValid = Buffer.NameOffset < pHeader->StringsSize
+                && UINT64(Buffer.FirstVariable) + Buffer.NumVariables <= pHeader->NumVariables
+                && (Buffer.BindingIndex == UINT32_MAX || Buffer.BindingIndex < pHeader->NumBindings);
+        }
+        for (UINT i = 0; bValid && i < pHeader->NumVariables; ++i)
+        {
+            bValid = m_pVariables[i].NameOffset < pHeader->StringsSize;
+        }
+        for (UINT i = 0; bValid && i < pHeader->NumInputParameters; ++i)
+        {
+            bValid = m_pInputParameters[i].SemanticNameOffset < pHeader->StringsSize;
+        }
+        for (UINT i = 0; bValid && i < pHeader->NumOutputParameters; ++i)
+        {
+            bValid = m_pOutputParameters[i].SemanticNameOffset < pHeader->StringsSize;
+        }
+        if (!bValid)
+        {
+            *this = CD3DX12ShaderReflectionView();
+            return E_INVALIDARG;
+        }
+        return S_OK;
+    }
+
+    UINT GetShaderVersion() const noexcept { return m_pHeader->ShaderVersion; }
+    UINT64 GetRequiresFlags() const noexcept { return m_pHeader->RequiresFlags; }
+    void GetThreadGroupSize(_Out_opt_ UINT* pSizeX, _Out_opt_ UINT* pSizeY, _Out_opt_ UINT* pSizeZ) const noexcept
+    {
+        if (pSizeX) *pSizeX = m_pHeader->ThreadGroupSize[0];
+        if (pSizeY) *pSizeY = m_pHeader->ThreadGroupSize[1];
+        if (pSizeZ) *pSizeZ = m_pHeader->ThreadGroupSize[2];
+    }
+
+    UINT GetNumBindings() const noexcept { return m_pHeader->NumBindings; }
+    const D3DX12_SHADER_REFLECTION_BINDING& GetBinding(UINT Index) const noexcept
+    {
+        D3DX12_ASSERT(Index < GetNumBindings());
+        return m_pBindings[Index];
+    }
+
+    UINT GetNumConstantBuffers() const noexcept { return m_pHeader->NumConstantBuffers; }
+    const D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER& GetConstantBuffer(UINT Index) const noexcept
+    {
+        D3DX12_ASSERT(Index < GetNumConstantBuffers());
+        return m_pConstantBuffers[Index];
+    }
+
+    // The VariableIndex-th variable of a constant buffer
+    const D3DX12_SHADER_REFLECTION_VARIABLE& GetVariable(const D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER& Buffer, UINT VariableIndex) const noexcept
+    {
+        D3DX12_ASSERT(VariableIndex < Buffer.NumVariables);
+        return m_pVariables[Buffer.FirstVariable + VariableIndex];
+    }
+
+    UINT GetNumInputParameters() const noexcept { return m_pHeader->NumInputParameters; }
+    const D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER& GetInputParameter(UINT Index) const noexcept
+    {
+        D3DX12_ASSERT(Index < GetNumInputParameters());
+        return m_pInputParameters[Index];
+    }
+
+    UINT GetNumOutputParameters() const noexcept { return m_pHeader->NumOutputParameters; }
+    const D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER& GetOutputParameter(UINT Index) const noexcept
+    {
+        D3DX12_ASSERT(Index < GetNumOutputParameters());
+        return m_pOutputParameters[Index];
+    }
+
+    LPCSTR GetString(UINT32 Offset) const noexcept
+    {
+        D3DX12_ASSERT(Offset < m_pHeader->StringsSize);
+        return m_pStrings + Offset;
+    }
+
+    // Returns the index of the named binding, or UINT_MAX
+    UINT FindBinding(_In_z_ LPCSTR pName) const noexcept
+    {
+        for (UINT i = 0; i < GetNumBindings(); ++i)
+        {
+            if (strcmp(GetString(m_pBindings[i].NameOffset), pName) == 0)
+            {
+                return i;
+            }
+        }
+        return UINT_MAX;
+    }
+
+    // Returns the index of the named constant buffer, or UINT_MAX
+    UINT FindConstantBuffer(_In_z_ LPCSTR pName) const noexcept
+    {
+        for (UINT i = 0; i < GetNumConstantBuffers(); ++i)
+        {
+            if (strcmp(GetString(m_pConstantBuffers[i].NameOffset), pName) == 0)
+            {
+                return i;
+            }
+        }
+        return UINT_MAX;
+    }
+
+private:
+    template <typename T>
+    static const BYTE* Read(const BYTE* pSrc, UINT Count, const T** ppArray) noexcept
+    {
+        *ppArray = reinterpret_cast<const T*>(pSrc);
+        return pSrc + SIZE_T(Count) * sizeof(T);
+    }
+
+    const D3DX12_SHADER_REFLECTION_HEADER* m_pHeader = nullptr;
+    const D3DX12_SHADER_REFLECTION_BINDING* m_pBindings = nullptr;
+    const D3DX12_SHADER_REFLECTION_CONSTANT_BUFFER* m_pConstantBuffers = nullptr;
+    const D3DX12_SHADER_REFLECTION_VARIABLE* m_pVariables = nullptr;
+    const D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER* m_pInputParameters = nullptr;
+    const D3DX12_SHADER_REFLECTION_SIGNATURE_PARAMETER* m_pOutputParameters = nullptr;
+    const char* m_pStrings = nullptr;
+};
+
+#endif // !D3DX12_NO_SHADER_REFLECTION_CACHE_HELPERS
+
+#ifndef D3DX12_NO_ROOT_SIGNATURE_GENERATION_HELPERS
+
+//================================================================================================
+// D3DX12 Root Signature Generation Helpers
+//
+// CD3DX12RootSignatureGenerator merges the resource bindings of the stages of a pipeline and
+// generates a version 1.1 root signature for them, together with a bind map telling where each
+// binding lives in it.
+// Uses STL
+//
+// Generation is deterministic in the merged binding set, so shader permutations that bind the same
+// registers produce the same root signature; GetLayoutHash() lets callers share one root signature
+// object between them.
+//
+// Layout:
+//   - Single CBVs become root CBVs while they fit in the 64 DWORD budget
+//   - Other CBVs, SRVs and UAVs go into one descriptor table per shader visibility, samplers into one
+//     sampler table per visibility, with contiguous registers merged into a single range
+//   - Unbounded arrays get a table of their own, with volatile descriptors
+//   - Bindings used by more than one stage are visible to all stages; stages without bindings are
+//     denied root access
+//
+//================================================================================================
+#include <algorithm>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+// A merged binding and its location in the generated root signature. Count is UINT_MAX for unbounded
+// arrays. TableOffset is the offset in descriptors from the start of the table, or UINT_MAX for a
+// root descriptor.
+struct D3DX12_ROOT_SIGNATURE_BINDING
+{
+    D3D12_DESCRIPTOR_RANGE_TYPE Type;
+    UINT Space;
+    UINT BaseRegister;
+    UINT Count;
+    D3D12_SHADER_VISIBILITY Visibility;
+    UINT RootParameterIndex;
+    UINT TableOffset;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12RootSignatureGenerator
+{
+public:
+    CD3DX12RootSignatureGenerator() = default;
+    CD3DX12RootSignatureGenerator(const CD3DX12RootSignatureGenerator&) = delete;
+    CD3DX12RootSignatureGenerator& operator=(const CD3DX12RootSignatureGenerator&) = delete;
+
+    void Reset() noexcept
+    {
+        m_Bindings.clear();
+        m_Ranges.clear();
+        m_Parameters.clear();
+        m_StageMask = 0;
+        m_Desc = CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC(CD3DX12_DEFAULT());
+    }
+
+    // Adds one binding of a stage. Compute and library shaders use D3D12_SHADER_VISIBILITY_ALL.
+    void AddBinding(const D3D12_SHADER_INPUT_BIND_DESC& Desc, D3D12_SHADER_VISIBILITY Visibility)
+    {
+        AddBinding(GetRangeType(Desc.Type), Desc.Space, Desc.BindPoint, Desc.BindCount == 0 ? UINT_MAX : Desc.BindCount, Visibility);
+    }
+
+#ifndef D3DX12_NO_SHADER_REFLECTION_CACHE_HELPERS
+    // Adds every binding of a stage from its cached reflection
+    void AddStage(const CD3DX12ShaderReflectionView& Reflection, D3D12_SHADER_VISIBILITY Visibility)
+    {
+        m_StageMask |= 1u << Visibility;
+        for (UINT i = 0; i < Reflection.GetNumBindings(); ++i)
+        {
+            const D3DX12_SHADER_REFLECTION_BINDING& Binding = Reflection.GetBinding(i);
+            AddBinding(GetRangeType(Binding.Type), Binding.Space, Binding.BindPoint,
+                Binding.BindCount == 0 ? UINT_MAX : Binding.BindCount, Visibility);
+        }
+    }
+#endif
+
+    // Marks a stage as present even if it has no bindings, so it is not denied root access
+    void AddStage(D3D12_SHADER_VISIBILITY Visibility) noexcept { m_StageMask |= 1u << Visibility; }
+
+    // Builds the root signature. With bStaticData, CBV and SRV data is declared static, i.e. not
+    // modified after the descriptors are recorded; UAV data is always volatile. Unbounded ranges
+    // have volatile descriptors, which version 1.1 only allows with data that is static while set
+    // at execute, so they never get static data.
+    HRESULT Generate(D3D12_ROOT_SIGNATURE_FLAGS Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE, bool bStaticData = false)
+    {
+        m_Ranges.clear();
+        m_Parameters.clear();
+        std::sort(m_Bindings.begin(), m_Bindings.end(), [](const D3DX12_ROOT_SIGNATURE_BINDING& a, const D3DX12_ROOT_SIGNATURE_BINDING& b)
+        {
+            if (a.Visibility != b.Visibility) return a.Visibility < b.Visibility;
+            if (IsSampler(a) != IsSampler(b)) return IsSampler(b);
+            if ((a.Count == UINT_MAX) != (b.Count == UINT_MAX)) return b.Count == UINT_MAX;
+            if (a.Type != b.Type) return a.Type < b.Type;
+            if (a.Space != b.Space) return a.Space < b.Space;
+            return a.BaseRegister < b.BaseRegister;
+        });
+
+        // Tables: one per (visibility, heap type) of bounded bindings, plus one per unbounded binding
+        UINT NumTables = 0;
+        UINT NumRootCBVCandidates = 0;
+        for (size_t i = 0; i < m_Bindings.size(); ++i)
+        {
+            const D3DX12_ROOT_SIGNATURE_BINDING& Binding = m_Bindings[i];
+            if (IsRootCBVCandidate(Binding))
+            {
+                ++NumRootCBVCandidates;
+            }
+            else if (Binding.Count == UINT_MAX || !IsSameTable(m_Bindings, i))
+            {
+                ++NumTables;
+            }
+        }
+        if (NumTables > D3D12_MAX_ROOT_COST)
+        {
+            return E_INVALIDARG;
+        }
+        // Root CBVs that do not fit fall back to tables, which may add one table per shader visibility
+        UINT RootCBVBudget = NumRootCBVCandidates;
+        if (NumTables + 2 * NumRootCBVCandidates > D3D12_MAX_ROOT_COST)
+        {
+            RootCBVBudget = NumTables + 8 < D3D12_MAX_ROOT_COST ? (D3D12_MAX_ROOT_COST - NumTables - 8) / 2 : 0;
+        }
+
+        // Root CBVs first, ahead of the tables
+        const D3D12_ROOT_DESCRIPTOR_FLAGS RootFlags = bStaticData ? D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC : D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE;
+        for (D3DX12_ROOT_SIGNATURE_BINDING& Binding : m_Bindings)
+        {
+            Binding.RootParameterIndex = UINT_MAX;
+            if (RootCBVBudget && IsRootCBVCandidate(Binding))
+            {
+                --RootCBVBudget;
+                Binding.RootParameterIndex = static_cast<UINT>(m_Parameters.size());
+                Binding.TableOffset = UINT_MAX;
+                CD3DX12_ROOT_PARAMETER1 Parameter;
+                Parameter.InitAsConstantBufferView(Binding.BaseRegister, Binding.Space, RootFlags, Binding.Visibility);
+                m_Parameters.push_back(Parameter);
+            }
+        }
+
+        // Ranges must not move once tables point at them
+        m_Ranges.reserve(m_Bindings.size());
+        UINT RootCost = static_cast<UINT>(m_Parameters.size()) * 2;
+        for (size_t i = 0; i < m_Bindings.size(); ++i)
+        {
+            D3DX12_ROOT_SIGNATURE_BINDING& Binding = m_Bindings[i];
+            if (Binding.RootParameterIndex != UINT_MAX)
+            {
+                continue;
+            }
+
+            // Start a new table, or a new range when the registers do not continue the previous one
+            D3DX12_ROOT_SIGNATURE_BINDING* pPrevious = FindPreviousTableBinding(i);
+            if (pPrevious == nullptr)
+            {
+                CD3DX12_ROOT_PARAMETER1 Parameter;
+                Parameter.InitAsDescriptorTable(0, m_Ranges.data() + m_Ranges.size(), Binding.Visibility);
+                m_Parameters.push_back(Parameter);
+                ++RootCost;
+            }
+            D3D12_ROOT_PARAMETER1& Table = m_Parameters.back();
+            Binding.RootParameterIndex = static_cast<UINT>(m_Parameters.size() - 1);
+            Binding.TableOffset = pPrevious ? pPrevious->TableOffset + pPrevious->Count : 0;
+
+            CD3DX12_DESCRIPTOR_RANGE1* pRange = Table.DescriptorTable.NumDescriptorRanges ? &m_Ranges.back() : nullptr;
+            if (pRange && pRange->RangeType == Binding.Type && pRange->RegisterSpace == Binding.Space
+                && pRange->BaseShaderRegister + pRange->NumDescriptors == Binding.BaseRegister)
+            {
+                pRange->NumDescriptors += Binding.Count;
+            }
+            else
+            {
+                m_Ranges.emplace_back(Binding.Type, Binding.Count, Binding.BaseRegister, Binding.Space,
+                    GetRangeFlags(Binding, bStaticData), Binding.TableOffset);
+                ++Table.DescriptorTable.NumDescriptorRanges;
+            }
+        }
+        if (RootCost > D3D12_MAX_ROOT_COST)
+        {
+            return E_INVALIDARG;
+        }
+
+        // Deny root access to the graphics stages that have no shader
+        if (m_StageMask & ~1u)
+        {
+            static const D3D12_ROOT_SIGNATURE_FLAGS DenyFlags[] =
+            {
+                D3D12_ROOT_SIGNATURE_FLAG_NONE,
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS,
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS,
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS,
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS,
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS,
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_AMPLIFICATION_SHADER_ROOT_ACCESS,
+                D3D12_ROOT_SIGNATURE_FLAG_DENY_MESH_SHADER_ROOT_ACCESS,
+            };
+            for (UINT Stage = 1; Stage < _countof(DenyFlags); ++Stage)
+            {
+                if (!(m_StageMask & (1u << Stage)))
+                {
+                    Flags |= DenyFlags[Stage];
+                }
+            }
+        }
+
+        m_Desc.Init_1_1(static_cast<UINT>(m_Parameters.size()), m_Parameters.data(), 0, nullptr, Flags);
+        return S_OK;
+    }
+
+    const CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC& GetDesc() const noexcept { return m_Desc; }
+
+    // Bind map, sorted by visibility, then samplers after the other types, unbounded after bounded
+    // bindings, type, space and register. RootParameterIndex and TableOffset locate each binding.
+    UINT GetNumBindings() const noexcept { return static_cast<UINT>(m_Bindings.size()); }
+    const D3DX12_ROOT_SIGNATURE_BINDING& GetBinding(UINT Index) const noexcept { return m_Bindings[Index]; }
+
+    // Returns the binding containing a register, or nullptr
+    const D3DX12_ROOT_SIGNATURE_BINDING* FindBinding(D3D12_DESCRIPTOR_RANGE_TYPE Type, UINT Space, UINT Register) const noexcept
+    {
+        for (const D3DX12_ROOT_SIGNATURE_BINDING& Binding : m_Bindings)
+        {
+            if (Binding.Type == Type && Binding.Space == Space && Register >= Binding.BaseRegister
+                && Register - Binding.BaseRegister < Binding.Count)
+            {
+                return &Binding;
+            }
+        }
+        return nullptr;
+    }
+
+    // Hash of the generated root signature; equal layouts hash equally
+    UINT64 GetLayoutHash() const noexcept
+    {
+        UINT64 Hash = 14695981039346656037ull;
+        auto Add = [&Hash](UINT Value)
+        {
+            Hash = (Hash ^ Value) * 1099511628211ull;
+        };
+        Add(m_Desc.Desc_1_1.Flags);
+        for (const D3D12_ROOT_PARAMETER1& Parameter : m_Parameters)
+        {
+            Add(Parameter.ParameterType);
+            Add(Parameter.ShaderVisibility);
+            if (Parameter.ParameterType == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
+            {
+                for (UINT i = 0; i < Parameter.DescriptorTable.NumDescriptorRanges; ++i)
+                {
+                    const D3D12_DESCRIPTOR_RANGE1& Range = Parameter.DescriptorTable.pDescriptorRanges[i];
+                    Add(Range.RangeType);
+                    Add(Range.NumDescriptors);
+                    Add(Range.BaseShaderRegister);
+                    Add(Range.RegisterSpace);
+                    Add(Range.Flags);
+                    Add(Range.OffsetInDescriptorsFromTableStart);
+                }
+            }
+            else
+            {
+                Add(Parameter.Descriptor.ShaderRegister);
+                Add(Parameter.Descriptor.RegisterSpace);
+                Add(Parameter.Descriptor.Flags);
+            }
+        }
+        return Hash;
+    }
+
+    static D3D12_DESCRIPTOR_RANGE_TYPE GetRangeType(D3D_SHADER_INPUT_TYPE Type) noexcept
+    {
+        switch (Type)
+        {
+        case D3D_SIT_CBUFFER:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+        case D3D_SIT_SAMPLER:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
+        case D3D_SIT_UAV_RWTYPED:
+        case D3D_SIT_UAV_RWSTRUCTURED:
+        case D3D_SIT_UAV_RWBYTEADDRESS:
+        case D3D_SIT_UAV_APPEND_STRUCTURED:
+        case D3D_SIT_UAV_CONSUME_STRUCTURED:
+        case D3D_SIT_UAV_RWSTRUCTURED_WITH_COUNTER:
+        case D3D_SIT_UAV_FEEDBACKTEXTURE:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+        default:
+            return D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        }
+    }
+
+private:
+    void AddBinding(D3D12_DESCRIPTOR_RANGE_TYPE Type, UINT Space, UINT BaseRegister, UINT Count, D3D12_SHADER_VISIBILITY Visibility)
+    {
+        m_StageMask |= 1u << Visibility;
+        D3DX12_ROOT_SIGNATURE_BINDING New = { Type, Space, BaseRegister, Count, Visibility, UINT_MAX, UINT_MAX };
+
+        // Overlapping registers of the same type are merged into one binding covering both
+        for (size_t i = 0; i < m_Bindings.size();)
+        {
+            const D3DX12_ROOT_SIGNATURE_BINDING& Existing = m_Bindings[i];
+            if (Existing.Type == Type && Existing.Space == Space
+                && UINT64(Existing.BaseRegister) + Existing.Count > New.BaseRegister
+                && UINT64(New.BaseRegister) + New.Count > Existing.BaseRegister)
+            {
+                const UINT64 End = (std::max)(UINT64(Existing.BaseRegister) + Existing.Count, UINT64(New.BaseRegister) + New.Count);
+                New.BaseRegister = (std::min)(Existing.BaseRegister, New.BaseRegister);
+                New.Count = (Existing.Count == UINT_MAX || New.Count == UINT_MAX) ? UINT_MAX : static_cast<UINT>(End - New.BaseRegister);
+                if (Existing.Visibility != New.Visibility)
+                {
+                    New.Visibility = D3D12_SHADER_VISIBILITY_ALL;
+                }
+                m_Bindings.erase(m_Bindings.begin() + static_cast<ptrdiff_t>(i));
+                i = 0;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        m_Bindings.push_back(New);
+    }
+
+    static bool IsSampler(const D3DX12_ROOT_SIGNATURE_BINDING& Binding) noexcept
+    {
+        return Binding.Type == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
+    }
+
+    static bool IsRootCBVCandidate(const D3DX12_ROOT_SIGNATURE_BINDING& Binding) noexcept
+    {
+        return Binding.Type == D3D12_DESCRIPTOR_RANGE_TYPE_CBV && Binding.Count == 1;
+    }
+
+    // Whether the i-th binding shares a bounded table with the binding before it
+    static bool IsSameTable(const std::vector<D3DX12_ROOT_SIGNATURE_BINDING>& Bindings, size_t i) noexcept
+    {
+        for (size_t j = i; j-- > 0;)
+        {
+            if (IsRootCBVCandidate(Bindings[j]))
+            {
+                continue;
+            }
+            return Bindings[j].Count != UINT_MAX && Bindings[i].Count != UINT_MAX
+                && Bindings[j].Visibility == Bindings[i].Visibility && IsSampler(Bindings[j]) == IsSampler(Bindings[i]);
+        }
+        return false;
+    }
+
+    // The previous binding in the same table as the i-th, or nullptr if the i-th starts a table
+    D3DX12_ROOT_SIGNATURE_BINDING* FindPreviousTableBinding(size_t i) noexcept
+    {
+        for (size_t j = i; j-- > 0;)
+        {
+            if (m_Bindings[j].TableOffset == UINT_MAX)
+            {
+                continue;
+            }
+            const bool bSameTable = m_Bindings[j].Count != UINT_MAX && m_Bindings[i].Count != UINT_MAX
+                && m_Bindings[j].Visibility == m_Bindings[i].Visibility && IsSampler(m_Bindings[j]) == IsSampler(m_Bindings[i]);
+            return bSameTable ? &m_Bindings[j] : nullptr;
+        }
+        return nullptr;
+    }
+
+    static D3D12_DESCRIPTOR_RANGE_FLAGS GetRangeFlags(const D3DX12_ROOT_SIGNATURE_BINDING& Binding, bool bStaticData) noexcept
+    {
+        D3D12_DESCRIPTOR_RANGE_FLAGS Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+        if (Binding.Count == UINT_MAX)
+        {
+            // DESCRIPTORS_VOLATILE cannot be combined with DATA_STATIC
+            Flags |= D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE;
+            bStaticData = false;
+        }
+        switch (Binding.Type)
+        {
+        case D3D12_DESCRIPTOR_RANGE_TYPE_UAV:
+            return Flags | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+        case D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER:
+            return Flags;
+        default:
+            return Flags | (bStaticData ? D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC : D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
+        }
+    }
+
+    std::vector<D3DX12_ROOT_SIGNATURE_BINDING> m_Bindings;
+    std::vector<CD3DX12_DESCRIPTOR_RANGE1> m_Ranges;
+    std::vector<CD3DX12_ROOT_PARAMETER1> m_Parameters;
+    UINT m_StageMask = 0;
+    CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC m_Desc = CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC(CD3DX12_DEFAULT());
+};
+
+#endif // !D3DX12_NO_ROOT_SIGNATURE_GENERATION_HELPERS
+
+#endif // defined( __cplusplus )
+
+#endif // __D3DX12_SHADER_H__
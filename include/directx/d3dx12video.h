@@ -0,0 +1,1552 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License (MIT).
+//
+//*********************************************************
+
+#ifndef __D3DX12_VIDEO_H__
+#define __D3DX12_VIDEO_H__
+
+#include "d3dx12.h"
+#include "d3d12video.h"
+
+#if defined( __cplusplus )
+
+#ifndef D3DX12_NO_VIDEO_ENCODER_OUTPUT_HELPERS
+
+//================================================================================================
+// D3DX12 Video Encoder Output Helpers
+//
+// Pipelines the EncodeFrame / ResolveEncoderOutputMetadata / readback sequence over a ring of N
+// frames. The resolve of frame N-1 is recorded on the same command list as, and after, the encode of
+// frame N, so the CPU never waits for an encode before submitting the next one.
+// Uses STL
+//
+// Per frame:
+//   BeginFrame()   - returns the output arguments for EncodeFrame and, except for the first frame,
+//                    the resolve arguments for the previous frame; record both, then signal the
+//                    fence value passed in.
+//   Flush()        - at the end of the stream, returns the resolve of the last frame.
+//   GetCompletedFrame() / ReleaseFrame() - once the fence has completed, exposes the resolved metadata
+//                    and subregion layout directly from the mapped metadata, and returns the slot.
+//
+//================================================================================================
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+// Resources backing one frame slot of CD3DX12VideoEncoderOutputRing
+struct D3DX12_VIDEO_ENCODER_FRAME_RESOURCES
+{
+    D3D12_VIDEO_ENCODER_COMPRESSED_BITSTREAM Bitstream;
+    // Opaque metadata written by EncodeFrame, sized by
+    // D3D12_FEATURE_DATA_VIDEO_ENCODER_RESOURCE_REQUIREMENTS::MaxEncoderOutputMetadataBufferSize
+    D3D12_VIDEO_ENCODER_ENCODE_OPERATION_METADATA_BUFFER EncoderOutputMetadata;
+    // Destination of ResolveEncoderOutputMetadata, at least
+    // CD3DX12VideoEncoderOutputRing::GetResolvedMetadataSize(MaxSubregions) bytes
+    D3D12_VIDEO_ENCODER_ENCODE_OPERATION_METADATA_BUFFER ResolvedMetadata;
+    // CPU address at which the resolved metadata is readable once the resolve has completed. This is
+    // either a persistent mapping of ResolvedMetadata (e.g. a custom heap with
+    // D3D12_CPU_PAGE_PROPERTY_WRITE_BACK) or of a readback buffer the caller copies it to.
+    const void* pMappedResolvedMetadata;
+};
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_VIDEO_ENCODER_RESOLVE_ARGUMENTS
+{
+    D3D12_VIDEO_ENCODER_RESOLVE_METADATA_INPUT_ARGUMENTS Input;
+    D3D12_VIDEO_ENCODER_RESOLVE_METADATA_OUTPUT_ARGUMENTS Output;
+};
+
+//------------------------------------------------------------------------------------------------
+// One encoded subregion (slice or tile group), located in the bitstream buffer
+struct D3DX12_VIDEO_ENCODER_SUBREGION
+{
+    UINT64 Offset;      // Absolute offset of the subregion payload in the bitstream buffer
+    UINT64 Size;        // Payload size in bytes, excluding the leading padding
+    UINT64 HeaderSize;  // Size of the codec header at the start of the payload
+};
+
+//------------------------------------------------------------------------------------------------
+// Validates resolved metadata and returns pointers into it. The resolved layout is a
+// D3D12_VIDEO_ENCODER_OUTPUT_METADATA followed by WrittenSubregionsCount
+// D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA.
+inline HRESULT D3DX12ParseVideoEncoderOutputMetadata(
+    _In_reads_bytes_(Size) const void* pResolvedMetadata,
+    SIZE_T Size,
+    _Out_ const D3D12_VIDEO_ENCODER_OUTPUT_METADATA** ppMetadata,
+    _Out_ const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA** ppSubregions) noexcept
+{
+    *ppMetadata = nullptr;
+    *ppSubregions = nullptr;
+    if (Size < sizeof(D3D12_VIDEO_ENCODER_OUTPUT_METADATA))
+    {
+        return E_INVALIDARG;
+    }
+    auto pMetadata = static_cast<const D3D12_VIDEO_ENCODER_OUTPUT_METADATA*>(pResolvedMetadata);
+    const SIZE_T MaxSubregions = (Size - sizeof(D3D12_VIDEO_ENCODER_OUTPUT_METADATA)) / sizeof(D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA);
+    if (pMetadata->WrittenSubregionsCount > MaxSubregions)
+    {
+        return E_INVALIDARG;
+    }
+    *ppMetadata = pMetadata;
+    *ppSubregions = reinterpret_cast<const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA*>(pMetadata + 1);
+    return S_OK;
+}
+
+//------------------------------------------------------------------------------------------------
+// Computes the bitstream location of subregion metadata entries. Subregions are stored back to back
+// from FrameStartOffset; each bSize includes bStartOffset bytes of padding before the payload.
+// Returns false if an entry is inconsistent.
+inline bool D3DX12GetVideoEncoderSubregions(
+    _In_reads_(NumSubregions) const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA* pSubregionMetadata,
+    UINT NumSubregions,
+    UINT64 FrameStartOffset,
+    _Out_writes_(NumSubregions) D3DX12_VIDEO_ENCODER_SUBREGION* pSubregions) noexcept
+{
+    UINT64 Offset = FrameStartOffset;
+    for (UINT i = 0; i < NumSubregions; ++i)
+    {
+        const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA& Metadata = pSubregionMetadata[i];
+        if (Metadata.bStartOffset > Metadata.bSize || Metadata.bHeaderSize > Metadata.bSize - Metadata.bStartOffset)
+        {
+            return false;
+        }
+        pSubregions[i].Offset = Offset + Metadata.bStartOffset;
+        pSubregions[i].Size = Metadata.bSize - Metadata.bStartOffset;
+        pSubregions[i].HeaderSize = Metadata.bHeaderSize;
+        Offset += Metadata.bSize;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------
+// A frame whose metadata has been resolved and is ready to be read. Pointers reference the mapped
+// resolved metadata and remain valid until ReleaseFrame().
+struct D3DX12_VIDEO_ENCODER_COMPLETED_FRAME
+{
+    UINT64 FrameIndex;
+    D3D12_VIDEO_ENCODER_COMPRESSED_BITSTREAM Bitstream;
+    const D3D12_VIDEO_ENCODER_OUTPUT_METADATA* pMetadata;
+    const D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA* pSubregions;
+    UINT NumSubregions;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12VideoEncoderOutputRing
+{
+public:
+    CD3DX12VideoEncoderOutputRing() = default;
+
+    static constexpr SIZE_T GetResolvedMetadataSize(UINT MaxSubregions) noexcept
+    {
+        return sizeof(D3D12_VIDEO_ENCODER_OUTPUT_METADATA) + SIZE_T(MaxSubregions) * sizeof(D3D12_VIDEO_ENCODER_FRAME_SUBREGION_METADATA);
+    }
+
+    // ResolveInputArguments supplies the codec, profile, input format and resolution; its
+    // HWLayoutMetadata is filled in per frame. At least two frames are needed to overlap the resolve
+    // of one frame with the encode of the next.
+    HRESULT Init(
+        UINT NumFrames,
+        _In_reads_(NumFrames) const D3DX12_VIDEO_ENCODER_FRAME_RESOURCES* pFrames,
+        UINT MaxSubregions,
+        const D3D12_VIDEO_ENCODER_RESOLVE_METADATA_INPUT_ARGUMENTS& ResolveInputArguments)
+    {
+        m_Frames.clear();
+        if (NumFrames < 2 || MaxSubregions == 0)
+        {
+            return E_INVALIDARG;
+        }
+        m_Frames.resize(NumFrames);
+        for (UINT i = 0; i < NumFrames; ++i)
+        {
+            m_Frames[i].Resources = pFrames[i];
+        }
+        m_MaxSubregions = MaxSubregions;
+        m_ResolveInputArguments = ResolveInputArguments;
+        m_NumBegun = m_NumResolved = m_NumReleased = 0;
+        return S_OK;
+    }
+
+    // Applies to frames begun after the call, e.g. on a resolution change
+    void SetResolveInputArguments(const D3D12_VIDEO_ENCODER_RESOLVE_METADATA_INPUT_ARGUMENTS& ResolveInputArguments) noexcept
+    { m_ResolveInputArguments = ResolveInputArguments; }
+
+    UINT GetNumFrames() const noexcept { return static_cast<UINT>(m_Frames.size()); }
+    UINT GetNumFramesInFlight() const noexcept { return static_cast<UINT>(m_NumBegun - m_NumReleased); }
+
+    // Starts a frame whose EncodeFrame is recorded on a command list that will signal
+    // SubmissionFenceValue. Fills the Bitstream and EncoderOutputMetadata of pOutputArguments (the
+    // ReconstructedPicture is left to the caller). If pResolveArguments is set on return, the resolve
+    // of the previous frame must be recorded after the EncodeFrame. Returns false, without consuming
+    // anything, if every slot is still in flight; complete and release the oldest frame first.
+    bool BeginFrame(
+        UINT64 SubmissionFenceValue,
+        _Inout_ D3D12_VIDEO_ENCODER_ENCODEFRAME_OUTPUT_ARGUMENTS* pOutputArguments,
+        _Out_ D3DX12_VIDEO_ENCODER_RESOLVE_ARGUMENTS* pResolveArguments,
+        _Out_ bool* pHasResolve) noexcept
+    {
+        *pHasResolve = false;
+        if (m_Frames.empty() || m_NumBegun - m_NumReleased == m_Frames.size())
+        {
+            return false;
+        }
+        *pHasResolve = ScheduleResolve(SubmissionFenceValue, pResolveArguments);
+
+        Frame& Slot = m_Frames[m_NumBegun % m_Frames.size()];
+        Slot.ResolveInputArguments = m_ResolveInputArguments;
+        Slot.ResolveInputArguments.HWLayoutMetadata = Slot.Resources.EncoderOutputMetadata;
+        pOutputArguments->Bitstream = Slot.Resources.Bitstream;
+        pOutputArguments->EncoderOutputMetadata = Slot.Resources.EncoderOutputMetadata;
+        ++m_NumBegun;
+        return true;
+    }
+
+    // Returns the resolve of the last begun frame, if it has not been scheduled yet; record it on a
+    // command list that signals SubmissionFenceValue.
+    bool Flush(UINT64 SubmissionFenceValue, _Out_ D3DX12_VIDEO_ENCODER_RESOLVE_ARGUMENTS* pResolveArguments) noexcept
+    {
+        return ScheduleResolve(SubmissionFenceValue, pResolveArguments);
+    }
+
+    // Returns S_OK and the oldest unreleased frame if its resolve has completed, S_FALSE if it has not,
+    // and E_FAIL if its resolved metadata is malformed (the frame must still be released).
+    HRESULT GetCompletedFrame(UINT64 CompletedFenceValue, _Out_ D3DX12_VIDEO_ENCODER_COMPLETED_FRAME* pFrame) const noexcept
+    {
+        *pFrame = {};
+        if (m_NumReleased == m_NumResolved)
+        {
+            return S_FALSE;
+        }
+        const Frame& Slot = m_Frames[m_NumReleased % m_Frames.size()];
+        if (Slot.ResolveFenceValue > CompletedFenceValue)
+        {
+            return S_FALSE;
+        }
+
+        pFrame->FrameIndex = m_NumReleased;
+        pFrame->Bitstream = Slot.Resources.Bitstream;
+        if (FAILED(D3DX12ParseVideoEncoderOutputMetadata(Slot.Resources.pMappedResolvedMetadata,
+                GetResolvedMetadataSize(m_MaxSubregions), &pFrame->pMetadata, &pFrame->pSubregions)))
+        {
+            return E_FAIL;
+        }
+        pFrame->NumSubregions = static_cast<UINT>(pFrame->pMetadata->WrittenSubregionsCount);
+        return S_OK;
+    }
+
+    // Returns the slot of the frame last returned by GetCompletedFrame to the ring
+    void ReleaseFrame() noexcept
+    {
+        D3DX12_ASSERT(m_NumReleased < m_NumResolved);
+        ++m_NumReleased;
+    }
+
+private:
+    struct Frame
+    {
+        D3DX12_VIDEO_ENCODER_FRAME_RESOURCES Resources;
+        D3D12_VIDEO_ENCODER_RESOLVE_METADATA_INPUT_ARGUMENTS ResolveInputArguments;
+        UINT64 ResolveFenceValue;
+    };
+
+    bool ScheduleResolve(UINT64 SubmissionFenceValue, D3DX12_VIDEO_ENCODER_RESOLVE_ARGUMENTS* pResolveArguments) noexcept
+    {
+        if (m_NumResolved == m_NumBegun)
+        {
+            return false;
+        }
+        Frame& Slot = m_Frames[m_NumResolved % m_Frames.size()];
+        Slot.ResolveFenceValue = SubmissionFenceValue;
+        pResolveArguments->Input = Slot.ResolveInputArguments;
+        pResolveArguments->Output.ResolvedLayoutMetadata = Slot.Resources.ResolvedMetadata;
+        ++m_NumResolved;
+        return true;
+    }
+
+    std::vector<Frame> m_Frames;
+    D3D12_VIDEO_ENCODER_RESOLVE_METADATA_INPUT_ARGUMENTS m_ResolveInputArguments = {};
+    UINT m_MaxSubregions = 0;
+    UINT64 m_NumBegun = 0;
+    UINT64 m_NumResolved = 0;
+    UINT64 m_NumReleased = 0;
+};
+
+#endif // !D3DX12_NO_VIDEO_ENCODER_OUTPUT_HELPERS
+
+#ifndef D3DX12_NO_VIDEO_FEATURE_SUPPORT_CLASS
+
+//================================================================================================
+// CD3DX12VideoFeatureSupport
+//
+// Video counterpart of CD3DX12FeatureSupport: enumerates the decode and encode capability matrix of
+// a video device once and answers support queries with a hashed lookup. The result can be
+// serialized to a blob tagged with the adapter LUID, so processes that start often can skip the
+// enumeration when a cached blob for the same adapter exists.
+// Uses STL
+//
+// Decode support is recorded per (profile, output format) as the largest of a ladder of standard
+// resolutions for which D3D12_FEATURE_VIDEO_DECODE_SUPPORT succeeds. Encode support is recorded
+// per (codec, profile, input format) with the supported level and resolution ranges. Configurations
+// that need a full D3D12_FEATURE_DATA_VIDEO_ENCODER_SUPPORT query (rate control, GOP structure,
+// subregion layout) are not cached.
+//
+//================================================================================================
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_VIDEO_DECODE_CAPS
+{
+    GUID Profile;
+    DXGI_FORMAT Format;
+    UINT MaxWidth;
+    UINT MaxHeight;
+    D3D12_VIDEO_DECODE_CONFIGURATION_FLAGS ConfigurationFlags;
+    D3D12_VIDEO_DECODE_TIER DecodeTier;
+};
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_VIDEO_ENCODE_CAPS
+{
+    D3D12_VIDEO_ENCODER_CODEC Codec;
+    UINT Profile;       // D3D12_VIDEO_ENCODER_PROFILE_H264 or D3D12_VIDEO_ENCODER_PROFILE_HEVC
+    DXGI_FORMAT Format;
+    UINT MinLevel;      // D3D12_VIDEO_ENCODER_LEVELS_H264 or D3D12_VIDEO_ENCODER_LEVELS_HEVC
+    UINT MaxLevel;
+    UINT MaxTier;       // D3D12_VIDEO_ENCODER_TIER_HEVC, 0 for H264
+    D3D12_VIDEO_ENCODER_PICTURE_RESOLUTION_DESC MinResolution;
+    D3D12_VIDEO_ENCODER_PICTURE_RESOLUTION_DESC MaxResolution;
+    UINT ResolutionWidthMultiple;
+    UINT ResolutionHeightMultiple;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12VideoFeatureSupport
+{
+public:
+    static constexpr UINT32 SerializedVersion = 1;
+
+    CD3DX12VideoFeatureSupport() = default;
+
+    // Queries the capability matrix of the given node
+    HRESULT Init(ID3D12VideoDevice* pVideoDevice, const LUID& AdapterLuid, UINT NodeIndex = 0)
+    {
+        Clear();
+        HRESULT hr = QueryDecodeCaps(pVideoDevice, NodeIndex);
+        if (SUCCEEDED(hr))
+        {
+            hr = QueryEncodeCaps(pVideoDevice, NodeIndex);
+        }
+        if (FAILED(hr))
+        {
+            Clear();
+            return hr;
+        }
+        m_AdapterLuid = AdapterLuid;
+        m_NodeIndex = NodeIndex;
+        BuildIndex();
+        return S_OK;
+    }
+
+    const LUID& GetAdapterLuid() const noexcept { return m_AdapterLuid; }
+    UINT GetNodeIndex() const noexcept { return m_NodeIndex; }
+
+    UINT GetNumDecodeCaps() const noexcept { return static_cast<UINT>(m_DecodeCaps.size()); }
+    const D3DX12_VIDEO_DECODE_CAPS& GetDecodeCaps(UINT Index) const noexcept { return m_DecodeCaps[Index]; }
+    UINT GetNumEncodeCaps() const noexcept { return static_cast<UINT>(m_EncodeCaps.size()); }
+    const D3DX12_VIDEO_ENCODE_CAPS& GetEncodeCaps(UINT Index) const noexcept { return m_EncodeCaps[Index]; }
+
+    // Returns nullptr if the profile cannot decode to Format
+    const D3DX12_VIDEO_DECODE_CAPS* FindDecodeCaps(REFGUID Profile, DXGI_FORMAT Format) const noexcept
+    {
+        const UINT Index = Find(m_DecodeIndex, DecodeKey(Profile, Format),
+            [&](const D3DX12_VIDEO_DECODE_CAPS& Caps) { return Caps.Profile == Profile && Caps.Format == Format; }, m_DecodeCaps);
+        return Index == UINT_MAX ? nullptr : &m_DecodeCaps[Index];
+    }
+
+    // Returns nullptr if the codec cannot encode the profile from Format
+    const D3DX12_VIDEO_ENCODE_CAPS* FindEncodeCaps(D3D12_VIDEO_ENCODER_CODEC Codec, UINT Profile, DXGI_FORMAT Format) const noexcept
+    {
+        const UINT Index = Find(m_EncodeIndex, EncodeKey(Codec, Profile, Format),
+            [&](const D3DX12_VIDEO_ENCODE_CAPS& Caps) { return Caps.Codec == Codec && Caps.Profile == Profile && Caps.Format == Format; }, m_EncodeCaps);
+        return Index == UINT_MAX ? nullptr : &m_EncodeCaps[Index];
+    }
+
+    bool DecodeSupported(REFGUID Profile, DXGI_FORMAT Format, UINT Width, UINT Height) const noexcept
+    {
+        const D3DX12_VIDEO_DECODE_CAPS* pCaps = FindDecodeCaps(Profile, Format);
+        return pCaps && Width <= pCaps->MaxWidth && Height <= pCaps->MaxHeight;
+    }
+
+    bool EncodeSupported(D3D12_VIDEO_ENCODER_CODEC Codec, UINT Profile, DXGI_FORMAT Format, UINT Width, UINT Height) const noexcept
+    {
+        const D3DX12_VIDEO_ENCODE_CAPS* pCaps = FindEncodeCaps(Codec, Profile, Format);
+        return pCaps
+            && Width >= pCaps->MinResolution.Width && Width <= pCaps->MaxResolution.Width
+            && Height >= pCaps->MinResolution.Height && Height <= pCaps->MaxResolution.Height
+            && (pCaps->ResolutionWidthMultiple == 0 || Width % pCaps->ResolutionWidthMultiple == 0)
+            && (pCaps->ResolutionHeightMultiple == 0 || Height % pCaps->ResolutionHeightMultiple == 0);
+    }
+
+    // Writes the cache to pData. Call with pData == nullptr to retrieve the required size.
+    HRESULT Serialize(_Out_writes_bytes_opt_(*pSize) void* pData, _Inout_ SIZE_T* pSize) const noexcept
+    {
+        const SIZE_T Required = sizeof(SerializedHeader)
+            + m_DecodeCaps.size() * sizeof(D3DX12_VIDEO_DECODE_CAPS)
+            + m_EncodeCaps.size() * sizeof(D3DX12_VIDEO_ENCODE_CAPS);
+        if (pData == nullptr)
+        {
+            *pSize = Required;
+            return S_OK;
+        }
+        if (*pSize < Required)
+        {
+            return E_INVALIDARG;
+        }
+
+        SerializedHeader Header = { SerializedMagic, SerializedVersion, m_AdapterLuid, m_NodeIndex,
+            static_cast<UINT32>(m_DecodeCaps.size()), static_cast<UINT32>(m_EncodeCaps.size()) };
+        BYTE* pBytes = static_cast<BYTE*>(pData);
+        memcpy(pBytes, &Header, sizeof(Header));
+        pBytes += sizeof(Header);
+        if (!m_DecodeCaps.empty())
+        {
+            memcpy(pBytes, m_DecodeCaps.data(), m_DecodeCaps.size() * sizeof(D3DX12_VIDEO_DECODE_CAPS));
+            pBytes += m_DecodeCaps.size() * sizeof(D3DX12_VIDEO_DECODE_CAPS);
+        }
+        if (!m_EncodeCaps.empty())
+        {
+            memcpy(pBytes, m_EncodeCaps.data(), m_EncodeCaps.size() * sizeof(D3DX12_VIDEO_ENCODE_CAPS));
+        }
+        *pSize = Required;
+        return S_OK;
+    }
+
+    // Loads a blob written by Serialize(). Returns E_INVALIDARG if the blob is malformed, was written
+    // by a different version of this class, or describes a different adapter; callers then re-query
+    // with Init().
+    HRESULT Deserialize(_In_reads_bytes_(Size) const void* pData, SIZE_T Size, const LUID& AdapterLuid, UINT NodeIndex = 0)
+    {
+        Clear();
+        SerializedHeader Header;
+        if (Size < sizeof(Header))
+        {
+            return E_INVALIDARG;
+        }
+        memcpy(&Header, pData, sizeof(Header));
+        if (Header.Magic != SerializedMagic || Header.Version != SerializedVersion
+            || Header.AdapterLuid.LowPart != AdapterLuid.LowPart || Header.AdapterLuid.HighPart != AdapterLuid.HighPart
+            || Header.NodeIndex != NodeIndex
+            || Size != sizeof(Header) + UINT64(Header.NumDecodeCaps) * sizeof(D3DX12_VIDEO_DECODE_CAPS)
+                + UINT64(Header.NumEncodeCaps) * sizeof(D3DX12_VIDEO_ENCODE_CAPS))
+        {
+            return E_INVALIDARG;
+        }
+
+        const BYTE* pBytes = static_cast<const BYTE*>(pData) + sizeof(Header);
+        m_DecodeCaps.resize(Header.NumDecodeCaps);
+        m_EncodeCaps.resize(Header.NumEncodeCaps);
+        if (Header.NumDecodeCaps)
+        {
+            memcpy(m_DecodeCaps.data(), pBytes, m_DecodeCaps.size() * sizeof(D3DX12_VIDEO_DECODE_CAPS));
+            pBytes += m_DecodeCaps.size() * sizeof(D3DX12_VIDEO_DECODE_CAPS);
+        }
+        if (Header.NumEncodeCaps)
+        {
+            memcpy(m_EncodeCaps.data(), pBytes, m_EncodeCaps.size() * sizeof(D3DX12_VIDEO_ENCODE_CAPS));
+        }
+        m_AdapterLuid = AdapterLuid;
+        m_NodeIndex = NodeIndex;
+        BuildIndex();
+        return S_OK;
+    }
+
+private:
+    static constexpr UINT32 SerializedMagic = 0x43565844; // 'DXVC'
+
+    struct SerializedHeader
+    {
+        UINT32 Magic;
+        UINT32 Version;
+        LUID AdapterLuid;
+        UINT32 NodeIndex;
+        UINT32 NumDecodeCaps;
+        UINT32 NumEncodeCaps;
+    };
+
+    void Clear() noexcept
+    {
+        m_DecodeCaps.clear();
+        m_EncodeCaps.clear();
+        m_DecodeIndex.clear();
+        m_EncodeIndex.clear();
+        m_AdapterLuid = {};
+        m_NodeIndex = 0;
+    }
+
+    HRESULT QueryDecodeCaps(ID3D12VideoDevice* pVideoDevice, UINT NodeIndex)
+    {
+        // Largest probed resolution wins. Each step is at least as wide and as tall as the one before it,
+        // so probing stops at the first miss; the common UHD/DCI sizes are included so a decoder capped
+        // at one of them is not reported at the next smaller step.
+        static const D3D12_VIDEO_ENCODER_PICTURE_RESOLUTION_DESC Ladder[] =
+        {
+            { 1280, 720 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 }, { 4096, 2160 }, { 4096, 2304 },
+            { 7680, 4320 }, { 8192, 4320 }, { 8192, 4352 }, { 16384, 16384 }
+        };
+
+        D3D12_FEATURE_DATA_VIDEO_DECODE_PROFILE_COUNT ProfileCount = { NodeIndex, 0 };
+        HRESULT hr = pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_DECODE_PROFILE_COUNT, &ProfileCount, sizeof(ProfileCount));
+        if (FAILED(hr) || ProfileCount.ProfileCount == 0)
+        {
+            // Devices without decode support are not an error
+            return S_OK;
+        }
+        std::vector<GUID> Profiles(ProfileCount.ProfileCount);
+        D3D12_FEATURE_DATA_VIDEO_DECODE_PROFILES ProfilesData = { NodeIndex, ProfileCount.ProfileCount, Profiles.data() };
+        hr = pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_DECODE_PROFILES, &ProfilesData, sizeof(ProfilesData));
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        std::vector<DXGI_FORMAT> Formats;
+        for (const GUID& Profile : Profiles)
+        {
+            const D3D12_VIDEO_DECODE_CONFIGURATION Configuration = { Profile, D3D12_BITSTREAM_ENCRYPTION_TYPE_NONE, D3D12_VIDEO_FRAME_CODED_INTERLACE_TYPE_NONE };
+            D3D12_FEATURE_DATA_VIDEO_DECODE_FORMAT_COUNT FormatCount = { NodeIndex, Configuration, 0 };
+            if (FAILED(pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_DECODE_FORMAT_COUNT, &FormatCount, sizeof(FormatCount)))
+                || FormatCount.FormatCount == 0)
+            {
+                continue;
+            }
+            Formats.resize(FormatCount.FormatCount);
+            D3D12_FEATURE_DATA_VIDEO_DECODE_FORMATS FormatsData = { NodeIndex, Configuration, FormatCount.FormatCount, Formats.data() };
+            hr = pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_DECODE_FORMATS, &FormatsData, sizeof(FormatsData));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            for (DXGI_FORMAT Format : Formats)
+            {
+                D3DX12_VIDEO_DECODE_CAPS Caps = {};
+                for (const auto& Resolution : Ladder)
+                {
+                    D3D12_FEATURE_DATA_VIDEO_DECODE_SUPPORT Support = {};
+                    Support.NodeIndex = NodeIndex;
+                    Support.Configuration = Configuration;
+                    Support.Width = Resolution.Width;
+                    Support.Height = Resolution.Height;
+                    Support.DecodeFormat = Format;
+                    Support.FrameRate = { 30, 1 };
+                    if (FAILED(pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_DECODE_SUPPORT, &Support, sizeof(Support)))
+                        || !(Support.SupportFlags & D3D12_VIDEO_DECODE_SUPPORT_FLAG_SUPPORTED))
+                    {
+                        break;
+                    }
+                    Caps.MaxWidth = Resolution.Width;
+                    Caps.MaxHeight = Resolution.Height;
+                    Caps.ConfigurationFlags = Support.ConfigurationFlags;
+                    Caps.DecodeTier = Support.DecodeTier;
+                }
+                if (Caps.MaxWidth != 0)
+                {
+                    Caps.Profile = Profile;
+                    Caps.Format = Format;
+                    m_DecodeCaps.push_back(Caps);
+                }
+            }
+        }
+        return S_OK;
+    }
+
+    HRESULT QueryEncodeCaps(ID3D12VideoDevice* pVideoDevice, UINT NodeIndex)
+    {
+        static const DXGI_FORMAT InputFormats[] =
+        {
+            DXGI_FORMAT_NV12, DXGI_FORMAT_P010, DXGI_FORMAT_P016, DXGI_FORMAT_AYUV, DXGI_FORMAT_Y410, DXGI_FORMAT_YUY2, DXGI_FORMAT_Y210
+        };
+        static const struct { D3D12_VIDEO_ENCODER_CODEC Codec; UINT NumProfiles; } Codecs[] =
+        {
+            { D3D12_VIDEO_ENCODER_CODEC_H264, D3D12_VIDEO_ENCODER_PROFILE_H264_HIGH_10 + 1 },
+            { D3D12_VIDEO_ENCODER_CODEC_HEVC, D3D12_VIDEO_ENCODER_PROFILE_HEVC_MAIN10 + 1 },
+        };
+
+        std::vector<D3D12_VIDEO_ENCODER_PICTURE_RESOLUTION_RATIO_DESC> Ratios;
+        for (const auto& Codec : Codecs)
+        {
+            D3D12_FEATURE_DATA_VIDEO_ENCODER_CODEC CodecData = { NodeIndex, Codec.Codec, FALSE };
+            if (FAILED(pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_ENCODER_CODEC, &CodecData, sizeof(CodecData)))
+                || !CodecData.IsSupported)
+            {
+                continue;
+            }
+
+            D3D12_FEATURE_DATA_VIDEO_ENCODER_OUTPUT_RESOLUTION_RATIOS_COUNT RatiosCount = { NodeIndex, Codec.Codec, 0 };
+            HRESULT hr = pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_ENCODER_OUTPUT_RESOLUTION_RATIOS_COUNT, &RatiosCount, sizeof(RatiosCount));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            Ratios.resize(RatiosCount.ResolutionRatiosCount);
+            D3D12_FEATURE_DATA_VIDEO_ENCODER_OUTPUT_RESOLUTION Resolution = {};
+            Resolution.NodeIndex = NodeIndex;
+            Resolution.Codec = Codec.Codec;
+            Resolution.ResolutionRatiosCount = RatiosCount.ResolutionRatiosCount;
+            Resolution.pResolutionRatios = Ratios.data();
+            hr = pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_ENCODER_OUTPUT_RESOLUTION, &Resolution, sizeof(Resolution));
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            if (!Resolution.IsSupported)
+            {
+                continue;
+            }
+
+            for (UINT Profile = 0; Profile < Codec.NumProfiles; ++Profile)
+            {
+                // Both profile enums are UINT sized and the level outputs are written through
+                // codec specific pointers.
+                UINT ProfileValue = Profile;
+                D3D12_VIDEO_ENCODER_LEVEL_TIER_CONSTRAINTS_HEVC MinLevel = {}, MaxLevel = {};
+                D3D12_FEATURE_DATA_VIDEO_ENCODER_PROFILE_LEVEL ProfileLevel = {};
+                ProfileLevel.NodeIndex = NodeIndex;
+                ProfileLevel.Codec = Codec.Codec;
+                ProfileLevel.Profile.DataSize = sizeof(UINT);
+                ProfileLevel.Profile.pH264Profile = reinterpret_cast<D3D12_VIDEO_ENCODER_PROFILE_H264*>(&ProfileValue);
+                if (Codec.Codec == D3D12_VIDEO_ENCODER_CODEC_HEVC)
+                {
+                    ProfileLevel.MinSupportedLevel.DataSize = sizeof(MinLevel);
+                    ProfileLevel.MinSupportedLevel.pHEVCLevelSetting = &MinLevel;
+                    ProfileLevel.MaxSupportedLevel.DataSize = sizeof(MaxLevel);
+                    ProfileLevel.MaxSupportedLevel.pHEVCLevelSetting = &MaxLevel;
+                }
+                else
+                {
+                    ProfileLevel.MinSupportedLevel.DataSize = sizeof(D3D12_VIDEO_ENCODER_LEVELS_H264);
+                    ProfileLevel.MinSupportedLevel.pH264LevelSetting = reinterpret_cast<D3D12_VIDEO_ENCODER_LEVELS_H264*>(&MinLevel.Level);
+                    ProfileLevel.MaxSupportedLevel.DataSize = sizeof(D3D12_VIDEO_ENCODER_LEVELS_H264);
+                    ProfileLevel.MaxSupportedLevel.pH264LevelSetting = reinterpret_cast<D3D12_VIDEO_ENCODER_LEVELS_H264*>(&MaxLevel.Level);
+                }
+                if (FAILED(pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_ENCODER_PROFILE_LEVEL, &ProfileLevel, sizeof(ProfileLevel)))
+                    || !ProfileLevel.IsSupported)
+                {
+                    continue;
+                }
+
+                for (DXGI_FORMAT Format : InputFormats)
+                {
+                    D3D12_FEATURE_DATA_VIDEO_ENCODER_INPUT_FORMAT InputFormat = { NodeIndex, Codec.Codec, ProfileLevel.Profile, Format, FALSE };
+                    if (FAILED(pVideoDevice->CheckFeatureSupport(D3D12_FEATURE_VIDEO_ENCODER_INPUT_FORMAT, &InputFormat, sizeof(InputFormat)))
+                        || !InputFormat.IsSupported)
+                    {
+                        continue;
+                    }
+
+                    D3DX12_VIDEO_ENCODE_CAPS Caps = {};
+                    Caps.Codec = Codec.Codec;
+                    Caps.Profile = Profile;
+                    Caps.Format = Format;
+                    Caps.MinLevel = static_cast<UINT>(MinLevel.Level);
+                    Caps.MaxLevel = static_cast<UINT>(MaxLevel.Level);
+                    Caps.MaxTier = static_cast<UINT>(MaxLevel.Tier);
+                    Caps.MinResolution = Resolution.MinResolutionSupported;
+                    Caps.MaxResolution = Resolution.MaxResolutionSupported;
+                    Caps.ResolutionWidthMultiple = Resolution.ResolutionWidthMultipleRequirement;
+                    Caps.ResolutionHeightMultiple = Resolution.ResolutionHeightMultipleRequirement;
+                    m_EncodeCaps.push_back(Caps);
+                }
+            }
+        }
+        return S_OK;
+    }
+
+    static UINT64 Mix(UINT64 Key) noexcept
+    {
+        Key ^= Key >> 33;
+        Key *= 0xff51afd7ed558ccdull;
+        Key ^= Key >> 33;
+        Key *= 0xc4ceb9fe1a85ec53ull;
+        return Key ^ (Key >> 33);
+    }
+
+    static UINT64 DecodeKey(REFGUID Profile, DXGI_FORMAT Format) noexcept
+    {
+        UINT64 Halves[2];
+        memcpy(Halves, &Profile, sizeof(Halves));
+        return Mix(Halves[0] ^ Mix(Halves[1] ^ Format));
+    }
+
+    static UINT64 EncodeKey(D3D12_VIDEO_ENCODER_CODEC Codec, UINT Profile, DXGI_FORMAT Format) noexcept
+    {
+        return Mix((UINT64(Codec) << 48) | (UINT64(Profile) << 32) | UINT64(Format));
+    }
+
+    // Open addressing table of entry index + 1, sized to a power of two at most half full
+    template <typename TCaps, typename TKey>
+    static void BuildTable(std::vector<UINT>& Table, const std::vector<TCaps>& Caps, TKey Key)
+    {
+        UINT Size = 4;
+        while (Size < Caps.size() * 2) Size *= 2;
+        Table.assign(Size, 0);
+        for (UINT i = 0; i < Caps.size(); ++i)
+        {
+            UINT Slot = static_cast<UINT>(Key(Caps[i])) & (Size - 1);
+            while (Table[Slot] != 0) Slot = (Slot + 1) & (Size - 1);
+            Table[Slot] = i + 1;
+        }
+    }
+
+    template <typename TCaps, typename TMatch>
+    static UINT Find(const std::vector<UINT>& Table, UINT64 Key, TMatch Match, const std::vector<TCaps>& Caps) noexcept
+    {
+        if (Table.empty())
+        {
+            return UINT_MAX;
+        }
+        const UINT Mask = static_cast<UINT>(Table.size()) - 1;
+        for (UINT Slot = static_cast<UINT>(Key) & Mask; Table[Slot] != 0; Slot = (Slot + 1) & Mask)
+        {
+            if (Match(Caps[Table[Slot] - 1]))
+            {
+                return Table[Slot] - 1;
+            }
+        }
+        return UINT_MAX;
+    }
+
+    void BuildIndex()
+    {
+        BuildTable(m_DecodeIndex, m_DecodeCaps, [](const D3DX12_VIDEO_DECODE_CAPS& Caps) { return DecodeKey(Caps.Profile, Caps.Format); });
+        BuildTable(m_EncodeIndex, m_EncodeCaps, [](const D3DX12_VIDEO_ENCODE_CAPS& Caps) { return EncodeKey(Caps.Codec, Caps.Profile, Caps.Format); });
+    }
+
+    std::vector<D3DX12_VIDEO_DECODE_CAPS> m_DecodeCaps;
+    std::vector<D3DX12_VIDEO_ENCODE_CAPS> m_EncodeCaps;
+    std::vector<UINT> m_DecodeIndex;
+    std::vector<UINT> m_EncodeIndex;
+    LUID m_AdapterLuid = {};
+    UINT m_NodeIndex = 0;
+};
+
+#endif // !D3DX12_NO_VIDEO_FEATURE_SUPPORT_CLASS
+
+#ifndef D3DX12_NO_VIDEO_ENCODER_DPB_HELPERS
+
+//================================================================================================
+// D3DX12 Video Encoder Reference Picture Helpers
+//
+// Decoded picture buffer management for H.264 and HEVC encode. Given the sequence GOP structure,
+// CD3DX12VideoEncoderDPB decides the type and display position of each frame in encode order,
+// tracks the short-term references in a sliding window, and fills the picture control descriptors
+// (reference lists, reference picture descriptors, D3D12_VIDEO_ENCODE_REFERENCE_FRAMES) for
+// EncodeFrame.
+//
+// Every GOP starts with an IDR frame; with GOPLength 0, only the first frame is. With a
+// PPicturePeriod N > 1, frames are coded anchor first: I0 P3 B1 B2 P6 B4 B5 ..., B frames are not
+// used as references, and the last frame of a finite GOP is always an anchor. The caller feeds the
+// input frame at GetDisplayIndex() to each EncodeFrame.
+//
+// Reconstructed pictures live in one texture array with MaxReferenceFrames + 1 slices, which are
+// reused as references leave the window. All storage is fixed size, so building a frame's
+// descriptors does not allocate; the pointers handed out remain valid until the next BeginFrame().
+//
+//================================================================================================
+#include <algorithm>
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12VideoEncoderDPB
+{
+public:
+    static constexpr UINT MaxReferences = 16;
+
+    CD3DX12VideoEncoderDPB() = default;
+    CD3DX12VideoEncoderDPB(const CD3DX12VideoEncoderDPB&) = delete;
+    CD3DX12VideoEncoderDPB& operator=(const CD3DX12VideoEncoderDPB&) = delete;
+
+    // pReconstructedPictures is a texture array with at least MaxReferenceFrames + 1 slices. List
+    // sizes are clamped to MaxL0References / MaxL1References, as reported by
+    // D3D12_FEATURE_DATA_VIDEO_ENCODER_CODEC_PICTURE_CONTROL_SUPPORT.
+    HRESULT Init(
+        D3D12_VIDEO_ENCODER_CODEC Codec,
+        const D3D12_VIDEO_ENCODER_SEQUENCE_GOP_STRUCTURE& GopStructure,
+        UINT MaxReferenceFrames,
+        UINT MaxL0References,
+        UINT MaxL1References,
+        _In_ ID3D12Resource* pReconstructedPictures) noexcept
+    {
+        m_bInitialized = false;
+        if (MaxReferenceFrames == 0 || MaxReferenceFrames > MaxReferences || pReconstructedPictures == nullptr)
+        {
+            return E_INVALIDARG;
+        }
+        if (Codec == D3D12_VIDEO_ENCODER_CODEC_H264 && GopStructure.DataSize == sizeof(D3D12_VIDEO_ENCODER_SEQUENCE_GOP_STRUCTURE_H264))
+        {
+            m_GopLength = GopStructure.pH264GroupOfPictures->GOPLength;
+            m_PPicturePeriod = GopStructure.pH264GroupOfPictures->PPicturePeriod;
+            m_MaxFrameNum = 1u << (GopStructure.pH264GroupOfPictures->log2_max_frame_num_minus4 + 4);
+        }
+        else if (Codec == D3D12_VIDEO_ENCODER_CODEC_HEVC && GopStructure.DataSize == sizeof(D3D12_VIDEO_ENCODER_SEQUENCE_GOP_STRUCTURE_HEVC))
+        {
+            m_GopLength = GopStructure.pHEVCGroupOfPictures->GOPLength;
+            m_PPicturePeriod = GopStructure.pHEVCGroupOfPictures->PPicturePeriod;
+            m_MaxFrameNum = 0;
+        }
+        else
+        {
+            return E_INVALIDARG;
+        }
+        if (m_PPicturePeriod == 0 || (m_PPicturePeriod > 1 && MaxL1References == 0) || (m_GopLength != 1 && MaxL0References == 0))
+        {
+            return E_INVALIDARG;
+        }
+
+        m_Codec = Codec;
+        m_MaxReferenceFrames = MaxReferenceFrames;
+        m_MaxL0References = (std::min)(MaxL0References, MaxReferences);
+        m_MaxL1References = (std::min)(MaxL1References, MaxReferences);
+        m_pReconstructedPictures = pReconstructedPictures;
+        m_GopDisplayCount = 0;
+        m_GopStartDisplayIndex = 0;
+        m_DecodeOrder = 0;
+        m_bCurrentIsReference = false;
+        m_bForceIDR = true;
+        m_bInitialized = true;
+        return S_OK;
+    }
+
+    // Starts a new GOP with an IDR frame at the next BeginFrame(). Input frames of an interrupted
+    // mini-GOP that have not been coded yet are skipped.
+    void Reset() noexcept
+    {
+        m_bForceIDR = true;
+    }
+
+    // Prepares the next frame in encode order. Fills the picture control (flags, codec data and
+    // reference frames) and the reconstructed picture for EncodeFrame; the reconstructed picture is
+    // null for frames that are not used as references.
+    void BeginFrame(
+        _Out_ D3D12_VIDEO_ENCODER_PICTURE_CONTROL_DESC* pPictureControl,
+        _Out_ D3D12_VIDEO_ENCODER_RECONSTRUCTED_PICTURE* pReconstructedPicture) noexcept
+    {
+        D3DX12_ASSERT(m_bInitialized);
+        CommitCurrent();
+
+        if (m_bForceIDR || (m_GopLength != 0 && m_GopDecodeIndex == m_GopLength))
+        {
+            m_GopStartDisplayIndex += m_GopDisplayCount;
+            m_bForceIDR = false;
+            m_GopDecodeIndex = 0;
+            m_GopDisplayCount = 0;
+            m_NumReferences = 0;
+            m_FreeSlots = (1u << (m_MaxReferenceFrames + 1)) - 1;
+            m_FrameNum = 0;
+            m_IdrPicId = (m_IdrPicId + 1) & 0xffff;
+        }
+
+        // Position of this frame in display order within the GOP
+        UINT FrameType = D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_IDR_FRAME;
+        UINT DisplayPosition = 0;
+        if (m_GopDecodeIndex != 0)
+        {
+            const UINT MiniGop = (m_GopDecodeIndex - 1) / m_PPicturePeriod;
+            const UINT Offset = (m_GopDecodeIndex - 1) % m_PPicturePeriod;
+            UINT Anchor = (MiniGop + 1) * m_PPicturePeriod;
+            if (m_GopLength != 0 && Anchor > m_GopLength - 1)
+            {
+                Anchor = m_GopLength - 1;
+            }
+            FrameType = Offset == 0 ? D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_P_FRAME : D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_B_FRAME;
+            DisplayPosition = Offset == 0 ? Anchor : MiniGop * m_PPicturePeriod + Offset;
+        }
+        m_GopDisplayCount = (std::max)(m_GopDisplayCount, DisplayPosition + 1);
+        ++m_GopDecodeIndex;
+
+        m_DisplayIndex = m_GopStartDisplayIndex + DisplayPosition;
+        m_bCurrentIsReference = FrameType != D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_B_FRAME;
+        m_Current.POC = m_Codec == D3D12_VIDEO_ENCODER_CODEC_H264 ? DisplayPosition * 2 : DisplayPosition;
+        m_Current.FrameNum = m_FrameNum;
+        m_Current.DecodeOrder = m_DecodeOrder++;
+        m_Current.Slot = UINT_MAX;
+
+        // Reference lists, as indices into the descriptors (one per DPB entry, in DPB order)
+        m_NumL0 = m_NumL1 = 0;
+        if (FrameType == D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_P_FRAME)
+        {
+            // Most recently coded first
+            for (UINT i = 0; i < m_NumReferences; ++i) m_List0[m_NumL0++] = i;
+            std::sort(m_List0, m_List0 + m_NumL0, [this](UINT a, UINT b) { return m_Dpb[a].DecodeOrder > m_Dpb[b].DecodeOrder; });
+        }
+        else if (FrameType == D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_B_FRAME)
+        {
+            // L0: past pictures by descending POC, then future ones; L1 the other way around
+            UINT NumPast = 0;
+            for (UINT i = 0; i < m_NumReferences; ++i)
+            {
+                if (m_Dpb[i].POC < m_Current.POC) m_List0[NumPast++] = i;
+            }
+            UINT NumFuture = 0;
+            for (UINT i = 0; i < m_NumReferences; ++i)
+            {
+                if (m_Dpb[i].POC > m_Current.POC) m_List1[NumFuture++] = i;
+            }
+            std::sort(m_List0, m_List0 + NumPast, [this](UINT a, UINT b) { return m_Dpb[a].POC > m_Dpb[b].POC; });
+            std::sort(m_List1, m_List1 + NumFuture, [this](UINT a, UINT b) { return m_Dpb[a].POC < m_Dpb[b].POC; });
+            std::copy(m_List1, m_List1 + NumFuture, m_List0 + NumPast);
+            std::copy(m_List0, m_List0 + NumPast, m_List1 + NumFuture);
+            m_NumL0 = m_NumL1 = NumPast + NumFuture;
+        }
+        m_NumL0 = (std::min)(m_NumL0, m_MaxL0References);
+        m_NumL1 = (std::min)(m_NumL1, m_MaxL1References);
+
+        for (UINT i = 0; i < m_NumReferences; ++i)
+        {
+            m_ReferenceTextures[i] = m_pReconstructedPictures;
+            m_ReferenceSubresources[i] = m_Dpb[i].Slot;
+        }
+        if (m_bCurrentIsReference)
+        {
+            m_Current.Slot = AllocateSlot();
+        }
+
+        FillCodecData(FrameType);
+        pPictureControl->IntraRefreshFrameIndex = 0;
+        pPictureControl->Flags = m_bCurrentIsReference ? D3D12_VIDEO_ENCODER_PICTURE_CONTROL_FLAG_USED_AS_REFERENCE_PICTURE : D3D12_VIDEO_ENCODER_PICTURE_CONTROL_FLAG_NONE;
+        if (m_Codec == D3D12_VIDEO_ENCODER_CODEC_H264)
+        {
+            pPictureControl->PictureControlCodecData.DataSize = sizeof(m_H264PicData);
+            pPictureControl->PictureControlCodecData.pH264PicData = &m_H264PicData;
+        }
+        else
+        {
+            pPictureControl->PictureControlCodecData.DataSize = sizeof(m_HEVCPicData);
+            pPictureControl->PictureControlCodecData.pHEVCPicData = &m_HEVCPicData;
+        }
+        const bool bIntra = FrameType == D3D12_VIDEO_ENCODER_FRAME_TYPE_H264_IDR_FRAME;
+        pPictureControl->ReferenceFrames.NumTexture2Ds = bIntra ? 0 : m_NumReferences;
+        pPictureControl->ReferenceFrames.ppTexture2Ds = bIntra ? nullptr : m_ReferenceTextures;
+        pPictureControl->ReferenceFrames.pSubresources = bIntra ? nullptr : m_ReferenceSubresources;
+
+        pReconstructedPicture->pReconstructedPicture = m_bCurrentIsReference ? m_pReconstructedPictures : nullptr;
+        pReconstructedPicture->ReconstructedPictureSubresource = m_bCurrentIsReference ? m_Current.Slot : 0;
+    }
+
+    // Display order index (from the first frame) of the input picture to encode in the current frame
+    UINT64 GetDisplayIndex() const noexcept { return m_DisplayIndex; }
+    UINT GetNumReferences() const noexcept { return m_NumReferences; }
+    bool IsReference() const noexcept { return m_bCurrentIsReference; }
+
+    const D3D12_VIDEO_ENCODER_PICTURE_CONTROL_CODEC_DATA_H264& GetH264PictureData() const noexcept { return m_H264PicData; }
+    const D3D12_VIDEO_ENCODER_PICTURE_CONTROL_CODEC_DATA_HEVC& GetHEVCPictureData() const noexcept { return m_HEVCPicData; }
+
+private:
+    struct Reference
+    {
+        UINT Slot;
+        UINT POC;
+        UINT FrameNum;
+        UINT64 DecodeOrder;
+    };
+
+    UINT AllocateSlot() noexcept
+    {
+        D3DX12_ASSERT(m_FreeSlots != 0);
+        UINT Slot = 0;
+        while (!(m_FreeSlots & (1u << Slot))) ++Slot;
+        m_FreeSlots &= ~(1u << Slot);
+        return Slot;
+    }
+
+    // Moves the previous frame into the DPB once it has been encoded, dropping the oldest reference
+    // when the window is full.
+    void CommitCurrent() noexcept
+    {
+        if (!m_bCurrentIsReference)
+        {
+            return;
+        }
+        m_bCurrentIsReference = false;
+        if (m_NumReferences == m_MaxReferenceFrames)
+        {
+            UINT Oldest = 0;
+            for (UINT i = 1; i < m_NumReferences; ++i)
+            {
+                if (m_Dpb[i].DecodeOrder < m_Dpb[Oldest].DecodeOrder) Oldest = i;
+            }
+            m_FreeSlots |= 1u << m_Dpb[Oldest].Slot;
+            for (UINT i = Oldest + 1; i < m_NumReferences; ++i) m_Dpb[i - 1] = m_Dpb[i];
+            --m_NumReferences;
+        }
+        m_Dpb[m_NumReferences++] = m_Current;
+        if (m_MaxFrameNum != 0)
+        {
+            m_FrameNum = (m_FrameNum + 1) % m_MaxFrameNum;
+        }
+    }
+
+    void FillCodecData(UINT FrameType) noexcept
+    {
+        if (m_Codec == D3D12_VIDEO_ENCODER_CODEC_H264)
+        {
+            for (UINT i = 0; i < m_NumReferences; ++i)
+            {
+                m_H264Descriptors[i] = { i, FALSE, 0, m_Dpb[i].POC, m_Dpb[i].FrameNum, 0 };
+            }
+            m_H264PicData = {};
+            m_H264PicData.FrameType = static_cast<D3D12_VIDEO_ENCODER_FRAME_TYPE_H264>(FrameType);
+            m_H264PicData.idr_pic_id = m_IdrPicId;
+            m_H264PicData.PictureOrderCountNumber = m_Current.POC;
+            m_H264PicData.FrameDecodingOrderNumber = m_Current.FrameNum;
+            m_H264PicData.List0ReferenceFramesCount = m_NumL0;
+            m_H264PicData.pList0ReferenceFrames = m_NumL0 ? m_List0 : nullptr;
+            m_H264PicData.List1ReferenceFramesCount = m_NumL1;
+            m_H264PicData.pList1ReferenceFrames = m_NumL1 ? m_List1 : nullptr;
+            m_H264PicData.ReferenceFramesReconPictureDescriptorsCount = m_NumReferences;
+            m_H264PicData.pReferenceFramesReconPictureDescriptors = m_NumReferences ? m_H264Descriptors : nullptr;
+        }
+        else
+        {
+            for (UINT i = 0; i < m_NumReferences; ++i)
+            {
+                const bool bUsed = std::find(m_List0, m_List0 + m_NumL0, i) != m_List0 + m_NumL0
+                    || std::find(m_List1, m_List1 + m_NumL1, i) != m_List1 + m_NumL1;
+                m_HEVCDescriptors[i] = { i, bUsed ? TRUE : FALSE, FALSE, m_Dpb[i].POC, 0 };
+            }
+            m_HEVCPicData = {};
+            m_HEVCPicData.FrameType = static_cast<D3D12_VIDEO_ENCODER_FRAME_TYPE_HEVC>(FrameType);
+            m_HEVCPicData.PictureOrderCountNumber = m_Current.POC;
+            m_HEVCPicData.List0ReferenceFramesCount = m_NumL0;
+            m_HEVCPicData.pList0ReferenceFrames = m_NumL0 ? m_List0 : nullptr;
+            m_HEVCPicData.List1ReferenceFramesCount = m_NumL1;
+            m_HEVCPicData.pList1ReferenceFrames = m_NumL1 ? m_List1 : nullptr;
+            m_HEVCPicData.ReferenceFramesReconPictureDescriptorsCount = m_NumReferences;
+            m_HEVCPicData.pReferenceFramesReconPictureDescriptors = m_NumReferences ? m_HEVCDescriptors : nullptr;
+        }
+    }
+
+    D3D12_VIDEO_ENCODER_CODEC m_Codec = D3D12_VIDEO_ENCODER_CODEC_H264;
+    UINT m_GopLength = 0;
+    UINT m_PPicturePeriod = 1;
+    UINT m_MaxFrameNum = 0;
+    UINT m_MaxReferenceFrames = 0;
+    UINT m_MaxL0References = 0;
+    UINT m_MaxL1References = 0;
+    ID3D12Resource* m_pReconstructedPictures = nullptr;
+    bool m_bInitialized = false;
+
+    // Sequence state
+    bool m_bForceIDR = true;
+    UINT m_GopDecodeIndex = 0;
+    UINT m_GopDisplayCount = 0;
+    UINT64 m_GopStartDisplayIndex = 0;
+    UINT64 m_DisplayIndex = 0;
+    UINT64 m_DecodeOrder = 0;
+    UINT m_FrameNum = 0;
+    UINT m_IdrPicId = 0xffff;
+
+    // DPB
+    Reference m_Dpb[MaxReferences] = {};
+    UINT m_NumReferences = 0;
+    UINT m_FreeSlots = 0;
+    Reference m_Current = {};
+    bool m_bCurrentIsReference = false;
+
+    // Per-frame descriptor storage
+    UINT m_List0[MaxReferences] = {};
+    UINT m_List1[MaxReferences] = {};
+    UINT m_NumL0 = 0;
+    UINT m_NumL1 = 0;
+    ID3D12Resource* m_ReferenceTextures[MaxReferences] = {};
+    UINT m_ReferenceSubresources[MaxReferences] = {};
+    D3D12_VIDEO_ENCODER_REFERENCE_PICTURE_DESCRIPTOR_H264 m_H264Descriptors[MaxReferences] = {};
+    D3D12_VIDEO_ENCODER_REFERENCE_PICTURE_DESCRIPTOR_HEVC m_HEVCDescriptors[MaxReferences] = {};
+    D3D12_VIDEO_ENCODER_PICTURE_CONTROL_CODEC_DATA_H264 m_H264PicData = {};
+    D3D12_VIDEO_ENCODER_PICTURE_CONTROL_CODEC_DATA_HEVC m_HEVCPicData = {};
+};
+
+#endif // !D3DX12_NO_VIDEO_ENCODER_DPB_HELPERS
+
+#ifndef D3DX12_NO_VIDEO_DECODE_BITSTREAM_HELPERS
+
+//================================================================================================
+// D3DX12 Video Decode Bitstream Helpers
+//
+// CD3DX12VideoDecodeBitstreamPool sub-allocates compressed bitstreams for DecodeFrame from one
+// persistently mapped upload buffer used as a ring. The demuxer writes (or gathers slices) straight
+// into the mapped memory of the open allocation, and the space is recycled once the fence value of
+// the decode that consumed it has completed.
+// Uses STL
+//
+// CD3DX12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS assembles the DecodeFrame input arguments.
+//
+//================================================================================================
+#include <deque>
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12VideoDecodeBitstreamPool
+{
+public:
+    CD3DX12VideoDecodeBitstreamPool() = default;
+
+    // pBuffer is an upload buffer of Size bytes, mapped at pMappedData for the lifetime of the pool.
+    // Alignment applies to the offset of every bitstream and must be a power of two no smaller than
+    // D3D12_VIDEO_DECODE_MIN_BITSTREAM_OFFSET_ALIGNMENT.
+    HRESULT Init(
+        _In_ ID3D12Resource* pBuffer,
+        _In_ void* pMappedData,
+        UINT64 Size,
+        UINT64 Alignment = D3D12_VIDEO_DECODE_MIN_BITSTREAM_OFFSET_ALIGNMENT)
+    {
+        m_pBuffer = nullptr;
+        if (pBuffer == nullptr || pMappedData == nullptr
+            || Alignment < D3D12_VIDEO_DECODE_MIN_BITSTREAM_OFFSET_ALIGNMENT || (Alignment & (Alignment - 1)) != 0
+            || Size < Alignment)
+        {
+            return E_INVALIDARG;
+        }
+        m_pBuffer = pBuffer;
+        m_pMappedData = static_cast<BYTE*>(pMappedData);
+        m_Size = Size & ~(Alignment - 1);
+        m_Alignment = Alignment;
+        m_Head = m_Tail = 0;
+        m_InFlight.clear();
+        m_bOpen = false;
+        return S_OK;
+    }
+
+    // Returns the space of every bitstream whose fence value is at most CompletedFenceValue
+    void Recycle(UINT64 CompletedFenceValue)
+    {
+        while (!m_InFlight.empty() && m_InFlight.front().FenceValue <= CompletedFenceValue)
+        {
+            m_Tail = m_InFlight.front().End;
+            m_InFlight.pop_front();
+        }
+    }
+
+    // Opens a bitstream of up to MaxSize bytes. Returns false if the ring has no contiguous space for
+    // it yet; recycle completed submissions and try again.
+    bool Begin(UINT64 MaxSize)
+    {
+        D3DX12_ASSERT(m_pBuffer != nullptr && !m_bOpen);
+        const UINT64 Capacity = D3DX12AlignAtLeast<UINT64>(MaxSize, m_Alignment);
+        if (Capacity > m_Size)
+        {
+            return false;
+        }
+
+        // Used space is [Tail, Head) or, once wrapped, [Tail, Size) + [0, Head)
+        UINT64 Start;
+        if (m_InFlight.empty())
+        {
+            m_Head = m_Tail = 0;
+            Start = 0;
+        }
+        else if (m_Head > m_Tail)
+        {
+            if (m_Size - m_Head >= Capacity) Start = m_Head;
+            else if (m_Tail >= Capacity) Start = 0;
+            else return false;
+        }
+        else if (m_Tail - m_Head >= Capacity)
+        {
+            Start = m_Head;
+        }
+        else
+        {
+            return false;
+        }
+
+        m_OpenStart = Start;
+        m_OpenCapacity = Capacity;
+        m_Written = 0;
+        m_bOpen = true;
+        return true;
+    }
+
+    // Mapped address at which the next bytes of the open bitstream go, and how many may be written
+    BYTE* GetWritePointer() const noexcept { return m_pMappedData + m_OpenStart + m_Written; }
+    UINT64 GetRemainingSize() const noexcept { return m_OpenCapacity - m_Written; }
+
+    // Accounts for NumBytes written directly at GetWritePointer()
+    void Advance(UINT64 NumBytes) noexcept
+    {
+        D3DX12_ASSERT(m_bOpen && NumBytes <= GetRemainingSize());
+        m_Written += NumBytes;
+    }
+
+    // Gathers one chunk (e.g. a slice NAL unit) into the open bitstream. Returns false, writing
+    // nothing, if it does not fit.
+    bool Append(_In_reads_bytes_(NumBytes) const void* pData, SIZE_T NumBytes) noexcept
+    {
+        D3DX12_ASSERT(m_bOpen);
+        if (NumBytes > GetRemainingSize())
+        {
+            return false;
+        }
+        memcpy(GetWritePointer(), pData, NumBytes);
+        m_Written += NumBytes;
+        return true;
+    }
+
+    UINT64 GetWrittenSize() const noexcept { return m_Written; }
+
+    // Closes the open bitstream; it stays in use until FenceValue completes. Unused reserved space is
+    // returned to the ring.
+    void End(UINT64 FenceValue, _Out_ D3D12_VIDEO_DECODE_COMPRESSED_BITSTREAM* pBitstream)
+    {
+        D3DX12_ASSERT(m_bOpen);
+        pBitstream->pBuffer = m_pBuffer;
+        pBitstream->Offset = m_OpenStart;
+        pBitstream->Size = m_Written;
+
+        m_Head = m_OpenStart + D3DX12AlignAtLeast<UINT64>(m_Written, m_Alignment);
+        m_InFlight.push_back({ FenceValue, m_Head });
+        m_bOpen = false;
+    }
+
+    // Abandons the open bitstream
+    void Cancel() noexcept { m_bOpen = false; }
+
+    UINT64 GetSize() const noexcept { return m_Size; }
+    UINT GetNumInFlight() const noexcept { return static_cast<UINT>(m_InFlight.size()); }
+
+private:
+    struct InFlight
+    {
+        UINT64 FenceValue;
+        UINT64 End;
+    };
+
+    ID3D12Resource* m_pBuffer = nullptr;
+    BYTE* m_pMappedData = nullptr;
+    UINT64 m_Size = 0;
+    UINT64 m_Alignment = D3D12_VIDEO_DECODE_MIN_BITSTREAM_OFFSET_ALIGNMENT;
+    UINT64 m_Head = 0;
+    UINT64 m_Tail = 0;
+    std::deque<InFlight> m_InFlight;
+    bool m_bOpen = false;
+    UINT64 m_OpenStart = 0;
+    UINT64 m_OpenCapacity = 0;
+    UINT64 m_Written = 0;
+};
+
+//------------------------------------------------------------------------------------------------
+struct CD3DX12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS : public D3D12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS
+{
+    CD3DX12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS() noexcept
+        : D3D12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS{}
+    {}
+    explicit CD3DX12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS(const D3D12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS& o) noexcept :
+        D3D12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS(o)
+    {}
+    CD3DX12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS(
+        const D3D12_VIDEO_DECODE_COMPRESSED_BITSTREAM& Bitstream,
+        _In_opt_ ID3D12VideoDecoderHeap* pDecoderHeap) noexcept
+        : D3D12_VIDEO_DECODE_INPUT_STREAM_ARGUMENTS{}
+    {
+        CompressedBitstream = Bitstream;
+        pHeap = pDecoderHeap;
+    }
+
+    // Returns false if all D3D12_VIDEO_DECODE_MAX_ARGUMENTS slots are used
+    bool AddFrameArgument(D3D12_VIDEO_DECODE_ARGUMENT_TYPE Type, UINT Size, _In_reads_bytes_(Size) const void* pData) noexcept
+    {
+        if (NumFrameArguments == D3D12_VIDEO_DECODE_MAX_ARGUMENTS)
+        {
+            return false;
+        }
+        FrameArguments[NumFrameArguments++] = { Type, Size, const_cast<void*>(pData) };
+        return true;
+    }
+
+    template <typename T>
+    bool AddFrameArgument(D3D12_VIDEO_DECODE_ARGUMENT_TYPE Type, const T& Data) noexcept
+    { return AddFrameArgument(Type, sizeof(T), &Data); }
+
+    // Slice control for NumSlices entries of the codec's slice control structure
+    template <typename T>
+    bool AddSliceControl(_In_reads_(NumSlices) const T* pSlices, UINT NumSlices) noexcept
+    { return AddFrameArgument(D3D12_VIDEO_DECODE_ARGUMENT_TYPE_SLICE_CONTROL, UINT(sizeof(T) * NumSlices), pSlices); }
+
+    void SetReferenceFrames(
+        UINT NumTexture2Ds,
+        _In_reads_(NumTexture2Ds) ID3D12Resource** ppTexture2Ds,
+        _In_reads_(NumTexture2Ds) UINT* pSubresources,
+        _In_reads_opt_(NumTexture2Ds) ID3D12VideoDecoderHeap** ppHeaps = nullptr) noexcept
+    {
+        ReferenceFrames.NumTexture2Ds = NumTexture2Ds;
+        ReferenceFrames.ppTexture2Ds = ppTexture2Ds;
+        ReferenceFrames.pSubresources = pSubresources;
+        ReferenceFrames.ppHeaps = ppHeaps;
+    }
+};
+
+#endif // !D3DX12_NO_VIDEO_DECODE_BITSTREAM_HELPERS
+
+#ifndef D3DX12_NO_VIDEO_MOTION_ESTIMATION_HELPERS
+
+//================================================================================================
+// D3DX12 Video Motion Estimation Helpers
+//
+// CD3DX12VideoMotionEstimationBatch runs motion estimation for many (input, reference) frame pairs
+// per submission. The motion vector heaps are created once, at Init(), one per ring slot. Each pair
+// is resolved into its slice of a caller-created R16G16_SINT texture array, which is copied into a
+// persistently mapped readback buffer so the vectors can be read on the CPU without any per-frame
+// allocation.
+// Uses STL
+//
+// Per submission: AddPair() for every pair, RecordEstimates() on a video encode command list,
+// RecordReadbacks() on a command list that executes after it, then Submit() with the fence value
+// signaled after both. GetCompletedPair() / ReleasePair() then return results in order.
+//
+//================================================================================================
+#include <vector>
+
+//------------------------------------------------------------------------------------------------
+struct D3DX12_VIDEO_MOTION_ESTIMATION_PAIR
+{
+    ID3D12Resource* pInputTexture2D;
+    UINT InputSubresourceIndex;
+    ID3D12Resource* pReferenceTexture2D;
+    UINT ReferenceSubresourceIndex;
+    UINT PixelWidth;
+    UINT PixelHeight;
+};
+
+//------------------------------------------------------------------------------------------------
+// Motion vectors of a completed pair: BlocksWide x BlocksHigh (X, Y) pairs of INT16 in quarter pel
+struct D3DX12_VIDEO_MOTION_VECTORS
+{
+    UINT64 PairIndex;
+    const INT16* pData;
+    UINT RowPitch;
+    UINT BlocksWide;
+    UINT BlocksHigh;
+};
+
+//------------------------------------------------------------------------------------------------
+class CD3DX12VideoMotionEstimationBatch
+{
+public:
+    CD3DX12VideoMotionEstimationBatch() = default;
+    CD3DX12VideoMotionEstimationBatch(const CD3DX12VideoMotionEstimationBatch&) = delete;
+    CD3DX12VideoMotionEstimationBatch& operator=(const CD3DX12VideoMotionEstimationBatch&) = delete;
+    ~CD3DX12VideoMotionEstimationBatch() { ReleaseHeaps(); }
+
+    // Validates the estimator description and creates NumSlots motion vector heaps
+    HRESULT Init(
+        _In_ ID3D12VideoDevice1* pVideoDevice,
+        const D3D12_VIDEO_MOTION_ESTIMATOR_DESC& Desc,
+        UINT NumSlots,
+        _In_opt_ ID3D12ProtectedResourceSession* pProtectedResourceSession = nullptr)
+    {
+        ReleaseHeaps();
+        m_Slots.clear();
+        if (NumSlots == 0
+            || !D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::MotionEstimatorAllowedInputFormat(Desc.InputFormat)
+            || Desc.SizeRange.MinWidth > Desc.SizeRange.MaxWidth || Desc.SizeRange.MinHeight > Desc.SizeRange.MaxHeight
+            || Desc.SizeRange.MaxWidth == 0 || Desc.SizeRange.MaxHeight == 0)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_Desc = Desc;
+        m_BlockSize = Desc.BlockSize == D3D12_VIDEO_MOTION_ESTIMATOR_SEARCH_BLOCK_SIZE_8X8 ? 8 : 16;
+        m_BlocksWide = (Desc.SizeRange.MaxWidth + m_BlockSize - 1) / m_BlockSize;
+        m_BlocksHigh = (Desc.SizeRange.MaxHeight + m_BlockSize - 1) / m_BlockSize;
+        m_RowPitch = D3DX12Align<UINT>(m_BlocksWide * 4u, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+        m_SlotReadbackSize = D3DX12Align<UINT64>(UINT64(m_RowPitch) * m_BlocksHigh, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+        const D3D12_VIDEO_MOTION_VECTOR_HEAP_DESC HeapDesc = { Desc.NodeMask, Desc.InputFormat, Desc.BlockSize, Desc.Precision, Desc.SizeRange };
+        m_Slots.resize(NumSlots);
+        for (Slot& Entry : m_Slots)
+        {
+            HRESULT hr = pVideoDevice->CreateVideoMotionVectorHeap(&HeapDesc, pProtectedResourceSession,
+                IID_ID3D12VideoMotionVectorHeap, reinterpret_cast<void**>(&Entry.pHeap));
+            if (FAILED(hr))
+            {
+                ReleaseHeaps();
+                m_Slots.clear();
+                return hr;
+            }
+        }
+        m_pResolvedVectors = nullptr;
+        m_pReadback = nullptr;
+        m_pMappedReadback = nullptr;
+        m_NumAdded = m_NumSubmitted = m_NumReleased = 0;
+        return S_OK;
+    }
+
+    // Description of the texture array receiving the resolved vectors, one slice per slot
+    CD3DX12_RESOURCE_DESC GetResolvedTextureDesc() const noexcept
+    {
+        return CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16_SINT, m_BlocksWide, m_BlocksHigh, UINT16(m_Slots.size()), 1);
+    }
+
+    // Size of the readback buffer holding the resolved vectors of every slot
+    UINT64 GetReadbackBufferSize() const noexcept { return m_SlotReadbackSize * m_Slots.size(); }
+
+    // Sets the resources created from GetResolvedTextureDesc() and GetReadbackBufferSize(); the
+    // readback buffer stays mapped at pMappedReadback.
+    void SetOutputResources(_In_ ID3D12Resource* pResolvedVectors, _In_ ID3D12Resource* pReadback, _In_ const void* pMappedReadback) noexcept
+    {
+        m_pResolvedVectors = pResolvedVectors;
+        m_pReadback = pReadback;
+        m_pMappedReadback = static_cast<const BYTE*>(pMappedReadback);
+    }
+
+    // Queues a pair. Returns false if its size is outside the estimator's range or every slot is in
+    // use; release completed pairs first.
+    bool AddPair(const D3DX12_VIDEO_MOTION_ESTIMATION_PAIR& Pair) noexcept
+    {
+        if (m_Slots.empty() || m_NumAdded - m_NumReleased == m_Slots.size()
+            || Pair.PixelWidth < m_Desc.SizeRange.MinWidth || Pair.PixelWidth > m_Desc.SizeRange.MaxWidth
+            || Pair.PixelHeight < m_Desc.SizeRange.MinHeight || Pair.PixelHeight > m_Desc.SizeRange.MaxHeight)
+        {
+            return false;
+        }
+        m_Slots[m_NumAdded % m_Slots.size()].Pair = Pair;
+        ++m_NumAdded;
+        return true;
+    }
+
+    UINT GetNumPending() const noexcept { return static_cast<UINT>(m_NumAdded - m_NumSubmitted); }
+
+    // Arguments of the PendingIndex-th pair queued since the last Submit()
+    void GetPairArguments(
+        UINT PendingIndex,
+        _Out_ D3D12_VIDEO_MOTION_ESTIMATOR_OUTPUT* pEstimateOutput,
+        _Out_ D3D12_VIDEO_MOTION_ESTIMATOR_INPUT* pEstimateInput,
+        _Out_ D3D12_RESOLVE_VIDEO_MOTION_VECTOR_HEAP_OUTPUT* pResolveOutput,
+        _Out_ D3D12_RESOLVE_VIDEO_MOTION_VECTOR_HEAP_INPUT* pResolveInput) const noexcept
+    {
+        const UINT SlotIndex = static_cast<UINT>((m_NumSubmitted + PendingIndex) % m_Slots.size());
+        const Slot& Entry = m_Slots[SlotIndex];
+        pEstimateOutput->pMotionVectorHeap = Entry.pHeap;
+        *pEstimateInput = { Entry.Pair.pInputTexture2D, Entry.Pair.InputSubresourceIndex,
+            Entry.Pair.pReferenceTexture2D, Entry.Pair.ReferenceSubresourceIndex, nullptr };
+        pResolveOutput->pMotionVectorTexture2D = m_pResolvedVectors;
+        pResolveOutput->MotionVectorCoordinate = { 0, 0, 0, SlotIndex };
+        *pResolveInput = { Entry.pHeap, Entry.Pair.PixelWidth, Entry.Pair.PixelHeight };
+    }
+
+    // Records EstimateMotion and ResolveMotionVectorHeap for every pending pair
+    void RecordEstimates(_In_ ID3D12VideoEncodeCommandList* pCmdList, _In_ ID3D12VideoMotionEstimator* pMotionEstimator) const noexcept
+    {
+        for (UINT i = 0; i < GetNumPending(); ++i)
+        {
+            D3D12_VIDEO_MOTION_ESTIMATOR_OUTPUT EstimateOutput;
+            D3D12_VIDEO_MOTION_ESTIMATOR_INPUT EstimateInput;
+            D3D12_RESOLVE_VIDEO_MOTION_VECTOR_HEAP_OUTPUT ResolveOutput;
+            D3D12_RESOLVE_VIDEO_MOTION_VECTOR_HEAP_INPUT ResolveInput;
+            GetPairArguments(i, &EstimateOutput, &EstimateInput, &ResolveOutput, &ResolveInput);
+            pCmdList->EstimateMotion(pMotionEstimator, &EstimateOutput, &EstimateInput);
+            pCmdList->ResolveMotionVectorHeap(&ResolveOutput, &ResolveInput);
+        }
+    }
+
+    // Records the copies of the resolved vectors of every pending pair into the readback buffer. The
+    // resolved texture must be in D3D12_RESOURCE_STATE_COPY_SOURCE.
+    void RecordReadbacks(_In_ ID3D12GraphicsCommandList* pCmdList) const noexcept
+    {
+        for (UINT i = 0; i < GetNumPending(); ++i)
+        {
+            const UINT SlotIndex = static_cast<UINT>((m_NumSubmitted + i) % m_Slots.size());
+            const Slot& Entry = m_Slots[SlotIndex];
+            const CD3DX12_TEXTURE_COPY_LOCATION Dst(m_pReadback, GetSlotFootprint(SlotIndex));
+            const CD3DX12_TEXTURE_COPY_LOCATION Src(m_pResolvedVectors, SlotIndex);
+            const CD3DX12_BOX Box(0, 0, BlocksFor(Entry.Pair.PixelWidth), BlocksFor(Entry.Pair.PixelHeight));
+            pCmdList->CopyTextureRegion(&Dst, 0, 0, 0, &Src, &Box);
+        }
+    }
+
+    // Marks the pending pairs as submitted in work that signals FenceValue
+    void Submit(UINT64 FenceValue) noexcept
+    {
+        for (; m_NumSubmitted < m_NumAdded; ++m_NumSubmitted)
+        {
+            m_Slots[m_NumSubmitted % m_Slots.size()].FenceValue = FenceValue;
+        }
+    }
+
+    // Returns the oldest unreleased pair if its fence has completed
+    bool GetCompletedPair(UINT64 CompletedFenceValue, _Out_ D3DX12_VIDEO_MOTION_VECTORS* pVectors) const noexcept
+    {
+        *pVectors = {};
+        if (m_NumReleased == m_NumSubmitted)
+        {
+            return false;
+        }
+        const UINT SlotIndex = static_cast<UINT>(m_NumReleased % m_Slots.size());
+        const Slot& Entry = m_Slots[SlotIndex];
+        if (Entry.FenceValue > CompletedFenceValue)
+        {
+            return false;
+        }
+        pVectors->PairIndex = m_NumReleased;
+        pVectors->pData = m_pMappedReadback ? reinterpret_cast<const INT16*>(m_pMappedReadback + m_SlotReadbackSize * SlotIndex) : nullptr;
+        pVectors->RowPitch = m_RowPitch;
+        pVectors->BlocksWide = BlocksFor(Entry.Pair.PixelWidth);
+        pVectors->BlocksHigh = BlocksFor(Entry.Pair.PixelHeight);
+        return true;
+    }
+
+    void ReleasePair() noexcept
+    {
+        D3DX12_ASSERT(m_NumReleased < m_NumSubmitted);
+        ++m_NumReleased;
+    }
+
+private:
+    struct Slot
+    {
+        ID3D12VideoMotionVectorHeap* pHeap = nullptr;
+        D3DX12_VIDEO_MOTION_ESTIMATION_PAIR Pair = {};
+        UINT64 FenceValue = 0;
+    };
+
+    UINT BlocksFor(UINT Pixels) const noexcept { return (Pixels + m_BlockSize - 1) / m_BlockSize; }
+
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT GetSlotFootprint(UINT SlotIndex) const noexcept
+    {
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT Footprint = {};
+        Footprint.Offset = m_SlotReadbackSize * SlotIndex;
+        Footprint.Footprint = CD3DX12_SUBRESOURCE_FOOTPRINT(DXGI_FORMAT_R16G16_SINT, m_BlocksWide, m_BlocksHigh, 1, m_RowPitch);
+        return Footprint;
+    }
+
+    void ReleaseHeaps() noexcept
+    {
+        for (Slot& Entry : m_Slots)
+        {
+            if (Entry.pHeap)
+            {
+                Entry.pHeap->Release();
+                Entry.pHeap = nullptr;
+            }
+        }
+    }
+
+    std::vector<Slot> m_Slots;
+    D3D12_VIDEO_MOTION_ESTIMATOR_DESC m_Desc = {};
+    UINT m_BlockSize = 16;
+    UINT m_BlocksWide = 0;
+    UINT m_BlocksHigh = 0;
+    UINT m_RowPitch = 0;
+    UINT64 m_SlotReadbackSize = 0;
+    ID3D12Resource* m_pResolvedVectors = nullptr;
+    ID3D12Resource* m_pReadback = nullptr;
+    const BYTE* m_pMappedReadback = nullptr;
+    UINT64 m_NumAdded = 0;
+    UINT64 m_NumSubmitted = 0;
+    UINT64 m_NumReleased = 0;
+};
+
+#endif // !D3DX12_NO_VIDEO_MOTION_ESTIMATION_HELPERS
+
+#endif // defined( __cplusplus )
+
+#endif //__D3DX12_VIDEO_H__